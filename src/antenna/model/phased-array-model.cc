@@ -25,6 +25,8 @@
 #include <ns3/pointer.h>
 #include <ns3/uinteger.h>
 
+#include <cstring>
+
 namespace ns3
 {
 
@@ -57,7 +59,8 @@ operator<<(std::ostream& os, const PhasedArrayModel::ComplexVector& cv)
 }
 
 PhasedArrayModel::PhasedArrayModel()
-    : m_isBfVectorValid{false}
+    : m_isBfVectorValid{false},
+      m_beamformingVectorId{0}
 {
     m_id = m_idCounter++;
 }
@@ -89,6 +92,29 @@ PhasedArrayModel::SetBeamformingVector(const ComplexVector& beamformingVector)
                   beamformingVector.GetSize() << " != " << GetNumberOfElements());
     m_beamformingVector = beamformingVector;
     m_isBfVectorValid = true;
+
+    // hash the bit patterns of the elements, so that equal vectors yield
+    // equal identifiers
+    uint64_t id = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < beamformingVector.GetSize(); i++)
+    {
+        for (double part : {beamformingVector[i].real(), beamformingVector[i].imag()})
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &part, sizeof(bits));
+            id = (id ^ bits) * 0xff51afd7ed558ccdULL;
+            id ^= id >> 33;
+        }
+    }
+    m_beamformingVectorId = id;
+}
+
+uint64_t
+PhasedArrayModel::GetBeamformingVectorId() const
+{
+    NS_ASSERT_MSG(m_isBfVectorValid,
+                  "The beamforming vector should be Set before its ID is requested");
+    return m_beamformingVectorId;
 }
 
 PhasedArrayModel::ComplexVector
@@ -108,6 +108,18 @@ class PhasedArrayModel : public Object
      */
     ComplexVector GetBeamformingVector() const;
 
+    /**
+     * Returns an identifier of the beamforming vector that is currently being
+     * used. The identifier is a 64-bit hash of the content of the vector, so
+     * that setting again a previously used beamforming vector (e.g., when
+     * sweeping the beams of a codebook) yields the same identifier. Different
+     * identifiers imply different vectors, but equal identifiers do not
+     * guarantee equal vectors: a caller relying on the equality of the
+     * vectors must compare them when the identifiers are equal.
+     * \return the 64-bit hash of the current beamforming vector
+     */
+    uint64_t GetBeamformingVectorId() const;
+
     /**
      * Returns the beamforming vector that points towards the specified position
      * \param a the beamforming angle
@@ -144,6 +156,7 @@ class PhasedArrayModel : public Object
     ComplexVector m_beamformingVector;  //!< the beamforming vector in use
     Ptr<AntennaModel> m_antennaElement; //!< the model of the antenna element in use
     bool m_isBfVectorValid;             //!< ensures the validity of the beamforming vector
+    uint64_t m_beamformingVectorId;     //!< identifier of the beamforming vector in use
     static uint32_t
         m_idCounter;  //!< the ID counter that is used to determine the unique antenna array ID
     uint32_t m_id{0}; //!< the ID of this antenna array instance
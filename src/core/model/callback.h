@@ -27,8 +27,10 @@
 #include "ptr.h"
 #include "simple-ref-count.h"
 
+#include <array>
 #include <functional>
 #include <memory>
+#include <tuple>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -72,6 +74,8 @@ namespace ns3
  * or not we really want to use it.
  */
 
+class CallbackComponentBase;
+
 /**
  * \ingroup callbackimpl
  * Abstract base class for CallbackImpl
@@ -97,6 +101,18 @@ class CallbackImplBase : public SimpleRefCount<CallbackImplBase>
      * \return The object type as a string.
      */
     virtual std::string GetTypeid() const = 0;
+    /**
+     * Get the number of components of this callback, i.e., the callable
+     * object and the bound arguments.
+     * \return The number of components.
+     */
+    virtual std::size_t GetNComponents() const = 0;
+    /**
+     * Get a component of this callback.
+     * \param [in] i The index of the component, the callable object being the first.
+     * \return The component.
+     */
+    virtual const CallbackComponentBase* GetComponent(std::size_t i) const = 0;
 
   protected:
     /**
@@ -144,10 +160,10 @@ class CallbackComponentBase
     /**
      * Equality test
      *
-     * \param [in] other CallbackComponent Ptr
+     * \param [in] other CallbackComponent pointer
      * \return \c true if we are equal
      */
-    virtual bool IsEqual(std::shared_ptr<const CallbackComponentBase> other) const = 0;
+    virtual bool IsEqual(const CallbackComponentBase* other) const = 0;
 };
 
 /**
@@ -176,12 +192,12 @@ class CallbackComponent : public CallbackComponentBase
     /**
      * Equality test between the values of two components
      *
-     * \param [in] other CallbackComponentBase Ptr
+     * \param [in] other CallbackComponentBase pointer
      * \return \c true if we are equal
      */
-    bool IsEqual(std::shared_ptr<const CallbackComponentBase> other) const override
+    bool IsEqual(const CallbackComponentBase* other) const override
     {
-        auto p = std::dynamic_pointer_cast<const CallbackComponent<T>>(other);
+        auto p = dynamic_cast<const CallbackComponent<T>*>(other);
 
         // other must have the same type and value as ours
         return !(p == nullptr || p->m_comp != m_comp);
@@ -218,17 +234,40 @@ class CallbackComponent<T, false> : public CallbackComponentBase
     /**
      * Equality test between functions
      *
-     * \param [in] other CallbackParam Ptr
+     * \param [in] other CallbackParam pointer
      * \return \c true if we are equal
      */
-    bool IsEqual(std::shared_ptr<const CallbackComponentBase> other) const override
+    bool IsEqual(const CallbackComponentBase* other) const override
     {
         return false;
     }
 };
 
-/// Vector of callback components
-typedef std::vector<std::shared_ptr<CallbackComponentBase>> CallbackComponentVector;
+/**
+ * \ingroup callbackimpl
+ * Invoke a callable object and convert the result to the return type
+ * of a callback, discarding it if the callback returns \c void.
+ *
+ * \tparam R \explicit The return type of the Callback.
+ * \tparam F \deduced The type of the callable object.
+ * \tparam Args \deduced The types of the arguments.
+ * \param [in] f The callable object.
+ * \param [in] args The arguments.
+ * \return The result of the call.
+ */
+template <typename R, typename F, typename... Args>
+R
+CallbackInvoke(F&& f, Args&&... args)
+{
+    if constexpr (std::is_void_v<R>)
+    {
+        std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+    else
+    {
+        return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+}
 
 /**
  * \ingroup callbackimpl
@@ -241,46 +280,13 @@ template <typename R, typename... UArgs>
 class CallbackImpl : public CallbackImplBase
 {
   public:
-    /**
-     * Constructor.
-     *
-     * \param func the callable object
-     * \param components the callback components (callable object and bound arguments)
-     */
-    CallbackImpl(std::function<R(UArgs...)> func, const CallbackComponentVector& components)
-        : m_func(func),
-          m_components(components)
-    {
-    }
-
-    /**
-     * Get the stored function.
-     * \return A const reference to the stored function.
-     */
-    const std::function<R(UArgs...)>& GetFunction() const
-    {
-        return m_func;
-    }
-
-    /**
-     * Get the vector of callback components.
-     * \return A const reference to the vector of callback components.
-     */
-    const CallbackComponentVector& GetComponents() const
-    {
-        return m_components;
-    }
-
     /**
      * Function call operator.
      *
      * \param uargs The arguments to the Callback.
      * \return Callback value
      */
-    R operator()(UArgs... uargs) const
-    {
-        return m_func(uargs...);
-    }
+    virtual R operator()(UArgs... uargs) const = 0;
 
     bool IsEqual(Ptr<const CallbackImplBase> other) const override
     {
@@ -294,23 +300,25 @@ class CallbackImpl : public CallbackImplBase
 
         // if the two callback implementations are made of a distinct number of
         // components, they are different
-        if (m_components.size() != otherDerived->GetComponents().size())
+        std::size_t n = GetNComponents();
+        if (n != otherDerived->GetNComponents())
         {
             return false;
         }
 
-        // the two functions are equal if they compare equal or the shared pointers
-        // point to the same locations
-        if (!m_components.at(0)->IsEqual(otherDerived->GetComponents().at(0)) &&
-            m_components.at(0) != otherDerived->GetComponents().at(0))
+        // the two functions are equal if they compare equal or they are
+        // the same component
+        const CallbackComponentBase* func = GetComponent(0);
+        const CallbackComponentBase* otherFunc = otherDerived->GetComponent(0);
+        if (!func->IsEqual(otherFunc) && func != otherFunc)
         {
             return false;
         }
 
         // check if the remaining components are equal one by one
-        for (std::size_t i = 1; i < m_components.size(); i++)
+        for (std::size_t i = 1; i < n; i++)
         {
-            if (!m_components.at(i)->IsEqual(otherDerived->GetComponents().at(i)))
+            if (!GetComponent(i)->IsEqual(otherDerived->GetComponent(i)))
             {
                 return false;
             }
@@ -342,13 +350,76 @@ class CallbackImpl : public CallbackImplBase
 
         return id;
     }
+};
 
-  private:
-    /// Stores the callable object associated with this callback (as a lambda)
-    std::function<R(UArgs...)> m_func;
+/**
+ * \ingroup callbackimpl
+ * CallbackImpl storing the callable object and the callback components in
+ * place, so that a Callback is built with a single allocation and invoked
+ * with a single virtual call.
+ *
+ * The components of a Callback built by binding the arguments of another
+ * one are those of the other Callback, followed by the bound arguments.
+ *
+ * \tparam F \explicit The type of the callable object.
+ * \tparam C \explicit The std::tuple of the CallbackComponent types of the
+ *           callable object (unless bound from another Callback) and of
+ *           the bound arguments.
+ * \tparam R \explicit The return type of the Callback.
+ * \tparam UArgs \explicit The types of any arguments to the Callback.
+ */
+template <typename F, typename C, typename R, typename... UArgs>
+class CallbackFunctorImpl : public CallbackImpl<R, UArgs...>
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \tparam Vs \deduced The types of the values of the components
+     * \param [in] parent The callback whose arguments are bound, if any
+     * \param [in] functor The callable object
+     * \param [in] values The values of the components
+     */
+    template <typename... Vs>
+    CallbackFunctorImpl(Ptr<CallbackImplBase> parent, F functor, const Vs&... values)
+        : m_functor(std::move(functor)),
+          m_components(values...),
+          m_parent(parent),
+          m_nParentComponents(parent ? parent->GetNComponents() : 0)
+    {
+        std::apply([this](const auto&... c) { m_componentPointers = {&c...}; }, m_components);
+    }
 
-    /// Stores the original callable object and the bound arguments, if any
-    std::vector<std::shared_ptr<CallbackComponentBase>> m_components;
+    R operator()(UArgs... uargs) const override
+    {
+        return m_functor(std::forward<UArgs>(uargs)...);
+    }
+
+    std::size_t GetNComponents() const override
+    {
+        return m_nParentComponents + std::tuple_size_v<C>;
+    }
+
+    const CallbackComponentBase* GetComponent(std::size_t i) const override
+    {
+        if (i < m_nParentComponents)
+        {
+            return m_parent->GetComponent(i);
+        }
+        return m_componentPointers.at(i - m_nParentComponents);
+    }
+
+  private:
+    /// The callable object, which may have a non-const call operator
+    mutable F m_functor;
+    /// The callable object and the bound arguments, to compare callbacks
+    C m_components;
+    /// Pointers to the elements of \c m_components
+    std::array<const CallbackComponentBase*, std::tuple_size_v<C>> m_componentPointers;
+    /// The callback whose arguments are bound, if any
+    Ptr<CallbackImplBase> m_parent;
+    /// The number of components of \c m_parent
+    std::size_t m_nParentComponents;
 };
 
 /**
@@ -464,17 +535,15 @@ class Callback : public CallbackBase
     template <typename... BArgs>
     Callback(const Callback<R, BArgs..., UArgs...>& cb, BArgs... bargs)
     {
-        auto f = cb.DoPeekImpl()->GetFunction();
+        Ptr<CallbackImpl<R, BArgs..., UArgs...>> impl(cb.DoPeekImpl());
+        auto f = [impl, bargs...](auto&&... uargs) mutable -> R {
+            return (*impl)(bargs..., std::forward<decltype(uargs)>(uargs)...);
+        };
 
-        CallbackComponentVector components(cb.DoPeekImpl()->GetComponents());
-        components.insert(components.end(),
-                          {std::make_shared<CallbackComponent<std::decay_t<BArgs>>>(bargs)...});
-
-        m_impl = Create<CallbackImpl<R, UArgs...>>(
-            [f, bargs...](auto&&... uargs) -> R {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
-            },
-            components);
+        m_impl = Create<CallbackFunctorImpl<decltype(f),
+                                            std::tuple<CallbackComponent<std::decay_t<BArgs>>...>,
+                                            R,
+                                            UArgs...>>(impl, f, bargs...);
     }
 
     /**
@@ -494,23 +563,21 @@ class Callback : public CallbackBase
               typename... BArgs>
     Callback(T func, BArgs... bargs)
     {
-        // store the function in a std::function object
-        std::function<R(BArgs..., UArgs...)> f(func);
+        // store the function and the bound arguments in place
+        auto f = [func, bargs...](auto&&... uargs) mutable -> R {
+            return CallbackInvoke<R>(func, bargs..., std::forward<decltype(uargs)>(uargs)...);
+        };
 
         // The original function is comparable if it is a function pointer or
         // a pointer to a member function or a pointer to a member data.
         constexpr bool isComp =
             std::is_function_v<std::remove_pointer_t<T>> || std::is_member_pointer_v<T>;
 
-        CallbackComponentVector components(
-            {std::make_shared<CallbackComponent<T, isComp>>(func),
-             std::make_shared<CallbackComponent<std::decay_t<BArgs>>>(bargs)...});
-
-        m_impl = Create<CallbackImpl<R, UArgs...>>(
-            [f, bargs...](auto&&... uargs) -> R {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
-            },
-            components);
+        m_impl = Create<CallbackFunctorImpl<
+            decltype(f),
+            std::tuple<CallbackComponent<T, isComp>, CallbackComponent<std::decay_t<BArgs>>...>,
+            R,
+            UArgs...>>(nullptr, f, func, bargs...);
     }
 
   private:
@@ -530,17 +597,18 @@ class Callback : public CallbackBase
     {
         Callback<R, std::tuple_element_t<sizeof...(bargs) + INDEX, std::tuple<UArgs...>>...> cb;
 
-        const auto f = DoPeekImpl()->GetFunction();
-
-        CallbackComponentVector components(DoPeekImpl()->GetComponents());
-        components.insert(components.end(),
-                          {std::make_shared<CallbackComponent<std::decay_t<BoundArgs>>>(bargs)...});
-
-        cb.m_impl = Create<std::remove_pointer_t<decltype(cb.DoPeekImpl())>>(
-            [f, bargs...](auto&&... uargs) mutable {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
-            },
-            components);
+        Ptr<CallbackImpl<R, UArgs...>> impl(DoPeekImpl());
+        auto f = [impl, bargs...](auto&&... uargs) mutable -> R {
+            return (*impl)(bargs..., std::forward<decltype(uargs)>(uargs)...);
+        };
+
+        cb.m_impl = Create<CallbackFunctorImpl<
+            decltype(f),
+            std::tuple<CallbackComponent<std::decay_t<BoundArgs>>...>,
+            R,
+            std::tuple_element_t<sizeof...(bargs) + INDEX, std::tuple<UArgs...>>...>>(impl,
+                                                                                      f,
+                                                                                      bargs...);
 
         return cb;
     }
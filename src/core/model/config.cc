@@ -26,7 +26,13 @@
 #include "pointer.h"
 #include "singleton.h"
 
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
 #include <sstream>
+#include <unordered_map>
 
 /**
  * \file
@@ -197,6 +203,8 @@ MatchContainer::DisconnectWithoutContext(std::string name, const CallbackBase& c
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once into a set of index ranges.
  */
 class ArrayMatcher
 {
@@ -208,14 +216,24 @@ class ArrayMatcher
      */
     ArrayMatcher(std::string element);
     /**
-     * Test if a specific index matches the Config Path.
+     * Get the entries of a container matching the Config path.
+     *
+     * Unless the specification is a wildcard, the entries are looked up
+     * by index instead of testing every entry of the container.
      *
-     * \param [in] i The index.
-     * \returns \c true if the index matches the Config Path.
+     * \param [in] container The container.
+     * \returns The matching entries, in increasing order of index.
      */
-    bool Matches(std::size_t i) const;
+    std::vector<std::pair<std::size_t, Ptr<Object>>> GetMatches(
+        const ObjectPtrContainerValue& container) const;
 
   private:
+    /**
+     * Parse a Config path specification into index ranges.
+     *
+     * \param [in] element The Config path specification.
+     */
+    void Parse(std::string element);
     /**
      * Convert a string to an \c uint32_t.
      *
@@ -226,75 +244,104 @@ class ArrayMatcher
     bool StringToUint32(std::string str, uint32_t* value) const;
     /** The Config path element. */
     std::string m_element;
+    /** Whether the element matches any index. */
+    bool m_wildcard;
+    /** The sorted, disjoint ranges of matching indices, bounds included. */
+    std::vector<std::pair<std::size_t, std::size_t>> m_ranges;
 
 }; // class ArrayMatcher
 
 ArrayMatcher::ArrayMatcher(std::string element)
-    : m_element(element)
+    : m_element(element),
+      m_wildcard(false)
 {
     NS_LOG_FUNCTION(this << element);
+    Parse(element);
+    std::sort(m_ranges.begin(), m_ranges.end());
+    // Merge the overlapping and adjacent ranges
+    std::vector<std::pair<std::size_t, std::size_t>> merged;
+    for (const auto& range : m_ranges)
+    {
+        if (!merged.empty() && range.first <= merged.back().second + 1)
+        {
+            merged.back().second = std::max(merged.back().second, range.second);
+        }
+        else
+        {
+            merged.push_back(range);
+        }
+    }
+    m_ranges.swap(merged);
 }
 
-bool
-ArrayMatcher::Matches(std::size_t i) const
+void
+ArrayMatcher::Parse(std::string element)
 {
-    NS_LOG_FUNCTION(this << i);
-    if (m_element == "*")
+    NS_LOG_FUNCTION(this << element);
+    if (element == "*")
     {
-        NS_LOG_DEBUG("Array " << i << " matches *");
-        return true;
+        m_wildcard = true;
+        return;
     }
     std::string::size_type tmp;
-    tmp = m_element.find('|');
+    tmp = element.find('|');
     if (tmp != std::string::npos)
     {
-        std::string left = m_element.substr(0, tmp - 0);
-        std::string right = m_element.substr(tmp + 1, m_element.size() - (tmp + 1));
-        ArrayMatcher matcher = ArrayMatcher(left);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << left);
-            return true;
-        }
-        matcher = ArrayMatcher(right);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << right);
-            return true;
-        }
-        NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
-        return false;
+        Parse(element.substr(0, tmp - 0));
+        Parse(element.substr(tmp + 1, element.size() - (tmp + 1)));
+        return;
     }
-    std::string::size_type leftBracket = m_element.find('[');
-    std::string::size_type rightBracket = m_element.find(']');
-    std::string::size_type dash = m_element.find('-');
-    if (leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
+    std::string::size_type leftBracket = element.find('[');
+    std::string::size_type rightBracket = element.find(']');
+    std::string::size_type dash = element.find('-');
+    if (leftBracket == 0 && rightBracket == element.size() - 1 && dash > leftBracket &&
         dash < rightBracket)
     {
-        std::string lowerBound = m_element.substr(leftBracket + 1, dash - (leftBracket + 1));
-        std::string upperBound = m_element.substr(dash + 1, rightBracket - (dash + 1));
+        std::string lowerBound = element.substr(leftBracket + 1, dash - (leftBracket + 1));
+        std::string upperBound = element.substr(dash + 1, rightBracket - (dash + 1));
         uint32_t min;
         uint32_t max;
-        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && i >= min &&
-            i <= max)
+        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && min <= max)
         {
-            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-            return true;
-        }
-        else
-        {
-            NS_LOG_DEBUG("Array " << i << " does not " << m_element);
-            return false;
+            m_ranges.emplace_back(min, max);
         }
+        return;
     }
     uint32_t value;
-    if (StringToUint32(m_element, &value) && i == value)
+    if (StringToUint32(element, &value))
     {
-        NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-        return true;
+        m_ranges.emplace_back(value, value);
     }
-    NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
-    return false;
+}
+
+std::vector<std::pair<std::size_t, Ptr<Object>>>
+ArrayMatcher::GetMatches(const ObjectPtrContainerValue& container) const
+{
+    NS_LOG_FUNCTION(this << &container);
+    std::vector<std::pair<std::size_t, Ptr<Object>>> matches;
+    if (container.GetN() == 0)
+    {
+        return matches;
+    }
+    if (m_wildcard)
+    {
+        matches.assign(container.Begin(), container.End());
+        return matches;
+    }
+    std::size_t last = std::prev(container.End())->first;
+    for (const auto& range : m_ranges)
+    {
+        for (std::size_t i = range.first; i <= std::min(range.second, last); ++i)
+        {
+            Ptr<Object> object = container.Get(i);
+            if (object)
+            {
+                matches.emplace_back(i, object);
+            }
+        }
+    }
+    NS_LOG_DEBUG("Array " << m_element << " matches " << matches.size() << " entries");
+    return matches;
 }
 
 bool
@@ -307,6 +354,171 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
     return !iss.bad() && !iss.fail();
 }
 
+/**
+ * \ingroup config-impl
+ * An element of a compiled Config path.
+ */
+struct PathElement
+{
+    /**
+     * Construct from a Config path element.
+     *
+     * \param [in] element The Config path element.
+     */
+    PathElement(std::string element);
+
+    std::string item;     //!< The Config path element
+    bool isObject;        //!< Whether the element is a "$" GetObject() call
+    std::string tidName;  //!< The name of the TypeId of a "$" element
+    bool tidFound;        //!< Whether the TypeId was registered when compiled
+    TypeId tid;           //!< The TypeId of a "$" element, if found
+    ArrayMatcher matcher; //!< The matcher of the element used as an array index
+};
+
+PathElement::PathElement(std::string element)
+    : item(element),
+      isObject(element.find('$') == 0),
+      tidFound(false),
+      matcher(element)
+{
+    if (isObject)
+    {
+        tidName = element.substr(1, element.size() - 1);
+        tidFound = TypeId::LookupByNameFailSafe(tidName, &tid);
+    }
+}
+
+/** \ingroup config-impl A Config path split into its compiled elements. */
+typedef std::vector<PathElement> CompiledPath;
+
+/**
+ * \ingroup config-impl
+ * Compiled Config paths and cached containers, shared by the resolutions.
+ *
+ * The paths are compiled the first time they are resolved: they are split
+ * into their elements, the "$" elements are looked up in the TypeId
+ * database, and the array indices are parsed.
+ *
+ * At most MAX_COMPILED_PATHS paths are kept: the compiled paths are all
+ * discarded when the limit is reached, and when the cache is invalidated.
+ * The resolutions in progress keep their own reference to their path.
+ *
+ * The contents of some ObjectPtrContainer attributes, such as the NodeList,
+ * are cached as well, so that the resolution of a path with a specific
+ * index does not copy the whole container. The owners of these containers
+ * must call Config::InvalidateCache() whenever their contents change.
+ */
+class ResolverCache
+{
+  public:
+    /**
+     * Get a compiled Config path.
+     *
+     * \param [in] path The canonical Config path.
+     * \returns The compiled path.
+     */
+    std::shared_ptr<const CompiledPath> Compile(const std::string& path);
+    /**
+     * Get the contents of a container attribute.
+     *
+     * \param [in] object The object holding the attribute.
+     * \param [in] tid The TypeId declaring the attribute.
+     * \param [in] name The name of the attribute.
+     * \returns The contents of the attribute.
+     */
+    const ObjectPtrContainerValue& GetContainer(Ptr<Object> object,
+                                                TypeId tid,
+                                                const std::string& name);
+    /** \copydoc ns3::Config::RegisterCachedContainer() */
+    void RegisterCachedContainer(TypeId tid, std::string name);
+    /** \copydoc ns3::Config::UnregisterCachedContainer() */
+    void UnregisterCachedContainer(TypeId tid, std::string name);
+    /** \copydoc ns3::Config::InvalidateCache() */
+    void Invalidate();
+
+  private:
+    /** The maximum number of compiled paths kept. */
+    static constexpr std::size_t MAX_COMPILED_PATHS = 1024;
+
+    /** The compiled paths. */
+    std::unordered_map<std::string, std::shared_ptr<const CompiledPath>> m_paths;
+    /** The container attributes to cache, by declaring TypeId and name. */
+    std::set<std::pair<TypeId, std::string>> m_cachedContainers;
+    /** The cached containers, by holding object and attribute name. */
+    std::map<std::pair<const Object*, std::string>, ObjectPtrContainerValue> m_containers;
+    /** The last container read, when not cached. */
+    ObjectPtrContainerValue m_uncached;
+
+}; // class ResolverCache
+
+std::shared_ptr<const CompiledPath>
+ResolverCache::Compile(const std::string& path)
+{
+    NS_LOG_FUNCTION(this << path);
+    auto it = m_paths.find(path);
+    if (it != m_paths.end())
+    {
+        return it->second;
+    }
+    if (m_paths.size() >= MAX_COMPILED_PATHS)
+    {
+        m_paths.clear();
+    }
+    auto compiled = std::make_shared<CompiledPath>();
+    std::string::size_type start = 0;
+    std::string::size_type next = path.find('/', 1);
+    while (next != std::string::npos)
+    {
+        compiled->emplace_back(path.substr(start + 1, next - (start + 1)));
+        start = next;
+        next = path.find('/', start + 1);
+    }
+    m_paths.emplace(path, compiled);
+    return compiled;
+}
+
+const ObjectPtrContainerValue&
+ResolverCache::GetContainer(Ptr<Object> object, TypeId tid, const std::string& name)
+{
+    NS_LOG_FUNCTION(this << object << tid << name);
+    if (m_cachedContainers.find({tid, name}) == m_cachedContainers.end())
+    {
+        object->GetAttribute(name, m_uncached);
+        return m_uncached;
+    }
+    auto key = std::make_pair(PeekPointer(object), name);
+    auto it = m_containers.find(key);
+    if (it == m_containers.end())
+    {
+        it = m_containers.emplace(key, ObjectPtrContainerValue()).first;
+        object->GetAttribute(name, it->second);
+    }
+    return it->second;
+}
+
+void
+ResolverCache::RegisterCachedContainer(TypeId tid, std::string name)
+{
+    NS_LOG_FUNCTION(this << tid << name);
+    m_cachedContainers.emplace(tid, name);
+}
+
+void
+ResolverCache::UnregisterCachedContainer(TypeId tid, std::string name)
+{
+    NS_LOG_FUNCTION(this << tid << name);
+    m_cachedContainers.erase({tid, name});
+    m_containers.clear();
+}
+
+void
+ResolverCache::Invalidate()
+{
+    NS_LOG_FUNCTION(this);
+    m_paths.clear();
+    m_containers.clear();
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
@@ -318,8 +530,9 @@ class Resolver
      * Construct from a base Config path.
      *
      * \param [in] path The Config path.
+     * \param [in] cache The compiled paths and cached containers.
      */
-    Resolver(std::string path);
+    Resolver(std::string path, ResolverCache* cache);
     /** Destructor. */
     virtual ~Resolver();
 
@@ -338,18 +551,18 @@ class Resolver
     /**
      * Parse the next element in the Config path.
      *
-     * \param [in] path The remaining portion of the Config path.
+     * \param [in] index The index of the next element of the Config path.
      * \param [in] root The object corresponding to the current position
      *                  in the Config path.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    void DoResolve(std::size_t index, Ptr<Object> root);
     /**
      * Parse an index on the Config path.
      *
-     * \param [in] path The remaining Config path.
+     * \param [in] index The index of the next element of the Config path.
      * \param [in,out] vector The resulting list of matching objects.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    void DoArrayResolve(std::size_t index, const ObjectPtrContainerValue& vector);
     /**
      * Handle one object found on the path.
      *
@@ -374,14 +587,20 @@ class Resolver
     std::vector<std::string> m_workStack;
     /** The Config path. */
     std::string m_path;
+    /** The compiled paths and cached containers. */
+    ResolverCache* m_cache;
+    /** The compiled Config path. */
+    std::shared_ptr<const CompiledPath> m_elements;
 
 }; // class Resolver
 
-Resolver::Resolver(std::string path)
-    : m_path(path)
+Resolver::Resolver(std::string path, ResolverCache* cache)
+    : m_path(path),
+      m_cache(cache)
 {
-    NS_LOG_FUNCTION(this << path);
+    NS_LOG_FUNCTION(this << path << cache);
     Canonicalize();
+    m_elements = m_cache->Compile(m_path);
 }
 
 Resolver::~Resolver()
@@ -414,7 +633,7 @@ Resolver::Resolve(Ptr<Object> root)
 {
     NS_LOG_FUNCTION(this << root);
 
-    DoResolve(m_path, root);
+    DoResolve(0, root);
 }
 
 std::string
@@ -440,13 +659,11 @@ Resolver::DoResolveOne(Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Resolver::DoResolve(std::size_t index, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << index << root);
 
-    if (next == std::string::npos)
+    if (index == m_elements->size())
     {
         //
         // If root is zero, we're beginning to see if we can use the object name
@@ -462,8 +679,8 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
         }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    const PathElement& element = (*m_elements)[index];
+    const std::string& item = element.item;
 
     //
     // If root is zero, we're beginning to see if we can use the object name
@@ -474,11 +691,10 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     //
     if (!root)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
+        if (item.compare(0, 5, "Names") == 0)
         {
             m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
+            DoResolve(index + 1, root);
             m_workStack.pop_back();
             return;
         }
@@ -495,7 +711,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
         m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
+        DoResolve(index + 1, namedObject);
         m_workStack.pop_back();
         return;
     }
@@ -511,21 +727,20 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         return;
     }
-    std::string::size_type dollarPos = item.find('$');
-    if (dollarPos == 0)
+    if (element.isObject)
     {
         // This is a call to GetObject
-        std::string tidString = item.substr(1, item.size() - 1);
-        NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
-        TypeId tid = TypeId::LookupByName(tidString);
+        NS_LOG_DEBUG("GetObject=" << element.tidName << " on path=" << GetResolvedPath());
+        TypeId tid = element.tidFound ? element.tid : TypeId::LookupByName(element.tidName);
         Ptr<Object> object = root->GetObject<Object>(tid);
         if (!object)
         {
-            NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
+            NS_LOG_DEBUG("GetObject (" << element.tidName
+                                       << ") failed on path=" << GetResolvedPath());
             return;
         }
         m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
+        DoResolve(index + 1, object);
         m_workStack.pop_back();
     }
     else
@@ -567,7 +782,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
                     }
                     foundMatch = true;
                     m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
+                    DoResolve(index + 1, object);
                     m_workStack.pop_back();
                 }
                 // attempt to cast to an object vector.
@@ -575,13 +790,13 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
                     dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
                 if (vectorChecker != nullptr)
                 {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
+                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name
+                                                         << " on path=" << GetResolvedPath());
                     foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
+                    const ObjectPtrContainerValue& vector =
+                        m_cache->GetContainer(root, tid, info.name);
                     m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
+                    DoArrayResolve(index + 1, vector);
                     m_workStack.pop_back();
                 }
                 // this could be anything else and we don't know what to do with it.
@@ -601,31 +816,22 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::size_t index, const ObjectPtrContainerValue& container)
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(!path.empty());
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
+    NS_LOG_FUNCTION(this << index << &container);
+    if (index == m_elements->size())
     {
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
 
-    ArrayMatcher matcher = ArrayMatcher(item);
-    ObjectPtrContainerValue::Iterator it;
-    for (it = container.Begin(); it != container.End(); ++it)
+    // The matches are copied, since the resolution of the rest of the path
+    // may read another container
+    const ArrayMatcher& matcher = (*m_elements)[index].matcher;
+    for (const auto& [i, object] : matcher.GetMatches(container))
     {
-        if (matcher.Matches((*it).first))
-        {
-            std::ostringstream oss;
-            oss << (*it).first;
-            m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
-            m_workStack.pop_back();
-        }
+        m_workStack.push_back(std::to_string(i));
+        DoResolve(index + 1, object);
+        m_workStack.pop_back();
     }
 }
 
@@ -663,6 +869,13 @@ class ConfigImpl : public Singleton<ConfigImpl>
     /** \copydoc ns3::Config::GetRootNamespaceObject() */
     Ptr<Object> GetRootNamespaceObject(std::size_t i) const;
 
+    /** \copydoc ns3::Config::RegisterCachedContainer() */
+    void RegisterCachedContainer(TypeId tid, std::string name);
+    /** \copydoc ns3::Config::UnregisterCachedContainer() */
+    void UnregisterCachedContainer(TypeId tid, std::string name);
+    /** \copydoc ns3::Config::InvalidateCache() */
+    void InvalidateCache();
+
   private:
     /**
      * Break a Config path into the leading path and the last leaf token.
@@ -678,6 +891,8 @@ class ConfigImpl : public Singleton<ConfigImpl>
 
     /** The list of Config path roots. */
     Roots m_roots;
+    /** The compiled paths and cached containers. */
+    ResolverCache m_cache;
 
 }; // class ConfigImpl
 
@@ -785,8 +1000,8 @@ ConfigImpl::LookupMatches(std::string path)
     class LookupMatchesResolver : public Resolver
     {
       public:
-        LookupMatchesResolver(std::string path)
-            : Resolver(path)
+        LookupMatchesResolver(std::string path, ResolverCache* cache)
+            : Resolver(path, cache)
         {
         }
 
@@ -798,7 +1013,7 @@ ConfigImpl::LookupMatches(std::string path)
 
         std::vector<Ptr<Object>> m_objects;
         std::vector<std::string> m_contexts;
-    } resolver = LookupMatchesResolver(path);
+    } resolver = LookupMatchesResolver(path, &m_cache);
 
     for (auto i = m_roots.begin(); i != m_roots.end(); i++)
     {
@@ -820,6 +1035,7 @@ ConfigImpl::RegisterRootNamespaceObject(Ptr<Object> obj)
 {
     NS_LOG_FUNCTION(this << obj);
     m_roots.push_back(obj);
+    m_cache.Invalidate();
 }
 
 void
@@ -832,6 +1048,7 @@ ConfigImpl::UnregisterRootNamespaceObject(Ptr<Object> obj)
         if (*i == obj)
         {
             m_roots.erase(i);
+            m_cache.Invalidate();
             return;
         }
     }
@@ -851,6 +1068,27 @@ ConfigImpl::GetRootNamespaceObject(std::size_t i) const
     return m_roots[i];
 }
 
+void
+ConfigImpl::RegisterCachedContainer(TypeId tid, std::string name)
+{
+    NS_LOG_FUNCTION(this << tid << name);
+    m_cache.RegisterCachedContainer(tid, name);
+}
+
+void
+ConfigImpl::UnregisterCachedContainer(TypeId tid, std::string name)
+{
+    NS_LOG_FUNCTION(this << tid << name);
+    m_cache.UnregisterCachedContainer(tid, name);
+}
+
+void
+ConfigImpl::InvalidateCache()
+{
+    NS_LOG_FUNCTION(this);
+    m_cache.Invalidate();
+}
+
 void
 Reset()
 {
@@ -870,6 +1108,8 @@ Reset()
     {
         (*i)->ResetInitialValue();
     }
+    // and discard the compiled paths and the cached containers.
+    ConfigImpl::Get()->InvalidateCache();
 }
 
 void
@@ -1029,6 +1269,27 @@ GetRootNamespaceObject(uint32_t i)
     return ConfigImpl::Get()->GetRootNamespaceObject(i);
 }
 
+void
+RegisterCachedContainer(TypeId tid, std::string name)
+{
+    NS_LOG_FUNCTION(tid << name);
+    ConfigImpl::Get()->RegisterCachedContainer(tid, name);
+}
+
+void
+UnregisterCachedContainer(TypeId tid, std::string name)
+{
+    NS_LOG_FUNCTION(tid << name);
+    ConfigImpl::Get()->UnregisterCachedContainer(tid, name);
+}
+
+void
+InvalidateCache()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    ConfigImpl::Get()->InvalidateCache();
+}
+
 } // namespace Config
 
 } // namespace ns3
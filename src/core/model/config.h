@@ -36,6 +36,7 @@ namespace ns3
 class AttributeValue;
 class Object;
 class CallbackBase;
+class TypeId;
 
 /**
  * \ingroup core
@@ -390,6 +391,39 @@ std::size_t GetRootNamespaceObjectN();
  */
 Ptr<Object> GetRootNamespaceObject(uint32_t i);
 
+/**
+ * \ingroup config
+ * \param [in] tid The TypeId declaring the attribute.
+ * \param [in] name The name of an ObjectPtrContainer attribute.
+ *
+ * Cache the contents of an attribute during path matching, so that
+ * the paths with a specific index, e.g., "/NodeList/3/DeviceList/1",
+ * are resolved without reading the whole container each time.
+ * The owner of the container must call Config::InvalidateCache()
+ * whenever an object is added to or removed from it.
+ */
+void RegisterCachedContainer(TypeId tid, std::string name);
+
+/**
+ * \ingroup config
+ * \param [in] tid The TypeId declaring the attribute.
+ * \param [in] name The name of an ObjectPtrContainer attribute.
+ *
+ * Stop caching the contents of an attribute registered with
+ * Config::RegisterCachedContainer().
+ */
+void UnregisterCachedContainer(TypeId tid, std::string name);
+
+/**
+ * \ingroup config
+ *
+ * Discard the contents of the containers cached during path matching,
+ * see Config::RegisterCachedContainer(), as well as the compiled paths.
+ * The cache is also discarded when a root namespace object is registered
+ * or unregistered, and by Config::Reset().
+ */
+void InvalidateCache();
+
 } // namespace Config
 
 } // namespace ns3
@@ -62,7 +62,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
+    m_eventsWithContext = nullptr;
     m_mainThreadId = std::this_thread::get_id();
 }
 
@@ -156,30 +156,36 @@ DefaultSimulatorImpl::IsFinished() const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext()
 {
-    if (m_eventsWithContextEmpty)
+    // A relaxed load is enough to skip the exchange on the hot path: an
+    // event pushed concurrently is drained before the next event.
+    if (m_eventsWithContext.load(std::memory_order_relaxed) == nullptr)
     {
         return;
     }
 
-    // swap queues
-    EventsWithContext eventsWithContext;
+    // Detach all the pending events at once, newest first
+    EventWithContext* head = m_eventsWithContext.exchange(nullptr, std::memory_order_acquire);
+    EventWithContext* oldest = nullptr;
+    while (head != nullptr)
     {
-        std::unique_lock lock{m_eventsWithContextMutex};
-        m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
+        EventWithContext* next = head->next;
+        head->next = oldest;
+        oldest = head;
+        head = next;
     }
-    while (!eventsWithContext.empty())
+    while (oldest != nullptr)
     {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
+        EventWithContext* event = oldest;
+        oldest = oldest->next;
         Scheduler::Event ev;
-        ev.impl = event.event;
-        ev.key.m_ts = m_currentTs + event.timestamp;
-        ev.key.m_context = event.context;
+        ev.impl = event->event;
+        ev.key.m_ts = m_currentTs + event->timestamp;
+        ev.key.m_context = event->context;
         ev.key.m_uid = m_uid;
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
+        delete event;
     }
 }
 
@@ -259,15 +265,17 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
     }
     else
     {
-        EventWithContext ev;
-        ev.context = context;
+        auto ev = new EventWithContext;
+        ev->context = context;
         // Current time added in ProcessEventsWithContext()
-        ev.timestamp = delay.GetTimeStep();
-        ev.event = event;
+        ev->timestamp = delay.GetTimeStep();
+        ev->event = event;
+        ev->next = m_eventsWithContext.load(std::memory_order_relaxed);
+        while (!m_eventsWithContext.compare_exchange_weak(ev->next,
+                                                          ev,
+                                                          std::memory_order_release,
+                                                          std::memory_order_relaxed))
         {
-            std::unique_lock lock{m_eventsWithContextMutex};
-            m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
         }
     }
 }
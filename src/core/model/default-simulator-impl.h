@@ -22,8 +22,8 @@
 
 #include "simulator-impl.h"
 
+#include <atomic>
 #include <list>
-#include <mutex>
 #include <thread>
 
 /**
@@ -86,7 +86,15 @@ class DefaultSimulatorImpl : public SimulatorImpl
     /** Move events from a different context into the main event queue. */
     void ProcessEventsWithContext();
 
-    /** Wrap an event with its execution context. */
+    /**
+     * Wrap an event with its execution context.
+     *
+     * The events scheduled from other threads are linked in a lock-free
+     * multiple producer, single consumer stack: the producers push with a
+     * compare-and-swap on the head, and the simulator thread detaches the
+     * whole stack with a single exchange, then reverses it to restore the
+     * order of insertion.
+     */
     struct EventWithContext
     {
         /** The event context. */
@@ -95,19 +103,15 @@ class DefaultSimulatorImpl : public SimulatorImpl
         uint64_t timestamp;
         /** The event implementation. */
         EventImpl* event;
+        /** The next event with context, pushed before this one. */
+        EventWithContext* next;
     };
 
-    /** Container type for the events from a different context. */
-    typedef std::list<EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * The last event pushed by another thread, or \c nullptr if all events
+     * with context have been moved to the primary event queue.
      */
-    bool m_eventsWithContextEmpty;
-    /** Mutex to control access to the list of events with context. */
-    std::mutex m_eventsWithContextMutex;
+    std::atomic<EventWithContext*> m_eventsWithContext;
 
     /** Container type for the events to run at Simulator::Destroy() */
     typedef std::list<EventId> DestroyEvents;
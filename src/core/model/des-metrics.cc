@@ -28,6 +28,7 @@
 #include "simulator.h"
 #include "system-path.h"
 
+#include <algorithm>
 #include <ctime> // time_t, time()
 #include <sstream>
 #include <string>
@@ -35,6 +36,39 @@
 namespace ns3
 {
 
+/**
+ * \ingroup simulator
+ *
+ * The records buffered by a thread, registered with the DesMetrics
+ * singleton so that Close() writes the records of all the threads.
+ */
+class DesMetrics::Buffer
+{
+  public:
+    /** Constructor, registers the buffer. */
+    Buffer()
+    {
+        m_records.reserve(BUFFER_RECORDS);
+        DesMetrics* metrics = DesMetrics::Get();
+        std::unique_lock lock{metrics->m_mutex};
+        metrics->m_buffers.push_back(this);
+    }
+
+    /** Destructor, writes the remaining records at the exit of the thread. */
+    ~Buffer()
+    {
+        DesMetrics* metrics = DesMetrics::Get();
+        std::unique_lock lock{metrics->m_mutex};
+        metrics->Write(m_records);
+        auto& buffers = metrics->m_buffers;
+        buffers.erase(std::find(buffers.begin(), buffers.end(), this));
+    }
+
+    std::vector<Record> m_records; //!< The records not written yet.
+};
+
+static_assert(sizeof(DesMetrics::Record) == 32, "DesMetrics::Record must not be padded");
+
 /* static */
 std::string DesMetrics::m_outputDir; // = "";
 
@@ -55,14 +89,14 @@ DesMetrics::Initialize(std::vector<std::string> args, std::string outDir /* = ""
         std::string arg0 = args[0];
         model_name = SystemPath::Split(arg0).back();
     }
-    std::string jsonFile = model_name + ".json";
+    std::string traceFile = model_name + ".desm";
     if (!outDir.empty())
     {
         DesMetrics::m_outputDir = outDir;
     }
     if (!DesMetrics::m_outputDir.empty())
     {
-        jsonFile = SystemPath::Append(DesMetrics::m_outputDir, jsonFile);
+        traceFile = SystemPath::Append(DesMetrics::m_outputDir, traceFile);
     }
 
     time_t current_time;
@@ -70,31 +104,39 @@ DesMetrics::Initialize(std::vector<std::string> args, std::string outDir /* = ""
     const char* date = ctime(&current_time);
     std::string capture_date(date, 24); // discard trailing newline from ctime
 
-    m_os.open(jsonFile);
-    m_os << "{" << std::endl;
-    m_os << " \"simulator_name\" : \"ns-3\"," << std::endl;
-    m_os << " \"model_name\" : \"" << model_name << "\"," << std::endl;
-    m_os << " \"capture_date\" : \"" << capture_date << "\"," << std::endl;
-    m_os << " \"command_line_arguments\" : \"";
-    if (args.empty())
+    std::ostringstream header;
+    header << "{" << std::endl;
+    header << " \"simulator_name\" : \"ns-3\"," << std::endl;
+    header << " \"model_name\" : \"" << model_name << "\"," << std::endl;
+    header << " \"capture_date\" : \"" << capture_date << "\"," << std::endl;
+    header << " \"command_line_arguments\" : \"";
+    if (!args.empty())
     {
         for (std::size_t i = 0; i < args.size(); ++i)
         {
             if (i > 0)
             {
-                m_os << " ";
+                header << " ";
             }
-            m_os << args[i];
+            header << args[i];
         }
     }
     else
     {
-        m_os << "[argv empty or not available]";
+        header << "[argv empty or not available]";
     }
-    m_os << "\"," << std::endl;
-    m_os << " \"events\" : [" << std::endl;
-
-    m_separator = ' ';
+    header << "\"," << std::endl;
+    header << " \"events\" : [" << std::endl;
+
+    std::string text = header.str();
+    auto length = static_cast<uint32_t>(text.size());
+    std::unique_lock lock{m_mutex};
+    m_os.open(traceFile, std::ios::binary);
+    m_os.write("ns3desm", 8);
+    m_os.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    m_os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    m_os.write(text.data(), length);
+    m_start = std::chrono::steady_clock::now();
 }
 
 void
@@ -112,26 +154,35 @@ DesMetrics::TraceWithContext(uint32_t context, const Time& now, const Time& dela
         Initialize(args);
     }
 
-    std::ostringstream ss;
-    if (m_separator == ',')
-    {
-        ss << m_separator << std::endl;
-    }
+    static thread_local Buffer buffer;
 
     uint32_t sendCtx = Simulator::GetContext();
     // Force to signed so we can show NoContext as '-1'
-    int32_t send = (sendCtx != Simulator::NO_CONTEXT) ? (int32_t)sendCtx : -1;
-    int32_t recv = (context != Simulator::NO_CONTEXT) ? (int32_t)context : -1;
-
-    ss << "  [\"" << send << "\",\"" << now.GetTimeStep() << "\",\"" << recv << "\",\""
-       << (now + delay).GetTimeStep() << "\"]";
-
+    Record record;
+    record.send = (sendCtx != Simulator::NO_CONTEXT) ? (int32_t)sendCtx : -1;
+    record.recv = (context != Simulator::NO_CONTEXT) ? (int32_t)context : -1;
+    record.sendTime = now.GetTimeStep();
+    record.recvTime = (now + delay).GetTimeStep();
+    record.wallClock = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - m_start)
+                           .count();
+    buffer.m_records.push_back(record);
+
+    if (buffer.m_records.size() == BUFFER_RECORDS)
     {
         std::unique_lock lock{m_mutex};
-        m_os << ss.str();
+        Write(buffer.m_records);
     }
+}
 
-    m_separator = ',';
+void
+DesMetrics::Write(std::vector<Record>& buffer)
+{
+    if (m_os.is_open())
+    {
+        m_os.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Record));
+    }
+    buffer.clear();
 }
 
 DesMetrics::~DesMetrics()
@@ -142,10 +193,11 @@ DesMetrics::~DesMetrics()
 void
 DesMetrics::Close()
 {
-    m_os << std::endl; // Finish the last event line
-
-    m_os << " ]" << std::endl;
-    m_os << "}" << std::endl;
+    std::unique_lock lock{m_mutex};
+    for (auto buffer : m_buffers)
+    {
+        Write(buffer->m_records);
+    }
     m_os.close();
 
     m_initialized = false;
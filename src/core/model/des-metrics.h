@@ -29,6 +29,7 @@
 #include "nstime.h"
 #include "singleton.h"
 
+#include <chrono>
 #include <fstream>
 #include <mutex>
 #include <stdint.h> // uint32_t
@@ -43,7 +44,7 @@ namespace ns3
  *
  * @brief Event trace data collector for the DES Metrics project.
  *
- * This feature generates a JSON file with event trace data,
+ * This feature records the event trace data,
  * including the source and destination context for each
  * event, and the (virtual) times when the event was scheduled and
  * when it will execute.
@@ -52,11 +53,11 @@ namespace ns3
  * for more information and analysis tools.
  *
  * If enabled (see below), ns-3 scripts should use CommandLine to
- * parse arguments, which will open the JSON file with the same name
- * as the script, and write the JSON header.  Failure to use CommandLine when
+ * parse arguments, which will open the trace file with the same name
+ * as the script, and write the trace header.  Failure to use CommandLine when
  * DES Metrics is enabled will put the trace data in the file
- * \c desTraceFile.json instead. All examples accessible from \c test.py
- * use CommandLine, and so generate JSON files.
+ * \c desTraceFile.desm instead. All examples accessible from \c test.py
+ * use CommandLine, and so generate trace files.
  *
  * Output from scripts ends up in the current working directory (normally the
  * top level directory). When \c test.py is used to run tests or examples
@@ -64,7 +65,22 @@ namespace ns3
  * \c testpy-output/,  which \c test.py normally deletes.
  * To keep the output of examples, use the \c --retain argument to \c test.py.
  *
- * The output file has the following form:
+ * Tracing is on the path of every Schedule() call, so the events are not
+ * formatted as they are scheduled: each one is stored as a fixed size
+ * DesMetrics::Record in a buffer of the scheduling thread, without any lock,
+ * and the full buffers are appended to the trace file in a single write.
+ * The trace file starts with the magic string \c "ns3desm", a 32 bit format
+ * version and the length of the header text, followed by the header text
+ * itself, then by the records, in native byte order. The records of the
+ * different threads of a multithreaded simulation are interleaved by
+ * buffer.
+ *
+ * The \c utils/des-metrics-convert.py script converts a trace file to the
+ * JSON format of the DES Metrics tools:
+ * \verbatim
+   $ ./utils/des-metrics-convert.py ipv4-raw.desm > ipv4-raw.json \endverbatim
+ *
+ * which has the following form:
  * \verbatim
 {
  "simulator_name" : "ns-3",
@@ -100,6 +116,10 @@ namespace ns3
  * \li Example traces end up in \c testpy-output/, so move there: <br/>
  *   \code cd testpy-output/$(date +"%F")*_/  \endcode
  *   (Remove the `_', which is to work around a Doxygen limitation.)
+ * \li Convert the traces to JSON: <br/>
+ *   \code for f in *.desm; do des-metrics-convert.py $f > ${f%.desm}.json; done \endcode
+ * \li Fold the traces into send;receive context stacks for \c flamegraph.pl: <br/>
+ *   \code des-metrics-convert.py --folded ipv4-raw.desm | flamegraph.pl > ipv4-raw.svg \endcode
  * \li Remove the traces with less than 10 events: <br/>
  *   \code wc -l *.json | sort -nr | grep "^ *[789] " | cut -d ' ' -f 9 | xargs rm -f \endcode
  * \li Show the largest file, and total number of trace files: <br/>
@@ -109,11 +129,27 @@ namespace ns3
 class DesMetrics : public Singleton<DesMetrics>
 {
   public:
+    /** An event record, as stored in the trace file. */
+    struct Record
+    {
+        int32_t send;      //!< Source context, or -1 for no context
+        int32_t recv;      //!< Destination context, or -1 for no context
+        int64_t sendTime;  //!< Time step when the event was scheduled
+        int64_t recvTime;  //!< Time step when the event will execute
+        int64_t wallClock; //!< Wall clock time since Initialize(), in ns
+    };
+
+    /** Version of the trace file format. */
+    static constexpr uint32_t VERSION = 1;
+
+    /** Number of records buffered by each thread before they are written. */
+    static constexpr std::size_t BUFFER_RECORDS = 16384;
+
     /**
      * Open the DesMetrics trace file and print the header.
      *
      * The trace file will have the same base name as the main program,
-     * '.json' as the extension.
+     * '.desm' as the extension.
      *
      * \param args [in] Command line arguments.
      * \param outDir [in] Directory where the trace file should be written.
@@ -143,9 +179,20 @@ class DesMetrics : public Singleton<DesMetrics>
     ~DesMetrics() override;
 
   private:
+    /** The records buffered by a thread. */
+    class Buffer;
+
     /** Close the output file. */
     void Close();
 
+    /**
+     * Append the records of a buffer to the output file, and clear it.
+     * The caller holds m_mutex.
+     *
+     * \param [in,out] buffer The buffer.
+     */
+    void Write(std::vector<Record>& buffer);
+
     /**
      * Cache the last-used output directory.
      *
@@ -154,11 +201,12 @@ class DesMetrics : public Singleton<DesMetrics>
      */
     static std::string m_outputDir;
 
-    bool m_initialized; //!< Have we been initialized.
-    std::ofstream m_os; //!< The output JSON trace file stream.
-    char m_separator;   //!< The separator between event records.
+    bool m_initialized{false};                     //!< Have we been initialized.
+    std::ofstream m_os;                            //!< The output trace file stream.
+    std::chrono::steady_clock::time_point m_start; //!< Wall clock time of Initialize().
+    std::vector<Buffer*> m_buffers;                //!< The buffers of the live threads.
 
-    /** Mutex to control access to the output file. */
+    /** Mutex to control access to the output file and to the buffer list. */
     std::mutex m_mutex;
 
 }; // class DesMetrics
@@ -21,6 +21,9 @@
 
 #include "log.h"
 
+#include <atomic>
+#include <new>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +35,183 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/** Granularity of the event pool size classes, in bytes. */
+constexpr std::size_t EVENT_POOL_GRANULARITY = 16;
+/** Number of size classes of the event pool. */
+constexpr std::size_t EVENT_POOL_CLASSES = 16;
+/**
+ * Maximum number of blocks cached by a thread for each size class, so that
+ * the events allocated by a thread and released by another one do not
+ * accumulate in the free lists of the latter.
+ */
+constexpr std::size_t EVENT_POOL_MAX_BLOCKS = 4096;
+
+/** Whether the storage of released events is recycled, in all the threads. */
+std::atomic<bool> g_eventPoolEnabled{true};
+
+/**
+ * Whether the event pool of the calling thread has been destroyed: events
+ * may still be released by the destructors of other thread-local or
+ * static objects.
+ */
+thread_local bool t_eventPoolDestroyed = false;
+
+/**
+ * \ingroup events
+ * Per-thread free lists of event storage, one for each size class.
+ *
+ * Released blocks are linked through their first word. Blocks are
+ * always allocated with the rounded size of their class, so that they
+ * can be released to the system allocator or recycled by any thread.
+ */
+struct EventPool
+{
+    /** Release the cached blocks when the thread exits. */
+    ~EventPool()
+    {
+        Release();
+        t_eventPoolDestroyed = true;
+    }
+
+    /** Return all the cached blocks to the system allocator. */
+    void Release()
+    {
+        for (std::size_t i = 0; i < EVENT_POOL_CLASSES; ++i)
+        {
+            while (m_heads[i] != nullptr)
+            {
+                void* next = *static_cast<void**>(m_heads[i]);
+                ::operator delete(m_heads[i]);
+                m_heads[i] = next;
+            }
+            m_counts[i] = 0;
+        }
+        m_cached = false;
+    }
+
+    void* m_heads[EVENT_POOL_CLASSES] = {};       //!< Free list heads, by size class.
+    std::size_t m_counts[EVENT_POOL_CLASSES] = {}; //!< Free list lengths, by size class.
+    bool m_cached{false};                          //!< Whether blocks are cached.
+};
+
+/**
+ * Get the event pool of the calling thread.
+ * \returns The event pool, or nullptr if it has been destroyed.
+ */
+EventPool*
+GetEventPool()
+{
+    if (t_eventPoolDestroyed)
+    {
+        return nullptr;
+    }
+    static thread_local EventPool pool;
+    return &pool;
+}
+
+/**
+ * Get the size class of an event.
+ * \param [in] size The size of the event object.
+ * \returns The size class, or EVENT_POOL_CLASSES if the size is not pooled.
+ */
+inline std::size_t
+GetEventPoolClass(std::size_t size)
+{
+    return (size - 1) / EVENT_POOL_GRANULARITY;
+}
+
+/**
+ * Get the event pool of the calling thread, if the pool is enabled. When
+ * the pool has been disabled, the blocks cached by the calling thread are
+ * released.
+ * \returns The event pool, or nullptr if it is disabled or destroyed.
+ */
+inline EventPool*
+GetEnabledEventPool()
+{
+    EventPool* pool = GetEventPool();
+    if (pool != nullptr && !g_eventPoolEnabled.load(std::memory_order_relaxed))
+    {
+        if (pool->m_cached)
+        {
+            pool->Release();
+        }
+        return nullptr;
+    }
+    return pool;
+}
+
+} // unnamed namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    std::size_t sizeClass = GetEventPoolClass(size);
+    if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+        return ::operator new(size);
+    }
+    EventPool* pool = GetEnabledEventPool();
+    if (pool != nullptr && pool->m_heads[sizeClass] != nullptr)
+    {
+        void* p = pool->m_heads[sizeClass];
+        pool->m_heads[sizeClass] = *static_cast<void**>(p);
+        pool->m_counts[sizeClass]--;
+        return p;
+    }
+    return ::operator new((sizeClass + 1) * EVENT_POOL_GRANULARITY);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    std::size_t sizeClass = GetEventPoolClass(size);
+    if (sizeClass < EVENT_POOL_CLASSES)
+    {
+        EventPool* pool = GetEnabledEventPool();
+        if (pool != nullptr && pool->m_counts[sizeClass] < EVENT_POOL_MAX_BLOCKS)
+        {
+            *static_cast<void**>(p) = pool->m_heads[sizeClass];
+            pool->m_heads[sizeClass] = p;
+            pool->m_counts[sizeClass]++;
+            pool->m_cached = true;
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
+void
+EventImpl::SetPoolEnabled(bool enabled)
+{
+    NS_LOG_FUNCTION(enabled);
+    g_eventPoolEnabled.store(enabled, std::memory_order_relaxed);
+    if (!enabled)
+    {
+        ReleasePool();
+    }
+}
+
+bool
+EventImpl::IsPoolEnabled()
+{
+    return g_eventPoolEnabled.load(std::memory_order_relaxed);
+}
+
+void
+EventImpl::ReleasePool()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    EventPool* pool = GetEventPool();
+    if (pool != nullptr)
+    {
+        pool->Release();
+    }
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -21,6 +21,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -67,6 +68,53 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /**
+     * Allocate the storage of an event.
+     *
+     * Events are allocated at a very high rate by the MakeEvent()
+     * functions, and released when they are executed or cancelled.
+     * Storage of up to 256 bytes is rounded up to a multiple of 16
+     * bytes and recycled through a per-thread free list for each size
+     * class, unless the pool has been disabled with SetPoolEnabled().
+     * Each free list caches at most 4096 blocks: the storage released
+     * beyond, e.g., by a thread which releases the events allocated by
+     * another one, is returned to the system allocator.
+     *
+     * \param [in] size The size of the event object.
+     * \returns The allocated storage.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Release the storage of an event.
+     *
+     * \param [in] p The storage to release.
+     * \param [in] size The size of the event object.
+     */
+    static void operator delete(void* p, std::size_t size);
+
+    /**
+     * Enable or disable the recycling of the event storage.
+     *
+     * This is normally configured through the
+     * ns3::SimulatorImpl::EventPool attribute. The switch is process-wide,
+     * like the simulator: it applies to the events of all the threads.
+     * When the pool is disabled, the storage cached by the calling thread
+     * is released, and the storage cached by each other thread is released
+     * the next time it allocates or releases an event.
+     *
+     * \param [in] enabled Whether the storage of released events is recycled.
+     */
+    static void SetPoolEnabled(bool enabled);
+    /**
+     * \returns Whether the storage of released events is recycled.
+     */
+    static bool IsPoolEnabled();
+    /**
+     * Return the storage cached in the free lists of the calling
+     * thread to the system allocator.
+     */
+    static void ReleasePool();
+
   protected:
     /**
      * Implementation for Invoke().
@@ -0,0 +1,264 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LadderScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<LadderScheduler>();
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topStart(0),
+      m_topMin(0),
+      m_topMax(0),
+      m_nRungs(0)
+{
+    NS_LOG_FUNCTION(this);
+    // Rungs hold references to each other's buckets while spawning.
+    m_rungs.reserve(MAX_RUNGS);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::size_t
+LadderScheduler::FindRung(uint64_t ts) const
+{
+    for (std::size_t i = 0; i < m_nRungs; ++i)
+    {
+        if (ts >= m_rungs[i].GetCurrentStart())
+        {
+            return i;
+        }
+    }
+    return m_nRungs;
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        if (m_top.empty())
+        {
+            m_topMin = ts;
+            m_topMax = ts;
+        }
+        else
+        {
+            m_topMin = std::min(m_topMin, ts);
+            m_topMax = std::max(m_topMax, ts);
+        }
+        m_top.push_back(ev);
+    }
+    else
+    {
+        std::size_t i = FindRung(ts);
+        if (i < m_nRungs)
+        {
+            Rung& rung = m_rungs[i];
+            rung.m_buckets[(ts - rung.m_start) / rung.m_width].push_back(ev);
+            ++rung.m_count;
+        }
+        else
+        {
+            InsertBottom(ev);
+        }
+    }
+    FillBottom();
+}
+
+void
+LadderScheduler::InsertBottom(const Event& ev)
+{
+    if (m_bottom.empty() || m_bottom.back() < ev)
+    {
+        m_bottom.push_back(ev);
+    }
+    else
+    {
+        m_bottom.insert(std::upper_bound(m_bottom.begin(), m_bottom.end(), ev), ev);
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_bottom.empty();
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_bottom.empty());
+    return m_bottom.front();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_bottom.empty());
+    Event ev = m_bottom.front();
+    m_bottom.pop_front();
+    FillBottom();
+    NS_LOG_DEBUG("remove " << ev.impl << " " << ev.key.m_ts << " " << ev.key.m_uid);
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        auto it = std::find(m_top.begin(), m_top.end(), ev);
+        NS_ASSERT(it != m_top.end());
+        *it = m_top.back();
+        m_top.pop_back();
+        return;
+    }
+    std::size_t i = FindRung(ts);
+    if (i < m_nRungs)
+    {
+        Rung& rung = m_rungs[i];
+        Bucket& bucket = rung.m_buckets[(ts - rung.m_start) / rung.m_width];
+        auto it = std::find(bucket.begin(), bucket.end(), ev);
+        NS_ASSERT(it != bucket.end());
+        *it = bucket.back();
+        bucket.pop_back();
+        --rung.m_count;
+        return;
+    }
+    auto it = std::lower_bound(m_bottom.begin(), m_bottom.end(), ev);
+    NS_ASSERT(it != m_bottom.end() && *it == ev);
+    m_bottom.erase(it);
+    FillBottom();
+}
+
+void
+LadderScheduler::SpawnRung(Bucket& events, uint64_t minTs, uint64_t end)
+{
+    NS_LOG_FUNCTION(this << events.size() << minTs << end);
+    NS_ASSERT(minTs < end);
+    NS_ASSERT(m_nRungs < MAX_RUNGS);
+    if (m_rungs.size() == m_nRungs)
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs++];
+    uint64_t span = end - minTs;
+    uint64_t n = events.size();
+    rung.m_start = minTs;
+    rung.m_width = (span + n - 1) / n;
+    rung.m_nBuckets = (span + rung.m_width - 1) / rung.m_width;
+    rung.m_current = 0;
+    rung.m_count = events.size();
+    if (rung.m_buckets.size() < rung.m_nBuckets)
+    {
+        rung.m_buckets.resize(rung.m_nBuckets);
+    }
+    for (const auto& ev : events)
+    {
+        rung.m_buckets[(ev.key.m_ts - minTs) / rung.m_width].push_back(ev);
+    }
+    events.clear();
+}
+
+void
+LadderScheduler::FillBottom()
+{
+    while (m_bottom.empty())
+    {
+        if (m_nRungs == 0)
+        {
+            if (m_top.empty())
+            {
+                // The queue is empty: any event can go to the top.
+                m_topStart = 0;
+                return;
+            }
+            NS_LOG_LOGIC("transfer " << m_top.size() << " events from the top");
+            uint64_t end = m_topMax + 1;
+            SpawnRung(m_top, m_topMin, end);
+            const Rung& rung = m_rungs[0];
+            m_topStart = rung.m_start + rung.m_nBuckets * rung.m_width;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        if (rung.m_count == 0)
+        {
+            --m_nRungs;
+            continue;
+        }
+        while (rung.m_buckets[rung.m_current].empty())
+        {
+            ++rung.m_current;
+        }
+        Bucket& bucket = rung.m_buckets[rung.m_current];
+        uint64_t end = rung.GetCurrentStart() + rung.m_width;
+        ++rung.m_current;
+        rung.m_count -= bucket.size();
+
+        if (bucket.size() > BUCKET_THRESHOLD && m_nRungs < MAX_RUNGS)
+        {
+            auto [minIt, maxIt] = std::minmax_element(bucket.begin(), bucket.end());
+            uint64_t minTs = minIt->key.m_ts;
+            if (minTs != maxIt->key.m_ts)
+            {
+                NS_LOG_LOGIC("spawn rung " << m_nRungs << " for " << bucket.size() << " events");
+                SpawnRung(bucket, minTs, end);
+                continue;
+            }
+        }
+        std::sort(bucket.begin(), bucket.end());
+        m_bottom.assign(bucket.begin(), bucket.end());
+        bucket.clear();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wee Tang, Rick Goh and Ian Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are kept in three tiers:
+ *
+ * - the \em top, an unsorted vector receiving the events beyond the
+ *   time span currently covered by the ladder;
+ * - the \em ladder, a stack of rungs. Each rung is an array of unsorted
+ *   buckets of uniform width; the first rung is built from the content of
+ *   the top, and each further rung splits a single bucket of the rung
+ *   above which held too many events;
+ * - the \em bottom, a short sorted list holding the earliest events,
+ *   from which events are dequeued.
+ *
+ * When the bottom runs empty, the next non-empty bucket of the last rung
+ * is either sorted into the bottom, if it holds at most
+ * \c BUCKET_THRESHOLD events, or spawned into a new rung otherwise.
+ * The bucket width of each rung is derived from the time span and
+ * number of its events when the rung is created, so the queue never
+ * needs the periodic full resize of the CalendarScheduler.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to top or rung bucket; short bottom insertion
+ * IsEmpty()    | Constant        | Bottom is empty only if the queue is empty
+ * PeekNext()   | Constant        | Head of the bottom
+ * Remove()     | Linear          | Search within the top or bucket holding the event
+ * RemoveNext() | ~Constant       | Sorting of a bucket of bounded size into the bottom
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | Rung buckets                     | `std::vector` per bucket, reused
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ *
+ * \note Simulator::Remove() is linear in the size of the top when the
+ * event is far in the future. Events are usually cancelled with
+ * Simulator::Cancel(), which does not reach the scheduler.
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Maximum number of events sorted into the bottom at once. */
+    static constexpr std::size_t BUCKET_THRESHOLD = 50;
+    /** Maximum number of rungs of the ladder. */
+    static constexpr std::size_t MAX_RUNGS = 8;
+
+    /** Events in a bucket, in no particular order. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        uint64_t m_start;              //!< Timestamp of the start of the first bucket
+        uint64_t m_width;              //!< Width of each bucket
+        std::size_t m_nBuckets;        //!< Number of buckets in use
+        std::size_t m_current;         //!< Index of the first bucket not yet dequeued
+        std::size_t m_count;           //!< Number of events in the rung
+        std::vector<Bucket> m_buckets; //!< The buckets, possibly more than m_nBuckets
+
+        /**
+         * \returns The timestamp of the start of the current bucket.
+         */
+        uint64_t GetCurrentStart() const
+        {
+            return m_start + m_current * m_width;
+        }
+    };
+
+    /**
+     * Find the rung an event with the given timestamp belongs to.
+     * \param [in] ts The timestamp of the event.
+     * \returns The index of the rung, or m_nRungs if the event belongs to
+     *          the bottom.
+     */
+    std::size_t FindRung(uint64_t ts) const;
+
+    /**
+     * Add a new rung to the ladder and distribute events into it.
+     *
+     * \param [in] events The events to distribute.
+     * \param [in] minTs The smallest timestamp of the events.
+     * \param [in] end The end of the time span covered by the new rung.
+     */
+    void SpawnRung(Bucket& events, uint64_t minTs, uint64_t end);
+
+    /**
+     * Refill the bottom from the ladder and the top, if the bottom is
+     * empty and the queue is not.
+     */
+    void FillBottom();
+
+    /**
+     * Insert an event in the sorted bottom.
+     * \param [in] ev The event to insert.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+
+    Bucket m_top;                          //!< Unsorted events beyond the span of the ladder
+    uint64_t m_topStart;                   //!< Events at or after this timestamp go to the top
+    uint64_t m_topMin;                     //!< Lower bound of the timestamps in the top
+    uint64_t m_topMax;                     //!< Upper bound of the timestamps in the top
+    std::vector<Rung> m_rungs;             //!< The rungs, possibly more than m_nRungs
+    std::size_t m_nRungs;                  //!< Number of rungs in use
+    std::deque<Scheduler::Event> m_bottom; //!< Earliest events, sorted
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -243,19 +243,6 @@ LogComponent::EnvVarCheck()
     Enable((LogLevel)level);
 }
 
-bool
-LogComponent::IsEnabled(const LogLevel level) const
-{
-    //  LogComponentEnableEnvVar ();
-    return level & m_levels;
-}
-
-bool
-LogComponent::IsNoneEnabled() const
-{
-    return m_levels == 0;
-}
-
 void
 LogComponent::SetMask(const LogLevel level)
 {
@@ -265,16 +252,16 @@ LogComponent::SetMask(const LogLevel level)
 void
 LogComponent::Enable(const LogLevel level)
 {
-    m_levels |= (level & ~m_mask);
+    m_levels.fetch_or(level & ~m_mask, std::memory_order_relaxed);
 }
 
 void
 LogComponent::Disable(const LogLevel level)
 {
-    m_levels &= ~level;
+    m_levels.fetch_and(~level, std::memory_order_relaxed);
 }
 
-std::string
+const std::string&
 LogComponent::Name() const
 {
     return m_name;
@@ -25,6 +25,7 @@
 #include "node-printer.h"
 #include "time-printer.h"
 
+#include <atomic>
 #include <iostream>
 #include <stdint.h>
 #include <string>
@@ -340,16 +341,21 @@ class LogComponent
     /**
      * Check if this LogComponent is enabled for \c level
      *
+     * This is inlined in every logging statement, and only loads the
+     * enabled levels, so that the statements of the disabled components
+     * cost a load and a branch, even in optimized builds configured
+     * with NS3_LOG.
+     *
      * \param [in] level The level to check for.
      * \return \c true if we are enabled at \c level.
      */
-    bool IsEnabled(const LogLevel level) const;
+    inline bool IsEnabled(const LogLevel level) const;
     /**
      * Check if all levels are disabled.
      *
      * \return \c true if all levels are disabled.
      */
-    bool IsNoneEnabled() const;
+    inline bool IsNoneEnabled() const;
     /**
      * Enable this LogComponent at \c level
      *
@@ -367,7 +373,7 @@ class LogComponent
      *
      * \return The name of this LogComponent.
      */
-    std::string Name() const;
+    const std::string& Name() const;
     /**
      * Get the compilation unit defining this LogComponent.
      * \returns The file name.
@@ -416,13 +422,31 @@ class LogComponent
      */
     void EnvVarCheck();
 
-    int32_t m_levels;   //!< Enabled LogLevels.
+    /**
+     * Enabled LogLevels.
+     *
+     * The levels may be changed by the main thread while the threads of
+     * a multithreaded simulation log, hence the relaxed atomic.
+     */
+    std::atomic<int32_t> m_levels;
     int32_t m_mask;     //!< Blocked LogLevels.
     std::string m_name; //!< LogComponent name.
     std::string m_file; //!< File defining this LogComponent.
 
 }; // class LogComponent
 
+bool
+LogComponent::IsEnabled(const LogLevel level) const
+{
+    return level & m_levels.load(std::memory_order_relaxed);
+}
+
+bool
+LogComponent::IsNoneEnabled() const
+{
+    return m_levels.load(std::memory_order_relaxed) == 0;
+}
+
 /**
  * Get the LogComponent registered with the given name.
  *
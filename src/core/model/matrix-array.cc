@@ -31,6 +31,36 @@ template <class T>
 using EigenMatrix = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>;
 template <class T>
 using ConstEigenMatrix = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>;
+#else
+/**
+ * \brief Multiply-accumulate acc += a * b.
+ * \param [in,out] acc the accumulator
+ * \param [in] a the first factor
+ * \param [in] b the second factor
+ */
+template <class T>
+inline void
+MultiplyAdd(T& acc, const T& a, const T& b)
+{
+    acc += a * b;
+}
+
+/**
+ * \brief Multiply-accumulate acc += a * b for complex values, skipping the
+ * recovery of infinite results performed by the complex multiplication
+ * operator, which prevents the compiler from inlining it.
+ * \param [in,out] acc the accumulator
+ * \param [in] a the first factor
+ * \param [in] b the second factor
+ */
+inline void
+MultiplyAdd(std::complex<double>& acc,
+            const std::complex<double>& a,
+            const std::complex<double>& b)
+{
+    acc = {acc.real() + a.real() * b.real() - a.imag() * b.imag(),
+           acc.imag() + a.real() * b.imag() + a.imag() * b.real()};
+}
 #endif
 
 template <class T>
@@ -170,6 +200,52 @@ MatrixArray<T>::MultiplyByLeftAndRightMatrix(const MatrixArray<T>& lMatrix,
 
     MatrixArray<T> res{lMatrix.m_numRows, rMatrix.m_numCols, m_numPages};
 
+    if (lMatrix.m_numRows == 1 && rMatrix.m_numCols == 1 && m_numPages > 0)
+    {
+        // Row vector * matrices * column vector: since the pages are stored
+        // contiguously in column-major order, this MatrixArray can be seen as a
+        // single M x (N * P) matrix, hence the whole operation reduces to two
+        // matrix-vector products, instead of two products per page.
+        std::vector<T> lProd(m_numCols * m_numPages);
+#ifdef HAVE_EIGEN3 // Eigen found and Eigen optimizations enabled
+        Eigen::Map<const Eigen::Matrix<T, 1, Eigen::Dynamic>> lVector(lMatrix.GetPagePtr(0),
+                                                                      m_numRows);
+        Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>> rVector(rMatrix.GetPagePtr(0),
+                                                                      m_numCols);
+        ConstEigenMatrix<T> allPages(GetPagePtr(0), m_numRows, m_numCols * m_numPages);
+        Eigen::Map<Eigen::Matrix<T, 1, Eigen::Dynamic>> lProdEigen(lProd.data(), lProd.size());
+        lProdEigen.noalias() = lVector * allPages;
+        Eigen::Map<Eigen::Matrix<T, 1, Eigen::Dynamic>> resEigen(res.GetPagePtr(0), m_numPages);
+        ConstEigenMatrix<T> lProdMatrix(lProd.data(), m_numCols, m_numPages);
+        resEigen.noalias() = rVector.transpose() * lProdMatrix;
+#else // Eigen not found or Eigen optimizations not enabled
+        const T* lVector = lMatrix.GetPagePtr(0);
+        const T* rVector = rMatrix.GetPagePtr(0);
+        const T* column = GetPagePtr(0);
+        for (size_t col = 0; col < lProd.size(); ++col, column += m_numRows)
+        {
+            T sum{};
+            for (size_t row = 0; row < m_numRows; ++row)
+            {
+                MultiplyAdd(sum, lVector[row], column[row]);
+            }
+            lProd[col] = sum;
+        }
+        T* resValues = res.GetPagePtr(0);
+        for (size_t page = 0; page < m_numPages; ++page)
+        {
+            T sum{};
+            const T* lProdPage = lProd.data() + page * m_numCols;
+            for (size_t col = 0; col < m_numCols; ++col)
+            {
+                MultiplyAdd(sum, lProdPage[col], rVector[col]);
+            }
+            resValues[page] = sum;
+        }
+#endif
+        return res;
+    }
+
 #ifdef HAVE_EIGEN3
 
     ConstEigenMatrix<T> lMatrixEigen(lMatrix.GetPagePtr(0), lMatrix.m_numRows, lMatrix.m_numCols);
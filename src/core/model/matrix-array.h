@@ -223,6 +223,10 @@ class MatrixArray : public ValArray<T>
      * This operation is not possible when using the multiplication operator because
      * the number of pages does not match.
      *
+     * When lMatrix is a row vector and rMatrix is a column vector (e.g., when
+     * computing the beamforming gain per cluster), all the pages are processed
+     * together as two matrix-vector products.
+     *
      * \param lMatrix the left matrix in the multiplication
      * \param rMatrix the right matrix in the multiplication
      * \returns Returns the result of the multiplication which is a 3D MatrixArray
@@ -27,6 +27,9 @@
 
 #include "ns3/core-config.h"
 
+#include <atomic>
+#include <mutex>
+
 /**
  * \file
  * \ingroup object
@@ -62,6 +65,48 @@ GetObjectIid()
     return tid;
 }
 
+/**
+ * Get the mutex protecting the attribute information of the TypeIds.
+ *
+ * The accessors, checkers and initial values of the attributes are
+ * reference counted and shared by all the instances of a type, which
+ * may be constructed concurrently by the threads of a parallel simulator.
+ *
+ * \relates ns3::ObjectBase
+ *
+ * \return The mutex.
+ */
+static std::recursive_mutex&
+GetAttributeMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+/**
+ * \relates ns3::ObjectBase
+ * Whether the attribute information may be accessed concurrently.
+ */
+static std::atomic<bool> g_concurrentAttributeAccess(false);
+
+/**
+ * Lock the attribute information of the TypeIds, if they may be
+ * accessed concurrently.
+ *
+ * \relates ns3::ObjectBase
+ *
+ * \return The lock, which does not own the mutex in a sequential simulation.
+ */
+static std::unique_lock<std::recursive_mutex>
+LockAttributes()
+{
+    if (!g_concurrentAttributeAccess.load(std::memory_order_relaxed))
+    {
+        return std::unique_lock<std::recursive_mutex>();
+    }
+    return std::unique_lock<std::recursive_mutex>(GetAttributeMutex());
+}
+
 TypeId
 ObjectBase::GetTypeId()
 {
@@ -75,6 +120,13 @@ ObjectBase::~ObjectBase()
     NS_LOG_FUNCTION(this);
 }
 
+void
+ObjectBase::SetConcurrentAttributeAccess(bool enable)
+{
+    NS_LOG_FUNCTION(enable);
+    g_concurrentAttributeAccess.store(enable, std::memory_order_relaxed);
+}
+
 void
 ObjectBase::NotifyConstructionCompleted()
 {
@@ -86,102 +138,100 @@ ObjectBase::ConstructSelf(const AttributeConstructionList& attributes)
 {
     // loop over the inheritance tree back to the Object base class.
     NS_LOG_FUNCTION(this << &attributes);
-    TypeId tid = GetInstanceTypeId();
-    do // Do this tid and all parents
+    auto lock = LockAttributes();
+    // Only look the attributes up in the environment if it sets any
+    bool useEnvironment = EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT").first;
+    // loop over all attributes in object type and its parents
+    for (const auto& attribute : GetInstanceTypeId().GetInheritedAttributes())
     {
-        // loop over all attributes in object type
-        NS_LOG_DEBUG("construct tid=" << tid.GetName() << ", params=" << tid.GetAttributeN());
-        for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
-        {
-            TypeId::AttributeInformation info = tid.GetAttribute(i);
-            NS_LOG_DEBUG("try to construct \"" << tid.GetName() << "::" << info.name << "\"");
-            // is this attribute stored in this AttributeConstructionList instance ?
-            Ptr<const AttributeValue> value = attributes.Find(info.checker);
-            std::string where = "argument";
-
-            // See if this attribute should not be set here in the
-            // constructor.
-            if (!(info.flags & TypeId::ATTR_CONSTRUCT))
-            {
-                // Handle this attribute if it should not be
-                // set here.
-                if (!value)
-                {
-                    // Skip this attribute if it's not in the
-                    // AttributeConstructionList.
-                    NS_LOG_DEBUG("skipping, not settable at construction");
-                    continue;
-                }
-                else
-                {
-                    // This is an error because this attribute is not
-                    // settable in its constructor but is present in
-                    // the AttributeConstructionList.
-                    NS_FATAL_ERROR("Attribute name="
-                                   << info.name << " tid=" << tid.GetName()
-                                   << ": initial value cannot be set using attributes");
-                }
-            }
+        TypeId tid = attribute.tid;
+        const TypeId::AttributeInformation& info = *attribute.info;
+        NS_LOG_DEBUG("try to construct \"" << tid.GetName() << "::" << info.name << "\"");
+        // is this attribute stored in this AttributeConstructionList instance ?
+        Ptr<const AttributeValue> value = attributes.Find(info.checker);
+        const char* where = "argument";
 
+        // See if this attribute should not be set here in the
+        // constructor.
+        if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+        {
+            // Handle this attribute if it should not be
+            // set here.
             if (!value)
             {
-                NS_LOG_DEBUG("trying to set from environment variable NS_ATTRIBUTE_DEFAULT");
-                auto [found, val] =
-                    EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT", tid.GetAttributeFullName(i));
-                if (found)
-                {
-                    NS_LOG_DEBUG("found in environment: " << val);
-                    value = Create<StringValue>(val);
-                    where = "env var";
-                }
+                // Skip this attribute if it's not in the
+                // AttributeConstructionList.
+                NS_LOG_DEBUG("skipping, not settable at construction");
+                continue;
             }
-
-            bool initial{false};
-            if (!value)
+            else
             {
-                // This is guaranteed to exist
-                NS_LOG_DEBUG("falling back to initial value from tid");
-                value = info.initialValue;
-                where = "initial value";
-                initial = true;
+                // This is an error because this attribute is not
+                // settable in its constructor but is present in
+                // the AttributeConstructionList.
+                NS_FATAL_ERROR("Attribute name="
+                               << info.name << " tid=" << tid.GetName()
+                               << ": initial value cannot be set using attributes");
             }
+        }
 
-            // We have a matching attribute value, if only from the initialValue
-            if (DoSet(info.accessor, info.checker, *value) || initial)
-            {
-                // Setting from initial value may fail, e.g. setting
-                // ObjectVectorValue from ""
-                // That's ok, so we still report success since construction is complete
-                NS_LOG_DEBUG("construct \"" << tid.GetName() << "::" << info.name << "\" from "
-                                            << where);
-            }
-            else
+        if (!value && useEnvironment)
+        {
+            NS_LOG_DEBUG("trying to set from environment variable NS_ATTRIBUTE_DEFAULT");
+            auto [found, val] = EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT",
+                                                         tid.GetName() + "::" + info.name);
+            if (found)
             {
-                /*
-                  One would think this is an error...
-
-                  but there are cases where `attributes.Find(info.checker)`
-                  returns a non-null value which still fails the `DoSet()` call.
-                  For example, `value` is sometimes a real `PointerValue`
-                  containing 0 as the pointed-to address.  Since value
-                  is not null (it just contains null) the initial
-                  value is not used, the DoSet fails, and we end up
-                  here.
-
-                  If we were adventurous we might try to fix this deep
-                  below DoSet, but there be dragons.
-                */
-                /*
-                NS_ASSERT_MSG(false,
-                              "Failed to set attribute '" << info.name << "' from '"
-                                                          << value->SerializeToString(info.checker)
-                                                          << "'");
-                */
+                NS_LOG_DEBUG("found in environment: " << val);
+                value = Create<StringValue>(val);
+                where = "env var";
             }
+        }
+
+        bool initial{false};
+        if (!value)
+        {
+            // This is guaranteed to exist
+            NS_LOG_DEBUG("falling back to initial value from tid");
+            value = info.initialValue;
+            where = "initial value";
+            initial = true;
+        }
+
+        // We have a matching attribute value, if only from the initialValue
+        if (DoSet(info.accessor, info.checker, *value) || initial)
+        {
+            // Setting from initial value may fail, e.g. setting
+            // ObjectVectorValue from ""
+            // That's ok, so we still report success since construction is complete
+            NS_LOG_DEBUG("construct \"" << tid.GetName() << "::" << info.name << "\" from "
+                                        << where);
+        }
+        else
+        {
+            /*
+              One would think this is an error...
+
+              but there are cases where `attributes.Find(info.checker)`
+              returns a non-null value which still fails the `DoSet()` call.
+              For example, `value` is sometimes a real `PointerValue`
+              containing 0 as the pointed-to address.  Since value
+              is not null (it just contains null) the initial
+              value is not used, the DoSet fails, and we end up
+              here.
+
+              If we were adventurous we might try to fix this deep
+              below DoSet, but there be dragons.
+            */
+            /*
+            NS_ASSERT_MSG(false,
+                          "Failed to set attribute '" << info.name << "' from '"
+                                                      << value->SerializeToString(info.checker)
+                                                      << "'");
+            */
+        }
 
-        } // for i attributes
-        tid = tid.GetParent();
-    } while (tid != ObjectBase::GetTypeId());
+    } // for attributes
     NotifyConstructionCompleted();
 }
 
@@ -204,6 +254,7 @@ void
 ObjectBase::SetAttribute(std::string name, const AttributeValue& value)
 {
     NS_LOG_FUNCTION(this << name << &value);
+    auto lock = LockAttributes();
     TypeId::AttributeInformation info;
     TypeId tid = GetInstanceTypeId();
     if (!tid.LookupAttributeByName(name, &info))
@@ -227,6 +278,7 @@ bool
 ObjectBase::SetAttributeFailSafe(std::string name, const AttributeValue& value)
 {
     NS_LOG_FUNCTION(this << name << &value);
+    auto lock = LockAttributes();
     TypeId::AttributeInformation info;
     TypeId tid = GetInstanceTypeId();
     if (!tid.LookupAttributeByName(name, &info))
@@ -244,6 +296,7 @@ void
 ObjectBase::GetAttribute(std::string name, AttributeValue& value) const
 {
     NS_LOG_FUNCTION(this << name << &value);
+    auto lock = LockAttributes();
     TypeId::AttributeInformation info;
     TypeId tid = GetInstanceTypeId();
     if (!tid.LookupAttributeByName(name, &info))
@@ -281,6 +334,7 @@ bool
 ObjectBase::GetAttributeFailSafe(std::string name, AttributeValue& value) const
 {
     NS_LOG_FUNCTION(this << name << &value);
+    auto lock = LockAttributes();
     TypeId::AttributeInformation info;
     TypeId tid = GetInstanceTypeId();
     if (!tid.LookupAttributeByName(name, &info))
@@ -195,6 +195,19 @@ class ObjectBase
      */
     virtual TypeId GetInstanceTypeId() const = 0;
 
+    /**
+     * Enable the locking of the attribute information of the TypeIds.
+     *
+     * The simulator implementations executing events in parallel threads
+     * must enable it before starting the threads, so that objects may be
+     * constructed and their attributes accessed concurrently. It is
+     * disabled by default, so that sequential simulations do not pay
+     * for the locking.
+     *
+     * \param [in] enable Whether the attributes may be accessed concurrently.
+     */
+    static void SetConcurrentAttributeAccess(bool enable);
+
     /**
      *
      * Set a single attribute, raising fatal errors if unsuccessful.
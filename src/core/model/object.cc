@@ -26,8 +26,11 @@
 #include "object-factory.h"
 #include "string.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
@@ -48,6 +51,71 @@ NS_LOG_COMPONENT_DEFINE("Object");
 
 NS_OBJECT_ENSURE_REGISTERED(Object);
 
+namespace
+{
+
+/**
+ * \ingroup object
+ * The aggregate lookup counters of a thread.
+ *
+ * The counters are only incremented by their own thread, so that the
+ * lookups of the threads of a MultithreadedSimulatorImpl do not contend
+ * on them. The live counters are registered in GetLookupRegistry(), and
+ * the counts of an exiting thread are added to the retired counts.
+ */
+struct LookupCounters
+{
+    LookupCounters();
+    ~LookupCounters();
+
+    std::atomic<uint64_t> hits{0};   //!< Lookups served by the cache
+    std::atomic<uint64_t> misses{0}; //!< Lookups searching the aggregates
+};
+
+/**
+ * \ingroup object
+ * The registry of the lookup counters of all the threads.
+ */
+struct LookupRegistry
+{
+    std::mutex mutex;                  //!< Protects the registry
+    std::vector<LookupCounters*> live; //!< The counters of the running threads
+    Object::LookupStatistics retired;  //!< The counts of the exited threads
+};
+
+/**
+ * \ingroup object
+ * Get the registry of the lookup counters.
+ * \returns The registry.
+ */
+LookupRegistry&
+GetLookupRegistry()
+{
+    static LookupRegistry registry;
+    return registry;
+}
+
+LookupCounters::LookupCounters()
+{
+    LookupRegistry& registry = GetLookupRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.live.push_back(this);
+}
+
+LookupCounters::~LookupCounters()
+{
+    LookupRegistry& registry = GetLookupRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired.hits += hits.load(std::memory_order_relaxed);
+    registry.retired.misses += misses.load(std::memory_order_relaxed);
+    registry.live.erase(std::find(registry.live.begin(), registry.live.end(), this));
+}
+
+/** The aggregate lookup counters of this thread. */
+thread_local LookupCounters g_lookupCounters;
+
+} // unnamed namespace
+
 Object::AggregateIterator::AggregateIterator()
     : m_object(nullptr),
       m_current(0)
@@ -101,6 +169,7 @@ Object::Object()
 {
     NS_LOG_FUNCTION(this);
     m_aggregates->n = 1;
+    m_aggregates->cache = nullptr;
     m_aggregates->buffer[0] = this;
 }
 
@@ -120,6 +189,8 @@ Object::~Object()
             m_aggregates->n--;
         }
     }
+    // the cache may refer to this object
+    ClearLookupCache(m_aggregates);
     // finally, if all objects have been removed from the list,
     // delete the aggregate list
     if (m_aggregates->n == 0)
@@ -137,6 +208,7 @@ Object::Object(const Object& o)
       m_getObjectCount(0)
 {
     m_aggregates->n = 1;
+    m_aggregates->cache = nullptr;
     m_aggregates->buffer[0] = this;
 }
 
@@ -153,6 +225,23 @@ Object::DoGetObject(TypeId tid) const
     NS_LOG_FUNCTION(this << tid);
     NS_ASSERT(CheckLoose());
 
+    LookupEntry* cache = m_aggregates->cache;
+    uint16_t uid = tid.GetUid();
+    if (cache != nullptr && cache[uid % LOOKUP_CACHE_SIZE].uid == uid)
+    {
+        g_lookupCounters.hits.fetch_add(1, std::memory_order_relaxed);
+        return cache[uid % LOOKUP_CACHE_SIZE].object;
+    }
+    g_lookupCounters.misses.fetch_add(1, std::memory_order_relaxed);
+    if (cache == nullptr)
+    {
+        cache = new LookupEntry[LOOKUP_CACHE_SIZE]();
+        m_aggregates->cache = cache;
+    }
+    LookupEntry& entry = cache[uid % LOOKUP_CACHE_SIZE];
+    entry.uid = uid;
+    entry.object = nullptr;
+
     uint32_t n = m_aggregates->n;
     TypeId objectTid = Object::GetTypeId();
     for (uint32_t i = 0; i < n; i++)
@@ -175,7 +264,8 @@ Object::DoGetObject(TypeId tid) const
             current->m_getObjectCount++;
             // then, update the sort
             UpdateSortedArray(m_aggregates, i);
-            // finally, return the match
+            // finally, record and return the match
+            entry.object = current;
             return const_cast<Object*>(current);
         }
     }
@@ -241,6 +331,40 @@ restart:
     }
 }
 
+void
+Object::ClearLookupCache(Aggregates* aggregates)
+{
+    delete[] aggregates->cache;
+    aggregates->cache = nullptr;
+}
+
+Object::LookupStatistics
+Object::GetLookupStatistics()
+{
+    LookupRegistry& registry = GetLookupRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    LookupStatistics statistics = registry.retired;
+    for (const auto counters : registry.live)
+    {
+        statistics.hits += counters->hits.load(std::memory_order_relaxed);
+        statistics.misses += counters->misses.load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
+void
+Object::ResetLookupStatistics()
+{
+    LookupRegistry& registry = GetLookupRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired = LookupStatistics();
+    for (const auto counters : registry.live)
+    {
+        counters->hits.store(0, std::memory_order_relaxed);
+        counters->misses.store(0, std::memory_order_relaxed);
+    }
+}
+
 void
 Object::UpdateSortedArray(Aggregates* aggregates, uint32_t j) const
 {
@@ -269,6 +393,7 @@ Object::AggregateObject(Ptr<Object> o)
     uint32_t total = m_aggregates->n + other->m_aggregates->n;
     auto aggregates = (Aggregates*)std::malloc(sizeof(Aggregates) + (total - 1) * sizeof(Object*));
     aggregates->n = total;
+    aggregates->cache = nullptr;
 
     // copy our buffer to the new buffer
     std::memcpy(&aggregates->buffer[0],
@@ -319,6 +444,8 @@ Object::AggregateObject(Ptr<Object> o)
     }
 
     // Now that we are done with them, we can free our old aggregate buffers
+    ClearLookupCache(a);
+    ClearLookupCache(b);
     std::free(a);
     std::free(b);
 }
@@ -346,6 +473,7 @@ Object::SetTypeId(TypeId tid)
     NS_LOG_FUNCTION(this << tid);
     NS_ASSERT(Check());
     m_tid = tid;
+    ClearLookupCache(m_aggregates);
 }
 
 void
@@ -231,6 +231,29 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      */
     bool IsInitialized() const;
 
+    /**
+     * The statistics of the aggregate lookups.
+     *
+     * A lookup is counted when GetObject() does not find the requested
+     * Object at the head of the aggregates, and is a hit when it is
+     * served by the lookup cache of the aggregates.
+     */
+    struct LookupStatistics
+    {
+        uint64_t hits{0};   //!< Number of lookups served by the cache
+        uint64_t misses{0}; //!< Number of lookups searching the aggregates
+    };
+
+    /**
+     * Get the statistics of the aggregate lookups of all the threads.
+     *
+     * \returns The numbers of hits and misses since the start of the
+     *          program or the last call to ResetLookupStatistics().
+     */
+    static LookupStatistics GetLookupStatistics();
+    /** Reset the statistics of the aggregate lookups. */
+    static void ResetLookupStatistics();
+
   protected:
     /**
      * Notify all Objects aggregated to this one of a new Object being
@@ -331,6 +354,22 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
 
     /**@}*/
 
+    /**
+     * An entry of the lookup cache of the aggregates.
+     *
+     * The cache is direct mapped, indexed by the TypeId uid of the lookup,
+     * and records the Object found, or \c nullptr when the aggregates have
+     * none of that type. It is freed whenever the aggregates change.
+     */
+    struct LookupEntry
+    {
+        uint16_t uid;   //!< TypeId uid of the lookup, 0 for an empty entry
+        Object* object; //!< Result of the lookup
+    };
+
+    /** Number of entries of the lookup cache. */
+    static constexpr uint32_t LOOKUP_CACHE_SIZE = 16;
+
     /**
      * The list of Objects aggregated to this one.
      *
@@ -347,13 +386,28 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
     {
         /** The number of entries in \c buffer. */
         uint32_t n;
+        /**
+         * The lookup cache, allocated by the first lookup which misses it,
+         * or \c nullptr.
+         */
+        LookupEntry* cache;
         /** The array of Objects. */
         Object* buffer[1];
     };
 
+    /**
+     * Free the lookup cache of aggregates.
+     *
+     * \param [in,out] aggregates The list of aggregated Objects.
+     */
+    static void ClearLookupCache(Aggregates* aggregates);
+
     /**
      * Find an Object of TypeId tid in the aggregates of this Object.
      *
+     * The result is recorded in the lookup cache of the aggregates, so
+     * that the next lookup of the same TypeId does not search them.
+     *
      * \param [in] tid The TypeId we're looking for
      * \return The matching Object, if it is found
      */
@@ -24,6 +24,8 @@
 #include "log.h"
 #include "uinteger.h"
 
+#include <atomic>
+
 /**
  * \file
  * \ingroup randomvariable
@@ -40,7 +42,7 @@ NS_LOG_COMPONENT_DEFINE("RngSeedManager");
  * The next random number generator stream number to use
  * for automatic assignment.
  */
-static uint64_t g_nextStreamIndex = 0;
+static std::atomic<uint64_t> g_nextStreamIndex(0);
 /**
  * \relates RngSeedManager
  * \anchor GlobalValueRngSeed
@@ -107,9 +109,9 @@ uint64_t
 RngSeedManager::GetNextStreamIndex()
 {
     NS_LOG_FUNCTION_NOARGS();
-    uint64_t next = g_nextStreamIndex;
-    g_nextStreamIndex++;
-    return next;
+    // Random variables may be created concurrently by the threads of a
+    // parallel simulator.
+    return g_nextStreamIndex.fetch_add(1, std::memory_order_relaxed);
 }
 
 } // namespace ns3
@@ -18,6 +18,8 @@
 
 #include "simulator-impl.h"
 
+#include "boolean.h"
+#include "event-impl.h"
 #include "log.h"
 
 /**
@@ -36,8 +38,32 @@ NS_OBJECT_ENSURE_REGISTERED(SimulatorImpl);
 TypeId
 SimulatorImpl::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::SimulatorImpl").SetParent<Object>().SetGroupName("Core");
+    static TypeId tid =
+        TypeId("ns3::SimulatorImpl")
+            .SetParent<Object>()
+            .SetGroupName("Core")
+            .AddAttribute("EventPool",
+                          "Recycle the storage of executed and cancelled events "
+                          "through per-thread, size-classed free lists. The setting "
+                          "is process-wide, and applies to all the threads.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&SimulatorImpl::SetEventPoolEnabled,
+                                              &SimulatorImpl::IsEventPoolEnabled),
+                          MakeBooleanChecker());
     return tid;
 }
 
+void
+SimulatorImpl::SetEventPoolEnabled(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
+    EventImpl::SetPoolEnabled(enabled);
+}
+
+bool
+SimulatorImpl::IsEventPoolEnabled() const
+{
+    return EventImpl::IsPoolEnabled();
+}
+
 } // namespace ns3
@@ -107,6 +107,17 @@ class SimulatorImpl : public Object
      * \param [in] id The event about to be processed.
      */
     virtual void PreEventHook(const EventId& id){};
+
+  private:
+    /**
+     * Enable or disable the recycling of the event storage.
+     * \param [in] enabled Whether the event pool is enabled.
+     */
+    void SetEventPoolEnabled(bool enabled);
+    /**
+     * \returns Whether the event pool is enabled.
+     */
+    bool IsEventPoolEnabled() const;
 };
 
 } // namespace ns3
@@ -156,6 +156,7 @@ Simulator::Destroy()
     (*pimpl)->Destroy();
     (*pimpl)->Unref();
     *pimpl = nullptr;
+    EventImpl::ReleasePool();
 }
 
 void
@@ -22,7 +22,9 @@
 
 #include "callback.h"
 
+#include <algorithm>
 #include <list>
+#include <vector>
 
 /**
  * \file
@@ -47,6 +49,15 @@ namespace ns3
  * calling the \c operator() form with the appropriate
  * number of arguments.
  *
+ * The chain is stored in a contiguous array, which is iterated
+ * without pointer chasing when the trace source fires. A Callback
+ * of the chain may connect or disconnect Callbacks, including itself,
+ * while the chain is invoked: the Callbacks appended are invoked in
+ * the same pass, and the Callbacks disconnected are not invoked anymore.
+ * The Callbacks disconnected during the invocation are only cleared
+ * from the chain, and released, when the outermost invocation returns,
+ * so that no other Callback of the chain is skipped.
+ *
  * \tparam Ts \explicit Types of the functor arguments.
  */
 template <typename... Ts>
@@ -113,9 +124,16 @@ class TracedCallback
      *
      * \tparam Ts \deduced Types of the functor arguments.
      */
-    typedef std::list<Callback<void, Ts...>> CallbackList;
-    /** The chain of Callbacks. */
-    CallbackList m_callbackList;
+    typedef std::vector<Callback<void, Ts...>> CallbackList;
+    /**
+     * The chain of Callbacks. The Callbacks disconnected while the chain
+     * is invoked are left as null Callbacks until the invocation returns.
+     */
+    mutable CallbackList m_callbackList;
+    /** The Callbacks disconnected while the chain is invoked. */
+    mutable CallbackList m_disconnected;
+    /** The depth of the nested invocations of the chain. */
+    mutable uint32_t m_invoking;
 };
 
 } // namespace ns3
@@ -129,7 +147,9 @@ namespace ns3
 
 template <typename... Ts>
 TracedCallback<Ts...>::TracedCallback()
-    : m_callbackList()
+    : m_callbackList(),
+      m_disconnected(),
+      m_invoking(0)
 {
 }
 
@@ -162,6 +182,20 @@ template <typename... Ts>
 void
 TracedCallback<Ts...>::DisconnectWithoutContext(const CallbackBase& callback)
 {
+    if (m_invoking > 0)
+    {
+        // Keep the indices of the chain being invoked and the Callbacks
+        // alive, since one of them may be running
+        for (auto& cb : m_callbackList)
+        {
+            if (!cb.IsNull() && cb.IsEqual(callback))
+            {
+                m_disconnected.push_back(cb);
+                cb = Callback<void, Ts...>();
+            }
+        }
+        return;
+    }
     for (auto i = m_callbackList.begin(); i != m_callbackList.end(); /* empty */)
     {
         if ((*i).IsEqual(callback))
@@ -192,9 +226,25 @@ template <typename... Ts>
 void
 TracedCallback<Ts...>::operator()(Ts... args) const
 {
-    for (auto i = m_callbackList.begin(); i != m_callbackList.end(); i++)
+    // Index the chain, since a Callback may append to it
+    m_invoking++;
+    for (std::size_t i = 0; i < m_callbackList.size(); i++)
+    {
+        if (!m_callbackList[i].IsNull())
+        {
+            m_callbackList[i](args...);
+        }
+    }
+    m_invoking--;
+    if (m_invoking == 0 && !m_disconnected.empty())
     {
-        (*i)(args...);
+        m_callbackList.erase(std::remove_if(m_callbackList.begin(),
+                                            m_callbackList.end(),
+                                            [](const Callback<void, Ts...>& cb) {
+                                                return cb.IsNull();
+                                            }),
+                             m_callbackList.end());
+        m_disconnected.clear();
     }
 }
 
@@ -202,7 +252,7 @@ template <typename... Ts>
 bool
 TracedCallback<Ts...>::IsEmpty() const
 {
-    return m_callbackList.empty();
+    return m_callbackList.size() == m_disconnected.size();
 }
 
 } // namespace ns3
@@ -23,9 +23,11 @@
 #include "singleton.h"
 #include "trace-source-accessor.h"
 
+#include <deque>
 #include <iomanip>
 #include <map>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -263,6 +265,28 @@ class IidManager : public Singleton<IidManager>
      * \returns Detailed information about the requested trace source.
      */
     TypeId::TraceSourceInformation GetTraceSource(uint16_t uid, std::size_t i) const;
+    /**
+     * Get the attributes of a type id and of its parents.
+     * \param [in] uid The id.
+     * \returns The attributes, from those of \pname{uid} to those of the root.
+     */
+    const std::vector<TypeId::InheritedAttribute>& GetInheritedAttributes(uint16_t uid);
+    /**
+     * Find an attribute of a type id or of its parents.
+     * \param [in] uid The id.
+     * \param [in] name The Attribute name.
+     * \returns The attribute, or \c nullptr if not found.
+     */
+    const TypeId::InheritedAttribute* LookupInheritedAttribute(uint16_t uid,
+                                                               const std::string& name);
+    /**
+     * Find a trace source of a type id or of its parents.
+     * \param [in] uid The id.
+     * \param [in] name The TraceSource name.
+     * \returns The trace source, or \c nullptr if not found.
+     */
+    const TypeId::TraceSourceInformation* LookupTraceSource(uint16_t uid,
+                                                            const std::string& name) const;
     /**
      * Check if this TypeId should not be listed in documentation.
      * \param [in] uid The id.
@@ -291,6 +315,13 @@ class IidManager : public Singleton<IidManager>
      * \returns The hashed value of \pname{name}.
      */
     static TypeId::hash_t Hasher(const std::string name);
+    /**
+     * Discard the cached inherited attributes affected by a change of a
+     * type id: those of the type id itself, or all of them if it already
+     * has children.
+     * \param [in] uid The id.
+     */
+    void InvalidateInheritedAttributes(uint16_t uid);
 
     /** The information record about a single type id. */
     struct IidInformation
@@ -315,14 +346,26 @@ class IidManager : public Singleton<IidManager>
         std::vector<TypeId::AttributeInformation> attributes;
         /** The container of TraceSources. */
         std::vector<TypeId::TraceSourceInformation> traceSources;
+        /** The index of the Attributes, by name. */
+        std::unordered_map<std::string, std::size_t> attributeIndex;
+        /** The index of the TraceSources, by name. */
+        std::unordered_map<std::string, std::size_t> traceSourceIndex;
         /** Support level/deprecation. */
         TypeId::SupportLevel supportLevel;
         /** Support message. */
         std::string supportMsg;
+        /** \c true if another type id has this one as parent. */
+        bool hasChildren;
+        /** The Attributes of this type id and of its parents. */
+        std::vector<TypeId::InheritedAttribute> inheritedAttributes;
+        /** The index of the inherited Attributes, by name. */
+        std::unordered_map<std::string, std::size_t> inheritedAttributeIndex;
+        /** The generation of the inherited Attributes, 0 if not built. */
+        uint64_t inheritedGeneration;
     };
 
     /** Iterator type. */
-    typedef std::vector<IidInformation>::const_iterator Iterator;
+    typedef std::deque<IidInformation>::const_iterator Iterator;
 
     /**
      * Retrieve the information record for a type.
@@ -331,19 +374,27 @@ class IidManager : public Singleton<IidManager>
      */
     IidManager::IidInformation* LookupInformation(uint16_t uid) const;
 
-    /** The container of all type id records. */
-    std::vector<IidInformation> m_information;
+    /**
+     * The container of all type id records.
+     *
+     * A deque keeps the records, and thus the cached inherited
+     * attributes, in place when new type ids are registered.
+     */
+    std::deque<IidInformation> m_information;
 
     /** Type of the by-name index. */
-    typedef std::map<std::string, uint16_t> namemap_t;
+    typedef std::unordered_map<std::string, uint16_t> namemap_t;
     /** The by-name index. */
     namemap_t m_namemap;
 
     /** Type of the by-hash index. */
-    typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
+    typedef std::unordered_map<TypeId::hash_t, uint16_t> hashmap_t;
     /** The by-hash index. */
     hashmap_t m_hashmap;
 
+    /** The current generation of the cached inherited attributes. */
+    uint64_t m_inheritedGeneration{1};
+
     /** IidManager constants. */
     enum
     {
@@ -440,6 +491,8 @@ IidManager::AllocateUid(std::string name)
     information.hasConstructor = false;
     information.mustHideFromDocumentation = false;
     information.supportLevel = TypeId::SUPPORTED;
+    information.hasChildren = false;
+    information.inheritedGeneration = 0;
     m_information.push_back(information);
     std::size_t tuid = m_information.size();
     NS_ASSERT(tuid <= 0xffff);
@@ -468,6 +521,11 @@ IidManager::SetParent(uint16_t uid, uint16_t parent)
     NS_ASSERT(parent <= m_information.size());
     IidInformation* information = LookupInformation(uid);
     information->parent = parent;
+    if (parent != 0 && parent != uid)
+    {
+        LookupInformation(parent)->hasChildren = true;
+    }
+    InvalidateInheritedAttributes(uid);
 }
 
 void
@@ -627,13 +685,10 @@ IidManager::HasAttribute(uint16_t uid, std::string name)
     IidInformation* information = LookupInformation(uid);
     while (true)
     {
-        for (auto i = information->attributes.begin(); i != information->attributes.end(); ++i)
+        if (information->attributeIndex.count(name) != 0)
         {
-            if (i->name == name)
-            {
-                NS_LOG_LOGIC(IIDL << true);
-                return true;
-            }
+            NS_LOG_LOGIC(IIDL << true);
+            return true;
         }
         IidInformation* parent = LookupInformation(information->parent);
         if (parent == information)
@@ -684,7 +739,9 @@ IidManager::AddAttribute(uint16_t uid,
     info.checker = checker;
     info.supportLevel = supportLevel;
     info.supportMsg = supportMsg;
+    information->attributeIndex[name] = information->attributes.size();
     information->attributes.push_back(info);
+    InvalidateInheritedAttributes(uid);
     NS_LOG_LOGIC(IIDL << information->attributes.size() - 1);
 }
 
@@ -723,29 +780,9 @@ bool
 IidManager::HasTraceSource(uint16_t uid, std::string name)
 {
     NS_LOG_FUNCTION(IID << uid << name);
-    IidInformation* information = LookupInformation(uid);
-    while (true)
-    {
-        for (auto i = information->traceSources.begin(); i != information->traceSources.end(); ++i)
-        {
-            if (i->name == name)
-            {
-                NS_LOG_LOGIC(IIDL << true);
-                return true;
-            }
-        }
-        IidInformation* parent = LookupInformation(information->parent);
-        if (parent == information)
-        {
-            // top of inheritance tree
-            NS_LOG_LOGIC(IIDL << false);
-            return false;
-        }
-        // check parent
-        information = parent;
-    }
-    NS_LOG_LOGIC(IIDL << false);
-    return false;
+    bool found = LookupTraceSource(uid, name) != nullptr;
+    NS_LOG_LOGIC(IIDL << found);
+    return found;
 }
 
 void
@@ -772,6 +809,7 @@ IidManager::AddTraceSource(uint16_t uid,
     source.callback = callback;
     source.supportLevel = supportLevel;
     source.supportMsg = supportMsg;
+    information->traceSourceIndex[name] = information->traceSources.size();
     information->traceSources.push_back(source);
     NS_LOG_LOGIC(IIDL << information->traceSources.size() - 1);
 }
@@ -796,6 +834,90 @@ IidManager::GetTraceSource(uint16_t uid, std::size_t i) const
     return information->traceSources[i];
 }
 
+void
+IidManager::InvalidateInheritedAttributes(uint16_t uid)
+{
+    NS_LOG_FUNCTION(IID << uid);
+    IidInformation* information = LookupInformation(uid);
+    if (information->hasChildren)
+    {
+        // The children may have cached the attributes of this type id
+        ++m_inheritedGeneration;
+    }
+    information->inheritedGeneration = 0;
+}
+
+const std::vector<TypeId::InheritedAttribute>&
+IidManager::GetInheritedAttributes(uint16_t uid)
+{
+    NS_LOG_FUNCTION(IID << uid);
+    IidInformation* information = LookupInformation(uid);
+    if (information->inheritedGeneration == m_inheritedGeneration)
+    {
+        return information->inheritedAttributes;
+    }
+    NS_LOG_LOGIC(IIDL << "building the inherited attributes of " << information->name);
+    information->inheritedAttributes.clear();
+    information->inheritedAttributeIndex.clear();
+    uint16_t tid = uid;
+    while (true)
+    {
+        IidInformation* current = LookupInformation(tid);
+        for (std::size_t i = 0; i < current->attributes.size(); ++i)
+        {
+            // The attributes of the children hide those of the parents
+            information->inheritedAttributeIndex.emplace(current->attributes[i].name,
+                                                         information->inheritedAttributes.size());
+            TypeId::InheritedAttribute attribute = {TypeId(tid), i, &current->attributes[i]};
+            information->inheritedAttributes.push_back(attribute);
+        }
+        if (current->parent == tid)
+        {
+            break;
+        }
+        tid = current->parent;
+    }
+    information->inheritedGeneration = m_inheritedGeneration;
+    return information->inheritedAttributes;
+}
+
+const TypeId::InheritedAttribute*
+IidManager::LookupInheritedAttribute(uint16_t uid, const std::string& name)
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    const auto& attributes = GetInheritedAttributes(uid);
+    const auto& index = LookupInformation(uid)->inheritedAttributeIndex;
+    auto it = index.find(name);
+    if (it == index.end())
+    {
+        return nullptr;
+    }
+    return &attributes[it->second];
+}
+
+const TypeId::TraceSourceInformation*
+IidManager::LookupTraceSource(uint16_t uid, const std::string& name) const
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    IidInformation* information = LookupInformation(uid);
+    while (true)
+    {
+        auto it = information->traceSourceIndex.find(name);
+        if (it != information->traceSourceIndex.end())
+        {
+            return &information->traceSources[it->second];
+        }
+        IidInformation* parent = LookupInformation(information->parent);
+        if (parent == information)
+        {
+            // top of inheritance tree
+            return nullptr;
+        }
+        // check parent
+        information = parent;
+    }
+}
+
 bool
 IidManager::MustHideFromDocumentation(uint16_t uid) const
 {
@@ -892,38 +1014,31 @@ bool
 TypeId::LookupAttributeByName(std::string name, TypeId::AttributeInformation* info) const
 {
     NS_LOG_FUNCTION(this << name << info);
-    TypeId tid;
-    TypeId nextTid = *this;
-    do
+    const InheritedAttribute* attribute =
+        IidManager::Get()->LookupInheritedAttribute(m_tid, name);
+    if (attribute == nullptr)
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetAttributeN(); i++)
-        {
-            TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                    *info = tmp;
-                    return true;
-                }
-                else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                    std::cerr << "Attribute '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return true;
-                }
-                else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("Attribute '" << name << "' is obsolete, with no fallback: "
-                                                 << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
-    return false;
+        return false;
+    }
+    const TypeId::AttributeInformation& tmp = *attribute->info;
+    if (tmp.supportLevel == TypeId::DEPRECATED)
+    {
+        std::cerr << "Attribute '" << name << "' is deprecated: " << tmp.supportMsg << std::endl;
+    }
+    else if (tmp.supportLevel == TypeId::OBSOLETE)
+    {
+        NS_FATAL_ERROR("Attribute '" << name
+                                     << "' is obsolete, with no fallback: " << tmp.supportMsg);
+    }
+    *info = tmp;
+    return true;
+}
+
+const std::vector<TypeId::InheritedAttribute>&
+TypeId::GetInheritedAttributes() const
+{
+    NS_LOG_FUNCTION(this);
+    return IidManager::Get()->GetInheritedAttributes(m_tid);
 }
 
 TypeId
@@ -1158,39 +1273,23 @@ Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName(std::string name, TraceSourceInformation* info) const
 {
     NS_LOG_FUNCTION(this << name);
-    TypeId tid;
-    TypeId nextTid = *this;
-    TypeId::TraceSourceInformation tmp;
-    do
+    const TraceSourceInformation* source = IidManager::Get()->LookupTraceSource(m_tid, name);
+    if (source == nullptr)
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetTraceSourceN(); i++)
-        {
-            tmp = tid.GetTraceSource(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                    std::cerr << "TraceSource '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("TraceSource '" << name << "' is obsolete, with no fallback: "
-                                                   << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
-    return nullptr;
+        return nullptr;
+    }
+    if (source->supportLevel == TypeId::DEPRECATED)
+    {
+        std::cerr << "TraceSource '" << name << "' is deprecated: " << source->supportMsg
+                  << std::endl;
+    }
+    else if (source->supportLevel == TypeId::OBSOLETE)
+    {
+        NS_FATAL_ERROR("TraceSource '" << name << "' is obsolete, with no fallback: "
+                                       << source->supportMsg);
+    }
+    *info = *source;
+    return source->accessor;
 }
 
 Ptr<const TraceSourceAccessor>
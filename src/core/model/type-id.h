@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 /**
  * \file
@@ -116,6 +117,9 @@ class TypeId
         std::string supportMsg;
     };
 
+    /** An attribute of a TypeId or of one of its parents. */
+    struct InheritedAttribute;
+
     /** Type of hash values. */
     typedef uint32_t hash_t;
 
@@ -269,6 +273,17 @@ class TypeId
      * \returns The full name associated to the attribute whose index is \pname{i}.
      */
     std::string GetAttributeFullName(std::size_t i) const;
+    /**
+     * Get the attributes of this TypeId and of all its parents.
+     *
+     * The table is built at the first call and cached, with a hashed
+     * index used by LookupAttributeByName(). It is rebuilt after an
+     * attribute is added to this TypeId or to one of its parents.
+     *
+     * \returns The attributes, from those of this TypeId to those of the
+     *          root TypeId.
+     */
+    const std::vector<InheritedAttribute>& GetInheritedAttributes() const;
 
     /**
      * Get the constructor callback.
@@ -539,6 +554,9 @@ class TypeId
     inline ~TypeId();
 
   private:
+    /** IidManager builds the InheritedAttribute tables. */
+    friend class IidManager;
+
     /**
      * \name Comparison operators.
      * Standard comparison operators.
@@ -565,6 +583,14 @@ class TypeId
     uint16_t m_tid;
 };
 
+/** An attribute of a TypeId or of one of its parents. */
+struct TypeId::InheritedAttribute
+{
+    TypeId tid;                              //!< The TypeId declaring the attribute
+    std::size_t index;                       //!< The index of the attribute in \c tid
+    const TypeId::AttributeInformation* info; //!< The attribute information
+};
+
 /**
  * \relates TypeId
  * Output streamer.
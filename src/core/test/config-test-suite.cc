@@ -864,6 +864,74 @@ SearchAttributesOfParentObjectsTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), 42, "Object Attribute \"X\" not settable in derived class");
 }
 
+/**
+ * \ingroup config-tests
+ * Test the resolution of paths through a cached container.
+ */
+class CachedContainerConfigTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    CachedContainerConfigTestCase();
+
+    /** Destructor. */
+    ~CachedContainerConfigTestCase() override
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+CachedContainerConfigTestCase::CachedContainerConfigTestCase()
+    : TestCase("Check the resolution of paths through a cached container")
+{
+}
+
+void
+CachedContainerConfigTestCase::DoRun()
+{
+    Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject>();
+    Config::RegisterRootNamespaceObject(root);
+    Config::RegisterCachedContainer(ConfigTestObject::GetTypeId(), "NodesA");
+
+    std::vector<Ptr<ConfigTestObject>> objects;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        objects.push_back(CreateObject<ConfigTestObject>());
+        root->AddNodeA(objects.back());
+    }
+    Config::InvalidateCache();
+
+    // The matches are ordered by index, without duplicates
+    Config::MatchContainer matches = Config::LookupMatches("/NodesA/3|[1-2]|1|7");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 3U, "Unexpected number of matches");
+    NS_TEST_EXPECT_MSG_EQ(matches.GetMatchedPath(0), "/NodesA/1/", "Unexpected first match");
+    NS_TEST_EXPECT_MSG_EQ(matches.GetMatchedPath(1), "/NodesA/2/", "Unexpected second match");
+    NS_TEST_EXPECT_MSG_EQ(matches.GetMatchedPath(2), "/NodesA/3/", "Unexpected third match");
+    NS_TEST_EXPECT_MSG_EQ(matches.Get(2), objects[3], "Unexpected matched object");
+
+    // The container is read again only once the cache is invalidated
+    objects.push_back(CreateObject<ConfigTestObject>());
+    root->AddNodeA(objects.back());
+    NS_TEST_EXPECT_MSG_EQ(Config::LookupMatches("/NodesA/*").GetN(), 4U, "Container not cached");
+    Config::InvalidateCache();
+    NS_TEST_EXPECT_MSG_EQ(Config::LookupMatches("/NodesA/*").GetN(), 5U, "Cache not invalidated");
+
+    Config::Set("/NodesA/4/A", IntegerValue(-17));
+    IntegerValue iv;
+    objects[4]->GetAttribute("A", iv);
+    NS_TEST_EXPECT_MSG_EQ(iv.Get(), -17, "Object Attribute \"A\" not set as expected");
+
+    // Once unregistered, the container is read at each resolution
+    Config::UnregisterCachedContainer(ConfigTestObject::GetTypeId(), "NodesA");
+    objects.push_back(CreateObject<ConfigTestObject>());
+    root->AddNodeA(objects.back());
+    NS_TEST_EXPECT_MSG_EQ(Config::LookupMatches("/NodesA/*").GetN(), 6U, "Container still cached");
+
+    Config::UnregisterRootNamespaceObject(root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -882,6 +950,7 @@ ConfigTestSuite::ConfigTestSuite()
     AddTestCase(new UnderRootNamespaceConfigTestCase);
     AddTestCase(new ObjectVectorConfigTestCase);
     AddTestCase(new SearchAttributesOfParentObjectsTestCase);
+    AddTestCase(new CachedContainerConfigTestCase);
 }
 
 /**
@@ -464,6 +464,71 @@ AggregateObjectTestCase::DoRun()
     NS_TEST_ASSERT_MSG_NE(baseA, nullptr, "Unable to GetObject on released object");
 }
 
+/**
+ * \ingroup object-tests
+ * Test the lookup cache of the aggregates.
+ */
+class LookupCacheTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    LookupCacheTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+LookupCacheTestCase::LookupCacheTestCase()
+    : TestCase("Check the lookup cache of the aggregates")
+{
+}
+
+void
+LookupCacheTestCase::DoRun()
+{
+    Ptr<BaseA> baseA = CreateObject<BaseA>();
+    Ptr<BaseB> baseB = CreateObject<BaseB>();
+    Object::LookupStatistics start = Object::GetLookupStatistics();
+
+    //
+    // A failed lookup is cached too.
+    //
+    NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(), nullptr, "Unexpected BaseB");
+    NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(), nullptr, "Unexpected cached BaseB");
+    Object::LookupStatistics statistics = Object::GetLookupStatistics();
+    NS_TEST_EXPECT_MSG_EQ(statistics.misses - start.misses, 1U, "Unexpected number of misses");
+    NS_TEST_EXPECT_MSG_EQ(statistics.hits - start.hits, 1U, "Unexpected number of hits");
+
+    //
+    // The aggregation invalidates the cache, which is then shared by the
+    // aggregated Objects.
+    //
+    baseA->AggregateObject(baseB);
+    start = Object::GetLookupStatistics();
+    NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(), baseB, "BaseB not found after aggregation");
+    NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<BaseB>(DerivedB::GetTypeId()),
+                          nullptr,
+                          "Unexpected DerivedB");
+    NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<BaseB>(BaseB::GetTypeId()),
+                          baseB,
+                          "Cached BaseB not found");
+    NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(DerivedB::GetTypeId()),
+                          nullptr,
+                          "Unexpected cached DerivedB");
+    statistics = Object::GetLookupStatistics();
+    NS_TEST_EXPECT_MSG_EQ(statistics.misses - start.misses, 2U, "Unexpected number of misses");
+    NS_TEST_EXPECT_MSG_EQ(statistics.hits - start.hits, 2U, "Unexpected number of hits");
+
+    //
+    // The DerivedB cached as missing is found once aggregated.
+    //
+    Ptr<DerivedB> derivedB = CreateObject<DerivedB>();
+    baseA->AggregateObject(derivedB);
+    NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<BaseB>(DerivedB::GetTypeId()),
+                          derivedB,
+                          "DerivedB not found after aggregation");
+}
+
 /**
  * \ingroup object-tests
  * Test an Object factory can create Objects
@@ -565,6 +630,7 @@ ObjectTestSuite::ObjectTestSuite()
 {
     AddTestCase(new CreateObjectTestCase);
     AddTestCase(new AggregateObjectTestCase);
+    AddTestCase(new LookupCacheTestCase);
     AddTestCase(new ObjectFactoryTestCase);
 }
 
@@ -16,14 +16,24 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/boolean.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/config.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
+#include "ns3/make-event.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -707,6 +717,193 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the ordering of the LadderScheduler against a sorted set,
+ * with a mix of same-time, near-future and far-future events and
+ * removals, which exercises the spawning and the exhaustion of rungs.
+ */
+class LadderSchedulerTestCase : public TestCase
+{
+  public:
+    LadderSchedulerTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+LadderSchedulerTestCase::LadderSchedulerTestCase()
+    : TestCase("Check the ordering of the LadderScheduler")
+{
+}
+
+void
+LadderSchedulerTestCase::DoRun()
+{
+    Ptr<LadderScheduler> ladder = CreateObject<LadderScheduler>();
+    std::set<Scheduler::Event> reference;
+    std::vector<Scheduler::Event> inserted;
+    std::mt19937_64 rng(RngSeedManager::GetSeed());
+    uint32_t uid = 0;
+    uint64_t now = 0;
+
+    for (uint32_t step = 0; step < 100000; ++step)
+    {
+        uint32_t op = rng() % 10;
+        if (op < 5 || reference.empty())
+        {
+            // same-time, slot-aligned, near-future and far-future events
+            const uint64_t delays[] = {0, (rng() % 4) * 1000, rng() % 100000, rng() % 100000000};
+            Scheduler::Event ev;
+            ev.impl = nullptr;
+            ev.key.m_ts = now + delays[rng() % 4];
+            ev.key.m_uid = uid++;
+            ev.key.m_context = 0;
+            ladder->Insert(ev);
+            reference.insert(ev);
+            inserted.push_back(ev);
+        }
+        else if (op < 9)
+        {
+            Scheduler::Event ev = ladder->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid,
+                                  reference.begin()->key.m_uid,
+                                  "Unexpected event at step " << step);
+            reference.erase(reference.begin());
+            now = ev.key.m_ts;
+        }
+        else
+        {
+            std::size_t i = rng() % inserted.size();
+            Scheduler::Event ev = inserted[i];
+            inserted[i] = inserted.back();
+            inserted.pop_back();
+            if (reference.erase(ev) == 1)
+            {
+                ladder->Remove(ev);
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(ladder->IsEmpty(), reference.empty(), "Unexpected queue state");
+        if (!reference.empty())
+        {
+            NS_TEST_ASSERT_MSG_EQ(ladder->PeekNext().key.m_uid,
+                                  reference.begin()->key.m_uid,
+                                  "Unexpected next event at step " << step);
+        }
+    }
+    while (!reference.empty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(ladder->RemoveNext().key.m_uid,
+                              reference.begin()->key.m_uid,
+                              "Unexpected event while draining the queue");
+        reference.erase(reference.begin());
+    }
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * An event released when its thread exits, after the event pool of the
+ * thread has been destroyed.
+ */
+struct ThreadLocalEvent
+{
+    /** Destructor, releases the event. */
+    ~ThreadLocalEvent()
+    {
+        if (m_event != nullptr)
+        {
+            m_event->Unref();
+        }
+    }
+
+    EventImpl* m_event{nullptr}; //!< The event
+};
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the recycling of the event storage.
+ */
+class SimulatorEventPoolTestCase : public TestCase
+{
+  public:
+    SimulatorEventPoolTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Event function, counting its invocations. */
+    static void Count();
+
+    static uint32_t m_count; //!< Number of invocations of Count()
+};
+
+uint32_t SimulatorEventPoolTestCase::m_count = 0;
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase()
+    : TestCase("Check the recycling of the event storage")
+{
+}
+
+void
+SimulatorEventPoolTestCase::Count()
+{
+    ++m_count;
+}
+
+void
+SimulatorEventPoolTestCase::DoRun()
+{
+    EventImpl::SetPoolEnabled(true);
+    EventImpl* first = MakeEvent(&SimulatorEventPoolTestCase::Count);
+    first->Unref();
+    EventImpl* second = MakeEvent(&SimulatorEventPoolTestCase::Count);
+    NS_TEST_EXPECT_MSG_EQ(first, second, "The storage of the released event was not recycled");
+    second->Invoke();
+    second->Unref();
+    NS_TEST_EXPECT_MSG_EQ(m_count, 1, "The recycled event was not invoked");
+
+    // Events allocated by a thread and released by another one, beyond the
+    // capacity of the free lists of the latter
+    std::vector<EventImpl*> events;
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        events.push_back(MakeEvent(&SimulatorEventPoolTestCase::Count));
+    }
+    std::thread([&events]() {
+        for (auto event : events)
+        {
+            event->Unref();
+        }
+    }).join();
+
+    // An event released after the destruction of the pool of its thread
+    std::thread([]() {
+        static thread_local ThreadLocalEvent event;
+        event.m_event = MakeEvent(&SimulatorEventPoolTestCase::Count);
+    }).join();
+
+    for (bool enabled : {false, true})
+    {
+        Config::SetDefault("ns3::SimulatorImpl::EventPool", BooleanValue(enabled));
+        m_count = 0;
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            EventId id = Simulator::Schedule(MicroSeconds(i), &SimulatorEventPoolTestCase::Count);
+            if (i % 10 == 0)
+            {
+                id.Cancel();
+            }
+        }
+        NS_TEST_EXPECT_MSG_EQ(EventImpl::IsPoolEnabled(), enabled, "EventPool not applied");
+        Simulator::Run();
+        Simulator::Destroy();
+        NS_TEST_EXPECT_MSG_EQ(m_count, 90, "Unexpected number of executed events");
+    }
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -730,6 +927,10 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new LadderSchedulerTestCase(), TestCase::QUICK);
+        AddTestCase(new SimulatorEventPoolTestCase(), TestCase::QUICK);
     }
 };
 
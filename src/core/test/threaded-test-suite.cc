@@ -30,6 +30,7 @@
 #include <list>
 #include <thread> // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -278,6 +279,100 @@ ThreadedSimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that the bursts of events scheduled by other threads are
+ * all executed, in the order each thread scheduled them.
+ */
+class ThreadedSimulatorBurstTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param threads The number of threads.
+     */
+    ThreadedSimulatorBurstTestCase(unsigned int threads);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Record an event.
+     * \param threadno The thread number.
+     * \param seq The order in which the thread scheduled the event.
+     */
+    void Record(unsigned int threadno, uint32_t seq);
+
+    /**
+     * Schedule a burst of events.
+     * \param threadno The thread number.
+     */
+    void SchedulingThread(unsigned int threadno);
+
+    static constexpr uint32_t BURST = 10000; //!< Number of events scheduled by each thread
+
+    unsigned int m_threads;                  //!< The number of threads.
+    std::vector<std::vector<uint32_t>> m_seq; //!< The events executed for each thread.
+};
+
+ThreadedSimulatorBurstTestCase::ThreadedSimulatorBurstTestCase(unsigned int threads)
+    : TestCase("Check bursts of events scheduled by " + std::to_string(threads) + " threads"),
+      m_threads(threads)
+{
+}
+
+void
+ThreadedSimulatorBurstTestCase::Record(unsigned int threadno, uint32_t seq)
+{
+    m_seq[threadno].push_back(seq);
+}
+
+void
+ThreadedSimulatorBurstTestCase::SchedulingThread(unsigned int threadno)
+{
+    for (uint32_t seq = 0; seq < BURST; ++seq)
+    {
+        Simulator::ScheduleWithContext(threadno,
+                                       Seconds(0),
+                                       &ThreadedSimulatorBurstTestCase::Record,
+                                       this,
+                                       threadno,
+                                       seq);
+    }
+}
+
+void
+ThreadedSimulatorBurstTestCase::DoRun()
+{
+    m_seq.assign(m_threads, {});
+    std::vector<std::thread> threads;
+    // The simulator drains the events while the threads are still
+    // scheduling them, until all the threads are joined.
+    Simulator::Schedule(MilliSeconds(1), [&threads]() {
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    });
+    for (unsigned int i = 0; i < m_threads; ++i)
+    {
+        threads.emplace_back(&ThreadedSimulatorBurstTestCase::SchedulingThread, this, i);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    for (unsigned int i = 0; i < m_threads; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_seq[i].size(), BURST, "Events lost for thread " << i);
+        for (uint32_t seq = 0; seq < BURST; ++seq)
+        {
+            NS_TEST_ASSERT_MSG_EQ(m_seq[i][seq], seq, "Events reordered for thread " << i);
+        }
+    }
+}
+
 /**
  * \ingroup threaded-tests
  *
@@ -315,6 +410,7 @@ class ThreadedSimulatorTestSuite : public TestSuite
                 }
             }
         }
+        AddTestCase(new ThreadedSimulatorBurstTestCase(4), TestCase::QUICK);
     }
 };
 
@@ -18,6 +18,8 @@
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
 
+#include <string>
+
 using namespace ns3;
 
 /**
@@ -133,6 +135,180 @@ BasicTracedCallbackTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(m_two, true, "Callback CbTwo not called");
 }
 
+/**
+ * \ingroup tracedcallback-tests
+ *
+ * Check the Callbacks connected while the TracedCallback is invoked.
+ */
+class ReentrantTracedCallbackTestCase : public TestCase
+{
+  public:
+    ReentrantTracedCallbackTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Count a call and connect another counting Callback.
+     * \param a The traced value.
+     */
+    void Connecting(uint32_t a);
+    /**
+     * Count a call with a context.
+     * \param context The context.
+     * \param a The traced value.
+     */
+    void Counting(std::string context, uint32_t a);
+
+    TracedCallback<uint32_t> m_trace; //!< The traced callback
+    uint32_t m_connecting;            //!< Number of calls of Connecting()
+    uint32_t m_counting;              //!< Number of calls of Counting()
+};
+
+ReentrantTracedCallbackTestCase::ReentrantTracedCallbackTestCase()
+    : TestCase("Check Callbacks connected while the TracedCallback is invoked")
+{
+}
+
+void
+ReentrantTracedCallbackTestCase::Connecting(uint32_t /* a */)
+{
+    m_connecting++;
+    m_trace.Connect(MakeCallback(&ReentrantTracedCallbackTestCase::Counting, this),
+                    std::to_string(m_connecting));
+}
+
+void
+ReentrantTracedCallbackTestCase::Counting(std::string /* context */, uint32_t /* a */)
+{
+    m_counting++;
+}
+
+void
+ReentrantTracedCallbackTestCase::DoRun()
+{
+    m_connecting = 0;
+    m_counting = 0;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        m_trace.ConnectWithoutContext(
+            MakeCallback(&ReentrantTracedCallbackTestCase::Connecting, this));
+    }
+
+    //
+    // The Callbacks appended by the chain are invoked in the same pass.
+    //
+    m_trace(1);
+    NS_TEST_ASSERT_MSG_EQ(m_connecting, 4U, "Connecting not called by each Callback");
+    NS_TEST_ASSERT_MSG_EQ(m_counting, 4U, "Appended Callbacks not called");
+
+    //
+    // Disconnecting a Callback with a context only removes that context.
+    //
+    m_trace.Disconnect(MakeCallback(&ReentrantTracedCallbackTestCase::Counting, this), "2");
+    m_trace.DisconnectWithoutContext(
+        MakeCallback(&ReentrantTracedCallbackTestCase::Connecting, this));
+    m_counting = 0;
+    m_trace(1);
+    NS_TEST_ASSERT_MSG_EQ(m_connecting, 4U, "Connecting unexpectedly called");
+    NS_TEST_ASSERT_MSG_EQ(m_counting, 3U, "Wrong number of Counting calls");
+}
+
+/**
+ * \ingroup tracedcallback-tests
+ *
+ * Check the Callbacks disconnected while the TracedCallback is invoked.
+ */
+class DisconnectingTracedCallbackTestCase : public TestCase
+{
+  public:
+    DisconnectingTracedCallbackTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Record a call, then disconnect the sinks selected by the context:
+     * sink "1" disconnects itself, sink "3" the earlier sink "2" and
+     * sink "4" the later sink "6".
+     * \param context The context, identifying the sink.
+     * \param a The traced value.
+     */
+    void Sink(std::string context, uint32_t a);
+
+    /**
+     * Disconnect a sink.
+     * \param context The context of the sink.
+     */
+    void DisconnectSink(std::string context);
+
+    TracedCallback<uint32_t> m_trace; //!< The traced callback
+    std::string m_calls;              //!< The contexts of the sinks called
+};
+
+DisconnectingTracedCallbackTestCase::DisconnectingTracedCallbackTestCase()
+    : TestCase("Check Callbacks disconnected while the TracedCallback is invoked")
+{
+}
+
+void
+DisconnectingTracedCallbackTestCase::DisconnectSink(std::string context)
+{
+    m_trace.Disconnect(MakeCallback(&DisconnectingTracedCallbackTestCase::Sink, this), context);
+}
+
+void
+DisconnectingTracedCallbackTestCase::Sink(std::string context, uint32_t /* a */)
+{
+    m_calls += context;
+    if (context == "1")
+    {
+        DisconnectSink("1");
+    }
+    else if (context == "3")
+    {
+        DisconnectSink("2");
+    }
+    else if (context == "4")
+    {
+        DisconnectSink("6");
+    }
+}
+
+void
+DisconnectingTracedCallbackTestCase::DoRun()
+{
+    for (uint32_t i = 1; i <= 6; i++)
+    {
+        m_trace.Connect(MakeCallback(&DisconnectingTracedCallbackTestCase::Sink, this),
+                        std::to_string(i));
+    }
+
+    //
+    // The sinks following a sink which disconnects itself or an earlier sink
+    // are still invoked, and a later sink disconnected is not invoked anymore.
+    //
+    m_trace(1);
+    NS_TEST_ASSERT_MSG_EQ(m_calls, "12345", "Wrong sinks called while disconnecting");
+    NS_TEST_ASSERT_MSG_EQ(m_trace.IsEmpty(), false, "Connected sinks not reported");
+
+    m_calls.clear();
+    m_trace(1);
+    NS_TEST_ASSERT_MSG_EQ(m_calls, "345", "Disconnected sinks called");
+
+    //
+    // Disconnecting the remaining sinks empties the chain.
+    //
+    for (const auto& context : {"3", "4", "5"})
+    {
+        DisconnectSink(context);
+    }
+    NS_TEST_ASSERT_MSG_EQ(m_trace.IsEmpty(), true, "Disconnected sinks reported");
+    m_calls.clear();
+    m_trace(1);
+    NS_TEST_ASSERT_MSG_EQ(m_calls, "", "Disconnected sinks called");
+}
+
 /**
  * \ingroup tracedcallback-tests
  *
@@ -148,6 +324,8 @@ TracedCallbackTestSuite::TracedCallbackTestSuite()
     : TestSuite("traced-callback", UNIT)
 {
     AddTestCase(new BasicTracedCallbackTestCase, TestCase::QUICK);
+    AddTestCase(new ReentrantTracedCallbackTestCase, TestCase::QUICK);
+    AddTestCase(new DisconnectingTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite
@@ -343,6 +343,102 @@ DeprecatedAttributeTestCase::DoRun()
               << (tinfo.supportLevel == TypeId::DEPRECATED ? "deprecated" : "error") << std::endl;
 }
 
+/**
+ * \ingroup typeid-tests
+ *
+ * Class used to test the attributes inherited from a parent.
+ */
+class DerivedAttribute : public DeprecatedAttribute
+{
+  private:
+    int m_derived; //!< An attribute added to the inherited ones.
+
+  public:
+    DerivedAttribute()
+        : m_derived(0)
+    {
+    }
+
+    /**
+     * \brief Get the type ID.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("DerivedAttribute")
+                                .SetParent<DeprecatedAttribute>()
+                                .AddAttribute("derived",
+                                              "the derived Attribute",
+                                              IntegerValue(2),
+                                              MakeIntegerAccessor(&DerivedAttribute::m_derived),
+                                              MakeIntegerChecker<int>());
+        return tid;
+    }
+};
+
+/**
+ * \ingroup typeid-tests
+ *
+ * Check the table of the inherited Attributes.
+ */
+class InheritedAttributeTestCase : public TestCase
+{
+  public:
+    InheritedAttributeTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+InheritedAttributeTestCase::InheritedAttributeTestCase()
+    : TestCase("Check the inherited Attributes")
+{
+}
+
+void
+InheritedAttributeTestCase::DoRun()
+{
+    TypeId parent = DeprecatedAttribute::GetTypeId();
+    TypeId tid = DerivedAttribute::GetTypeId();
+
+    const auto& inherited = tid.GetInheritedAttributes();
+    NS_TEST_ASSERT_MSG_EQ(inherited.size(),
+                          tid.GetAttributeN() + parent.GetAttributeN(),
+                          "wrong number of inherited attributes");
+
+    // The attributes of the derived class come first
+    NS_TEST_EXPECT_MSG_EQ(inherited[0].tid, tid, "wrong TypeId of the derived attribute");
+    NS_TEST_EXPECT_MSG_EQ(inherited[0].info->name, "derived", "wrong derived attribute");
+    for (std::size_t i = 1; i < inherited.size(); ++i)
+    {
+        const auto& attribute = inherited[i];
+        NS_TEST_EXPECT_MSG_EQ(attribute.tid, parent, "wrong TypeId of attribute " << i);
+        NS_TEST_EXPECT_MSG_EQ(attribute.info->name,
+                              parent.GetAttribute(attribute.index).name,
+                              "wrong index of attribute " << i);
+    }
+
+    TypeId::AttributeInformation info;
+    NS_TEST_ASSERT_MSG_EQ(tid.LookupAttributeByName("attribute", &info),
+                          true,
+                          "lookup parent attribute");
+    NS_TEST_EXPECT_MSG_EQ(info.name, "attribute", "wrong parent attribute");
+    NS_TEST_EXPECT_MSG_EQ(tid.LookupAttributeByName("missing", &info),
+                          false,
+                          "lookup missing attribute");
+
+    // A new initial value is seen through the table
+    std::size_t index = inherited[0].index;
+    Ptr<const AttributeValue> initial = inherited[0].info->initialValue;
+    tid.SetAttributeInitialValue(index, Create<IntegerValue>(3));
+    NS_TEST_EXPECT_MSG_EQ(DynamicCast<const IntegerValue>(
+                              tid.GetInheritedAttributes()[0].info->initialValue)
+                              ->Get(),
+                          3,
+                          "new initial value not seen");
+    tid.SetAttributeInitialValue(index, initial);
+}
+
 /**
  * \ingroup typeid-tests
  *
@@ -455,6 +551,7 @@ TypeIdTestSuite::TypeIdTestSuite()
     AddTestCase(new UniqueTypeIdTestCase, QUICK);
     AddTestCase(new CollisionTestCase, QUICK);
     AddTestCase(new DeprecatedAttributeTestCase, QUICK);
+    AddTestCase(new InheritedAttributeTestCase, QUICK);
 }
 
 /// Static variable for test initialization.
@@ -22,7 +22,9 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -33,6 +35,19 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("FlowMonitor");
 
+/**
+ * \ingroup flow-monitor
+ * Write a value to a binary snapshot, in the native byte order.
+ * \param os the output stream
+ * \param value the value
+ */
+template <typename T>
+static void
+WriteSnapshotValue(std::ostream* os, T value)
+{
+    os->write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
 NS_OBJECT_ENSURE_REGISTERED(FlowMonitor);
 
 TypeId
@@ -80,7 +95,14 @@ FlowMonitor::GetTypeId()
                 ("The minimum inter-arrival time that is considered a flow interruption."),
                 TimeValue(Seconds(0.5)),
                 MakeTimeAccessor(&FlowMonitor::m_flowInterruptionsMinTime),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("HistogramPrecision",
+                          ("If not zero, the histograms have logarithmic bins, with "
+                           "2^HistogramPrecision bins per power of two, and the bin width "
+                           "attributes are the widths of the narrowest bins."),
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FlowMonitor::m_histogramPrecision),
+                          MakeUintegerChecker<uint8_t>(0, 16));
     return tid;
 }
 
@@ -91,7 +113,9 @@ FlowMonitor::GetInstanceTypeId() const
 }
 
 FlowMonitor::FlowMonitor()
-    : m_enabled(false)
+    : m_enabled(false),
+      m_histogramPrecision(0),
+      m_snapshotFormat(CSV)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -102,6 +126,12 @@ FlowMonitor::DoDispose()
     NS_LOG_FUNCTION(this);
     Simulator::Cancel(m_startEvent);
     Simulator::Cancel(m_stopEvent);
+    if (m_snapshotStream)
+    {
+        WriteSnapshot();
+        m_snapshotStream = nullptr;
+    }
+    Simulator::Cancel(m_snapshotEvent);
     for (auto iter = m_classifiers.begin(); iter != m_classifiers.end(); iter++)
     {
         *iter = nullptr;
@@ -118,8 +148,13 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow(FlowId flowId)
 {
     NS_LOG_FUNCTION(this);
-    auto iter = m_flowStats.find(flowId);
-    if (iter == m_flowStats.end())
+    if (flowId >= m_flowIndex.size())
+    {
+        m_flowIndex.resize(flowId + 1, FlowEntry{nullptr, false});
+    }
+    MarkChanged(flowId);
+    FlowEntry& entry = m_flowIndex[flowId];
+    if (entry.stats == nullptr)
     {
         FlowMonitor::FlowStats& ref = m_flowStats[flowId];
         ref.delaySum = Seconds(0);
@@ -131,18 +166,47 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
         ref.rxPackets = 0;
         ref.lostPackets = 0;
         ref.timesForwarded = 0;
-        ref.delayHistogram.SetDefaultBinWidth(m_delayBinWidth);
-        ref.jitterHistogram.SetDefaultBinWidth(m_jitterBinWidth);
-        ref.packetSizeHistogram.SetDefaultBinWidth(m_packetSizeBinWidth);
-        ref.flowInterruptionsHistogram.SetDefaultBinWidth(m_flowInterruptionsBinWidth);
-        return ref;
+        ref.delayHistogram = CreateHistogram(m_delayBinWidth);
+        ref.jitterHistogram = CreateHistogram(m_jitterBinWidth);
+        ref.packetSizeHistogram = CreateHistogram(m_packetSizeBinWidth);
+        ref.flowInterruptionsHistogram = CreateHistogram(m_flowInterruptionsBinWidth);
+        entry.stats = &ref;
+    }
+    return *entry.stats;
+}
+
+Histogram
+FlowMonitor::CreateHistogram(double binWidth) const
+{
+    Histogram histogram;
+    if (m_histogramPrecision > 0)
+    {
+        histogram.SetLogBins(binWidth, m_histogramPrecision);
     }
     else
     {
-        return iter->second;
+        histogram.SetDefaultBinWidth(binWidth);
+    }
+    return histogram;
+}
+
+inline void
+FlowMonitor::MarkChanged(FlowId flowId)
+{
+    FlowEntry& entry = m_flowIndex[flowId];
+    if (!entry.changed)
+    {
+        entry.changed = true;
+        m_changedFlows.push_back(flowId);
     }
 }
 
+inline uint64_t
+FlowMonitor::GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (static_cast<uint64_t>(flowId) << 32) | packetId;
+}
+
 void
 FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
                            uint32_t flowId,
@@ -156,7 +220,7 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         return;
     }
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
+    TrackedPacket& tracked = m_trackedPackets[GetTrackedPacketKey(flowId, packetId)];
     tracked.firstSeenTime = now;
     tracked.lastSeenTime = tracked.firstSeenTime;
     tracked.timesForwarded = 0;
@@ -187,8 +251,7 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    auto tracked = m_trackedPackets.find(key);
+    auto tracked = m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet forward report (flowId="
@@ -215,7 +278,7 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    auto tracked = m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet last-tx report (flowId="
@@ -299,7 +362,7 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    auto tracked = m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked != m_trackedPackets.end())
     {
         // we don't need to track this packet anymore
@@ -316,6 +379,30 @@ FlowMonitor::GetFlowStats() const
     return m_flowStats;
 }
 
+Histogram
+FlowMonitor::GetDelayHistogram() const
+{
+    NS_LOG_FUNCTION(this);
+    Histogram histogram = CreateHistogram(m_delayBinWidth);
+    for (const auto& iter : m_flowStats)
+    {
+        histogram.Merge(iter.second.delayHistogram);
+    }
+    return histogram;
+}
+
+Histogram
+FlowMonitor::GetJitterHistogram() const
+{
+    NS_LOG_FUNCTION(this);
+    Histogram histogram = CreateHistogram(m_jitterBinWidth);
+    for (const auto& iter : m_flowStats)
+    {
+        histogram.Merge(iter.second.jitterHistogram);
+    }
+    return histogram;
+}
+
 void
 FlowMonitor::CheckForLostPackets(Time maxDelay)
 {
@@ -327,12 +414,13 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
         if (now - iter->second.lastSeenTime >= maxDelay)
         {
             // packet is considered lost, add it to the loss statistics
-            auto flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
+            auto flowId = static_cast<FlowId>(iter->first >> 32);
+            NS_ASSERT(flowId < m_flowIndex.size() && m_flowIndex[flowId].stats);
+            m_flowIndex[flowId].stats->lostPackets++;
+            MarkChanged(flowId);
 
             // we won't track it anymore
-            m_trackedPackets.erase(iter++);
+            iter = m_trackedPackets.erase(iter);
         }
         else
         {
@@ -419,6 +507,7 @@ FlowMonitor::StopRightNow()
     }
     m_enabled = false;
     CheckForLostPackets();
+    WriteSnapshot();
 }
 
 void
@@ -535,6 +624,7 @@ FlowMonitor::ResetAllStats()
 
     for (auto& iter : m_flowStats)
     {
+        MarkChanged(iter.first);
         auto& flowStat = iter.second;
         flowStat.delaySum = Seconds(0);
         flowStat.jitterSum = Seconds(0);
@@ -555,4 +645,92 @@ FlowMonitor::ResetAllStats()
     }
 }
 
+void
+FlowMonitor::EnableSnapshots(std::string fileName, Time interval, SnapshotFormat format)
+{
+    NS_LOG_FUNCTION(this << fileName << interval.As(Time::S) << format);
+    NS_ASSERT_MSG(interval.IsStrictlyPositive(), "The snapshot interval must be positive");
+    Simulator::Cancel(m_snapshotEvent);
+    std::ios::openmode mode = std::ios::out;
+    if (format == BINARY)
+    {
+        mode |= std::ios::binary;
+    }
+    m_snapshotStream = Create<OutputStreamWrapper>(fileName, mode);
+    m_snapshotFormat = format;
+    m_snapshotInterval = interval;
+    if (format == CSV)
+    {
+        *m_snapshotStream->GetStream()
+            << "time,flowId,txBytes,rxBytes,txPackets,rxPackets,lostPackets,timesForwarded,"
+               "delaySum,jitterSum,lastDelay,timeFirstTxPacket,timeFirstRxPacket,"
+               "timeLastTxPacket,timeLastRxPacket\n";
+    }
+    m_snapshotEvent = Simulator::Schedule(interval, &FlowMonitor::PeriodicSnapshot, this);
+}
+
+void
+FlowMonitor::WriteSnapshot()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_snapshotStream || m_changedFlows.empty())
+    {
+        return;
+    }
+    std::ostream* os = m_snapshotStream->GetStream();
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    std::sort(m_changedFlows.begin(), m_changedFlows.end());
+    NS_LOG_DEBUG("Writing a snapshot of " << m_changedFlows.size() << " flows");
+
+    if (m_snapshotFormat == BINARY)
+    {
+        WriteSnapshotValue<int64_t>(os, now);
+        WriteSnapshotValue<uint32_t>(os, m_changedFlows.size());
+    }
+    for (FlowId flowId : m_changedFlows)
+    {
+        FlowEntry& entry = m_flowIndex[flowId];
+        entry.changed = false;
+        const FlowStats& stats = *entry.stats;
+        if (m_snapshotFormat == CSV)
+        {
+            *os << now << ',' << flowId << ',' << stats.txBytes << ',' << stats.rxBytes << ','
+                << stats.txPackets << ',' << stats.rxPackets << ',' << stats.lostPackets << ','
+                << stats.timesForwarded << ',' << stats.delaySum.GetNanoSeconds() << ','
+                << stats.jitterSum.GetNanoSeconds() << ',' << stats.lastDelay.GetNanoSeconds()
+                << ',' << stats.timeFirstTxPacket.GetNanoSeconds() << ','
+                << stats.timeFirstRxPacket.GetNanoSeconds() << ','
+                << stats.timeLastTxPacket.GetNanoSeconds() << ','
+                << stats.timeLastRxPacket.GetNanoSeconds() << '\n';
+        }
+        else
+        {
+            WriteSnapshotValue<uint32_t>(os, flowId);
+            WriteSnapshotValue<uint32_t>(os, stats.txPackets);
+            WriteSnapshotValue<uint32_t>(os, stats.rxPackets);
+            WriteSnapshotValue<uint32_t>(os, stats.lostPackets);
+            WriteSnapshotValue<uint32_t>(os, stats.timesForwarded);
+            WriteSnapshotValue<uint64_t>(os, stats.txBytes);
+            WriteSnapshotValue<uint64_t>(os, stats.rxBytes);
+            WriteSnapshotValue<int64_t>(os, stats.delaySum.GetNanoSeconds());
+            WriteSnapshotValue<int64_t>(os, stats.jitterSum.GetNanoSeconds());
+            WriteSnapshotValue<int64_t>(os, stats.lastDelay.GetNanoSeconds());
+            WriteSnapshotValue<int64_t>(os, stats.timeFirstTxPacket.GetNanoSeconds());
+            WriteSnapshotValue<int64_t>(os, stats.timeFirstRxPacket.GetNanoSeconds());
+            WriteSnapshotValue<int64_t>(os, stats.timeLastTxPacket.GetNanoSeconds());
+            WriteSnapshotValue<int64_t>(os, stats.timeLastRxPacket.GetNanoSeconds());
+        }
+    }
+    m_changedFlows.clear();
+    os->flush();
+}
+
+void
+FlowMonitor::PeriodicSnapshot()
+{
+    WriteSnapshot();
+    m_snapshotEvent =
+        Simulator::Schedule(m_snapshotInterval, &FlowMonitor::PeriodicSnapshot, this);
+}
+
 } // namespace ns3
@@ -27,9 +27,11 @@
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
+#include "ns3/output-stream-wrapper.h"
 #include "ns3/ptr.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -47,6 +49,25 @@ namespace ns3
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * Besides the end-of-run XML output, the statistics can be streamed to a
+ * file while the simulation runs, see EnableSnapshots(). Each snapshot
+ * holds only the flows whose statistics changed since the previous one,
+ * in increasing FlowId order, and no snapshot is written if no flow
+ * changed, so that long runs with many flows can be monitored without
+ * keeping the full history in memory.
+ *
+ * In the CSV format, each flow is a line with the snapshot time and the
+ * fields time,flowId,txBytes,rxBytes,txPackets,rxPackets,lostPackets,
+ * timesForwarded,delaySum,jitterSum,lastDelay,timeFirstTxPacket,
+ * timeFirstRxPacket,timeLastTxPacket,timeLastRxPacket, after a header
+ * line. All the times are in nanoseconds.
+ *
+ * In the binary format, in the native byte order, each snapshot is the
+ * snapshot time (int64_t, nanoseconds) and the number of flows (uint32_t),
+ * followed by the flows: flowId, txPackets, rxPackets, lostPackets and
+ * timesForwarded (uint32_t), txBytes and rxBytes (uint64_t), and delaySum,
+ * jitterSum, lastDelay, timeFirstTxPacket, timeFirstRxPacket,
+ * timeLastTxPacket and timeLastRxPacket (int64_t, nanoseconds).
  */
 class FlowMonitor : public Object
 {
@@ -240,6 +261,16 @@ class FlowMonitor : public Object
     /// Container Const Iterator: FlowProbe
     typedef std::vector<Ptr<FlowProbe>>::const_iterator FlowProbeContainerCI;
 
+    /// Merge the delay histograms of all the flows.  The histograms can
+    /// be merged only if they have the same bins, i.e., if the bin
+    /// attributes were not changed since the first flow was seen.
+    /// \returns the delay histogram of the packets of all the flows
+    Histogram GetDelayHistogram() const;
+
+    /// Merge the jitter histograms of all the flows, see GetDelayHistogram()
+    /// \returns the jitter histogram of the packets of all the flows
+    Histogram GetJitterHistogram() const;
+
     /// Retrieve all collected the flow statistics.  Note, if the
     /// FlowMonitor has not stopped monitoring yet, you should call
     /// CheckForLostPackets() to make sure all possibly lost packets are
@@ -277,6 +308,27 @@ class FlowMonitor : public Object
     /// Reset all the statistics
     void ResetAllStats();
 
+    /// Format of the flow statistics snapshots
+    enum SnapshotFormat
+    {
+        CSV,   //!< One text line per flow
+        BINARY //!< Fixed size binary records
+    };
+
+    /// Periodically write the statistics of the flows that changed since
+    /// the previous snapshot to a file. A snapshot is also written when the
+    /// monitoring stops and when the FlowMonitor is disposed. This method
+    /// overwrites any previous call.
+    /// \param fileName name or path of the output file that will be created
+    /// \param interval time between two snapshots
+    /// \param format format of the output file
+    void EnableSnapshots(std::string fileName, Time interval, SnapshotFormat format = CSV);
+
+    /// Write right now the statistics of the flows that changed since the
+    /// previous snapshot. Does nothing if the snapshots are not enabled or
+    /// if no flow changed.
+    void WriteSnapshot();
+
   protected:
     void NotifyConstructionCompleted() override;
     void DoDispose() override;
@@ -290,11 +342,22 @@ class FlowMonitor : public Object
         uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
     };
 
+    /// Entry of the FlowStats index
+    struct FlowEntry
+    {
+        FlowStats* stats; //!< the stats of the flow, nullptr if not seen yet
+        bool changed;     //!< the stats changed since the last snapshot
+    };
+
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
+    /// FlowStats of m_flowStats, indexed by FlowId
+    std::vector<FlowEntry> m_flowIndex;
+    /// Flows changed since the last snapshot
+    std::vector<FlowId> m_changedFlows;
 
-    /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+    /// (FlowId,PacketId) --> TrackedPacket, with the FlowId in the upper 32 bits of the key
+    typedef std::unordered_map<uint64_t, TrackedPacket> TrackedPacketMap;
     TrackedPacketMap m_trackedPackets; //!< Tracked packets
     Time m_maxPerHopDelay;             //!< Minimum per-hop delay
     FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
@@ -310,14 +373,38 @@ class FlowMonitor : public Object
     double m_packetSizeBinWidth;        //!< packet size bin width (for histograms)
     double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
     Time m_flowInterruptionsMinTime;    //!< Flow interruptions minimum time
+    uint8_t m_histogramPrecision;       //!< Precision of logarithmic histograms, 0 if linear
+
+    Ptr<OutputStreamWrapper> m_snapshotStream; //!< Snapshot output, if enabled
+    SnapshotFormat m_snapshotFormat;           //!< Snapshot format
+    Time m_snapshotInterval;                   //!< Time between two snapshots
+    EventId m_snapshotEvent;                   //!< Next periodic snapshot
 
     /// Get the stats for a given flow
     /// \param flowId the Flow identification
     /// \returns the stats of the flow
     FlowStats& GetStatsForFlow(FlowId flowId);
 
+    /// Create an empty histogram with the configured bins
+    /// \param binWidth the bin width, or the width of the narrowest logarithmic bins
+    /// \returns the histogram
+    Histogram CreateHistogram(double binWidth) const;
+
+    /// Record that the stats of a flow changed since the last snapshot
+    /// \param flowId the Flow identification
+    void MarkChanged(FlowId flowId);
+
+    /// Get the key of a tracked packet
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet identification
+    /// \returns the key of the packet in m_trackedPackets
+    static uint64_t GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId);
+
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
+
+    /// Periodic function to write the snapshots
+    void PeriodicSnapshot();
 };
 
 } // namespace ns3
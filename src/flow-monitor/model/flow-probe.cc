@@ -52,10 +52,24 @@ FlowProbe::DoDispose()
     Object::DoDispose();
 }
 
+FlowProbe::FlowStats&
+FlowProbe::GetStatsForFlow(FlowId flowId)
+{
+    if (flowId >= m_statsIndex.size())
+    {
+        m_statsIndex.resize(flowId + 1, nullptr);
+    }
+    if (m_statsIndex[flowId] == nullptr)
+    {
+        m_statsIndex[flowId] = &m_stats[flowId];
+    }
+    return *m_statsIndex[flowId];
+}
+
 void
 FlowProbe::AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirstProbe)
 {
-    FlowStats& flow = m_stats[flowId];
+    FlowStats& flow = GetStatsForFlow(flowId);
     flow.delayFromFirstProbeSum += delayFromFirstProbe;
     flow.bytes += packetSize;
     ++flow.packets;
@@ -64,7 +78,7 @@ FlowProbe::AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirs
 void
 FlowProbe::AddPacketDropStats(FlowId flowId, uint32_t packetSize, uint32_t reasonCode)
 {
-    FlowStats& flow = m_stats[flowId];
+    FlowStats& flow = GetStatsForFlow(flowId);
 
     if (flow.packetsDropped.size() < reasonCode + 1)
     {
@@ -108,6 +108,14 @@ class FlowProbe : public Object
   protected:
     Ptr<FlowMonitor> m_flowMonitor; //!< the FlowMonitor instance
     Stats m_stats;                  //!< The flow stats
+
+  private:
+    /// Get the stats of a flow, adding them if needed
+    /// \param flowId the flow Identifier
+    /// \returns the stats of the flow
+    FlowStats& GetStatsForFlow(FlowId flowId);
+
+    std::vector<FlowStats*> m_statsIndex; //!< The flow stats of m_stats, indexed by FlowId
 };
 
 } // namespace ns3
@@ -24,8 +24,10 @@
 
 #include "ns3/ipv4-header.h"
 
-#include <map>
+#include <array>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -93,12 +95,26 @@ class Ipv4FlowClassifier : public FlowClassifier
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
   private:
+    /// Hash function of the FiveTuples
+    struct FiveTupleHash
+    {
+        /// \param tuple the FiveTuple
+        /// \return the hash of the FiveTuple
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
+    /// A flow seen by the classifier
+    struct Flow
+    {
+        FiveTuple tuple;                     //!< The FiveTuple of the flow
+        FlowPacketId lastPacketId;           //!< The FlowPacketId of the last packet
+        std::array<uint32_t, 64> dscpCounts; //!< The number of packets, by DSCP value
+    };
+
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
-    /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-    /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>> m_flowDscpMap;
+    std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+    /// The flows, indexed by FlowId - 1 (the FlowIds are allocated in sequence)
+    std::vector<Flow> m_flows;
 };
 
 /**
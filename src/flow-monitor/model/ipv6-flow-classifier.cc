@@ -92,6 +92,17 @@ operator==(const Ipv6FlowClassifier::FiveTuple& t1, const Ipv6FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
+std::size_t
+Ipv6FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    Ipv6AddressHash addressHash;
+    uint64_t ports = (uint64_t(tuple.protocol) << 32) | (uint32_t(tuple.sourcePort) << 16) |
+                     tuple.destinationPort;
+    uint64_t hash = addressHash(tuple.sourceAddress) * 0x9e3779b97f4a7c15ULL;
+    hash = (hash ^ addressHash(tuple.destinationAddress)) * 0x9e3779b97f4a7c15ULL ^ ports;
+    return hash ^ (hash >> 32);
+}
+
 Ipv6FlowClassifier::Ipv6FlowClassifier()
 {
 }
@@ -149,31 +160,26 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
     auto insert = m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
 
     // if the insertion succeeded, we need to assign this tuple a new flow identifier
+    Flow* flow;
     if (insert.second)
     {
         FlowId newFlowId = GetNewFlowId();
         insert.first->second = newFlowId;
-        m_flowPktIdMap[newFlowId] = 0;
-        m_flowDscpMap[newFlowId];
+        NS_ASSERT_MSG(newFlowId == m_flows.size() + 1, "FlowIds not allocated in sequence");
+        m_flows.push_back(Flow{tuple, 0, {}});
+        flow = &m_flows.back();
     }
     else
     {
-        m_flowPktIdMap[insert.first->second]++;
+        flow = &m_flows[insert.first->second - 1];
+        flow->lastPacketId++;
     }
 
     // increment the counter of packets with the same DSCP value
-    Ipv6Header::DscpType dscp = ipHeader.GetDscp();
-    auto dscpInserter = m_flowDscpMap[insert.first->second].insert(
-        std::pair<Ipv6Header::DscpType, uint32_t>(dscp, 1));
-
-    // if the insertion did not succeed, we need to increment the counter
-    if (!dscpInserter.second)
-    {
-        m_flowDscpMap[insert.first->second][dscp]++;
-    }
+    flow->dscpCounts[ipHeader.GetDscp()]++;
 
     *out_flowId = insert.first->second;
-    *out_packetId = m_flowPktIdMap[*out_flowId];
+    *out_packetId = flow->lastPacketId;
 
     return true;
 }
@@ -181,12 +187,9 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow(FlowId flowId) const
 {
-    for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
+    if (flowId > 0 && flowId <= m_flows.size())
     {
-        if (iter->second == flowId)
-        {
-            return iter->first;
-        }
+        return m_flows[flowId - 1].tuple;
     }
     NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     FiveTuple retval = {Ipv6Address::GetZero(), Ipv6Address::GetZero(), 0, 0, 0};
@@ -203,15 +206,20 @@ Ipv6FlowClassifier::SortByCount::operator()(std::pair<Ipv6Header::DscpType, uint
 std::vector<std::pair<Ipv6Header::DscpType, uint32_t>>
 Ipv6FlowClassifier::GetDscpCounts(FlowId flowId) const
 {
-    auto flow = m_flowDscpMap.find(flowId);
-
-    if (flow == m_flowDscpMap.end())
+    if (flowId == 0 || flowId > m_flows.size())
     {
         NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     }
 
-    std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> v(flow->second.begin(),
-                                                             flow->second.end());
+    std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> v;
+    const auto& counts = m_flows[flowId - 1].dscpCounts;
+    for (uint32_t dscp = 0; dscp < counts.size(); dscp++)
+    {
+        if (counts[dscp] > 0)
+        {
+            v.emplace_back(static_cast<Ipv6Header::DscpType>(dscp), counts[dscp]);
+        }
+    }
     std::sort(v.begin(), v.end(), SortByCount());
     return v;
 }
@@ -222,27 +230,37 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     Indent(os, indent);
     os << "<Ipv6FlowClassifier>\n";
 
+    // list the flows in the order of their FiveTuples
+    std::vector<const Flow*> flows;
+    for (const auto& flow : m_flows)
+    {
+        flows.push_back(&flow);
+    }
+    std::sort(flows.begin(), flows.end(), [](const Flow* a, const Flow* b) {
+        return a->tuple < b->tuple;
+    });
+
     indent += 2;
-    for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
+    for (auto iter = flows.begin(); iter != flows.end(); iter++)
     {
+        const FiveTuple& tuple = (*iter)->tuple;
         Indent(os, indent);
-        os << "<Flow flowId=\"" << iter->second << "\""
-           << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-           << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-           << " protocol=\"" << int(iter->first.protocol) << "\""
-           << " sourcePort=\"" << iter->first.sourcePort << "\""
-           << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
+        os << "<Flow flowId=\"" << (*iter - m_flows.data()) + 1 << "\""
+           << " sourceAddress=\"" << tuple.sourceAddress << "\""
+           << " destinationAddress=\"" << tuple.destinationAddress << "\""
+           << " protocol=\"" << int(tuple.protocol) << "\""
+           << " sourcePort=\"" << tuple.sourcePort << "\""
+           << " destinationPort=\"" << tuple.destinationPort << "\">\n";
 
         indent += 2;
-        auto flow = m_flowDscpMap.find(iter->second);
-
-        if (flow != m_flowDscpMap.end())
+        const auto& counts = (*iter)->dscpCounts;
+        for (uint32_t dscp = 0; dscp < counts.size(); dscp++)
         {
-            for (auto i = flow->second.begin(); i != flow->second.end(); i++)
+            if (counts[dscp] > 0)
             {
                 Indent(os, indent);
-                os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(i->first) << "\""
-                   << " packets=\"" << std::dec << i->second << "\" />\n";
+                os << "<Dscp value=\"0x" << std::hex << dscp << "\""
+                   << " packets=\"" << std::dec << counts[dscp] << "\" />\n";
             }
         }
 
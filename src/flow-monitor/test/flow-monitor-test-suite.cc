@@ -0,0 +1,419 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv6-flow-classifier.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor
+ * \defgroup flow-monitor-test FlowMonitor module tests
+ */
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief A FlowProbe reporting the packets given by the test cases.
+ */
+class TestFlowProbe : public FlowProbe
+{
+  public:
+    /**
+     * \param monitor the FlowMonitor the probe reports to
+     */
+    TestFlowProbe(Ptr<FlowMonitor> monitor)
+        : FlowProbe(monitor)
+    {
+    }
+};
+
+/**
+ * Create the IP payload of a TCP or UDP packet.
+ *
+ * \param sourcePort the source port
+ * \param destinationPort the destination port
+ * \return the payload, whose first four bytes are the ports
+ */
+static Ptr<Packet>
+CreatePayload(uint16_t sourcePort, uint16_t destinationPort)
+{
+    uint8_t buffer[100] = {static_cast<uint8_t>(sourcePort >> 8),
+                           static_cast<uint8_t>(sourcePort & 0xff),
+                           static_cast<uint8_t>(destinationPort >> 8),
+                           static_cast<uint8_t>(destinationPort & 0xff)};
+    return Create<Packet>(buffer, sizeof(buffer));
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Flow classifier and XML output test.
+ *
+ * Classifies IPv4 and IPv6 packets of a few flows, checks the FlowIds,
+ * FlowPacketIds, FiveTuples and DSCP counts of the flows, and compares the
+ * XML output of a FlowMonitor with its expected content.
+ */
+class FlowClassifierTestCase : public TestCase
+{
+  public:
+    FlowClassifierTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FlowClassifierTestCase::FlowClassifierTestCase()
+    : TestCase("Flow classifiers and XML output")
+{
+}
+
+void
+FlowClassifierTestCase::DoRun()
+{
+    Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier>();
+    uint32_t flowId = 0;
+    uint32_t packetId = 0;
+    auto classify = [&](const char* source,
+                        uint8_t protocol,
+                        uint16_t sourcePort,
+                        uint16_t destinationPort,
+                        Ipv4Header::DscpType dscp,
+                        uint16_t fragmentOffset = 0) {
+        Ipv4Header header;
+        header.SetSource(Ipv4Address(source));
+        header.SetDestination(Ipv4Address("10.0.0.2"));
+        header.SetProtocol(protocol);
+        header.SetDscp(dscp);
+        header.SetFragmentOffset(fragmentOffset);
+        return classifier->Classify(header,
+                                    CreatePayload(sourcePort, destinationPort),
+                                    &flowId,
+                                    &packetId);
+    };
+
+    // the FlowIds are allocated in order of arrival, the FlowPacketIds per flow
+    NS_TEST_EXPECT_MSG_EQ(classify("10.0.0.3", 17, 49153, 9, Ipv4Header::DSCP_AF11),
+                          true,
+                          "Packet not classified");
+    NS_TEST_EXPECT_MSG_EQ(flowId, 1, "Wrong FlowId of the first flow");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 0, "Wrong FlowPacketId of the first packet");
+    NS_TEST_EXPECT_MSG_EQ(classify("10.0.0.1", 6, 1000, 80, Ipv4Header::DscpDefault),
+                          true,
+                          "Packet not classified");
+    NS_TEST_EXPECT_MSG_EQ(flowId, 2, "Wrong FlowId of a new flow");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 0, "Wrong FlowPacketId of the first packet");
+    NS_TEST_EXPECT_MSG_EQ(classify("10.0.0.3", 17, 49153, 9, Ipv4Header::DSCP_AF11),
+                          true,
+                          "Packet not classified");
+    NS_TEST_EXPECT_MSG_EQ(flowId, 1, "Wrong FlowId of a known flow");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 1, "Wrong FlowPacketId of the second packet");
+    NS_TEST_EXPECT_MSG_EQ(classify("10.0.0.3", 17, 49153, 9, Ipv4Header::DSCP_EF),
+                          true,
+                          "Packet not classified");
+    NS_TEST_EXPECT_MSG_EQ(flowId, 1, "Wrong FlowId of a packet with another DSCP");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 2, "Wrong FlowPacketId of the third packet");
+    NS_TEST_EXPECT_MSG_EQ(classify("10.0.0.3", 1, 49153, 9, Ipv4Header::DscpDefault),
+                          false,
+                          "ICMP packet classified");
+    NS_TEST_EXPECT_MSG_EQ(classify("10.0.0.3", 17, 49153, 9, Ipv4Header::DscpDefault, 8),
+                          false,
+                          "Fragment classified");
+
+    Ipv4FlowClassifier::FiveTuple tuple = classifier->FindFlow(1);
+    NS_TEST_EXPECT_MSG_EQ(tuple.sourceAddress, Ipv4Address("10.0.0.3"), "Wrong source address");
+    NS_TEST_EXPECT_MSG_EQ(tuple.destinationAddress,
+                          Ipv4Address("10.0.0.2"),
+                          "Wrong destination address");
+    NS_TEST_EXPECT_MSG_EQ(uint32_t(tuple.protocol), 17, "Wrong protocol");
+    NS_TEST_EXPECT_MSG_EQ(tuple.sourcePort, 49153, "Wrong source port");
+    NS_TEST_EXPECT_MSG_EQ(tuple.destinationPort, 9, "Wrong destination port");
+    NS_TEST_EXPECT_MSG_EQ(classifier->FindFlow(2).sourcePort, 1000, "Wrong source port");
+
+    auto dscpCounts = classifier->GetDscpCounts(1);
+    NS_TEST_ASSERT_MSG_EQ(dscpCounts.size(), 2, "Wrong number of DSCP values");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[0].first, Ipv4Header::DSCP_AF11, "Wrong DSCP order");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[0].second, 2, "Wrong DSCP count");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[1].first, Ipv4Header::DSCP_EF, "Wrong DSCP order");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[1].second, 1, "Wrong DSCP count");
+    NS_TEST_EXPECT_MSG_EQ(classifier->GetDscpCounts(2).size(), 1, "Wrong number of DSCP values");
+
+    Ptr<Ipv6FlowClassifier> classifier6 = Create<Ipv6FlowClassifier>();
+    Ipv6Header header6;
+    header6.SetSource(Ipv6Address("2001:db8::1"));
+    header6.SetDestination(Ipv6Address("2001:db8::2"));
+    header6.SetNextHeader(17);
+    header6.SetDscp(Ipv6Header::DSCP_AF21);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(
+            classifier6->Classify(header6, CreatePayload(5000, 6000), &flowId, &packetId),
+            true,
+            "IPv6 packet not classified");
+        NS_TEST_EXPECT_MSG_EQ(flowId, 1, "Wrong IPv6 FlowId");
+        NS_TEST_EXPECT_MSG_EQ(packetId, i, "Wrong IPv6 FlowPacketId");
+    }
+    NS_TEST_EXPECT_MSG_EQ(classifier6->FindFlow(1).destinationAddress,
+                          Ipv6Address("2001:db8::2"),
+                          "Wrong IPv6 destination address");
+    NS_TEST_EXPECT_MSG_EQ(classifier6->FindFlow(1).destinationPort, 6000, "Wrong IPv6 port");
+    auto dscpCounts6 = classifier6->GetDscpCounts(1);
+    NS_TEST_ASSERT_MSG_EQ(dscpCounts6.size(), 1, "Wrong number of IPv6 DSCP values");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts6[0].first, Ipv6Header::DSCP_AF21, "Wrong IPv6 DSCP");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts6[0].second, 3, "Wrong IPv6 DSCP count");
+
+    // the XML output lists the flows of the classifier in the order of their FiveTuples
+    Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor>();
+    monitor->AddFlowClassifier(classifier);
+    Ptr<TestFlowProbe> probe = CreateObject<TestFlowProbe>(monitor);
+    monitor->StartRightNow();
+    monitor->ReportFirstTx(probe, 1, 0, 100);
+    monitor->ReportFirstTx(probe, 2, 0, 200);
+    Simulator::Schedule(Seconds(0.5), &FlowMonitor::ReportLastRx, monitor, probe, 1, 0, 100);
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+
+    std::ostringstream xml;
+    monitor->SerializeToXmlStream(xml, 0, true, true);
+    std::string expected =
+        "<FlowMonitor>\n"
+        "  <FlowStats>\n"
+        "    <Flow flowId=\"1\" timeFirstTxPacket=\"+0ns\" timeFirstRxPacket=\"+5e+08ns\" "
+        "timeLastTxPacket=\"+0ns\" timeLastRxPacket=\"+5e+08ns\" delaySum=\"+5e+08ns\" "
+        "jitterSum=\"+0ns\" lastDelay=\"+5e+08ns\" txBytes=\"100\" rxBytes=\"100\" "
+        "txPackets=\"1\" rxPackets=\"1\" lostPackets=\"0\" timesForwarded=\"0\">\n"
+        "      <delayHistogram nBins=\"501\" >\n"
+        "        <bin index=\"500\" start=\"0.5\" width=\"0.001\" count=\"1\" />\n"
+        "      </delayHistogram>\n"
+        "      <jitterHistogram nBins=\"0\" >\n"
+        "      </jitterHistogram>\n"
+        "      <packetSizeHistogram nBins=\"6\" >\n"
+        "        <bin index=\"5\" start=\"100\" width=\"20\" count=\"1\" />\n"
+        "      </packetSizeHistogram>\n"
+        "      <flowInterruptionsHistogram nBins=\"0\" >\n"
+        "      </flowInterruptionsHistogram>\n"
+        "    </Flow>\n"
+        "    <Flow flowId=\"2\" timeFirstTxPacket=\"+0ns\" timeFirstRxPacket=\"+0ns\" "
+        "timeLastTxPacket=\"+0ns\" timeLastRxPacket=\"+0ns\" delaySum=\"+0ns\" "
+        "jitterSum=\"+0ns\" lastDelay=\"+0ns\" txBytes=\"200\" rxBytes=\"0\" "
+        "txPackets=\"1\" rxPackets=\"0\" lostPackets=\"0\" timesForwarded=\"0\">\n"
+        "      <delayHistogram nBins=\"0\" >\n"
+        "      </delayHistogram>\n"
+        "      <jitterHistogram nBins=\"0\" >\n"
+        "      </jitterHistogram>\n"
+        "      <packetSizeHistogram nBins=\"0\" >\n"
+        "      </packetSizeHistogram>\n"
+        "      <flowInterruptionsHistogram nBins=\"0\" >\n"
+        "      </flowInterruptionsHistogram>\n"
+        "    </Flow>\n"
+        "  </FlowStats>\n"
+        "  <Ipv4FlowClassifier>\n"
+        "    <Flow flowId=\"2\" sourceAddress=\"10.0.0.1\" destinationAddress=\"10.0.0.2\" "
+        "protocol=\"6\" sourcePort=\"1000\" destinationPort=\"80\">\n"
+        "      <Dscp value=\"0x0\" packets=\"1\" />\n"
+        "    </Flow>\n"
+        "    <Flow flowId=\"1\" sourceAddress=\"10.0.0.3\" destinationAddress=\"10.0.0.2\" "
+        "protocol=\"17\" sourcePort=\"49153\" destinationPort=\"9\">\n"
+        "      <Dscp value=\"0xa\" packets=\"2\" />\n"
+        "      <Dscp value=\"0x2e\" packets=\"1\" />\n"
+        "    </Flow>\n"
+        "  </Ipv4FlowClassifier>\n"
+        "  <FlowProbes>\n"
+        "    <FlowProbe index=\"0\">\n"
+        "      <FlowStats  flowId=\"1\" packets=\"2\" bytes=\"200\" "
+        "delayFromFirstProbeSum=\"+5e+08ns\" >\n"
+        "      </FlowStats>\n"
+        "      <FlowStats  flowId=\"2\" packets=\"1\" bytes=\"200\" "
+        "delayFromFirstProbeSum=\"+0ns\" >\n"
+        "      </FlowStats>\n"
+        "    </FlowProbe>\n"
+        "  </FlowProbes>\n"
+        "</FlowMonitor>\n";
+    NS_TEST_EXPECT_MSG_EQ(xml.str(), expected, "Unexpected XML output");
+
+    monitor->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Flow statistics snapshots test.
+ *
+ * Reports the packets of two flows to a FlowMonitor writing a snapshot every
+ * second, in CSV or binary format, and checks that each snapshot holds the
+ * flows that changed since the previous one, in FlowId order, that no
+ * snapshot is written when no flow changed, and that a last snapshot is
+ * written when the monitoring stops.
+ */
+class FlowMonitorSnapshotTestCase : public TestCase
+{
+  public:
+    /**
+     * \param format the format of the snapshots
+     */
+    FlowMonitorSnapshotTestCase(FlowMonitor::SnapshotFormat format);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check the CSV snapshots.
+     * \param fileName the name of the snapshot file
+     */
+    void CheckCsv(std::string fileName);
+
+    /**
+     * Check the binary snapshots.
+     * \param fileName the name of the snapshot file
+     */
+    void CheckBinary(std::string fileName);
+
+    FlowMonitor::SnapshotFormat m_format; //!< the format of the snapshots
+};
+
+FlowMonitorSnapshotTestCase::FlowMonitorSnapshotTestCase(FlowMonitor::SnapshotFormat format)
+    : TestCase(format == FlowMonitor::CSV ? "CSV snapshots" : "Binary snapshots"),
+      m_format(format)
+{
+}
+
+void
+FlowMonitorSnapshotTestCase::DoRun()
+{
+    std::string fileName = CreateTempDirFilename("flow-monitor-snapshots");
+    Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor>();
+    Ptr<TestFlowProbe> probe = CreateObject<TestFlowProbe>(monitor);
+    monitor->StartRightNow();
+    monitor->EnableSnapshots(fileName, Seconds(1), m_format);
+
+    // flows 1 and 2 change before the snapshot at 1s, flow 2 before the ones
+    // at 2s and 3.5s (when the monitoring stops), and none before the one at 3s
+    Simulator::Schedule(Seconds(0.5), &FlowMonitor::ReportFirstTx, monitor, probe, 2, 0, 100);
+    Simulator::Schedule(Seconds(0.5), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 0, 100);
+    Simulator::Schedule(Seconds(0.6), &FlowMonitor::ReportLastRx, monitor, probe, 1, 0, 100);
+    Simulator::Schedule(Seconds(1.5), &FlowMonitor::ReportFirstTx, monitor, probe, 2, 1, 100);
+    Simulator::Schedule(Seconds(3.2), &FlowMonitor::ReportLastRx, monitor, probe, 2, 1, 100);
+    Simulator::Schedule(Seconds(3.5), &FlowMonitor::StopRightNow, monitor);
+    Simulator::Stop(Seconds(4.5));
+    Simulator::Run();
+    monitor->Dispose();
+    Simulator::Destroy();
+
+    if (m_format == FlowMonitor::CSV)
+    {
+        CheckCsv(fileName);
+    }
+    else
+    {
+        CheckBinary(fileName);
+    }
+}
+
+void
+FlowMonitorSnapshotTestCase::CheckCsv(std::string fileName)
+{
+    std::ifstream file(fileName);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        lines.push_back(line);
+    }
+    NS_TEST_ASSERT_MSG_EQ(lines.size(), 5, "Wrong number of lines");
+    NS_TEST_EXPECT_MSG_EQ(lines[0].substr(0, 19), "time,flowId,txBytes", "Wrong header line");
+    NS_TEST_EXPECT_MSG_EQ(lines[1],
+                          "1000000000,1,100,100,1,1,0,0,100000000,0,100000000,500000000,"
+                          "600000000,500000000,600000000",
+                          "Wrong line of flow 1 at 1s");
+    NS_TEST_EXPECT_MSG_EQ(lines[2],
+                          "1000000000,2,100,0,1,0,0,0,0,0,0,500000000,0,500000000,0",
+                          "Wrong line of flow 2 at 1s");
+    NS_TEST_EXPECT_MSG_EQ(lines[3],
+                          "2000000000,2,200,0,2,0,0,0,0,0,0,500000000,0,1500000000,0",
+                          "Wrong line of flow 2 at 2s");
+    NS_TEST_EXPECT_MSG_EQ(lines[4],
+                          "3500000000,2,200,100,2,1,0,0,1700000000,0,1700000000,500000000,"
+                          "3200000000,1500000000,3200000000",
+                          "Wrong line of flow 2 at 3.5s");
+}
+
+void
+FlowMonitorSnapshotTestCase::CheckBinary(std::string fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    auto read = [&file](auto& value) {
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return file.good();
+    };
+
+    const int64_t times[] = {1000000000, 2000000000, 3500000000};
+    const std::vector<uint32_t> flows[] = {{1, 2}, {2}, {2}};
+    const std::vector<uint32_t> txPackets[] = {{1, 1}, {2}, {2}};
+    for (uint32_t snapshot = 0; snapshot < 3; snapshot++)
+    {
+        int64_t time = 0;
+        uint32_t nFlows = 0;
+        NS_TEST_ASSERT_MSG_EQ((read(time) && read(nFlows)), true, "Snapshot missing");
+        NS_TEST_EXPECT_MSG_EQ(time, times[snapshot], "Wrong snapshot time");
+        NS_TEST_ASSERT_MSG_EQ(nFlows, flows[snapshot].size(), "Wrong number of flows");
+        for (uint32_t i = 0; i < nFlows; i++)
+        {
+            uint32_t counters[5];
+            uint64_t bytes[2];
+            int64_t timestamps[7];
+            NS_TEST_ASSERT_MSG_EQ((read(counters) && read(bytes) && read(timestamps)),
+                                  true,
+                                  "Truncated flow record");
+            NS_TEST_EXPECT_MSG_EQ(counters[0], flows[snapshot][i], "Wrong FlowId");
+            NS_TEST_EXPECT_MSG_EQ(counters[1],
+                                  txPackets[snapshot][i],
+                                  "Wrong number of transmitted packets");
+            NS_TEST_EXPECT_MSG_EQ(bytes[0], 100 * counters[1], "Wrong number of transmitted bytes");
+        }
+    }
+    char byte;
+    file.read(&byte, 1);
+    NS_TEST_EXPECT_MSG_EQ(file.eof(), true, "Unexpected data after the last snapshot");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief FlowMonitor TestSuite
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+  public:
+    FlowMonitorTestSuite();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite()
+    : TestSuite("flow-monitor", UNIT)
+{
+    AddTestCase(new FlowClassifierTestCase, TestCase::QUICK);
+    AddTestCase(new FlowMonitorSnapshotTestCase(FlowMonitor::CSV), TestCase::QUICK);
+    AddTestCase(new FlowMonitorSnapshotTestCase(FlowMonitor::BINARY), TestCase::QUICK);
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite; //!< Static variable for test initialization
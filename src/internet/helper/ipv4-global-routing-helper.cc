@@ -67,9 +67,19 @@ Ipv4GlobalRoutingHelper::PopulateRoutingTables()
 void
 Ipv4GlobalRoutingHelper::RecomputeRoutingTables()
 {
-    GlobalRouteManager::DeleteGlobalRoutes();
-    GlobalRouteManager::BuildGlobalRoutingDatabase();
-    GlobalRouteManager::InitializeRoutes();
+    GlobalRouteManager::UpdateRoutes();
+}
+
+void
+Ipv4GlobalRoutingHelper::SetNThreads(uint32_t nThreads)
+{
+    GlobalRouteManager::SetNThreads(nThreads);
+}
+
+void
+Ipv4GlobalRoutingHelper::SetIncremental(bool incremental)
+{
+    GlobalRouteManager::SetIncremental(incremental);
 }
 
 } // namespace ns3
@@ -87,8 +87,34 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      * Users must first call PopulateRoutingTables() and then may subsequently
      * call RecomputeRoutingTables() at any later time in the simulation.
      *
+     * With incremental updates, only the routes of the nodes affected by the
+     * changes of the topology are recomputed.
      */
     static void RecomputeRoutingTables();
+
+    /**
+     * \brief Set the number of threads on which the routes of the nodes are
+     * computed.
+     *
+     * The routing tables do not depend on the number of threads.
+     *
+     * \param nThreads the number of threads (default 1)
+     */
+    static void SetNThreads(uint32_t nThreads);
+
+    /**
+     * \brief Enable or disable the incremental updates of the routes.
+     *
+     * When enabled, the shortest path tree of each node is kept after
+     * PopulateRoutingTables(), and RecomputeRoutingTables() and the interface
+     * and address notifications only update the nodes whose routes may have
+     * changed.  The trees take memory in the order of the square of the
+     * number of nodes.  Must be called before PopulateRoutingTables().
+     *
+     * \param incremental whether the routing tables are updated incrementally
+     * (default false)
+     */
+    static void SetIncremental(bool incremental);
 };
 
 } // namespace ns3
@@ -22,6 +22,7 @@
 #include "ipv4-interface.h"
 
 #include "ns3/assert.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/node.h"
@@ -30,6 +31,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -75,6 +78,14 @@ ArpCache::GetTypeId()
                                           UintegerValue(3),
                                           MakeUintegerAccessor(&ArpCache::m_pendingQueueSize),
                                           MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("RemoveExpiredEntries",
+                                          "Remove the alive and dead entries from the cache "
+                                          "once they have expired. An expired alive entry "
+                                          "is then resolved again, rather than refreshed "
+                                          "when a packet is received from its address.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&ArpCache::m_removeExpired),
+                                          MakeBooleanChecker())
                             .AddTraceSource("Drop",
                                             "Packet dropped due to ArpCache entry "
                                             "in WaitReply expiring.",
@@ -85,7 +96,8 @@ ArpCache::GetTypeId()
 
 ArpCache::ArpCache()
     : m_device(nullptr),
-      m_interface(nullptr)
+      m_interface(nullptr),
+      m_waitReplyTime(Time::Max())
 {
     NS_LOG_FUNCTION(this);
 }
@@ -102,10 +114,6 @@ ArpCache::DoDispose()
     Flush();
     m_device = nullptr;
     m_interface = nullptr;
-    if (!m_waitReplyTimer.IsRunning())
-    {
-        m_waitReplyTimer.Cancel();
-    }
     Object::DoDispose();
 }
 
@@ -184,13 +192,60 @@ void
 ArpCache::StartWaitReplyTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (!m_waitReplyTimer.IsRunning())
+    if (m_waitReplyTime == Time::Max())
     {
         NS_LOG_LOGIC("Starting WaitReplyTimer at " << Simulator::Now() << " for "
                                                    << m_waitReplyTimeout);
-        m_waitReplyTimer =
-            Simulator::Schedule(m_waitReplyTimeout, &ArpCache::HandleWaitReplyTimeout, this);
+        m_waitReplyTime = Simulator::Now() + m_waitReplyTimeout;
+        ScheduleSweep();
+    }
+}
+
+void
+ArpCache::ScheduleSweep()
+{
+    NS_LOG_FUNCTION(this);
+    Time next = m_waitReplyTime;
+    if (!m_expiries.empty())
+    {
+        next = std::min(next, m_expiries.begin()->first);
+    }
+    if (next == Time::Max() || (m_sweepEvent.IsRunning() && m_sweepTime <= next))
+    {
+        // an early sweep finds nothing to do and schedules the next one
+        return;
     }
+    m_sweepEvent.Cancel();
+    m_sweepTime = next;
+    m_sweepEvent = Simulator::Schedule(next - Simulator::Now(), &ArpCache::Sweep, this);
+}
+
+void
+ArpCache::Sweep()
+{
+    NS_LOG_FUNCTION(this);
+    Time now = Simulator::Now();
+    if (m_waitReplyTime <= now)
+    {
+        m_waitReplyTime = Time::Max();
+        HandleWaitReplyTimeout();
+    }
+    while (!m_expiries.empty() && m_expiries.begin()->first <= now)
+    {
+        ArpCache::Entry* entry = m_expiries.begin()->second;
+        entry->CancelExpiry();
+        if (entry->IsExpired())
+        {
+            NS_LOG_LOGIC("Removing expired entry for " << entry->GetIpv4Address());
+            Remove(entry);
+        }
+        else
+        {
+            // the entry has been seen since it was scheduled
+            entry->ScheduleExpiry();
+        }
+    }
+    ScheduleSweep();
 }
 
 void
@@ -199,9 +254,10 @@ ArpCache::HandleWaitReplyTimeout()
     NS_LOG_FUNCTION(this);
     ArpCache::Entry* entry;
     bool restartWaitReplyTimer = false;
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    for (auto i = m_waitReply.begin(); i != m_waitReply.end();)
     {
-        entry = (*i).second;
+        // the entries marked dead leave m_waitReply
+        entry = (i++)->second;
         if (entry != nullptr && entry->IsWaitReply())
         {
             if (entry->GetRetries() < m_maxRetries)
@@ -236,8 +292,7 @@ ArpCache::HandleWaitReplyTimeout()
     if (restartWaitReplyTimer)
     {
         NS_LOG_LOGIC("Restarting WaitReplyTimer at " << Simulator::Now().GetSeconds());
-        m_waitReplyTimer =
-            Simulator::Schedule(m_waitReplyTimeout, &ArpCache::HandleWaitReplyTimeout, this);
+        m_waitReplyTime = Simulator::Now() + m_waitReplyTimeout;
     }
 }
 
@@ -250,12 +305,13 @@ ArpCache::Flush()
         delete (*i).second;
     }
     m_arpCache.erase(m_arpCache.begin(), m_arpCache.end());
-    if (m_waitReplyTimer.IsRunning())
+    if (m_waitReplyTime != Time::Max())
     {
         NS_LOG_LOGIC("Stopping WaitReplyTimer at " << Simulator::Now().GetSeconds()
                                                    << " due to ArpCache flush");
-        m_waitReplyTimer.Cancel();
+        m_waitReplyTime = Time::Max();
     }
+    m_sweepEvent.Cancel();
 }
 
 void
@@ -264,7 +320,9 @@ ArpCache::PrintArpCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // print the entries in address order
+    std::map<Ipv4Address, ArpCache::Entry*> entries(m_arpCache.begin(), m_arpCache.end());
+    for (auto i = entries.begin(); i != entries.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -333,6 +391,9 @@ ArpCache::LookupInverse(Address to)
             entryList.push_back(entry);
         }
     }
+    entryList.sort([](ArpCache::Entry* a, ArpCache::Entry* b) {
+        return a->GetIpv4Address() < b->GetIpv4Address();
+    });
     return entryList;
 }
 
@@ -365,15 +426,20 @@ ArpCache::Remove(ArpCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    auto i = m_arpCache.find(entry->GetIpv4Address());
+    if (i == m_arpCache.end() || i->second != entry)
     {
-        if ((*i).second == entry)
-        {
-            m_arpCache.erase(i);
-            entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
-            delete entry;
-            return;
-        }
+        // the address of the entry has been changed
+        i = std::find_if(m_arpCache.begin(), m_arpCache.end(), [entry](const auto& item) {
+            return item.second == entry;
+        });
+    }
+    if (i != m_arpCache.end())
+    {
+        m_arpCache.erase(i);
+        entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
+        delete entry;
+        return;
     }
     NS_LOG_WARN("Entry not found in this ARP Cache");
 }
@@ -381,11 +447,19 @@ ArpCache::Remove(ArpCache::Entry* entry)
 ArpCache::Entry::Entry(ArpCache* arp)
     : m_arp(arp),
       m_state(ALIVE),
-      m_retries(0)
+      m_retries(0),
+      m_expiry(arp->m_expiries.end())
 {
     NS_LOG_FUNCTION(this << arp);
 }
 
+ArpCache::Entry::~Entry()
+{
+    NS_LOG_FUNCTION(this);
+    SetState(DEAD);
+    CancelExpiry();
+}
+
 bool
 ArpCache::Entry::IsDead()
 {
@@ -426,9 +500,10 @@ ArpCache::Entry::MarkDead()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(m_state == ALIVE || m_state == WAIT_REPLY || m_state == DEAD);
-    m_state = DEAD;
+    SetState(DEAD);
     ClearRetries();
     UpdateSeen();
+    ScheduleExpiry();
 }
 
 void
@@ -437,9 +512,10 @@ ArpCache::Entry::MarkAlive(Address macAddress)
     NS_LOG_FUNCTION(this << macAddress);
     NS_ASSERT(m_state == WAIT_REPLY);
     m_macAddress = macAddress;
-    m_state = ALIVE;
+    SetState(ALIVE);
     ClearRetries();
     UpdateSeen();
+    ScheduleExpiry();
 }
 
 void
@@ -448,7 +524,8 @@ ArpCache::Entry::MarkPermanent()
     NS_LOG_FUNCTION(this << m_macAddress);
     NS_ASSERT(!m_macAddress.IsInvalid());
 
-    m_state = PERMANENT;
+    SetState(PERMANENT);
+    CancelExpiry();
     ClearRetries();
     UpdateSeen();
 }
@@ -459,7 +536,8 @@ ArpCache::Entry::MarkAutoGenerated()
     NS_LOG_FUNCTION(this << m_macAddress);
     NS_ASSERT(!m_macAddress.IsInvalid());
 
-    m_state = STATIC_AUTOGENERATED;
+    SetState(STATIC_AUTOGENERATED);
+    CancelExpiry();
     ClearRetries();
     UpdateSeen();
 }
@@ -489,7 +567,8 @@ ArpCache::Entry::MarkWaitReply(Ipv4PayloadHeaderPair waiting)
     NS_ASSERT(m_pending.empty());
     NS_ASSERT_MSG(waiting.first, "Can not add a null packet to the ARP queue");
 
-    m_state = WAIT_REPLY;
+    SetState(WAIT_REPLY);
+    CancelExpiry();
     m_pending.push_back(waiting);
     UpdateSeen();
     m_arp->StartWaitReplyTimer();
@@ -520,6 +599,11 @@ void
 ArpCache::Entry::SetIpv4Address(Ipv4Address destination)
 {
     NS_LOG_FUNCTION(this << destination);
+    if (m_state == WAIT_REPLY)
+    {
+        m_arp->m_waitReply.erase(m_ipv4Address);
+        m_arp->m_waitReply[destination] = this;
+    }
     m_ipv4Address = destination;
 }
 
@@ -543,6 +627,47 @@ ArpCache::Entry::GetTimeout() const
     return Time(); // Silence compiler warning
 }
 
+void
+ArpCache::Entry::SetState(ArpCacheEntryState_e state)
+{
+    NS_LOG_FUNCTION(this << state);
+    if (m_state == WAIT_REPLY && state != WAIT_REPLY)
+    {
+        m_arp->m_waitReply.erase(m_ipv4Address);
+    }
+    else if (m_state != WAIT_REPLY && state == WAIT_REPLY)
+    {
+        m_arp->m_waitReply[m_ipv4Address] = this;
+    }
+    m_state = state;
+}
+
+void
+ArpCache::Entry::ScheduleExpiry()
+{
+    NS_LOG_FUNCTION(this);
+    CancelExpiry();
+    Time timeout = GetTimeout();
+    if (!m_arp->m_removeExpired || timeout >= Time::Max() - m_lastSeen)
+    {
+        return;
+    }
+    // IsExpired() becomes true one time step after the timeout
+    m_expiry = m_arp->m_expiries.emplace(m_lastSeen + timeout + TimeStep(1), this);
+    m_arp->ScheduleSweep();
+}
+
+void
+ArpCache::Entry::CancelExpiry()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_expiry != m_arp->m_expiries.end())
+    {
+        m_arp->m_expiries.erase(m_expiry);
+        m_expiry = m_arp->m_expiries.end();
+    }
+}
+
 bool
 ArpCache::Entry::IsExpired() const
 {
@@ -34,6 +34,7 @@
 #include <list>
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -48,6 +49,15 @@ class Ipv4Header;
  *
  * A cached lookup table for translating layer 3 addresses to layer 2.
  * This implementation does lookups from IPv4 to a MAC address
+ *
+ * The entries are stored in a hash table indexed by their IPv4 address.
+ * The cache has no per-entry timer: a single event per cache retransmits
+ * the ArpRequests of the entries in WaitReply state every WaitReplyTimeout.
+ * Expired entries are kept, as an expired alive entry is refreshed when a
+ * packet is received from its address, unless the RemoveExpiredEntries
+ * attribute is set, in which case the same event removes the alive and dead
+ * entries once they have expired, in batches, to bound the size of the
+ * cache.
  */
 class ArpCache : public Object
 {
@@ -126,7 +136,7 @@ class ArpCache : public Object
     void SetArpRequestCallback(Callback<void, Ptr<const ArpCache>, Ipv4Address> arpRequestCallback);
     /**
      * This method will schedule a timeout at WaitReplyTimeout interval
-     * in the future, unless a timer is already running for the cache,
+     * in the future, unless a timeout is already scheduled for the cache,
      * in which case this method does nothing.
      */
     void StartWaitReplyTimer();
@@ -289,7 +299,14 @@ class ArpCache : public Object
          */
         void UpdateSeen();
 
+        /**
+         * \brief Destructor
+         */
+        ~Entry();
+
       private:
+        friend class ArpCache;
+
         /**
          * \brief ARP cache entry states
          */
@@ -308,6 +325,23 @@ class ArpCache : public Object
          */
         Time GetTimeout() const;
 
+        /**
+         * \brief Change the state of the entry, and the list of the entries
+         * waiting for a reply accordingly
+         * \param state the new state
+         */
+        void SetState(ArpCacheEntryState_e state);
+
+        /**
+         * \brief Schedule the removal of the entry when it expires
+         */
+        void ScheduleExpiry();
+
+        /**
+         * \brief Cancel the removal of the entry
+         */
+        void CancelExpiry();
+
         ArpCache* m_arp;              //!< pointer to the ARP cache owning the entry
         ArpCacheEntryState_e m_state; //!< state of the entry
         Time m_lastSeen;              //!< last moment a packet from that address has been seen
@@ -315,17 +349,18 @@ class ArpCache : public Object
         Ipv4Address m_ipv4Address;    //!< entry's IP address
         std::list<Ipv4PayloadHeaderPair> m_pending; //!< list of pending packets for the entry's IP
         uint32_t m_retries;                         //!< rerty counter
+        std::multimap<Time, Entry*>::iterator m_expiry; //!< scheduled removal, if any
     };
 
   private:
     /**
      * \brief ARP Cache container
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv4Address, ArpCache::Entry*, Ipv4AddressHash> Cache;
     /**
      * \brief ARP Cache container iterator
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*>::iterator CacheI;
+    typedef Cache::iterator CacheI;
 
     void DoDispose() override;
 
@@ -334,19 +369,37 @@ class ArpCache : public Object
     Time m_aliveTimeout;            //!< cache alive state timeout
     Time m_deadTimeout;             //!< cache dead state timeout
     Time m_waitReplyTimeout;        //!< cache reply state timeout
-    EventId m_waitReplyTimer;       //!< cache alive state timer
+    Time m_waitReplyTime;           //!< next retransmission time, or Time::Max() if none
+    EventId m_sweepEvent;           //!< next retransmission or removal of expired entries
+    Time m_sweepTime;               //!< time of m_sweepEvent
     Callback<void, Ptr<const ArpCache>, Ipv4Address>
         m_arpRequestCallback; //!< reply timeout callback
     uint32_t m_maxRetries;    //!< max retries for a resolution
+    bool m_removeExpired;     //!< whether expired alive and dead entries are removed
 
     /**
-     * This function is an event handler for the event that the
-     * ArpCache wants to check whether it must retry any Arp requests.
-     * If there are no Arp requests pending, this event is not scheduled.
+     * This function is called when the ArpCache wants to check whether it
+     * must retry any Arp requests.
+     * If there are no Arp requests pending, it is not scheduled.
      */
     void HandleWaitReplyTimeout();
+
+    /**
+     * This function is an event handler for the event that the ArpCache
+     * must retry the pending Arp requests or remove expired entries.
+     */
+    void Sweep();
+
+    /**
+     * Schedule the next Sweep(), if it is needed before the one already
+     * scheduled.
+     */
+    void ScheduleSweep();
+
     uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
     Cache m_arpCache;            //!< the ARP cache
+    std::map<Ipv4Address, ArpCache::Entry*> m_waitReply; //!< the entries in WaitReply state
+    std::multimap<Time, ArpCache::Entry*> m_expiries;    //!< the entries, by removal time
     TracedCallback<Ptr<const Packet>>
         m_dropTrace; //!< trace for packets dropped by the ARP cache queue
 };
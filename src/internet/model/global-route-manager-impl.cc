@@ -36,7 +36,10 @@
 
 #include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <queue>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -45,6 +48,56 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+namespace
+{
+
+/**
+ * \ingroup globalrouting
+ * Number of SPF calculations of a thread whose routes are held before they
+ * are installed.
+ */
+constexpr std::size_t SPF_BATCH_SIZE = 64;
+
+/**
+ * \ingroup globalrouting
+ * Compare the content of two Link State Advertisements.
+ * \param a the first LSA
+ * \param b the second LSA
+ * \returns true if the LSAs advertise the same links
+ */
+bool
+IsSameLSA(const GlobalRoutingLSA& a, const GlobalRoutingLSA& b)
+{
+    if (a.GetLSType() != b.GetLSType() || a.GetLinkStateId() != b.GetLinkStateId() ||
+        a.GetAdvertisingRouter() != b.GetAdvertisingRouter() ||
+        a.GetNetworkLSANetworkMask() != b.GetNetworkLSANetworkMask() ||
+        a.GetNLinkRecords() != b.GetNLinkRecords() ||
+        a.GetNAttachedRouters() != b.GetNAttachedRouters())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < a.GetNLinkRecords(); i++)
+    {
+        const GlobalRoutingLinkRecord* la = a.GetLinkRecord(i);
+        const GlobalRoutingLinkRecord* lb = b.GetLinkRecord(i);
+        if (la->GetLinkType() != lb->GetLinkType() || la->GetLinkId() != lb->GetLinkId() ||
+            la->GetLinkData() != lb->GetLinkData() || la->GetMetric() != lb->GetMetric())
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < a.GetNAttachedRouters(); i++)
+    {
+        if (a.GetAttachedRouter(i) != b.GetAttachedRouter(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 /**
  * \brief Stream insertion operator.
  *
@@ -426,6 +479,7 @@ SPFVertex::ClearVertexProcessed()
 
 GlobalRouteManagerLSDB::GlobalRouteManagerLSDB()
     : m_database(),
+      m_linkData(),
       m_extdatabase()
 {
     NS_LOG_FUNCTION(this);
@@ -448,6 +502,7 @@ GlobalRouteManagerLSDB::~GlobalRouteManagerLSDB()
     }
     NS_LOG_LOGIC("clear map");
     m_database.clear();
+    m_linkData.clear();
 }
 
 void
@@ -469,9 +524,26 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     {
         m_extdatabase.push_back(lsa);
     }
-    else
+    else if (m_database.insert(LSDBPair_t(addr, lsa)).second)
     {
-        m_database.insert(LSDBPair_t(addr, lsa));
+        //
+        // Index the router by the link data of its transit records.  If several
+        // routers have the same link data, the one with the lowest address is
+        // found, as when searching the database in order.
+        //
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+                continue;
+            }
+            auto [i, inserted] = m_linkData.emplace(lr->GetLinkData(), lsa);
+            if (!inserted && addr < i->second->GetLinkStateId())
+            {
+                i->second = lsa;
+            }
+        }
     }
 }
 
@@ -496,12 +568,10 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_database.find(addr);
+    if (i != m_database.end())
     {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
+        return i->second;
     }
     return nullptr;
 }
@@ -511,25 +581,23 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this << addr);
     //
-    // Look up an LSA by its address.
+    // Look up an LSA by the link data of its transit network records.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_linkData.find(addr);
+    if (i != m_linkData.end())
     {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
-        {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
-            {
-                return temp;
-            }
-        }
+        return i->second;
     }
     return nullptr;
 }
 
+const GlobalRouteManagerLSDB::LSDBMap_t&
+GlobalRouteManagerLSDB::GetLSAs() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_database;
+}
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManagerImpl Implementation
@@ -537,7 +605,8 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 // ---------------------------------------------------------------------------
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl()
-    : m_spfroot(nullptr)
+    : m_nThreads(1),
+      m_incremental(false)
 {
     NS_LOG_FUNCTION(this);
     m_lsdb = new GlobalRouteManagerLSDB();
@@ -563,6 +632,38 @@ GlobalRouteManagerImpl::DebugUseLsdb(GlobalRouteManagerLSDB* lsdb)
     m_lsdb = lsdb;
 }
 
+void
+GlobalRouteManagerImpl::SetNThreads(uint32_t nThreads)
+{
+    NS_LOG_FUNCTION(this << nThreads);
+    m_nThreads = std::max<uint32_t>(nThreads, 1);
+}
+
+void
+GlobalRouteManagerImpl::SetIncremental(bool incremental)
+{
+    NS_LOG_FUNCTION(this << incremental);
+    m_incremental = incremental;
+}
+
+void
+GlobalRouteManagerImpl::RemoveRoutes(Ptr<Ipv4GlobalRouting> gr)
+{
+    NS_LOG_FUNCTION(this << gr);
+    uint32_t j = 0;
+    uint32_t nRoutes = gr->GetNRoutes();
+    NS_LOG_LOGIC("Deleting " << nRoutes << " routes");
+    // Each time we delete route 0, the route index shifts downward
+    // We can delete all routes if we delete the route numbered 0
+    // nRoutes times
+    for (j = 0; j < nRoutes; j++)
+    {
+        NS_LOG_LOGIC("Deleting global route " << j);
+        gr->RemoveRoute(0);
+    }
+    NS_LOG_LOGIC("Deleted " << j << " global routes");
+}
+
 void
 GlobalRouteManagerImpl::DeleteGlobalRoutes()
 {
@@ -575,20 +676,10 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
         {
             continue;
         }
-        Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-        uint32_t j = 0;
-        uint32_t nRoutes = gr->GetNRoutes();
-        NS_LOG_LOGIC("Deleting " << gr->GetNRoutes() << " routes from node " << node->GetId());
-        // Each time we delete route 0, the route index shifts downward
-        // We can delete all routes if we delete the route numbered 0
-        // nRoutes times
-        for (j = 0; j < nRoutes; j++)
-        {
-            NS_LOG_LOGIC("Deleting global route " << j << " from node " << node->GetId());
-            gr->RemoveRoute(0);
-        }
-        NS_LOG_LOGIC("Deleted " << j << " global routes from node " << node->GetId());
+        NS_LOG_LOGIC("Deleting routes from node " << node->GetId());
+        RemoveRoutes(router->GetRoutingProtocol());
     }
+    m_calculations.clear();
     if (m_lsdb)
     {
         NS_LOG_LOGIC("Deleting LSDB, creating new one");
@@ -690,12 +781,59 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
 //
 void
 GlobalRouteManagerImpl::InitializeRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    CalculateRoutes();
+}
+
+uint32_t
+GlobalRouteManagerImpl::CalculateRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<std::unique_ptr<SPFCalculation>> calcs;
+    CreateCalculations(calcs);
+    NS_LOG_INFO("About to start SPF calculation");
+    //
+    // The routes are computed by batches, so that the routes of all the
+    // routers are not held at the same time.
+    //
+    std::size_t batchSize = SPF_BATCH_SIZE * m_nThreads;
+    for (std::size_t first = 0; first < calcs.size(); first += batchSize)
+    {
+        std::vector<SPFCalculation*> batch;
+        for (std::size_t i = first; i < calcs.size() && i < first + batchSize; i++)
+        {
+            batch.push_back(calcs[i].get());
+        }
+        RunCalculations(batch, &GlobalRouteManagerImpl::SPFCalculate);
+        for (auto calc : batch)
+        {
+            InstallRoutes(*calc);
+        }
+        if (!m_incremental)
+        {
+            for (std::size_t i = first; i < calcs.size() && i < first + batchSize; i++)
+            {
+                calcs[i].reset();
+            }
+        }
+    }
+    NS_LOG_INFO("Finished SPF calculation");
+    uint32_t nCalculations = calcs.size();
+    if (m_incremental)
+    {
+        m_calculations = std::move(calcs);
+    }
+    return nCalculations;
+}
+
+void
+GlobalRouteManagerImpl::CreateCalculations(std::vector<std::unique_ptr<SPFCalculation>>& calcs)
 {
     NS_LOG_FUNCTION(this);
     //
     // Walk the list of nodes in the system.
     //
-    NS_LOG_INFO("About to start SPF calculation");
     for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
     {
         Ptr<Node> node = *i;
@@ -714,14 +852,379 @@ GlobalRouteManagerImpl::InitializeRoutes()
 
         //
         // if the node has a global router interface, then run the global routing
-        // algorithms.
+        // algorithms.  The interfaces and the routing protocol of the node are
+        // looked up here, as the calculations may run on other threads.
         //
         if (rtr && rtr->GetNumLSAs())
         {
-            SPFCalculate(rtr->GetRouterId());
+            auto calc = std::make_unique<SPFCalculation>();
+            calc->root = rtr->GetRouterId();
+            calc->ipv4 = node->GetObject<Ipv4>();
+            NS_ASSERT_MSG(calc->ipv4,
+                          "GlobalRouteManagerImpl::CreateCalculations (): "
+                          "GetObject for <Ipv4> interface failed");
+            calc->routing = rtr->GetRoutingProtocol();
+            calcs.push_back(std::move(calc));
         }
     }
-    NS_LOG_INFO("Finished SPF calculation");
+}
+
+void
+GlobalRouteManagerImpl::RunCalculations(const std::vector<SPFCalculation*>& calcs,
+                                        void (GlobalRouteManagerImpl::*step)(SPFCalculation&))
+{
+    NS_LOG_FUNCTION(this << calcs.size());
+    uint32_t nThreads = std::min<std::size_t>(m_nThreads, calcs.size());
+    // the calculations are run one at a time when their log is enabled, so
+    // that the log lines of the routers are not mixed
+    if (nThreads <= 1 || !g_log.IsNoneEnabled())
+    {
+        for (auto calc : calcs)
+        {
+            (this->*step)(*calc);
+        }
+        return;
+    }
+    // the calculations are interleaved among the threads to balance the
+    // load when the routers are ordered by their position in the topology
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads - 1);
+    auto worker = [this, &calcs, step, nThreads](uint32_t first) {
+        for (std::size_t i = first; i < calcs.size(); i += nThreads)
+        {
+            (this->*step)(*calcs[i]);
+        }
+    };
+    for (uint32_t t = 1; t < nThreads; t++)
+    {
+        workers.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+}
+
+void
+GlobalRouteManagerImpl::InstallRoutes(SPFCalculation& calc)
+{
+    NS_LOG_FUNCTION(this << calc.root);
+    if (calc.routing)
+    {
+        for (const auto& route : calc.routes)
+        {
+            switch (route.type)
+            {
+            case SPFRoute::HOST:
+                calc.routing->AddHostRouteTo(route.dest, route.nextHop, route.outIf);
+                break;
+            case SPFRoute::NETWORK:
+                calc.routing->AddNetworkRouteTo(route.dest, route.mask, route.nextHop, route.outIf);
+                break;
+            case SPFRoute::EXTERNAL:
+                calc.routing->AddASExternalRouteTo(route.dest,
+                                                   route.mask,
+                                                   route.nextHop,
+                                                   route.outIf);
+                break;
+            }
+        }
+    }
+    std::vector<SPFRoute>().swap(calc.routes);
+}
+
+/**
+ * \brief The changes between two Link State DataBases.
+ *
+ * The vertices are the IDs of the LSAs which were added, removed or
+ * modified, and the links are the edges of the graph of the routers and
+ * networks that are only in one of the two databases.
+ */
+struct GlobalRouteManagerImpl::LSDBChanges
+{
+    /** A directed edge of the graph of the routers and transit networks */
+    struct Link
+    {
+        Ipv4Address from; //!< the vertex ID of the origin
+        Ipv4Address to;   //!< the vertex ID of the destination
+        Ipv4Address data; //!< the link data
+        uint32_t cost;    //!< the cost of the edge
+        bool toNetwork;   //!< whether the destination is a transit network
+
+        /**
+         * \brief Less-than operator, to sort the links.
+         * \param other the other link
+         * \returns true if this link is before the other one
+         */
+        bool operator<(const Link& other) const
+        {
+            return std::tie(from, to, data, cost, toNetwork) <
+                   std::tie(other.from, other.to, other.data, other.cost, other.toNetwork);
+        }
+    };
+
+    /**
+     * \brief Compare two Link State DataBases.
+     * \param previous the previous database
+     * \param current the current database
+     */
+    LSDBChanges(const GlobalRouteManagerLSDB& previous, const GlobalRouteManagerLSDB& current);
+
+    /**
+     * \brief Append the edges of the graph leaving a vertex.
+     *
+     * The network to router edges have a cost of 0, and are only found if
+     * the attached router is in the database.
+     *
+     * \param lsdb the database
+     * \param lsa the LSA of the vertex
+     * \param links the edges
+     */
+    static void GetLinks(const GlobalRouteManagerLSDB& lsdb,
+                         const GlobalRoutingLSA* lsa,
+                         std::vector<Link>& links);
+
+    std::vector<Ipv4Address> vertices; //!< the vertices whose LSA was added, removed or modified
+    std::vector<Ipv4Address> replaced; //!< the vertices removed, or whose type or mask changed
+    std::vector<Link> links;           //!< the edges only in one of the databases
+    bool externals{false};             //!< whether the external LSAs changed
+};
+
+GlobalRouteManagerImpl::LSDBChanges::LSDBChanges(const GlobalRouteManagerLSDB& previous,
+                                                 const GlobalRouteManagerLSDB& current)
+{
+    //
+    // The edges leaving a network depend on the router LSAs found by their
+    // link data, so the edges of all the vertices are compared, not only those
+    // of the modified LSAs.
+    //
+    std::vector<Link> before;
+    std::vector<Link> after;
+    for (const auto& [id, lsa] : previous.GetLSAs())
+    {
+        GlobalRoutingLSA* other = current.GetLSA(id);
+        if (!other || !IsSameLSA(*lsa, *other))
+        {
+            vertices.push_back(id);
+            if (!other || other->GetLSType() != lsa->GetLSType() ||
+                other->GetNetworkLSANetworkMask() != lsa->GetNetworkLSANetworkMask())
+            {
+                replaced.push_back(id);
+            }
+        }
+        before.clear();
+        after.clear();
+        GetLinks(previous, lsa, before);
+        if (other)
+        {
+            GetLinks(current, other, after);
+        }
+        std::sort(before.begin(), before.end());
+        std::sort(after.begin(), after.end());
+        std::set_symmetric_difference(before.begin(),
+                                      before.end(),
+                                      after.begin(),
+                                      after.end(),
+                                      std::back_inserter(links));
+    }
+    for (const auto& [id, lsa] : current.GetLSAs())
+    {
+        if (!previous.GetLSA(id))
+        {
+            vertices.push_back(id);
+            GetLinks(current, lsa, links);
+        }
+    }
+    externals = previous.GetNumExtLSAs() != current.GetNumExtLSAs();
+    for (uint32_t i = 0; !externals && i < current.GetNumExtLSAs(); i++)
+    {
+        externals = !IsSameLSA(*previous.GetExtLSA(i), *current.GetExtLSA(i));
+    }
+}
+
+void
+GlobalRouteManagerImpl::LSDBChanges::GetLinks(const GlobalRouteManagerLSDB& lsdb,
+                                              const GlobalRoutingLSA* lsa,
+                                              std::vector<Link>& links)
+{
+    Ipv4Address id = lsa->GetLinkStateId();
+    if (lsa->GetLSType() == GlobalRoutingLSA::RouterLSA)
+    {
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(j);
+            bool transit = l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork;
+            if (transit || l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
+            {
+                links.push_back({id, l->GetLinkId(), l->GetLinkData(), l->GetMetric(), transit});
+            }
+        }
+    }
+    else if (lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA)
+    {
+        for (uint32_t j = 0; j < lsa->GetNAttachedRouters(); j++)
+        {
+            Ipv4Address addr = lsa->GetAttachedRouter(j);
+            GlobalRoutingLSA* router = lsdb.GetLSAByLinkData(addr);
+            if (router)
+            {
+                links.push_back({id, router->GetLinkStateId(), addr, 0, false});
+            }
+        }
+    }
+}
+
+GlobalRouteManagerImpl::SPFUpdate
+GlobalRouteManagerImpl::GetUpdate(const SPFCalculation& calc, const LSDBChanges& changes) const
+{
+    NS_LOG_FUNCTION(this << calc.root);
+    // the routes of a stub node depend on its only neighbor, and are cheap
+    if (calc.stub)
+    {
+        return SPF_RECOMPUTE;
+    }
+    for (const auto& id : changes.replaced)
+    {
+        if (id == calc.root || calc.index.count(id))
+        {
+            return SPF_RECOMPUTE;
+        }
+    }
+    auto getDistance = [&calc](Ipv4Address id) -> uint64_t {
+        auto i = calc.index.find(id);
+        return i == calc.index.end() ? SPF_INFINITY : calc.tree[i->second].distance;
+    };
+    //
+    // An added or removed edge can only change the tree if it is on a path
+    // from the root at most as long as the shortest path to its destination.
+    // The next hops towards the routers of the networks attached to the root
+    // also depend on the edges from these routers back to the network.  The
+    // distances are those of the previous tree: an edge leaving a vertex that
+    // was not reachable only matters if another changed edge reaches it.
+    //
+    for (const auto& link : changes.links)
+    {
+        if (link.from == calc.root || link.to == calc.root)
+        {
+            return SPF_RECOMPUTE;
+        }
+        uint64_t from = getDistance(link.from);
+        uint64_t to = getDistance(link.to);
+        if (from == SPF_INFINITY && to == SPF_INFINITY)
+        {
+            continue;
+        }
+        if ((from != SPF_INFINITY && from + link.cost <= to) || (link.toNetwork && to <= from))
+        {
+            return SPF_RECOMPUTE;
+        }
+    }
+    //
+    // Otherwise the tree is unchanged, but the addresses and the networks
+    // advertised by its vertices may have changed.
+    //
+    for (const auto& id : changes.vertices)
+    {
+        if (id == calc.root)
+        {
+            return SPF_RECOMPUTE;
+        }
+        if (calc.index.count(id))
+        {
+            return SPF_REGENERATE;
+        }
+    }
+    return changes.externals ? SPF_REGENERATE : SPF_UNCHANGED;
+}
+
+uint32_t
+GlobalRouteManagerImpl::UpdateRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_incremental || m_calculations.empty())
+    {
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        return CalculateRoutes();
+    }
+    //
+    // Build the routing database again, and compare it with the previous one.
+    //
+    GlobalRouteManagerLSDB* previous = m_lsdb;
+    m_lsdb = new GlobalRouteManagerLSDB();
+    BuildGlobalRoutingDatabase();
+    LSDBChanges changes(*previous, *m_lsdb);
+    delete previous;
+    if (changes.vertices.empty() && !changes.externals)
+    {
+        NS_LOG_INFO("The routing database is unchanged");
+        return 0;
+    }
+    //
+    // Match the routers with their previous calculations, which hold their
+    // trees, and find which routers must be updated.
+    //
+    std::unordered_map<Ipv4Address, std::unique_ptr<SPFCalculation>, Ipv4AddressHash> previousCalcs;
+    for (auto& calc : m_calculations)
+    {
+        Ipv4Address root = calc->root;
+        previousCalcs[root] = std::move(calc);
+    }
+    std::vector<std::unique_ptr<SPFCalculation>> calcs;
+    CreateCalculations(calcs);
+    std::vector<SPFCalculation*> recompute;
+    std::vector<SPFCalculation*> regenerate;
+    std::vector<SPFCalculation*> updated;
+    for (auto& calc : calcs)
+    {
+        auto i = previousCalcs.find(calc->root);
+        SPFUpdate update = SPF_RECOMPUTE;
+        if (i != previousCalcs.end())
+        {
+            update = GetUpdate(*i->second, changes);
+            i->second->ipv4 = calc->ipv4;
+            i->second->routing = calc->routing;
+            calc = std::move(i->second);
+            previousCalcs.erase(i);
+        }
+        switch (update)
+        {
+        case SPF_UNCHANGED:
+            continue;
+        case SPF_REGENERATE:
+            regenerate.push_back(calc.get());
+            break;
+        case SPF_RECOMPUTE:
+            recompute.push_back(calc.get());
+            break;
+        }
+        updated.push_back(calc.get());
+    }
+    //
+    // The routers which no longer take part in the routing lose their routes.
+    //
+    for (auto& [root, calc] : previousCalcs)
+    {
+        if (calc->routing)
+        {
+            RemoveRoutes(calc->routing);
+        }
+    }
+    NS_LOG_INFO("Updating " << updated.size() << " of " << calcs.size() << " routers, "
+                            << recompute.size() << " SPF calculations");
+    RunCalculations(recompute, &GlobalRouteManagerImpl::SPFCalculate);
+    RunCalculations(regenerate, &GlobalRouteManagerImpl::SPFGenerateRoutes);
+    for (auto calc : updated)
+    {
+        if (calc->routing)
+        {
+            RemoveRoutes(calc->routing);
+        }
+        InstallRoutes(*calc);
+    }
+    m_calculations = std::move(calcs);
+    return recompute.size();
 }
 
 //
@@ -738,7 +1241,7 @@ GlobalRouteManagerImpl::InitializeRoutes()
 // vertex already on the candidate list, store the new (lower) cost.
 //
 void
-GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
+GlobalRouteManagerImpl::SPFNext(SPFCalculation& calc, SPFVertex* v, CandidateQueue& candidate)
 {
     NS_LOG_FUNCTION(this << v << &candidate);
 
@@ -827,7 +1330,8 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         // If the link is to a router that is already in the shortest path first tree
         // then we have it covered -- ignore it.
         //
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        auto explored = calc.explored.find(w_lsa);
+        if (explored != calc.explored.end() && explored->second == nullptr)
         {
             NS_LOG_LOGIC("Skipping ->  LSA " << w_lsa->GetLinkStateId() << " already in SPF tree");
             continue;
@@ -851,7 +1355,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         NS_LOG_LOGIC("Considering w_lsa " << w_lsa->GetLinkStateId());
 
         // Is there already vertex w in candidate list?
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+        if (explored == calc.explored.end())
         {
             // Calculate nexthop to w
             // We need to figure out how to actually get to the new router represented
@@ -861,9 +1365,9 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
 
             // prepare vertex w
             w = new SPFVertex(w_lsa);
-            if (SPFNexthopCalculation(v, w, l, distance))
+            if (SPFNexthopCalculation(calc, v, w, l, distance))
             {
-                w_lsa->SetStatus(GlobalRoutingLSA::LSA_SPF_CANDIDATE);
+                calc.explored[w_lsa] = w;
                 //
                 // Push this new vertex onto the priority queue (ordered by distance from the
                 // root node).
@@ -880,23 +1384,22 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                                   << "return false, but it does now!");
             }
         }
-        else if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
+        else
         {
             //
             // We have already considered the link represented by <w>.  What wse have to
             // do now is to decide if this new router represents a route with a shorter
             // distance metric.
             //
-            // So, locate the vertex in the candidate queue and take a look at the
-            // distance.
+            // So, take the vertex recorded when it was pushed in the candidate queue
+            // and take a look at the distance.
 
             /* (quagga-0.98.6) W is already on the candidate list; call it cw.
              * Compare the previously calculated cost (cw->distance)
              * with the cost we just determined (w->distance) to see
              * if we've found a shorter path.
              */
-            SPFVertex* cw;
-            cw = candidate.Find(w_lsa->GetLinkStateId());
+            SPFVertex* cw = explored->second;
             if (cw->GetDistanceFromRoot() < distance)
             {
                 //
@@ -927,7 +1430,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
 
                 // prepare vertex w
                 w = new SPFVertex(w_lsa);
-                SPFNexthopCalculation(v, w, l, distance);
+                SPFNexthopCalculation(calc, v, w, l, distance);
                 cw->MergeRootExitDirections(w);
                 cw->MergeParent(w);
                 // SPFVertexAddParent (w) is necessary as the destructor of
@@ -946,7 +1449,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                 // N.B. the nexthop_calculation is conditional, if it finds a valid nexthop
                 // it will call spf_add_parents, which will flush the old parents
                 //
-                if (SPFNexthopCalculation(v, cw, l, distance))
+                if (SPFNexthopCalculation(calc, v, cw, l, distance))
                 {
                     //
                     // If we've changed the cost to get to the vertex represented by <w>, we
@@ -970,7 +1473,8 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
 // For now, this is greatly simplified from the quagga code
 //
 int
-GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
+GlobalRouteManagerImpl::SPFNexthopCalculation(const SPFCalculation& calc,
+                                              SPFVertex* v,
                                               SPFVertex* w,
                                               GlobalRoutingLinkRecord* l,
                                               uint32_t distance)
@@ -986,7 +1490,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
     */
 
     //
-    // The vertex m_spfroot is a distinguished vertex representing the node at
+    // The vertex calc.spfroot is a distinguished vertex representing the node at
     // the root of the calculations.  That is, it is the node for which we are
     // calculating the routes.
     //
@@ -1008,7 +1512,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
     // The point-to-point link information is only useful in this calculation when
     // we are examining the root node.
     //
-    if (v == m_spfroot)
+    if (v == calc.spfroot)
     {
         //
         // In this case <v> is the root node, which means it is the starting point
@@ -1053,7 +1557,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
             // from the perspective of <v> -- remember that <l> is the link "from"
             // <v> "to" <w>.
             //
-            uint32_t outIf = FindOutgoingInterfaceId(l->GetLinkData());
+            uint32_t outIf = FindOutgoingInterfaceId(calc, l->GetLinkData());
 
             w->SetRootExitDirection(nextHop, outIf);
             w->SetDistanceFromRoot(distance);
@@ -1070,8 +1574,9 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
             GlobalRoutingLSA* w_lsa = w->GetLSA();
             NS_ASSERT(w_lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA);
             // Find outgoing interface ID for this network
-            uint32_t outIf =
-                FindOutgoingInterfaceId(w_lsa->GetLinkStateId(), w_lsa->GetNetworkLSANetworkMask());
+            uint32_t outIf = FindOutgoingInterfaceId(calc,
+                                                     w_lsa->GetLinkStateId(),
+                                                     w_lsa->GetNetworkLSANetworkMask());
             // Set the next hop to 0.0.0.0 meaning "not exist"
             Ipv4Address nextHop = Ipv4Address::GetZero();
             w->SetRootExitDirection(nextHop, outIf);
@@ -1086,7 +1591,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
     else if (v->GetVertexType() == SPFVertex::VertexNetwork)
     {
         // See if any of v's parents are the root
-        if (v->GetParent() == m_spfroot)
+        if (v->GetParent() == calc.spfroot)
         {
             // 16.1.1 para 5. ...the parent vertex is a network that
             // directly connects the calculating router to the destination
@@ -1112,7 +1617,8 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
         }
         else
         {
-            w->SetRootExitDirection(v->GetRootExitDirection());
+            // the network may be reached through several equal-cost paths
+            w->InheritAllRootExitDirections(v);
         }
     }
     else
@@ -1234,7 +1740,20 @@ void
 GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
-    SPFCalculate(root);
+    SPFCalculation calc;
+    calc.root = root;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter>();
+        if (rtr && rtr->GetRouterId() == root)
+        {
+            calc.ipv4 = (*i)->GetObject<Ipv4>();
+            calc.routing = rtr->GetRoutingProtocol();
+            break;
+        }
+    }
+    SPFCalculate(calc);
+    InstallRoutes(calc);
 }
 
 //
@@ -1244,10 +1763,10 @@ GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
 // to be run
 //
 bool
-GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
+GlobalRouteManagerImpl::CheckForStubNode(SPFCalculation& calc)
 {
-    NS_LOG_FUNCTION(this << root);
-    GlobalRoutingLSA* rlsa = m_lsdb->GetLSA(root);
+    NS_LOG_FUNCTION(this << calc.root);
+    GlobalRoutingLSA* rlsa = m_lsdb->GetLSA(calc.root);
     Ipv4Address myRouterId = rlsa->GetLinkStateId();
     int transits = 0;
     GlobalRoutingLinkRecord* transitLink = nullptr;
@@ -1270,7 +1789,7 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
         // This router is not connected to any router.  Probably, global
         // routing should not be called for this node, but we can just raise
         // a warning here and return true.
-        NS_LOG_WARN("all nodes should have at least one transit link:" << root);
+        NS_LOG_WARN("all nodes should have at least one transit link:" << calc.root);
         return true;
     }
     if (transits == 1)
@@ -1307,18 +1826,15 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
                 if (lr->GetLinkId() == myRouterId)
                 {
                     // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                    NS_ASSERT(gr);
-                    gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
-                                          Ipv4Mask("0.0.0.0"),
-                                          lr->GetLinkData(),
-                                          FindOutgoingInterfaceId(transitLink->GetLinkData()));
+                    int32_t outIf = FindOutgoingInterfaceId(calc, transitLink->GetLinkData());
+                    calc.routes.push_back({SPFRoute::NETWORK,
+                                           Ipv4Address("0.0.0.0"),
+                                           Ipv4Mask("0.0.0.0"),
+                                           lr->GetLinkData(),
+                                           static_cast<uint32_t>(outIf)});
                     NS_LOG_LOGIC("Inserting default route for node "
                                  << myRouterId << " to next hop " << lr->GetLinkData()
-                                 << " via interface "
-                                 << FindOutgoingInterfaceId(transitLink->GetLinkData()));
+                                 << " via interface " << outIf);
                     return true;
                 }
             }
@@ -1329,15 +1845,21 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
 
 // quagga ospf_spf_calculate
 void
-GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
+GlobalRouteManagerImpl::SPFCalculate(SPFCalculation& calc)
 {
-    NS_LOG_FUNCTION(this << root);
+    NS_LOG_FUNCTION(this << calc.root);
 
     SPFVertex* v;
     //
-    // Initialize the Link State Database.
+    // Start from an empty tree.  The state of the calculation is kept in calc,
+    // so that the Link State Database is not modified.
     //
-    m_lsdb->Initialize();
+    calc.explored.clear();
+    calc.tree.clear();
+    calc.walk.clear();
+    calc.index.clear();
+    calc.routes.clear();
+    calc.stub = false;
     //
     // The candidate queue is a priority queue of SPFVertex objects, with the top
     // of the queue being the closest vertex in terms of distance from the root
@@ -1350,15 +1872,15 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // calculation.  Each router (and corresponding network) is a vertex in the
     // shortest path first (SPF) tree.
     //
-    v = new SPFVertex(m_lsdb->GetLSA(root));
+    v = new SPFVertex(m_lsdb->GetLSA(calc.root));
     //
     // This vertex is the root of the SPF tree and it is distance 0 from the root.
     // We also mark this vertex as being in the SPF tree.
     //
-    m_spfroot = v;
+    calc.spfroot = v;
     v->SetDistanceFromRoot(0);
-    v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
-    NS_LOG_LOGIC("Starting SPFCalculate for node " << root);
+    calc.explored[v->GetLSA()] = nullptr;
+    NS_LOG_LOGIC("Starting SPFCalculate for node " << calc.root);
 
     //
     // Optimize SPF calculation, for ns-3.
@@ -1367,12 +1889,16 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // reached.  Instead, short-circuit this computation and just install
     // a default route in the CheckForStubNode() method.
     //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    if (calc.routing && CheckForStubNode(calc))
     {
-        NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
-        delete m_spfroot;
+        NS_LOG_LOGIC("SPFCalculate truncated for stub node " << calc.root);
+        calc.stub = true;
+        calc.explored.clear();
+        delete calc.spfroot;
+        calc.spfroot = nullptr;
         return;
     }
+    SPFAddToTree(calc, v);
 
     for (;;)
     {
@@ -1390,7 +1916,7 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
         // shortest path).  If the new vertices represent shorter paths, we use them
         // and update the path cost.
         //
-        SPFNext(v, candidate);
+        SPFNext(calc, v, candidate);
         //
         // RFC2328 16.1. (3).
         //
@@ -1415,10 +1941,9 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
         v = candidate.Pop();
         NS_LOG_LOGIC("Popped vertex " << v->GetVertexId());
         //
-        // Update the status field of the vertex to indicate that it is in the SPF
-        // tree.
+        // Update the state of the vertex to indicate that it is in the SPF tree.
         //
-        v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+        calc.explored[v->GetLSA()] = nullptr;
         //
         // The current vertex has a parent pointer.  By calling this rather oddly
         // named method (blame quagga) we add the current vertex to the list of
@@ -1434,718 +1959,363 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
         //
         // RFC2328 16.1. (4).
         //
-        // This is the method that actually adds the routes.  It'll walk the list
-        // of nodes in the system, looking for the node corresponding to the router
-        // ID of the root of the tree -- that is the router we're building the routes
-        // for.  It looks for the Ipv4 interface of that node and remembers it.  So
-        // we are only actually adding routes to that one node at the root of the SPF
-        // tree.
+        // The vertex, its distance and the root's exits towards it are final:
+        // record them.  The routes to the vertex are added by SPFGenerateRoutes,
+        // in the order in which the vertices joined the tree.
         //
-        // We're going to pop of a pointer to every vertex in the tree except the
-        // root in order of distance from the root.  For each of the vertices, we call
-        // SPFIntraAddRouter ().  Down in SPFIntraAddRouter, we look at all of the
-        // point-to-point Global Router Link Records (the links to nodes adjacent to
-        // the node represented by the vertex).  We add a route to the IP address
-        // specified by the m_linkData field of each of those link records.  This will
-        // be the *local* IP address associated with the interface attached to the
-        // link.  We use the outbound interface and next hop information present in
-        // the vertex <v> which have possibly been inherited from the root.
+        SPFAddToTree(calc, v);
         //
-        // To summarize, we're going to look at the node represented by <v> and loop
-        // through its point-to-point links, adding a *host* route to the local IP
-        // address (at the <v> side) for each of those links.
+        // RFC2328 16.1. (5).
         //
-        if (v->GetVertexType() == SPFVertex::VertexRouter)
+        // Iterate the algorithm by returning to Step 2 until there are no more
+        // candidate vertices.
+
+    } // end for loop
+
+    //
+    // Record the order in which the second stage of the calculation visits the
+    // vertices.  Then, delete all of the vertices and corresponding resources.
+    //
+    SPFWalkTree(calc, calc.spfroot);
+    calc.explored.clear();
+    delete calc.spfroot;
+    calc.spfroot = nullptr;
+
+    SPFGenerateRoutes(calc);
+    //
+    // The tree is only kept for the incremental updates.
+    //
+    if (!m_incremental)
+    {
+        calc.tree = std::vector<SPFTreeVertex>();
+        calc.walk = std::vector<uint32_t>();
+        calc.index.clear();
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFAddToTree(SPFCalculation& calc, SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << v);
+    NS_ASSERT_MSG(v->GetVertexType() == SPFVertex::VertexRouter ||
+                      v->GetVertexType() == SPFVertex::VertexNetwork,
+                  "illegal SPFVertex type");
+    calc.index[v->GetVertexId()] = calc.tree.size();
+    SPFTreeVertex vertex;
+    vertex.id = v->GetVertexId();
+    vertex.type = v->GetVertexType();
+    vertex.distance = v->GetDistanceFromRoot();
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        vertex.exits.push_back(v->GetRootExitDirection(i));
+    }
+    calc.tree.push_back(std::move(vertex));
+}
+
+void
+GlobalRouteManagerImpl::SPFWalkTree(SPFCalculation& calc, SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << v);
+    calc.walk.push_back(calc.index.at(v->GetVertexId()));
+    for (uint32_t i = 0; i < v->GetNChildren(); i++)
+    {
+        if (!v->GetChild(i)->IsVertexProcessed())
         {
-            SPFIntraAddRouter(v);
+            SPFWalkTree(calc, v->GetChild(i));
+            v->GetChild(i)->SetVertexProcessed(true);
         }
-        else if (v->GetVertexType() == SPFVertex::VertexNetwork)
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFGenerateRoutes(SPFCalculation& calc)
+{
+    NS_LOG_FUNCTION(this << calc.root);
+    calc.routes.clear();
+    //
+    // We go through every vertex in the tree except the root, in order of
+    // distance from the root.  For the routers, we call SPFIntraAddRouter (),
+    // which looks at all of the point-to-point Global Router Link Records (the
+    // links to nodes adjacent to the node represented by the vertex).  We add
+    // a route to the IP address specified by the m_linkData field of each of
+    // those link records.  This will be the *local* IP address associated with
+    // the interface attached to the link.  We use the outbound interfaces and
+    // next hops from the root towards the vertex.
+    //
+    for (uint32_t i = 1; i < calc.tree.size(); i++)
+    {
+        const SPFTreeVertex& v = calc.tree[i];
+        if (v.type == SPFVertex::VertexRouter)
         {
-            SPFIntraAddTransit(v);
+            SPFIntraAddRouter(calc, v);
         }
         else
         {
-            NS_ASSERT_MSG(0, "illegal SPFVertex type");
+            SPFIntraAddTransit(calc, v);
         }
-        //
-        // RFC2328 16.1. (5).
-        //
-        // Iterate the algorithm by returning to Step 2 until there are no more
-        // candidate vertices.
-
-    } // end for loop
+    }
 
     // Second stage of SPF calculation procedure
-    SPFProcessStubs(m_spfroot);
+    SPFProcessStubs(calc);
     for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs(); i++)
     {
-        m_spfroot->ClearVertexProcessed();
         GlobalRoutingLSA* extlsa = m_lsdb->GetExtLSA(i);
         NS_LOG_LOGIC("Processing External LSA with id " << extlsa->GetLinkStateId());
-        ProcessASExternals(m_spfroot, extlsa);
+        ProcessASExternals(calc, extlsa);
     }
-
-    //
-    // We're all done setting the routing information for the node at the root of
-    // the SPF tree.  Delete all of the vertices and corresponding resources.  Go
-    // possibly do it again for the next router.
-    //
-    delete m_spfroot;
-    m_spfroot = nullptr;
 }
 
 void
-GlobalRouteManagerImpl::ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extlsa)
+GlobalRouteManagerImpl::SPFAddRoutes(SPFCalculation& calc,
+                                     SPFRoute::Type type,
+                                     Ipv4Address dest,
+                                     Ipv4Mask mask,
+                                     const SPFTreeVertex& v)
 {
-    NS_LOG_FUNCTION(this << v << extlsa);
-    NS_LOG_LOGIC("Processing external for destination "
-                 << extlsa->GetLinkStateId() << ", for router " << v->GetVertexId()
-                 << ", advertised by " << extlsa->GetAdvertisingRouter());
-    if (v->GetVertexType() == SPFVertex::VertexRouter)
+    NS_LOG_FUNCTION(this << type << dest << mask << v.id);
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the vertex 'v' from the root node, due to ECMP
+    for (uint32_t i = 0; i < v.exits.size(); i++)
     {
-        GlobalRoutingLSA* rlsa = v->GetLSA();
-        NS_LOG_LOGIC("Processing router LSA with id " << rlsa->GetLinkStateId());
-        if ((rlsa->GetLinkStateId()) == (extlsa->GetAdvertisingRouter()))
+        Ipv4Address nextHop = v.exits[i].first;
+        int32_t outIf = v.exits[i].second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("Found advertising router to destination");
-            SPFAddASExternal(extlsa, v);
+            calc.routes.push_back({type, dest, mask, nextHop, static_cast<uint32_t>(outIf)});
+            NS_LOG_LOGIC("(Route " << i << ") Node " << calc.root << " add route to " << dest
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-    }
-    for (uint32_t i = 0; i < v->GetNChildren(); i++)
-    {
-        if (!v->GetChild(i)->IsVertexProcessed())
+        else
         {
-            NS_LOG_LOGIC("Vertex's child " << i << " not yet processed, processing...");
-            ProcessASExternals(v->GetChild(i), extlsa);
-            v->GetChild(i)->SetVertexProcessed(true);
+            NS_LOG_LOGIC("(Route " << i << ") Node " << calc.root << " NOT able to add route to "
+                                   << dest << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative " << outIf);
         }
     }
 }
 
+void
+GlobalRouteManagerImpl::ProcessASExternals(SPFCalculation& calc, GlobalRoutingLSA* extlsa)
+{
+    NS_LOG_FUNCTION(this << calc.root << extlsa);
+    NS_LOG_LOGIC("Processing external for destination "
+                 << extlsa->GetLinkStateId() << ", for router " << calc.root
+                 << ", advertised by " << extlsa->GetAdvertisingRouter());
+    auto i = calc.index.find(extlsa->GetAdvertisingRouter());
+    if (i != calc.index.end() && calc.tree[i->second].type == SPFVertex::VertexRouter)
+    {
+        NS_LOG_LOGIC("Found advertising router to destination");
+        SPFAddASExternal(calc, extlsa, calc.tree[i->second]);
+    }
+}
+
 //
 // Adding external routes to routing table - modeled after
 // SPFAddIntraAddStub()
 //
 
 void
-GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
+GlobalRouteManagerImpl::SPFAddASExternal(SPFCalculation& calc,
+                                         GlobalRoutingLSA* extlsa,
+                                         const SPFTreeVertex& v)
 {
-    NS_LOG_FUNCTION(this << extlsa << v);
+    NS_LOG_FUNCTION(this << extlsa << v.id);
 
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFAddASExternal (): Root pointer not set");
     // Two cases to consider: We are advertising the external ourselves
     // => No need to add anything
     // OR find best path to the advertising router
-    if (v->GetVertexId() == m_spfroot->GetVertexId())
+    if (v.id == calc.root)
     {
-        NS_LOG_LOGIC("External is on local host: " << v->GetVertexId() << "; returning");
+        NS_LOG_LOGIC("External is on local host: " << v.id << "; returning");
         return;
     }
     NS_LOG_LOGIC("External is on remote host: " << extlsa->GetAdvertisingRouter()
                                                 << "; installing");
 
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
-    {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
-        {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
-        }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+    Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = extlsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    SPFAddRoutes(calc, SPFRoute::EXTERNAL, tempip, tempmask, v);
 }
 
 // Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
 // stub link records will exist for point-to-point interfaces and for
 // broadcast interfaces for which no neighboring router can be found
 void
-GlobalRouteManagerImpl::SPFProcessStubs(SPFVertex* v)
+GlobalRouteManagerImpl::SPFProcessStubs(SPFCalculation& calc)
 {
-    NS_LOG_FUNCTION(this << v);
-    NS_LOG_LOGIC("Processing stubs for " << v->GetVertexId());
-    if (v->GetVertexType() == SPFVertex::VertexRouter)
+    NS_LOG_FUNCTION(this << calc.root);
+    for (uint32_t index : calc.walk)
     {
-        GlobalRoutingLSA* rlsa = v->GetLSA();
+        const SPFTreeVertex& v = calc.tree[index];
+        NS_LOG_LOGIC("Processing stubs for " << v.id);
+        if (v.type != SPFVertex::VertexRouter)
+        {
+            continue;
+        }
+        GlobalRoutingLSA* rlsa = m_lsdb->GetLSA(v.id);
+        NS_ASSERT_MSG(rlsa, "GlobalRouteManagerImpl::SPFProcessStubs (): missing LSA " << v.id);
         NS_LOG_LOGIC("Processing router LSA with id " << rlsa->GetLinkStateId());
         for (uint32_t i = 0; i < rlsa->GetNLinkRecords(); i++)
         {
-            NS_LOG_LOGIC("Examining link " << i << " of " << v->GetVertexId() << "'s "
-                                           << v->GetLSA()->GetNLinkRecords() << " link records");
-            GlobalRoutingLinkRecord* l = v->GetLSA()->GetLinkRecord(i);
+            NS_LOG_LOGIC("Examining link " << i << " of " << v.id << "'s "
+                                           << rlsa->GetNLinkRecords() << " link records");
+            GlobalRoutingLinkRecord* l = rlsa->GetLinkRecord(i);
             if (l->GetLinkType() == GlobalRoutingLinkRecord::StubNetwork)
             {
                 NS_LOG_LOGIC("Found a Stub record to " << l->GetLinkId());
-                SPFIntraAddStub(l, v);
+                SPFIntraAddStub(calc, l, v);
                 continue;
             }
         }
     }
-    for (uint32_t i = 0; i < v->GetNChildren(); i++)
-    {
-        if (!v->GetChild(i)->IsVertexProcessed())
-        {
-            SPFProcessStubs(v->GetChild(i));
-            v->GetChild(i)->SetVertexProcessed(true);
-        }
-    }
 }
 
 // RFC2328 16.1. second stage.
 void
-GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddStub(SPFCalculation& calc,
+                                        GlobalRoutingLinkRecord* l,
+                                        const SPFTreeVertex& v)
 {
-    NS_LOG_FUNCTION(this << l << v);
-
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddStub (): Root pointer not set");
+    NS_LOG_FUNCTION(this << l << v.id);
 
     // XXX simplified logic for the moment.  There are two cases to consider:
     // 1) the stub network is on this router; do nothing for now
     //    (already handled above)
     // 2) the stub network is on a remote router, so I should use the
     // same next hop that I use to get to vertex v
-    if (v->GetVertexId() == m_spfroot->GetVertexId())
+    if (v.id == calc.root)
     {
-        NS_LOG_LOGIC("Stub is on local host: " << v->GetVertexId() << "; returning");
+        NS_LOG_LOGIC("Stub is on local host: " << v.id << "; returning");
         return;
     }
-    NS_LOG_LOGIC("Stub is on remote host: " << v->GetVertexId() << "; installing");
-    //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    NS_LOG_LOGIC("Stub is on remote host: " << v.id << "; installing");
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // We add a route to the stub network, using the same next hops and
+    // outgoing interfaces as for the vertex <v> that advertises it.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
-    {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
-        {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
-        }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+    Ipv4Mask tempmask(l->GetLinkData().Get());
+    Ipv4Address tempip = l->GetLinkId();
+    tempip = tempip.CombineMask(tempmask);
+    SPFAddRoutes(calc, SPFRoute::NETWORK, tempip, tempmask, v);
 }
 
 //
 // Return the interface number corresponding to a given IP address and mask
-// This is a wrapper around GetInterfaceForPrefix(), but we first
-// have to find the right node pointer to pass to that function.
+// This is a wrapper around GetInterfaceForPrefix() on the node at the root
+// of the calculation.
 // If no such interface is found, return -1 (note:  unit test framework
 // for routing assumes -1 to be a legal return value)
 //
 int32_t
-GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
+GlobalRouteManagerImpl::FindOutgoingInterfaceId(const SPFCalculation& calc,
+                                                Ipv4Address a,
+                                                Ipv4Mask amask)
 {
     NS_LOG_FUNCTION(this << a << amask);
     //
-    // We have an IP address <a> and a vertex ID of the root of the SPF tree.
-    // The question is what interface index does this address correspond to.
-    // The answer is a little complicated since we have to find a pointer to
-    // the node corresponding to the vertex ID, find the Ipv4 interface on that
-    // node in order to iterate the interfaces and find the one corresponding to
-    // the address in question.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    // The node at the root of the SPF tree is the node for which we are
+    // building the routing table.  Its Ipv4 interface was found when the
+    // calculation was created.
     //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!calc.ipv4)
     {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-        //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
-        //
-        if (!rtr)
-        {
-            continue;
-        }
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif
-            return interface;
-        }
+        NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << calc.root);
+        return -1;
     }
     //
-    // Couldn't find it.
+    // Look through the interfaces on this node for one that has the IP address
+    // we're looking for.  If we find one, return the corresponding interface
+    // index, or -1 if not found.
     //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
-    return -1;
+    return calc.ipv4->GetInterfaceForPrefix(a, amask);
 }
 
 //
 // This method is derived from quagga ospf_intra_add_router ()
 //
-// This is where we are actually going to add the host routes to the routing
-// tables of the individual nodes.
+// This is where we compute the host routes of the node at the root of the
+// SPF tree.
 //
-// The vertex passed as a parameter has just been added to the SPF tree.
-// This vertex must have a valid m_root_oid, corresponding to the outgoing
-// interface on the root router of the tree that is the first hop on the path
-// to the vertex.  The vertex must also have a next hop address, corresponding
-// to the next hop on the path to the vertex.  The vertex has an m_lsa field
-// that has some number of link records.  For each point to point link record,
-// the m_linkData is the local IP address of the link.  This corresponds to
-// a destination IP address, reachable from the root, to which we add a host
-// route.
+// The vertex passed as a parameter is in the SPF tree.  It has the outgoing
+// interfaces on the root router of the tree that are the first hop on the
+// paths to the vertex, and the corresponding next hop addresses.  The LSA of
+// the vertex has some number of link records.  For each point to point link
+// record, the m_linkData is the local IP address of the link.  This
+// corresponds to a destination IP address, reachable from the root, to which
+// we add a host route.
 //
 void
-GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddRouter(SPFCalculation& calc, const SPFTreeVertex& v)
 {
-    NS_LOG_FUNCTION(this << v);
-
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
+    NS_LOG_FUNCTION(this << v.id);
     //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    GlobalRoutingLSA* lsa = m_lsdb->GetLSA(v.id);
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA for vertex "
+                      << v.id);
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    uint32_t nLinkRecords = lsa->GetNLinkRecords();
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Iterate through the link records on the vertex to which we're going to add
+    // routes.  To make sure we're being clear, we're going to add routing table
+    // entries to the tables on the node corresping to the root of the SPF tree.
+    // These entries will have routes to the IP addresses we find from looking at
+    // the local side of the point-to-point links found on the node described by
+    // the vertex <v>.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    NS_LOG_LOGIC(" Node " << calc.root << " found " << nLinkRecords << " link records in LSA "
+                          << lsa << "with LinkStateId " << lsa->GetLinkStateId());
+    for (uint32_t j = 0; j < nLinkRecords; ++j)
     {
-        Ptr<Node> node = *i;
         //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
+        // We are only concerned about point-to-point links
         //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+        if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
         //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
+        // Here's why we did all of that work.  We're going to add a host route to the
+        // host address found in the m_linkData field of the point-to-point link
+        // record.  In the case of a point-to-point link, this is the local IP address
+        // of the node connected to the link.  Each of these point-to-point links
+        // will correspond to a local interface that has an IP address to which
+        // the node at the root of the SPF tree can send packets.  The vertex <v>
+        // (corresponding to the node that has these links and interfaces) has
+        // the next hop addresses and the outbound interfaces of the root towards
+        // the vertex, one for each of the equal cost paths.
         //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresping to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
-            }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
-        }
+        SPFAddRoutes(calc, SPFRoute::HOST, lr->GetLinkData(), Ipv4Mask::GetOnes(), v);
     }
 }
 
 void
-GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddTransit(SPFCalculation& calc, const SPFTreeVertex& v)
 {
-    NS_LOG_FUNCTION(this << v);
-
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
+    NS_LOG_FUNCTION(this << v.id);
     //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    // Get the Network Link State Advertisement from the vertex we're adding
+    // the routes to.  We add a route to the network, through each of the
+    // exits of the root towards the vertex.
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
-    {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
-        {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
-        }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
-            }
-        }
-    }
+    GlobalRoutingLSA* lsa = m_lsdb->GetLSA(v.id);
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                  "Expected valid LSA for vertex "
+                      << v.id);
+    Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = lsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    SPFAddRoutes(calc, SPFRoute::NETWORK, tempip, tempmask, v);
 }
 
 // Derived from quagga ospf_vertex_add_parents ()
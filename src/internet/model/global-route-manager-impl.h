@@ -29,8 +29,10 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <queue>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -39,6 +41,7 @@ namespace ns3
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
 
 /**
@@ -569,11 +572,18 @@ class SPFVertex
  * also export their own LSAs.
  *
  * This class implements a searchable database of LSAs gathered from every
- * router in the simulation.
+ * router in the simulation.  The LSAs are indexed by their link state ID and
+ * by the link data of their transit network link records, so that both
+ * lookups of the SPF calculation take constant or logarithmic time.  The
+ * database is not modified by the SPF calculations, which can therefore
+ * run concurrently.
  */
 class GlobalRouteManagerLSDB
 {
   public:
+    typedef std::map<Ipv4Address, GlobalRoutingLSA*>
+        LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
+
     /**
      * @brief Construct an empty Global Router Manager Link State Database.
      *
@@ -639,6 +649,14 @@ class GlobalRouteManagerLSDB
      */
     GlobalRoutingLSA* GetLSAByLinkData(Ipv4Address addr) const;
 
+    /**
+     * @brief Get the router and network Link State Advertisements of the
+     * database.
+     *
+     * @returns The Link State Advertisements, by link state ID.
+     */
+    const LSDBMap_t& GetLSAs() const;
+
     /**
      * @brief Set all LSA flags to an initialized state, for SPF computation
      *
@@ -673,12 +691,13 @@ class GlobalRouteManagerLSDB
     uint32_t GetNumExtLSAs() const;
 
   private:
-    typedef std::map<Ipv4Address, GlobalRoutingLSA*>
-        LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
     typedef std::pair<Ipv4Address, GlobalRoutingLSA*>
         LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
+    typedef std::unordered_map<Ipv4Address, GlobalRoutingLSA*, Ipv4AddressHash>
+        LinkDataMap_t; //!< container of link data / Link State Advertisements
 
-    LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+    LSDBMap_t m_database;     //!< database of IPv4 addresses / Link State Advertisements
+    LinkDataMap_t m_linkData; //!< router LSAs by the link data of their transit records
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
 };
@@ -693,6 +712,20 @@ class GlobalRouteManagerLSDB
  * and finally configure each of the node's forwarding tables.
  *
  * The design is guided by OSPFv2 \RFC{2328} section 16.1.1 and quagga ospfd.
+ *
+ * The SPF calculation of a router only reads the LSDB and the interfaces of
+ * the router, and keeps its state (the explored vertices, the tree and the
+ * computed routes) in an SPFCalculation.  The calculations of the routers
+ * can therefore run on several threads; the routes are then installed on
+ * the simulation thread, in the order of the node list, so that the routing
+ * tables do not depend on the number of threads.
+ *
+ * When the incremental updates are enabled, the shortest path tree of each
+ * router is kept after the calculation.  UpdateRoutes () then compares the
+ * new LSDB with the previous one and, for each router, either keeps its
+ * routes, derives them again from its tree when only the networks and
+ * addresses advertised by the vertices of the tree changed, or recomputes
+ * its tree when a changed link may be on one of its shortest paths.
  */
 class GlobalRouteManagerImpl
 {
@@ -725,6 +758,38 @@ class GlobalRouteManagerImpl
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Update the routes after a change of the topology.
+     *
+     * If the incremental updates are disabled, or the routes have not been
+     * computed yet, this is equivalent to DeleteGlobalRoutes (),
+     * BuildGlobalRoutingDatabase () and InitializeRoutes ().  Otherwise, the
+     * routing database is built again and only the routers affected by the
+     * changes of the Link State Advertisements are updated.
+     *
+     * @returns The number of routers whose shortest path tree was computed.
+     */
+    virtual uint32_t UpdateRoutes();
+
+    /**
+     * @brief Set the number of threads of the SPF calculations.
+     * @param nThreads The number of threads; with 1 thread, the default, the
+     * routers are processed one at a time.
+     */
+    void SetNThreads(uint32_t nThreads);
+
+    /**
+     * @brief Enable or disable the incremental updates of the routes.
+     *
+     * The incremental updates keep the shortest path tree of every router,
+     * which takes memory in the order of the square of the number of routers.
+     * The setting applies to the next InitializeRoutes ().
+     *
+     * @param incremental Whether UpdateRoutes () only updates the affected
+     * routers.
+     */
+    void SetIncremental(bool incremental);
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -738,8 +803,126 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
-    SPFVertex* m_spfroot;           //!< the root node
+    /**
+     * @brief A route computed by an SPF calculation, to be installed in the
+     * routing table of the root.
+     */
+    struct SPFRoute
+    {
+        /** The kind of route */
+        enum Type
+        {
+            HOST,    //!< Host route, see Ipv4GlobalRouting::AddHostRouteTo
+            NETWORK, //!< Network route, see Ipv4GlobalRouting::AddNetworkRouteTo
+            EXTERNAL //!< External route, see Ipv4GlobalRouting::AddASExternalRouteTo
+        };
+
+        Type type;           //!< the kind of route
+        Ipv4Address dest;    //!< the destination host or network
+        Ipv4Mask mask;       //!< the mask of the destination network
+        Ipv4Address nextHop; //!< the next hop
+        uint32_t outIf;      //!< the outgoing interface
+    };
+
+    /**
+     * @brief A vertex of a shortest path tree, as kept after the SPF
+     * calculation.
+     */
+    struct SPFTreeVertex
+    {
+        Ipv4Address id;                           //!< the vertex ID
+        SPFVertex::VertexType type;               //!< the vertex type
+        uint32_t distance;                        //!< the distance from the root
+        std::vector<SPFVertex::NodeExit_t> exits; //!< the root's exits towards the vertex
+    };
+
+    /**
+     * @brief The state of the SPF calculation of a router.
+     */
+    struct SPFCalculation
+    {
+        Ipv4Address root;               //!< the router ID of the root
+        Ptr<Ipv4> ipv4;                 //!< the IPv4 stack of the root, if known
+        Ptr<Ipv4GlobalRouting> routing; //!< the routing protocol of the root, if known
+        SPFVertex* spfroot{nullptr};    //!< the root of the tree being built
+        /**
+         * The LSAs of the explored vertices: the candidate vertex, or nullptr
+         * if the vertex is in the tree.  The LSAs not in the map are not
+         * explored yet.
+         */
+        std::unordered_map<const GlobalRoutingLSA*, SPFVertex*> explored;
+        bool stub{false};                //!< whether the root is a stub node
+        std::vector<SPFTreeVertex> tree; //!< the vertices, in the order they joined the tree
+        std::vector<uint32_t> walk;      //!< the indices of the vertices, depth first
+        /** The indices of the vertices in the tree, by vertex ID */
+        std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> index;
+        std::vector<SPFRoute> routes; //!< the routes to install
+    };
+
+    /** How a change of the LSDB affects the routes of a router */
+    enum SPFUpdate
+    {
+        SPF_UNCHANGED,  //!< the routes are unchanged
+        SPF_REGENERATE, //!< the routes are derived again from the tree
+        SPF_RECOMPUTE   //!< the tree is computed again
+    };
+
+    struct LSDBChanges;
+
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    uint32_t m_nThreads;            //!< the number of threads of the SPF calculations
+    bool m_incremental;             //!< whether the trees are kept for incremental updates
+    std::vector<std::unique_ptr<SPFCalculation>>
+        m_calculations; //!< the calculations kept for incremental updates, in node order
+
+    /**
+     * \brief Compute and install the routes of all the routers of this
+     * system.
+     *
+     * \returns the number of routers
+     */
+    uint32_t CalculateRoutes();
+
+    /**
+     * \brief Create the SPF calculations of the routers of this system.
+     *
+     * \param calcs the calculations, in the order of the node list
+     */
+    void CreateCalculations(std::vector<std::unique_ptr<SPFCalculation>>& calcs);
+
+    /**
+     * \brief Run a step of several SPF calculations, possibly on several
+     * threads.
+     *
+     * \param calcs the calculations
+     * \param step the step to run on each calculation
+     */
+    void RunCalculations(const std::vector<SPFCalculation*>& calcs,
+                         void (GlobalRouteManagerImpl::*step)(SPFCalculation&));
+
+    /**
+     * \brief Install the routes of an SPF calculation in its root, and release
+     * them.
+     *
+     * \param calc the calculation
+     */
+    void InstallRoutes(SPFCalculation& calc);
+
+    /**
+     * \brief Remove all the routes of a routing protocol.
+     *
+     * \param gr the routing protocol
+     */
+    void RemoveRoutes(Ptr<Ipv4GlobalRouting> gr);
+
+    /**
+     * \brief Find how a change of the LSDB affects the routes of a router.
+     *
+     * \param calc the calculation of the router, with its tree
+     * \param changes the changes of the LSDB
+     * \returns how the routes of the router must be updated
+     */
+    SPFUpdate GetUpdate(const SPFCalculation& calc, const LSDBChanges& changes) const;
 
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
@@ -748,18 +931,58 @@ class GlobalRouteManagerImpl
      * can safely be added to the next-hop router and SPF does not need
      * to be run
      *
-     * \param root the root node
+     * \param calc the calculation of the root node
      * \returns true if the node is a stub
      */
-    bool CheckForStubNode(Ipv4Address root);
+    bool CheckForStubNode(SPFCalculation& calc);
 
     /**
-     * \brief Calculate the shortest path first (SPF) tree
+     * \brief Calculate the shortest path first (SPF) tree and the routes
      *
      * Equivalent to quagga ospf_spf_calculate
-     * \param root the root node
+     * \param calc the calculation of the root node
+     */
+    void SPFCalculate(SPFCalculation& calc);
+
+    /**
+     * \brief Add a vertex which joined the SPF tree to the kept tree
+     *
+     * \param calc the calculation
+     * \param v the vertex
+     */
+    void SPFAddToTree(SPFCalculation& calc, SPFVertex* v);
+
+    /**
+     * \brief Record the depth first order of the vertices of the SPF tree,
+     * in which the stubs are processed
+     *
+     * \param calc the calculation
+     * \param v the vertex to walk from
+     */
+    void SPFWalkTree(SPFCalculation& calc, SPFVertex* v);
+
+    /**
+     * \brief Derive the routes of the root from its SPF tree and the LSDB
+     *
+     * \param calc the calculation, with its tree
+     */
+    void SPFGenerateRoutes(SPFCalculation& calc);
+
+    /**
+     * \brief Add the routes towards a vertex, through each of the root's
+     * exits towards it
+     *
+     * \param calc the calculation
+     * \param type the kind of route
+     * \param dest the destination host or network
+     * \param mask the mask of the destination network
+     * \param v the vertex
      */
-    void SPFCalculate(Ipv4Address root);
+    void SPFAddRoutes(SPFCalculation& calc,
+                      SPFRoute::Type type,
+                      Ipv4Address dest,
+                      Ipv4Mask mask,
+                      const SPFTreeVertex& v);
 
     /**
      * \brief Process Stub nodes
@@ -768,17 +991,17 @@ class GlobalRouteManagerImpl
      * stub link records will exist for point-to-point interfaces and for
      * broadcast interfaces for which no neighboring router can be found
      *
-     * \param v vertex to be processed
+     * \param calc the calculation
      */
-    void SPFProcessStubs(SPFVertex* v);
+    void SPFProcessStubs(SPFCalculation& calc);
 
     /**
      * \brief Process Autonomous Systems (AS) External LSA
      *
-     * \param v vertex to be processed
+     * \param calc the calculation
      * \param extlsa external LSA
      */
-    void ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extlsa);
+    void ProcessASExternals(SPFCalculation& calc, GlobalRoutingLSA* extlsa);
 
     /**
      * \brief Examine the links in v's LSA and update the list of candidates with any
@@ -798,10 +1021,11 @@ class GlobalRouteManagerImpl
      * vertices not already on the list.  If a lower-cost path is found to a
      * vertex already on the candidate list, store the new (lower) cost.
      *
+     * \param calc the calculation
      * \param v the vertex
      * \param candidate the SPF candidate queue
      */
-    void SPFNext(SPFVertex* v, CandidateQueue& candidate);
+    void SPFNext(SPFCalculation& calc, SPFVertex* v, CandidateQueue& candidate);
 
     /**
      * \brief Calculate nexthop from root through V (parent) to vertex W (destination)
@@ -810,13 +1034,15 @@ class GlobalRouteManagerImpl
      * This method is derived from quagga ospf_nexthop_calculation() 16.1.1.
      * For now, this is greatly simplified from the quagga code
      *
+     * \param calc the calculation
      * \param v the parent
      * \param w the destination
      * \param l the link record
      * \param distance the target distance
      * \returns 1 on success
      */
-    int SPFNexthopCalculation(SPFVertex* v,
+    int SPFNexthopCalculation(const SPFCalculation& calc,
+                              SPFVertex* v,
                               SPFVertex* w,
                               GlobalRoutingLinkRecord* l,
                               uint32_t distance);
@@ -866,60 +1092,65 @@ class GlobalRouteManagerImpl
      *
      * This method is derived from quagga ospf_intra_add_router ()
      *
-     * This is where we are actually going to add the host routes to the routing
-     * tables of the individual nodes.
+     * This is where we compute the host routes of the node at the root of the
+     * SPF tree.
      *
-     * The vertex passed as a parameter has just been added to the SPF tree.
-     * This vertex must have a valid m_root_oid, corresponding to the outgoing
-     * interface on the root router of the tree that is the first hop on the path
-     * to the vertex.  The vertex must also have a next hop address, corresponding
-     * to the next hop on the path to the vertex.  The vertex has an m_lsa field
-     * that has some number of link records.  For each point to point link record,
-     * the m_linkData is the local IP address of the link.  This corresponds to
-     * a destination IP address, reachable from the root, to which we add a host
-     * route.
+     * The vertex passed as a parameter is in the SPF tree.  It has the
+     * outgoing interfaces on the root router of the tree that are the first hop
+     * on the paths to the vertex, and the corresponding next hop addresses.
+     * The LSA of the vertex has some number of link records.  For each point to
+     * point link record, the m_linkData is the local IP address of the link.
+     * This corresponds to a destination IP address, reachable from the root, to
+     * which we add a host route.
      *
+     * \param calc the calculation
      * \param v the vertex
      *
      */
-    void SPFIntraAddRouter(SPFVertex* v);
+    void SPFIntraAddRouter(SPFCalculation& calc, const SPFTreeVertex& v);
 
     /**
      * \brief Add a transit to the routing tables
      *
+     * \param calc the calculation
      * \param v the vertex
      */
-    void SPFIntraAddTransit(SPFVertex* v);
+    void SPFIntraAddTransit(SPFCalculation& calc, const SPFTreeVertex& v);
 
     /**
      * \brief Add a stub to the routing tables
      *
+     * \param calc the calculation
      * \param l the global routing link record
      * \param v the vertex
      */
-    void SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v);
+    void SPFIntraAddStub(SPFCalculation& calc, GlobalRoutingLinkRecord* l, const SPFTreeVertex& v);
 
     /**
      * \brief Add an external route to the routing tables
      *
+     * \param calc the calculation
      * \param extlsa the external LSA
      * \param v the vertex
      */
-    void SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v);
+    void SPFAddASExternal(SPFCalculation& calc, GlobalRoutingLSA* extlsa, const SPFTreeVertex& v);
 
     /**
      * \brief Return the interface number corresponding to a given IP address and mask
      *
-     * This is a wrapper around GetInterfaceForPrefix(), but we first
-     * have to find the right node pointer to pass to that function.
+     * This is a wrapper around GetInterfaceForPrefix() on the node at the
+     * root of the calculation.
      * If no such interface is found, return -1 (note:  unit test framework
      * for routing assumes -1 to be a legal return value)
      *
+     * \param calc the calculation
      * \param a the target IP address
      * \param amask the target subnet mask
      * \return the outgoing interface number
      */
-    int32_t FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask = Ipv4Mask("255.255.255.255"));
+    int32_t FindOutgoingInterfaceId(const SPFCalculation& calc,
+                                    Ipv4Address a,
+                                    Ipv4Mask amask = Ipv4Mask("255.255.255.255"));
 };
 
 } // namespace ns3
@@ -57,6 +57,27 @@ GlobalRouteManager::InitializeRoutes()
     SimulationSingleton<GlobalRouteManagerImpl>::Get()->InitializeRoutes();
 }
 
+uint32_t
+GlobalRouteManager::UpdateRoutes()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    return SimulationSingleton<GlobalRouteManagerImpl>::Get()->UpdateRoutes();
+}
+
+void
+GlobalRouteManager::SetNThreads(uint32_t nThreads)
+{
+    NS_LOG_FUNCTION(nThreads);
+    SimulationSingleton<GlobalRouteManagerImpl>::Get()->SetNThreads(nThreads);
+}
+
+void
+GlobalRouteManager::SetIncremental(bool incremental)
+{
+    NS_LOG_FUNCTION(incremental);
+    SimulationSingleton<GlobalRouteManagerImpl>::Get()->SetIncremental(incremental);
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId()
 {
@@ -70,6 +70,31 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Update the routes after a change of the topology.
+     *
+     * Without incremental updates, this deletes, rebuilds and recomputes all
+     * the routes.  With incremental updates, only the routers affected by
+     * the changes of the Link State Advertisements are updated.
+     *
+     * @returns The number of routers whose shortest path tree was computed.
+     */
+    static uint32_t UpdateRoutes();
+
+    /**
+     * @brief Set the number of threads of the SPF calculations.
+     * @param nThreads The number of threads (default 1).
+     */
+    static void SetNThreads(uint32_t nThreads);
+
+    /**
+     * @brief Enable or disable the incremental updates of the routes, which
+     * keep the shortest path tree of every router.
+     * @param incremental Whether UpdateRoutes () only updates the affected
+     * routers (default false).
+     */
+    static void SetIncremental(bool incremental);
 };
 
 } // namespace ns3
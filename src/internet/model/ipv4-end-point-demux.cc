@@ -24,15 +24,35 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("Ipv4EndPointDemux");
 
+bool
+Ipv4EndPointDemux::Connection::operator==(const Connection& other) const
+{
+    return localAddress == other.localAddress && localPort == other.localPort &&
+           peerAddress == other.peerAddress && peerPort == other.peerPort;
+}
+
+size_t
+Ipv4EndPointDemux::ConnectionHash::operator()(const Connection& connection) const
+{
+    uint64_t addresses =
+        (uint64_t(connection.localAddress.Get()) << 32) | connection.peerAddress.Get();
+    uint32_t ports = (uint32_t(connection.localPort) << 16) | connection.peerPort;
+    return std::hash<uint64_t>()(addresses ^ (uint64_t(ports) * 0x9e3779b97f4a7c15ULL));
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux()
     : m_ephemeral(49152),
       m_portLast(65535),
-      m_portFirst(49152)
+      m_portFirst(49152),
+      m_nextOrder(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -40,36 +60,94 @@ Ipv4EndPointDemux::Ipv4EndPointDemux()
 Ipv4EndPointDemux::~Ipv4EndPointDemux()
 {
     NS_LOG_FUNCTION(this);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // The destroy callbacks of the end points may deallocate other end points
+    for (auto endPoint : GetAllEndPoints())
     {
-        Ipv4EndPoint* endPoint = *i;
-        delete endPoint;
+        DeAllocate(endPoint);
     }
-    m_endPoints.clear();
 }
 
-bool
-Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
+void
+Ipv4EndPointDemux::Index(Ipv4EndPoint* endPoint)
 {
-    NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    uint64_t order = m_endPoints.at(endPoint);
+    Port& port = m_ports[endPoint->GetLocalPort()];
+    port.all.emplace(order, endPoint);
+    if (endPoint->GetPeerAddress() != Ipv4Address::GetAny() && endPoint->GetPeerPort() != 0)
+    {
+        m_connections.emplace(Connection{endPoint->GetLocalAddress(),
+                                         endPoint->GetLocalPort(),
+                                         endPoint->GetPeerAddress(),
+                                         endPoint->GetPeerPort()},
+                              endPoint);
+    }
+    else
+    {
+        port.unconnected.emplace(order, endPoint);
+    }
+}
+
+void
+Ipv4EndPointDemux::Unindex(Ipv4EndPoint* endPoint)
+{
+    uint64_t order = m_endPoints.at(endPoint);
+    auto port = m_ports.find(endPoint->GetLocalPort());
+    NS_ASSERT(port != m_ports.end());
+    if (endPoint->GetPeerAddress() != Ipv4Address::GetAny() && endPoint->GetPeerPort() != 0)
     {
-        if ((*i)->GetLocalPort() == port)
+        auto range = m_connections.equal_range(Connection{endPoint->GetLocalAddress(),
+                                                          endPoint->GetLocalPort(),
+                                                          endPoint->GetPeerAddress(),
+                                                          endPoint->GetPeerPort()});
+        for (auto i = range.first; i != range.second; i++)
         {
-            return true;
+            if (i->second == endPoint)
+            {
+                m_connections.erase(i);
+                break;
+            }
         }
     }
-    return false;
+    else
+    {
+        port->second.unconnected.erase(order);
+    }
+    port->second.all.erase(order);
+    if (port->second.all.empty())
+    {
+        m_ports.erase(port);
+    }
+}
+
+Ipv4EndPoint*
+Ipv4EndPointDemux::Insert(Ipv4EndPoint* endPoint)
+{
+    m_endPoints.emplace(endPoint, m_nextOrder++);
+    endPoint->m_demux = this;
+    Index(endPoint);
+    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+    return endPoint;
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
+{
+    NS_LOG_FUNCTION(this << port);
+    return m_ports.find(port) != m_ports.end();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto i = m_ports.find(port);
+    if (i == m_ports.end())
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        return false;
+    }
+    for (const auto& [order, endPoint] : i->second.all)
+    {
+        if (endPoint->GetLocalAddress() == addr && endPoint->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -87,10 +165,7 @@ Ipv4EndPointDemux::Allocate()
         NS_LOG_WARN("Ephemeral port allocation failed.");
         return nullptr;
     }
-    auto endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-    return endPoint;
+    return Insert(new Ipv4EndPoint(Ipv4Address::GetAny(), port));
 }
 
 Ipv4EndPoint*
@@ -103,10 +178,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         NS_LOG_WARN("Ephemeral port allocation failed.");
         return nullptr;
     }
-    auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-    return endPoint;
+    return Insert(new Ipv4EndPoint(address, port));
 }
 
 Ipv4EndPoint*
@@ -126,10 +198,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         NS_LOG_WARN("Duplicated endpoint.");
         return nullptr;
     }
-    auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-    return endPoint;
+    return Insert(new Ipv4EndPoint(address, port));
 }
 
 Ipv4EndPoint*
@@ -140,37 +209,52 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto isDuplicate = [&](Ipv4EndPoint* endPoint) {
+        return endPoint->GetLocalAddress() == localAddress &&
+               endPoint->GetPeerPort() == peerPort && endPoint->GetPeerAddress() == peerAddress &&
+               (endPoint->GetBoundNetDevice() == boundNetDevice ||
+                !endPoint->GetBoundNetDevice());
+    };
+    bool duplicate = false;
+    if (peerAddress != Ipv4Address::GetAny() && peerPort != 0)
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        auto range =
+            m_connections.equal_range(Connection{localAddress, localPort, peerAddress, peerPort});
+        for (auto i = range.first; i != range.second && !duplicate; i++)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            duplicate = isDuplicate(i->second);
         }
     }
+    else if (auto port = m_ports.find(localPort); port != m_ports.end())
+    {
+        for (auto i = port->second.unconnected.begin();
+             i != port->second.unconnected.end() && !duplicate;
+             i++)
+        {
+            duplicate = isDuplicate(i->second);
+        }
+    }
+    if (duplicate)
+    {
+        NS_LOG_WARN("Duplicated endpoint.");
+        return nullptr;
+    }
     auto endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
-
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-
-    return endPoint;
+    return Insert(endPoint);
 }
 
 void
 Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this << endPoint);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto i = m_endPoints.find(endPoint);
+    if (i != m_endPoints.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        Unindex(endPoint);
+        m_endPoints.erase(i);
+        endPoint->m_demux = nullptr;
+        delete endPoint;
     }
 }
 
@@ -181,16 +265,145 @@ Ipv4EndPointDemux::EndPoints
 Ipv4EndPointDemux::GetAllEndPoints()
 {
     NS_LOG_FUNCTION(this);
-    EndPoints ret;
+    std::vector<std::pair<uint64_t, Ipv4EndPoint*>> endPoints;
+    endPoints.reserve(m_endPoints.size());
+    for (const auto& [endPoint, order] : m_endPoints)
+    {
+        endPoints.emplace_back(order, endPoint);
+    }
+    std::sort(endPoints.begin(), endPoints.end());
 
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    EndPoints ret;
+    for (const auto& [order, endPoint] : endPoints)
     {
-        Ipv4EndPoint* endP = *i;
-        ret.push_back(endP);
+        ret.push_back(endPoint);
     }
     return ret;
 }
 
+uint32_t
+Ipv4EndPointDemux::Match(Ipv4EndPoint* endP,
+                         Ipv4Address daddr,
+                         Ipv4Address saddr,
+                         uint16_t sport,
+                         Ptr<Ipv4Interface> incomingInterface) const
+{
+    NS_LOG_DEBUG("Looking at endpoint dport="
+                 << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                 << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
+
+    if (!endP->IsRxEnabled())
+    {
+        NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint can not receive packets");
+        return 0;
+    }
+
+    if (endP->GetBoundNetDevice())
+    {
+        if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+        {
+            NS_LOG_LOGIC("Skipping endpoint "
+                         << &endP << " because endpoint is bound to specific device and"
+                         << endP->GetBoundNetDevice() << " does not match packet device "
+                         << incomingInterface->GetDevice());
+            return 0;
+        }
+    }
+
+    bool localAddressMatchesExact = false;
+    bool localAddressIsAny = false;
+    bool localAddressIsSubnetAny = false;
+
+    // We have 3 cases:
+    // 1) Exact local / destination address match
+    // 2) Local endpoint bound to Any -> matches anything
+    // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
+    // x.y.z.255 in a /24 net) and direct destination match.
+
+    if (endP->GetLocalAddress() == daddr)
+    {
+        // Case 1:
+        localAddressMatchesExact = true;
+    }
+    else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
+    {
+        // Case 2:
+        localAddressIsAny = true;
+    }
+    else
+    {
+        // Case 3:
+        for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
+        {
+            Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
+
+            Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
+            if (endP->GetLocalAddress() == addrNetpart)
+            {
+                NS_LOG_LOGIC("Endpoint is SubnetDirectedAny " << endP->GetLocalAddress() << "/"
+                                                              << addr.GetMask().GetPrefixLength());
+
+                Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
+                if (addrNetpart == daddrNetPart)
+                {
+                    localAddressIsSubnetAny = true;
+                }
+            }
+        }
+
+        // if no match here, keep looking
+        if (!localAddressIsSubnetAny)
+        {
+            return 0;
+        }
+    }
+
+    bool remotePortMatchesExact = endP->GetPeerPort() == sport;
+    bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
+    bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
+    bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
+
+    // If remote does not match either with exact or wildcard,
+    // skip this one
+    if (!(remotePortMatchesExact || remotePortMatchesWildCard))
+    {
+        return 0;
+    }
+    if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+    {
+        return 0;
+    }
+
+    bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
+
+    uint32_t cases = 0;
+    if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
+    { // All 4 match - this is the case of an open TCP connection, for example.
+        NS_LOG_LOGIC("Found an endpoint for case 4, adding " << endP->GetLocalAddress() << ":"
+                                                             << endP->GetLocalPort());
+        cases |= 1;
+    }
+    if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
+    { // All but local address - no idea what this case could be.
+        NS_LOG_LOGIC("Found an endpoint for case 3, adding " << endP->GetLocalAddress() << ":"
+                                                             << endP->GetLocalPort());
+        cases |= 2;
+    }
+    if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
+    { // Only local port and local address matches exactly - Not yet opened connection
+        NS_LOG_LOGIC("Found an endpoint for case 2, adding " << endP->GetLocalAddress() << ":"
+                                                             << endP->GetLocalPort());
+        cases |= 4;
+    }
+    if (localAddressMatchesWildCard && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
+    { // Only local port matches exactly - Endpoint open to "any" connection
+        NS_LOG_LOGIC("Found an endpoint for case 1, adding " << endP->GetLocalAddress() << ":"
+                                                             << endP->GetLocalPort());
+        cases |= 8;
+    }
+    return cases;
+}
+
 /*
  * If we have an exact match, we return it.
  * Otherwise, if we find a generic match, we return it.
@@ -205,163 +418,81 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport << incomingInterface);
 
-    EndPoints retval1; // Matches exact on local port, wildcards on others
-    EndPoints retval2; // Matches exact on local port/adder, wildcards on others
-    EndPoints retval3; // Matches all but local address
-    EndPoints retval4; // Exact match on all 4
-
-    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        Ipv4EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
-
-        if (endP->GetLocalPort() != dport)
+    // retval[0]: Exact match on all 4
+    // retval[1]: Matches all but local address
+    // retval[2]: Matches exact on local port/adder, wildcards on others
+    // retval[3]: Matches exact on local port, wildcards on others
+    EndPoints retval[4];
+    auto add = [&](Ipv4EndPoint* endP) {
+        uint32_t cases = Match(endP, daddr, saddr, sport, incomingInterface);
+        for (uint32_t i = 0; i < 4; i++)
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
-        }
-        if (endP->GetBoundNetDevice())
-        {
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            if (cases & (1 << i))
             {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
-                continue;
+                retval[i].push_back(endP);
             }
         }
+    };
 
-        bool localAddressMatchesExact = false;
-        bool localAddressIsAny = false;
-        bool localAddressIsSubnetAny = false;
-
-        // We have 3 cases:
-        // 1) Exact local / destination address match
-        // 2) Local endpoint bound to Any -> matches anything
-        // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
-        // x.y.z.255 in a /24 net) and direct destination match.
-
-        if (endP->GetLocalAddress() == daddr)
-        {
-            // Case 1:
-            localAddressMatchesExact = true;
-        }
-        else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
+    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
+    auto port = m_ports.find(dport);
+    if (port == m_ports.end())
+    {
+        return EndPoints();
+    }
+    //
+    // The endpoints with a peer can only match with the source address and
+    // port of the packet, and with a local address which is the destination
+    // address, the any address, or the network of an address of the incoming
+    // interface.
+    //
+    if (saddr != Ipv4Address::GetAny() && sport != 0)
+    {
+        std::vector<Ipv4Address> localAddresses{daddr};
+        if (daddr != Ipv4Address::GetAny())
         {
-            // Case 2:
-            localAddressIsAny = true;
+            localAddresses.push_back(Ipv4Address::GetAny());
         }
-        else
+        for (uint32_t i = 0; incomingInterface && i < incomingInterface->GetNAddresses(); i++)
         {
-            // Case 3:
-            for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
+            Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
+            Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
+            if (std::find(localAddresses.begin(), localAddresses.end(), addrNetpart) ==
+                localAddresses.end())
             {
-                Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
-
-                Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
-                if (endP->GetLocalAddress() == addrNetpart)
-                {
-                    NS_LOG_LOGIC("Endpoint is SubnetDirectedAny "
-                                 << endP->GetLocalAddress() << "/"
-                                 << addr.GetMask().GetPrefixLength());
-
-                    Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
-                    if (addrNetpart == daddrNetPart)
-                    {
-                        localAddressIsSubnetAny = true;
-                    }
-                }
+                localAddresses.push_back(addrNetpart);
             }
-
-            // if no match here, keep looking
-            if (!localAddressIsSubnetAny)
-            {
-                continue;
-            }
-        }
-
-        bool remotePortMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
-
-        // If remote does not match either with exact or wildcard,
-        // skip this one
-        if (!(remotePortMatchesExact || remotePortMatchesWildCard))
-        {
-            continue;
         }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+        for (const auto& localAddress : localAddresses)
         {
-            continue;
-        }
-
-        bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
-
-        if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All 4 match - this is the case of an open TCP connection, for example.
-            NS_LOG_LOGIC("Found an endpoint for case 4, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval4.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All but local address - no idea what this case could be.
-            NS_LOG_LOGIC("Found an endpoint for case 3, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
-        { // Only local port and local address matches exactly - Not yet opened connection
-            NS_LOG_LOGIC("Found an endpoint for case 2, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesWildCard &&
-            remotePortMatchesWildCard)
-        { // Only local port matches exactly - Endpoint open to "any" connection
-            NS_LOG_LOGIC("Found an endpoint for case 1, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval1.push_back(endP);
+            auto range = m_connections.equal_range(Connection{localAddress, dport, saddr, sport});
+            for (auto i = range.first; i != range.second; i++)
+            {
+                add(i->second);
+            }
         }
     }
-
-    // Here we find the most exact match
-    EndPoints retval;
-    if (!retval4.empty())
+    for (const auto& [order, endP] : port->second.unconnected)
     {
-        retval = retval4;
+        add(endP);
     }
-    else if (!retval3.empty())
-    {
-        retval = retval3;
-    }
-    else if (!retval2.empty())
-    {
-        retval = retval2;
-    }
-    else
+
+    // Here we find the most exact match
+    EndPoints empty;
+    EndPoints* found = &empty;
+    for (auto& endPoints : retval)
     {
-        retval = retval1;
+        if (!endPoints.empty())
+        {
+            found = &endPoints;
+            break;
+        }
     }
 
-    NS_ABORT_MSG_IF(retval.size() > 1,
+    NS_ABORT_MSG_IF(found->size() > 1,
                     "Too many endpoints - perhaps you created too many sockets without binding "
                     "them to different NetDevices.");
-    return retval; // might be empty if no matches
+    return *found; // might be empty if no matches
 }
 
 Ipv4EndPoint*
@@ -373,33 +504,35 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport);
 
     // this code is a copy/paste version of an old BSD ip stack lookup
-    // function.
+    // function.  It is only used for the ICMP errors, so the endpoints of
+    // the port are scanned in allocation order.
+    auto port = m_ports.find(dport);
+    if (port == m_ports.end())
+    {
+        return nullptr;
+    }
     uint32_t genericity = 3;
     Ipv4EndPoint* generic = nullptr;
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    for (const auto& [order, endPoint] : port->second.all)
     {
-        if ((*i)->GetLocalPort() != dport)
-        {
-            continue;
-        }
-        if ((*i)->GetLocalAddress() == daddr && (*i)->GetPeerPort() == sport &&
-            (*i)->GetPeerAddress() == saddr)
+        if (endPoint->GetLocalAddress() == daddr && endPoint->GetPeerPort() == sport &&
+            endPoint->GetPeerAddress() == saddr)
         {
             /* this is an exact match. */
-            return *i;
+            return endPoint;
         }
         uint32_t tmp = 0;
-        if ((*i)->GetLocalAddress() == Ipv4Address::GetAny())
+        if (endPoint->GetLocalAddress() == Ipv4Address::GetAny())
         {
             tmp++;
         }
-        if ((*i)->GetPeerAddress() == Ipv4Address::GetAny())
+        if (endPoint->GetPeerAddress() == Ipv4Address::GetAny())
         {
             tmp++;
         }
         if (tmp < genericity)
         {
-            generic = (*i);
+            generic = endPoint;
             genericity = tmp;
         }
     }
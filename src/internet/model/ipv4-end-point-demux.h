@@ -25,7 +25,9 @@
 #include "ns3/ipv4-address.h"
 
 #include <list>
+#include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -42,6 +44,14 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are indexed in hash tables: the endpoints with a peer address
+ * and port (e.g., the connected TCP sockets) by their four-tuple, and the
+ * other endpoints (e.g., the listening sockets) by their local port.  A
+ * lookup therefore only examines the endpoints which can match the packet,
+ * whatever the number of connections, with the same precedence as a scan of
+ * all the endpoints.  The endpoints update the index when their addresses
+ * change.
  */
 
 class Ipv4EndPointDemux
@@ -171,6 +181,84 @@ class Ipv4EndPointDemux
     void DeAllocate(Ipv4EndPoint* endPoint);
 
   private:
+    friend class Ipv4EndPoint;
+
+    /**
+     * \brief The four-tuple of an endpoint with a peer address and port.
+     */
+    struct Connection
+    {
+        Ipv4Address localAddress; //!< The local address
+        uint16_t localPort;       //!< The local port
+        Ipv4Address peerAddress;  //!< The peer address
+        uint16_t peerPort;        //!< The peer port
+
+        /**
+         * \brief Equality operator.
+         * \param other the other four-tuple
+         * \return true if the four-tuples are equal
+         */
+        bool operator==(const Connection& other) const;
+    };
+
+    /**
+     * \brief Hash function of the four-tuples.
+     */
+    struct ConnectionHash
+    {
+        /**
+         * \brief Hash a four-tuple.
+         * \param connection the four-tuple
+         * \return the hash
+         */
+        size_t operator()(const Connection& connection) const;
+    };
+
+    /**
+     * \brief The endpoints of a local port, by allocation order.
+     */
+    struct Port
+    {
+        std::map<uint64_t, Ipv4EndPoint*> all;         //!< All the endpoints
+        std::map<uint64_t, Ipv4EndPoint*> unconnected; //!< The endpoints without a peer
+    };
+
+    /**
+     * \brief Add an endpoint to the indexes.
+     * \param endPoint the endpoint
+     */
+    void Index(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Remove an endpoint from the indexes.
+     * \param endPoint the endpoint
+     */
+    void Unindex(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Add a new endpoint to the demux.
+     * \param endPoint the endpoint
+     * \return the endpoint
+     */
+    Ipv4EndPoint* Insert(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Check if an endpoint matches a packet.
+     *
+     * \param endP the endpoint, bound to the destination port
+     * \param daddr destination address to test
+     * \param saddr source address to test
+     * \param sport source port to test
+     * \param incomingInterface the incoming interface
+     * \return the cases of Lookup() matched by the endpoint, as a bit mask:
+     *         bit 0 for the full match, to bit 3 for the local port match
+     */
+    uint32_t Match(Ipv4EndPoint* endP,
+                   Ipv4Address daddr,
+                   Ipv4Address saddr,
+                   uint16_t sport,
+                   Ptr<Ipv4Interface> incomingInterface) const;
+
     /**
      * \brief Allocate an ephemeral port.
      * \returns the ephemeral port
@@ -193,9 +281,24 @@ class Ipv4EndPointDemux
     uint16_t m_portFirst;
 
     /**
-     * \brief A list of IPv4 end points.
+     * \brief The allocation order of the IPv4 end points.
+     */
+    std::unordered_map<Ipv4EndPoint*, uint64_t> m_endPoints;
+
+    /**
+     * \brief The allocation order of the next end point.
+     */
+    uint64_t m_nextOrder;
+
+    /**
+     * \brief The end points, by local port.
+     */
+    std::unordered_map<uint16_t, Port> m_ports;
+
+    /**
+     * \brief The end points with a peer address and port, by four-tuple.
      */
-    EndPoints m_endPoints;
+    std::unordered_multimap<Connection, Ipv4EndPoint*, ConnectionHash> m_connections;
 };
 
 } // namespace ns3
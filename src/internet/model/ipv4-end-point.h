@@ -33,6 +33,7 @@ namespace ns3
 {
 
 class Header;
+class Ipv4EndPointDemux;
 class Packet;
 
 /**
@@ -235,6 +236,13 @@ class Ipv4EndPoint
      * \brief true if the endpoint can receive packets.
      */
     bool m_rxEnabled;
+
+    /**
+     * \brief The demux which indexes the endpoint by its addresses, if any.
+     */
+    Ipv4EndPointDemux* m_demux;
+
+    friend class Ipv4EndPointDemux;
 };
 
 } // namespace ns3
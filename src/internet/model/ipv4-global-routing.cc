@@ -30,6 +30,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -83,6 +84,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
     m_hostRoutes.push_back(route);
+    m_hostRouteTrie.Add(route);
 }
 
 void
@@ -92,6 +94,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
     m_hostRoutes.push_back(route);
+    m_hostRouteTrie.Add(route);
 }
 
 void
@@ -104,6 +107,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_networkRoutes.push_back(route);
+    m_networkRouteTrie.Add(route);
 }
 
 void
@@ -113,6 +117,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     m_networkRoutes.push_back(route);
+    m_networkRouteTrie.Add(route);
 }
 
 void
@@ -125,6 +130,7 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_ASexternalRoutes.push_back(route);
+    m_ASexternalRouteTrie.Add(route);
 }
 
 Ptr<Ipv4Route>
@@ -138,65 +144,124 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     RouteVec_t allRoutes;
 
     NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
-    for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+    const Ipv4RouteTrie::Routes* hostRoutes = m_hostRouteTrie.Find(dest, Ipv4Mask::GetOnes());
+    if (hostRoutes)
     {
-        NS_ASSERT((*i)->IsHost());
-        if ((*i)->GetDest() == dest)
+        for (const auto& i : *hostRoutes)
         {
+            NS_ASSERT(i.entry->IsHost());
             if (oif)
             {
-                if (oif != m_ipv4->GetNetDevice((*i)->GetInterface()))
+                if (oif != m_ipv4->GetNetDevice(i.entry->GetInterface()))
                 {
                     NS_LOG_LOGIC("Not on requested interface, skipping");
                     continue;
                 }
             }
-            allRoutes.push_back(*i);
-            NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << *i);
+            allRoutes.push_back(i.entry);
+            NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << i.entry);
         }
     }
+    // The network and external routes of all the matching prefixes, and
+    // with a matching non-contiguous mask, are considered in the order in
+    // which they were added
+    const Ipv4RouteTrie::Routes* matches[Ipv4RouteTrie::MAX_MATCHES];
+    std::vector<const Ipv4RouteTrie::Route*> candidates;
     if (allRoutes.empty()) // if no host route is found
     {
         NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
-        for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+        uint32_t nMatches = m_networkRouteTrie.Lookup(dest, matches);
+        std::vector<const Ipv4RouteTrie::Route*> nonContiguous;
+        m_networkRouteTrie.LookupNonContiguous(dest, nonContiguous);
+        for (uint32_t k = 0; k < nMatches; k++)
         {
-            Ipv4Mask mask = (*j)->GetDestNetworkMask();
-            Ipv4Address entry = (*j)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+            for (const auto& j : *matches[k])
             {
                 if (oif)
                 {
-                    if (oif != m_ipv4->GetNetDevice((*j)->GetInterface()))
+                    if (oif != m_ipv4->GetNetDevice(j.entry->GetInterface()))
                     {
                         NS_LOG_LOGIC("Not on requested interface, skipping");
                         continue;
                     }
                 }
-                allRoutes.push_back(*j);
-                NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << *j);
+                candidates.push_back(&j);
             }
         }
+        for (auto j : nonContiguous)
+        {
+            if (oif)
+            {
+                if (oif != m_ipv4->GetNetDevice(j->entry->GetInterface()))
+                {
+                    NS_LOG_LOGIC("Not on requested interface, skipping");
+                    continue;
+                }
+            }
+            candidates.push_back(j);
+        }
+        if (nMatches > 1 || !nonContiguous.empty())
+        {
+            std::sort(candidates.begin(),
+                      candidates.end(),
+                      [](const Ipv4RouteTrie::Route* a, const Ipv4RouteTrie::Route* b) {
+                          return a->order < b->order;
+                      });
+        }
+        for (auto j : candidates)
+        {
+            allRoutes.push_back(j->entry);
+            NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << j->entry);
+        }
     }
     if (allRoutes.empty()) // consider external if no host/network found
     {
-        for (auto k = m_ASexternalRoutes.begin(); k != m_ASexternalRoutes.end(); k++)
+        const Ipv4RouteTrie::Route* first = nullptr;
+        uint32_t nMatches = m_ASexternalRouteTrie.Lookup(dest, matches);
+        for (uint32_t k = 0; k < nMatches; k++)
         {
-            Ipv4Mask mask = (*k)->GetDestNetworkMask();
-            Ipv4Address entry = (*k)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+            for (const auto& l : *matches[k])
             {
-                NS_LOG_LOGIC("Found external route" << *k);
+                if (first && first->order < l.order)
+                {
+                    break;
+                }
+                NS_LOG_LOGIC("Found external route" << l.entry);
                 if (oif)
                 {
-                    if (oif != m_ipv4->GetNetDevice((*k)->GetInterface()))
+                    if (oif != m_ipv4->GetNetDevice(l.entry->GetInterface()))
                     {
                         NS_LOG_LOGIC("Not on requested interface, skipping");
                         continue;
                     }
                 }
-                allRoutes.push_back(*k);
+                first = &l;
+                break;
+            }
+        }
+        candidates.clear();
+        m_ASexternalRouteTrie.LookupNonContiguous(dest, candidates);
+        for (auto l : candidates)
+        {
+            if (first && first->order < l->order)
+            {
                 break;
             }
+            NS_LOG_LOGIC("Found external route" << l->entry);
+            if (oif)
+            {
+                if (oif != m_ipv4->GetNetDevice(l->entry->GetInterface()))
+                {
+                    NS_LOG_LOGIC("Not on requested interface, skipping");
+                    continue;
+                }
+            }
+            first = l;
+            break;
+        }
+        if (first)
+        {
+            allRoutes.push_back(first->entry);
         }
     }
     if (!allRoutes.empty()) // if route(s) is found
@@ -297,6 +362,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             if (tmp == index)
             {
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
+                m_hostRouteTrie.Remove(*i);
                 delete *i;
                 m_hostRoutes.erase(i);
                 NS_LOG_LOGIC("Done removing host route "
@@ -313,6 +379,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
+            m_networkRouteTrie.Remove(*j);
             delete *j;
             m_networkRoutes.erase(j);
             NS_LOG_LOGIC("Done removing network route "
@@ -328,6 +395,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_ASexternalRoutes.size());
+            m_ASexternalRouteTrie.Remove(*k);
             delete *k;
             m_ASexternalRoutes.erase(k);
             NS_LOG_LOGIC("Done removing network route "
@@ -351,6 +419,9 @@ void
 Ipv4GlobalRouting::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_hostRouteTrie.Clear();
+    m_networkRouteTrie.Clear();
+    m_ASexternalRouteTrie.Clear();
     for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i = m_hostRoutes.erase(i))
     {
         delete (*i);
@@ -532,9 +603,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -544,9 +613,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -556,9 +623,7 @@ Ipv4GlobalRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress add
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -568,9 +633,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -20,6 +20,7 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include "ipv4-header.h"
+#include "ipv4-route-trie.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
@@ -277,6 +278,9 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     HostRoutes m_hostRoutes;             //!< Routes to hosts
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
+    Ipv4RouteTrie m_hostRouteTrie;       //!< Index of the routes to hosts
+    Ipv4RouteTrie m_networkRouteTrie;    //!< Index of the routes to networks
+    Ipv4RouteTrie m_ASexternalRouteTrie; //!< Index of the external routes
 
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
@@ -17,11 +17,10 @@
 
 #include "ipv4-queue-disc-item.h"
 
-#include "tcp-header.h"
-#include "udp-header.h"
-
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -125,23 +124,6 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
     uint8_t prot = m_header.GetProtocol();
     uint16_t fragOffset = m_header.GetFragmentOffset();
 
-    TcpHeader tcpHdr;
-    UdpHeader udpHdr;
-    uint16_t srcPort = 0;
-    uint16_t destPort = 0;
-
-    if (prot == 6 && fragOffset == 0) // TCP
-    {
-        GetPacket()->PeekHeader(tcpHdr);
-        srcPort = tcpHdr.GetSourcePort();
-        destPort = tcpHdr.GetDestinationPort();
-    }
-    else if (prot == 17 && fragOffset == 0) // UDP
-    {
-        GetPacket()->PeekHeader(udpHdr);
-        srcPort = udpHdr.GetSourcePort();
-        destPort = udpHdr.GetDestinationPort();
-    }
     if (prot != 6 && prot != 17)
     {
         NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
@@ -152,10 +134,16 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
     src.Serialize(buf);
     dest.Serialize(buf + 4);
     buf[8] = prot;
-    buf[9] = (srcPort >> 8) & 0xff;
-    buf[10] = srcPort & 0xff;
-    buf[11] = (destPort >> 8) & 0xff;
-    buf[12] = destPort & 0xff;
+    // the source and destination ports are the first four bytes of both the
+    // TCP and the UDP headers: copy them instead of deserializing the header
+    if ((prot == 6 || prot == 17) && fragOffset == 0 && GetPacket()->GetSize() >= 4)
+    {
+        GetPacket()->CopyData(buf + 9, 4);
+    }
+    else
+    {
+        std::fill(buf + 9, buf + 13, 0);
+    }
     buf[13] = (perturbation >> 24) & 0xff;
     buf[14] = (perturbation >> 16) & 0xff;
     buf[15] = (perturbation >> 8) & 0xff;
@@ -0,0 +1,326 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-route-trie.h"
+
+#include "ipv4-routing-table-entry.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Ipv4RouteTrie");
+
+namespace
+{
+
+/**
+ * \ingroup ipv4Routing
+ * Keep the first bits of an address.
+ * \param [in] address The address.
+ * \param [in] length The number of bits to keep.
+ * \return The prefix of the address.
+ */
+inline uint32_t
+Truncate(uint32_t address, uint8_t length)
+{
+    return length == 0 ? 0 : address & (0xffffffff << (32 - length));
+}
+
+/**
+ * \ingroup ipv4Routing
+ * Get a bit of an address.
+ * \param [in] address The address.
+ * \param [in] index The index of the bit, from the most significant one.
+ * \return The bit.
+ */
+inline uint32_t
+GetBit(uint32_t address, uint8_t index)
+{
+    return (address >> (31 - index)) & 1;
+}
+
+} // namespace
+
+Ipv4RouteTrie::Ipv4RouteTrie()
+    : m_nRoutes(0),
+      m_nextOrder(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Ipv4RouteTrie::~Ipv4RouteTrie()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+}
+
+bool
+Ipv4RouteTrie::IsContiguous(Ipv4Mask mask)
+{
+    return Truncate(0xffffffff, mask.GetPrefixLength()) == mask.Get();
+}
+
+std::size_t
+Ipv4RouteTrie::FindNonContiguous(Ipv4Address network, Ipv4Mask mask) const
+{
+    std::size_t i = 0;
+    while (i < m_nonContiguous.size() &&
+           (m_nonContiguous[i].mask != mask.Get() ||
+            m_nonContiguous[i].network != (network.Get() & mask.Get())))
+    {
+        i++;
+    }
+    return i;
+}
+
+void
+Ipv4RouteTrie::Add(Ipv4RoutingTableEntry* entry, uint32_t metric)
+{
+    NS_LOG_FUNCTION(this << entry << metric);
+    Ipv4Mask mask = entry->GetDestNetworkMask();
+    if (!IsContiguous(mask))
+    {
+        std::size_t i = FindNonContiguous(entry->GetDestNetwork(), mask);
+        if (i == m_nonContiguous.size())
+        {
+            m_nonContiguous.push_back(
+                {entry->GetDestNetwork().Get() & mask.Get(), mask.Get(), Routes()});
+        }
+        m_nonContiguous[i].routes.push_back({entry, metric, m_nextOrder++});
+        m_nRoutes++;
+        return;
+    }
+    auto length = static_cast<uint8_t>(mask.GetPrefixLength());
+    uint32_t prefix = Truncate(entry->GetDestNetwork().Get(), length);
+
+    std::unique_ptr<Node>* link = &m_root;
+    Node* node = nullptr;
+    while (true)
+    {
+        Node* current = link->get();
+        if (current == nullptr)
+        {
+            *link = std::make_unique<Node>();
+            node = link->get();
+            node->prefix = prefix;
+            node->length = length;
+            break;
+        }
+        uint32_t diff = prefix ^ current->prefix;
+        uint8_t common = diff == 0 ? 32 : __builtin_clz(diff);
+        common = std::min({common, length, current->length});
+        if (common == current->length)
+        {
+            if (length == current->length)
+            {
+                node = current;
+                break;
+            }
+            link = &current->children[GetBit(prefix, current->length)];
+            continue;
+        }
+        // The new prefix branches off, or is a prefix of, the current node:
+        // insert a node for their common prefix above the current node
+        auto split = std::make_unique<Node>();
+        split->prefix = Truncate(prefix, common);
+        split->length = common;
+        split->children[GetBit(current->prefix, common)] = std::move(*link);
+        if (common == length)
+        {
+            node = split.get();
+        }
+        else
+        {
+            auto leaf = std::make_unique<Node>();
+            leaf->prefix = prefix;
+            leaf->length = length;
+            node = leaf.get();
+            split->children[GetBit(prefix, common)] = std::move(leaf);
+        }
+        *link = std::move(split);
+        break;
+    }
+    node->routes.push_back({entry, metric, m_nextOrder++});
+    m_nRoutes++;
+}
+
+bool
+Ipv4RouteTrie::Remove(const Ipv4RoutingTableEntry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    Ipv4Mask mask = entry->GetDestNetworkMask();
+    if (!IsContiguous(mask))
+    {
+        std::size_t i = FindNonContiguous(entry->GetDestNetwork(), mask);
+        if (i == m_nonContiguous.size())
+        {
+            return false;
+        }
+        Routes& routes = m_nonContiguous[i].routes;
+        auto route = std::find_if(routes.begin(), routes.end(), [entry](const Route& r) {
+            return r.entry == entry;
+        });
+        if (route == routes.end())
+        {
+            return false;
+        }
+        routes.erase(route);
+        if (routes.empty())
+        {
+            m_nonContiguous.erase(m_nonContiguous.begin() + i);
+        }
+        m_nRoutes--;
+        return true;
+    }
+    auto length = static_cast<uint8_t>(mask.GetPrefixLength());
+    uint32_t prefix = Truncate(entry->GetDestNetwork().Get(), length);
+
+    // The links from the root to the node of the prefix
+    std::unique_ptr<Node>* path[MAX_MATCHES + 1];
+    uint32_t depth = 0;
+    std::unique_ptr<Node>* link = &m_root;
+    while (*link && (*link)->length < length &&
+           Truncate(prefix, (*link)->length) == (*link)->prefix)
+    {
+        path[depth++] = link;
+        link = &(*link)->children[GetBit(prefix, (*link)->length)];
+    }
+    if (!*link || (*link)->length != length || (*link)->prefix != prefix)
+    {
+        return false;
+    }
+    Routes& routes = (*link)->routes;
+    auto it = std::find_if(routes.begin(), routes.end(), [entry](const Route& route) {
+        return route.entry == entry;
+    });
+    if (it == routes.end())
+    {
+        return false;
+    }
+    routes.erase(it);
+    m_nRoutes--;
+
+    // Remove the nodes left without routes and with less than two children
+    path[depth++] = link;
+    while (depth > 0)
+    {
+        link = path[--depth];
+        Node* node = link->get();
+        if (!node->routes.empty() || (node->children[0] && node->children[1]))
+        {
+            break;
+        }
+        std::unique_ptr<Node> child =
+            std::move(node->children[0] ? node->children[0] : node->children[1]);
+        *link = std::move(child);
+    }
+    return true;
+}
+
+void
+Ipv4RouteTrie::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    // the prefix lengths increase along a branch, so the trie is at most 33 deep
+    m_root.reset();
+    m_nonContiguous.clear();
+    m_nRoutes = 0;
+}
+
+uint32_t
+Ipv4RouteTrie::GetNRoutes() const
+{
+    return m_nRoutes;
+}
+
+const Ipv4RouteTrie::Routes*
+Ipv4RouteTrie::Find(Ipv4Address network, Ipv4Mask mask) const
+{
+    if (!IsContiguous(mask))
+    {
+        std::size_t i = FindNonContiguous(network, mask);
+        return i == m_nonContiguous.size() ? nullptr : &m_nonContiguous[i].routes;
+    }
+    auto length = static_cast<uint8_t>(mask.GetPrefixLength());
+    uint32_t prefix = Truncate(network.Get(), length);
+    const Node* node = m_root.get();
+    while (node && node->length < length && Truncate(prefix, node->length) == node->prefix)
+    {
+        node = node->children[GetBit(prefix, node->length)].get();
+    }
+    if (node && node->length == length && node->prefix == prefix && !node->routes.empty())
+    {
+        return &node->routes;
+    }
+    return nullptr;
+}
+
+uint32_t
+Ipv4RouteTrie::Lookup(Ipv4Address dest,
+                      const Routes* matches[MAX_MATCHES],
+                      uint8_t* prefixLengths) const
+{
+    uint32_t address = dest.Get();
+    uint32_t n = 0;
+    const Node* node = m_root.get();
+    while (node && Truncate(address, node->length) == node->prefix)
+    {
+        if (!node->routes.empty())
+        {
+            matches[n] = &node->routes;
+            if (prefixLengths)
+            {
+                prefixLengths[n] = node->length;
+            }
+            n++;
+        }
+        if (node->length == 32)
+        {
+            break;
+        }
+        node = node->children[GetBit(address, node->length)].get();
+    }
+    std::reverse(matches, matches + n);
+    if (prefixLengths)
+    {
+        std::reverse(prefixLengths, prefixLengths + n);
+    }
+    return n;
+}
+
+void
+Ipv4RouteTrie::LookupNonContiguous(Ipv4Address dest, std::vector<const Route*>& matches) const
+{
+    std::size_t first = matches.size();
+    for (const auto& network : m_nonContiguous)
+    {
+        if ((dest.Get() & network.mask) == network.network)
+        {
+            for (const auto& route : network.routes)
+            {
+                matches.push_back(&route);
+            }
+        }
+    }
+    std::sort(matches.begin() + first, matches.end(), [](const Route* a, const Route* b) {
+        return a->order < b->order;
+    });
+}
+
+} // namespace ns3
@@ -0,0 +1,173 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_ROUTE_TRIE_H
+#define IPV4_ROUTE_TRIE_H
+
+#include "ns3/ipv4-address.h"
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Longest prefix match index of IPv4 unicast routes.
+ *
+ * The routes are stored in a path-compressed binary trie: a node exists
+ * only for the prefixes of the routes and for the branching points between
+ * them, so a lookup visits at most one node per distinct prefix length on
+ * the path to the destination, whatever the number of routes. The trie is
+ * updated incrementally as the routes are added and removed.
+ *
+ * The trie does not own the routing table entries; it is an index of the
+ * route lists of the routing protocols. The routes of a prefix are kept in
+ * the order of insertion, and each route records a global insertion order,
+ * so that the routing protocols can select among the matching routes with
+ * the same tie-breaking rules as a scan of their lists.
+ *
+ * The routes with a non-contiguous network mask, which have no prefix,
+ * are kept in a list outside of the trie, grouped by network and mask.
+ * The list is scanned by LookupNonContiguous(), and its routes share the
+ * insertion order of the routes of the trie.
+ */
+class Ipv4RouteTrie
+{
+  public:
+    /** A route of the trie. */
+    struct Route
+    {
+        Ipv4RoutingTableEntry* entry; //!< The routing table entry
+        uint32_t metric;              //!< The metric of the route
+        uint64_t order;               //!< The insertion order of the route
+    };
+
+    /** The routes of a prefix, in insertion order. */
+    typedef std::vector<Route> Routes;
+
+    /** Maximum number of prefixes matching an address: the lengths 0 to 32. */
+    static constexpr uint32_t MAX_MATCHES = 33;
+
+    Ipv4RouteTrie();
+    ~Ipv4RouteTrie();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    Ipv4RouteTrie(const Ipv4RouteTrie&) = delete;
+    Ipv4RouteTrie& operator=(const Ipv4RouteTrie&) = delete;
+
+    /**
+     * Add a route, after the routes already added.
+     *
+     * \param [in] entry The routing table entry, whose destination network
+     *             and mask are the prefix of the route.
+     * \param [in] metric The metric of the route.
+     */
+    void Add(Ipv4RoutingTableEntry* entry, uint32_t metric = 0);
+
+    /**
+     * Remove a route.
+     *
+     * \param [in] entry The routing table entry, as given to Add().
+     * \return true if the route was found.
+     */
+    bool Remove(const Ipv4RoutingTableEntry* entry);
+
+    /** Remove all the routes. */
+    void Clear();
+
+    /**
+     * \return The number of routes.
+     */
+    uint32_t GetNRoutes() const;
+
+    /**
+     * Get the routes of a prefix, or of a network with a non-contiguous mask.
+     *
+     * \param [in] network The network address of the prefix.
+     * \param [in] mask The network mask of the prefix.
+     * \return The routes of the prefix, or nullptr if there are none.
+     */
+    const Routes* Find(Ipv4Address network, Ipv4Mask mask) const;
+
+    /**
+     * Get the routes whose prefix matches an address.
+     *
+     * \param [in] dest The address.
+     * \param [out] matches The routes of each matching prefix, longest
+     *              prefix first.
+     * \param [out] prefixLengths The lengths of the matching prefixes, if
+     *              not nullptr.
+     * \return The number of matching prefixes.
+     */
+    uint32_t Lookup(Ipv4Address dest,
+                    const Routes* matches[MAX_MATCHES],
+                    uint8_t* prefixLengths = nullptr) const;
+
+    /**
+     * Get the routes with a non-contiguous network mask which match an
+     * address. They are not returned by Lookup().
+     *
+     * \param [in] dest The address.
+     * \param [out] matches The matching routes, appended in insertion order.
+     */
+    void LookupNonContiguous(Ipv4Address dest, std::vector<const Route*>& matches) const;
+
+    /**
+     * \param [in] mask A network mask.
+     * \return true if the ones of the mask are contiguous.
+     */
+    static bool IsContiguous(Ipv4Mask mask);
+
+  private:
+    /** A prefix, or a branching point between prefixes. */
+    struct Node
+    {
+        uint32_t prefix;                   //!< The prefix bits, the others are zero
+        uint8_t length;                    //!< The prefix length
+        std::unique_ptr<Node> children[2]; //!< The longer prefixes, by their next bit
+        Routes routes;                     //!< The routes of the prefix, if any
+    };
+
+    /** A network with a non-contiguous mask. */
+    struct Network
+    {
+        uint32_t network; //!< The network bits, the others are zero
+        uint32_t mask;    //!< The network mask
+        Routes routes;    //!< The routes of the network
+    };
+
+    /**
+     * Find the network of a non-contiguous mask.
+     * \param [in] network The network address.
+     * \param [in] mask The network mask.
+     * \return The index of the network in m_nonContiguous, or its size.
+     */
+    std::size_t FindNonContiguous(Ipv4Address network, Ipv4Mask mask) const;
+
+    std::unique_ptr<Node> m_root;         //!< The shortest prefix
+    std::vector<Network> m_nonContiguous; //!< The networks with a non-contiguous mask
+    uint32_t m_nRoutes;                   //!< The number of routes
+    uint64_t m_nextOrder;                 //!< The insertion order of the next route
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTE_TRIE_H */
@@ -36,6 +36,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 
 using std::make_pair;
@@ -80,6 +81,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
     {
         auto routePtr = new Ipv4RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRouteTrie.Add(routePtr, metric);
     }
 }
 
@@ -98,6 +100,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
         auto routePtr = new Ipv4RoutingTableEntry(route);
 
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRouteTrie.Add(routePtr, metric);
     }
 }
 
@@ -153,6 +156,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Mask networkMask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_networkRouteTrie.Add(route, 0);
 }
 
 uint32_t
@@ -224,14 +228,21 @@ Ipv4StaticRouting::RemoveMulticastRoute(uint32_t index)
 bool
 Ipv4StaticRouting::LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metric)
 {
-    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    // only the routes of the same prefix can be equal
+    const Ipv4RouteTrie::Routes* routes =
+        m_networkRouteTrie.Find(route.GetDestNetwork(), route.GetDestNetworkMask());
+    if (routes == nullptr)
+    {
+        return false;
+    }
+    for (const auto& j : *routes)
     {
-        Ipv4RoutingTableEntry* rtentry = j->first;
+        Ipv4RoutingTableEntry* rtentry = j.entry;
 
         if (rtentry->GetDest() == route.GetDest() &&
             rtentry->GetDestNetworkMask() == route.GetDestNetworkMask() &&
             rtentry->GetGateway() == route.GetGateway() &&
-            rtentry->GetInterface() == route.GetInterface() && j->second == metric)
+            rtentry->GetInterface() == route.GetInterface() && j.metric == metric)
         {
             return true;
         }
@@ -244,7 +255,6 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
 {
     NS_LOG_FUNCTION(this << dest << " " << oif);
     Ptr<Ipv4Route> rtentry = nullptr;
-    uint16_t longest_mask = 0;
     uint32_t shortest_metric = 0xffffffff;
     /* when sending on local multicast, there have to be interface specified */
     if (dest.IsLocalMulticast())
@@ -261,56 +271,95 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
-    for (auto i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
-    {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
-        Ipv4Mask mask = (j)->GetDestNetworkMask();
-        uint16_t masklen = mask.GetPrefixLength();
-        Ipv4Address entry = (j)->GetDestNetwork();
-        NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to " << entry
-                                               << "/" << masklen);
-        if (mask.IsMatch(dest, entry))
+    // The routes are indexed by prefix, longest first. Among the routes of
+    // the longest matching prefix on the requested interface, the one with
+    // the lowest metric is selected, the last added one in case of a tie,
+    // except for host routes, where the first added one is selected.
+    Ipv4RoutingTableEntry* route = nullptr;
+    uint16_t longest_mask = 0;
+    auto consider = [&](const Ipv4RouteTrie::Route& i, uint16_t masklen) {
+        Ipv4RoutingTableEntry* j = i.entry;
+        uint32_t metric = i.metric;
+        NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
+                                                   << ", metric " << metric);
+        if (oif)
         {
-            NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
-                                                       << ", metric " << metric);
-            if (oif)
-            {
-                if (oif != m_ipv4->GetNetDevice(j->GetInterface()))
-                {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
-                    continue;
-                }
-            }
-            if (masklen < longest_mask) // Not interested if got shorter mask
+            if (oif != m_ipv4->GetNetDevice(j->GetInterface()))
             {
-                NS_LOG_LOGIC("Previous match longer, skipping");
-                continue;
+                NS_LOG_LOGIC("Not on requested interface, skipping");
+                return false;
             }
-            if (masklen > longest_mask) // Reset metric if longer masklen
+        }
+        if (masklen < longest_mask) // Not interested if got shorter mask
+        {
+            NS_LOG_LOGIC("Previous match longer, skipping");
+            return false;
+        }
+        if (masklen > longest_mask) // Reset metric if longer masklen
+        {
+            shortest_metric = 0xffffffff;
+        }
+        longest_mask = masklen;
+        if (metric > shortest_metric)
+        {
+            NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
+            return false;
+        }
+        shortest_metric = metric;
+        route = j;
+        return masklen == 32;
+    };
+    const Ipv4RouteTrie::Routes* matches[Ipv4RouteTrie::MAX_MATCHES];
+    uint8_t masklens[Ipv4RouteTrie::MAX_MATCHES];
+    uint32_t nMatches = m_networkRouteTrie.Lookup(dest, matches, masklens);
+    std::vector<const Ipv4RouteTrie::Route*> nonContiguous;
+    m_networkRouteTrie.LookupNonContiguous(dest, nonContiguous);
+    if (nonContiguous.empty())
+    {
+        for (uint32_t k = 0; k < nMatches && !route; k++)
+        {
+            for (const auto& i : *matches[k])
             {
-                shortest_metric = 0xffffffff;
+                if (consider(i, masklens[k]))
+                {
+                    break;
+                }
             }
-            longest_mask = masklen;
-            if (metric > shortest_metric)
+        }
+    }
+    else
+    {
+        // The routes with a non-contiguous mask have no prefix: all the
+        // matching routes are scanned in the order in which they were added.
+        for (uint32_t k = 0; k < nMatches; k++)
+        {
+            for (const auto& i : *matches[k])
             {
-                NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
-                continue;
+                nonContiguous.push_back(&i);
             }
-            shortest_metric = metric;
-            Ipv4RoutingTableEntry* route = (j);
-            uint32_t interfaceIdx = route->GetInterface();
-            rtentry = Create<Ipv4Route>();
-            rtentry->SetDestination(route->GetDest());
-            rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
-            rtentry->SetGateway(route->GetGateway());
-            rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-            if (masklen == 32)
+        }
+        std::sort(nonContiguous.begin(),
+                  nonContiguous.end(),
+                  [](const Ipv4RouteTrie::Route* a, const Ipv4RouteTrie::Route* b) {
+                      return a->order < b->order;
+                  });
+        for (auto i : nonContiguous)
+        {
+            if (consider(*i, i->entry->GetDestNetworkMask().GetPrefixLength()))
             {
                 break;
             }
         }
     }
+    if (route)
+    {
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv4Route>();
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+    }
     if (rtentry)
     {
         NS_LOG_LOGIC("Matching route via " << rtentry->GetGateway() << " at the end");
@@ -457,6 +506,7 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
     {
         if (tmp == index)
         {
+            m_networkRouteTrie.Remove(j->first);
             delete j->first;
             m_networkRoutes.erase(j);
             return;
@@ -588,6 +638,7 @@ void
 Ipv4StaticRouting::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_networkRouteTrie.Clear();
     for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j = m_networkRoutes.erase(j))
     {
         delete (j->first);
@@ -631,6 +682,7 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
     {
         if (it->first->GetInterface() == i)
         {
+            m_networkRouteTrie.Remove(it->first);
             delete it->first;
             it = m_networkRoutes.erase(it);
         }
@@ -676,6 +728,7 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
             it->first->GetDestNetwork() == networkAddress &&
             it->first->GetDestNetworkMask() == networkMask)
         {
+            m_networkRouteTrie.Remove(it->first);
             delete it->first;
             it = m_networkRoutes.erase(it);
         }
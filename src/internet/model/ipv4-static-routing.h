@@ -22,6 +22,7 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include "ipv4-header.h"
+#include "ipv4-route-trie.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
@@ -411,6 +412,11 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief the longest prefix match index of m_networkRoutes.
+     */
+    Ipv4RouteTrie m_networkRouteTrie;
+
     /**
      * \brief the forwarding table for multicast.
      */
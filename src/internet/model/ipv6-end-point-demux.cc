@@ -23,15 +23,36 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("Ipv6EndPointDemux");
 
+bool
+Ipv6EndPointDemux::Connection::operator==(const Connection& other) const
+{
+    return localAddress == other.localAddress && localPort == other.localPort &&
+           peerAddress == other.peerAddress && peerPort == other.peerPort;
+}
+
+size_t
+Ipv6EndPointDemux::ConnectionHash::operator()(const Connection& connection) const
+{
+    Ipv6AddressHash addressHash;
+    size_t hash = addressHash(connection.localAddress);
+    hash = hash * 31 + addressHash(connection.peerAddress);
+    uint32_t ports = (uint32_t(connection.localPort) << 16) | connection.peerPort;
+    return hash ^ (std::hash<uint32_t>()(ports) * 0x9e3779b97f4a7c15ULL);
+}
+
 Ipv6EndPointDemux::Ipv6EndPointDemux()
     : m_ephemeral(49152),
       m_portFirst(49152),
-      m_portLast(65535)
+      m_portLast(65535),
+      m_nextOrder(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -39,36 +60,94 @@ Ipv6EndPointDemux::Ipv6EndPointDemux()
 Ipv6EndPointDemux::~Ipv6EndPointDemux()
 {
     NS_LOG_FUNCTION(this);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // The destroy callbacks of the end points may deallocate other end points
+    for (auto endPoint : GetEndPoints())
     {
-        Ipv6EndPoint* endPoint = *i;
-        delete endPoint;
+        DeAllocate(endPoint);
     }
-    m_endPoints.clear();
 }
 
-bool
-Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
+void
+Ipv6EndPointDemux::Index(Ipv6EndPoint* endPoint)
 {
-    NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    uint64_t order = m_endPoints.at(endPoint);
+    Port& port = m_ports[endPoint->GetLocalPort()];
+    port.all.emplace(order, endPoint);
+    if (endPoint->GetPeerAddress() != Ipv6Address::GetAny() && endPoint->GetPeerPort() != 0)
+    {
+        m_connections.emplace(Connection{endPoint->GetLocalAddress(),
+                                         endPoint->GetLocalPort(),
+                                         endPoint->GetPeerAddress(),
+                                         endPoint->GetPeerPort()},
+                              endPoint);
+    }
+    else
+    {
+        port.unconnected.emplace(order, endPoint);
+    }
+}
+
+void
+Ipv6EndPointDemux::Unindex(Ipv6EndPoint* endPoint)
+{
+    uint64_t order = m_endPoints.at(endPoint);
+    auto port = m_ports.find(endPoint->GetLocalPort());
+    NS_ASSERT(port != m_ports.end());
+    if (endPoint->GetPeerAddress() != Ipv6Address::GetAny() && endPoint->GetPeerPort() != 0)
     {
-        if ((*i)->GetLocalPort() == port)
+        auto range = m_connections.equal_range(Connection{endPoint->GetLocalAddress(),
+                                                          endPoint->GetLocalPort(),
+                                                          endPoint->GetPeerAddress(),
+                                                          endPoint->GetPeerPort()});
+        for (auto i = range.first; i != range.second; i++)
         {
-            return true;
+            if (i->second == endPoint)
+            {
+                m_connections.erase(i);
+                break;
+            }
         }
     }
-    return false;
+    else
+    {
+        port->second.unconnected.erase(order);
+    }
+    port->second.all.erase(order);
+    if (port->second.all.empty())
+    {
+        m_ports.erase(port);
+    }
+}
+
+Ipv6EndPoint*
+Ipv6EndPointDemux::Insert(Ipv6EndPoint* endPoint)
+{
+    m_endPoints.emplace(endPoint, m_nextOrder++);
+    endPoint->m_demux = this;
+    Index(endPoint);
+    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
+    return endPoint;
+}
+
+bool
+Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
+{
+    NS_LOG_FUNCTION(this << port);
+    return m_ports.find(port) != m_ports.end();
 }
 
 bool
 Ipv6EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto i = m_ports.find(port);
+    if (i == m_ports.end())
+    {
+        return false;
+    }
+    for (const auto& [order, endPoint] : i->second.all)
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        if (endPoint->GetLocalAddress() == addr && endPoint->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -86,10 +165,7 @@ Ipv6EndPointDemux::Allocate()
         NS_LOG_WARN("Ephemeral port allocation failed.");
         return nullptr;
     }
-    auto endPoint = new Ipv6EndPoint(Ipv6Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-    return endPoint;
+    return Insert(new Ipv6EndPoint(Ipv6Address::GetAny(), port));
 }
 
 Ipv6EndPoint*
@@ -102,10 +178,7 @@ Ipv6EndPointDemux::Allocate(Ipv6Address address)
         NS_LOG_WARN("Ephemeral port allocation failed.");
         return nullptr;
     }
-    auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-    return endPoint;
+    return Insert(new Ipv6EndPoint(address, port));
 }
 
 Ipv6EndPoint*
@@ -125,10 +198,7 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv6Address address,
         NS_LOG_WARN("Duplicated endpoint.");
         return nullptr;
     }
-    auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-    return endPoint;
+    return Insert(new Ipv6EndPoint(address, port));
 }
 
 Ipv6EndPoint*
@@ -139,38 +209,136 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto isDuplicate = [&](Ipv6EndPoint* endPoint) {
+        return endPoint->GetLocalAddress() == localAddress &&
+               endPoint->GetPeerPort() == peerPort && endPoint->GetPeerAddress() == peerAddress &&
+               (endPoint->GetBoundNetDevice() == boundNetDevice ||
+                !endPoint->GetBoundNetDevice());
+    };
+    bool duplicate = false;
+    if (peerAddress != Ipv6Address::GetAny() && peerPort != 0)
+    {
+        auto range =
+            m_connections.equal_range(Connection{localAddress, localPort, peerAddress, peerPort});
+        for (auto i = range.first; i != range.second && !duplicate; i++)
+        {
+            duplicate = isDuplicate(i->second);
+        }
+    }
+    else if (auto port = m_ports.find(localPort); port != m_ports.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (auto i = port->second.unconnected.begin();
+             i != port->second.unconnected.end() && !duplicate;
+             i++)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            duplicate = isDuplicate(i->second);
         }
     }
+    if (duplicate)
+    {
+        NS_LOG_WARN("Duplicated endpoint.");
+        return nullptr;
+    }
     auto endPoint = new Ipv6EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
-
-    NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
-
-    return endPoint;
+    return Insert(endPoint);
 }
 
 void
 Ipv6EndPointDemux::DeAllocate(Ipv6EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto i = m_endPoints.find(endPoint);
+    if (i != m_endPoints.end())
     {
-        if (*i == endPoint)
+        Unindex(endPoint);
+        m_endPoints.erase(i);
+        endPoint->m_demux = nullptr;
+        delete endPoint;
+    }
+}
+
+uint32_t
+Ipv6EndPointDemux::Match(Ipv6EndPoint* endP,
+                         Ipv6Address daddr,
+                         Ipv6Address saddr,
+                         uint16_t sport,
+                         Ptr<Ipv6Interface> incomingInterface) const
+{
+    NS_LOG_DEBUG("Looking at endpoint dport="
+                 << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                 << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
+
+    if (!endP->IsRxEnabled())
+    {
+        NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint can not receive packets");
+        return 0;
+    }
+
+    if (endP->GetBoundNetDevice())
+    {
+        if (!incomingInterface)
         {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
+            return 0;
         }
+        if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+        {
+            NS_LOG_LOGIC("Skipping endpoint "
+                         << &endP << " because endpoint is bound to specific device and"
+                         << endP->GetBoundNetDevice() << " does not match packet device "
+                         << incomingInterface->GetDevice());
+            return 0;
+        }
+    }
+
+    NS_LOG_DEBUG("dest addr " << daddr);
+
+    bool localAddressMatchesWildCard = endP->GetLocalAddress() == Ipv6Address::GetAny();
+    bool localAddressMatchesExact = endP->GetLocalAddress() == daddr;
+    bool localAddressMatchesAllRouters =
+        endP->GetLocalAddress() == Ipv6Address::GetAllRoutersMulticast();
+
+    /* if no match here, keep looking */
+    if (!(localAddressMatchesExact || localAddressMatchesWildCard))
+    {
+        return 0;
+    }
+    bool remotePeerMatchesExact = endP->GetPeerPort() == sport;
+    bool remotePeerMatchesWildCard = endP->GetPeerPort() == 0;
+    bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
+    bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv6Address::GetAny();
+
+    /* If remote does not match either with exact or wildcard,
+       skip this one */
+    if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
+    {
+        return 0;
+    }
+    if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+    {
+        return 0;
+    }
+
+    /* Now figure out which return list to add this one to */
+    uint32_t cases = 0;
+    if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
+    { /* All 4 match */
+        cases |= 1;
+    }
+    if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
+    { /* All but local address */
+        cases |= 2;
     }
+    if ((localAddressMatchesExact || (localAddressMatchesAllRouters)) &&
+        remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+    { /* Only local port and local address matches exactly */
+        cases |= 4;
+    }
+    if (localAddressMatchesWildCard && remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+    { /* Only local port matches exactly */
+        cases |= 8;
+    }
+    return cases;
 }
 
 /*
@@ -187,161 +355,107 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport << incomingInterface);
 
-    EndPoints retval1; /* Matches exact on local port, wildcards on others */
-    EndPoints retval2; /* Matches exact on local port/adder, wildcards on others */
-    EndPoints retval3; /* Matches all but local address */
-    EndPoints retval4; /* Exact match on all 4 */
-
-    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        Ipv6EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
-
-        if (endP->GetLocalPort() != dport)
+    /* retval[0]: Exact match on all 4
+     * retval[1]: Matches all but local address
+     * retval[2]: Matches exact on local port/adder, wildcards on others
+     * retval[3]: Matches exact on local port, wildcards on others */
+    EndPoints retval[4];
+    auto add = [&](Ipv6EndPoint* endP) {
+        uint32_t cases = Match(endP, daddr, saddr, sport, incomingInterface);
+        for (uint32_t i = 0; i < 4; i++)
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
-        }
-
-        if (endP->GetBoundNetDevice())
-        {
-            if (!incomingInterface)
+            if (cases & (1 << i))
             {
-                continue;
-            }
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
-            {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
-                continue;
+                retval[i].push_back(endP);
             }
         }
+    };
 
-        /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-        NS_LOG_DEBUG("dest addr " << daddr);
-
-        bool localAddressMatchesWildCard = endP->GetLocalAddress() == Ipv6Address::GetAny();
-        bool localAddressMatchesExact = endP->GetLocalAddress() == daddr;
-        bool localAddressMatchesAllRouters =
-            endP->GetLocalAddress() == Ipv6Address::GetAllRoutersMulticast();
-
-        /* if no match here, keep looking */
-        if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        {
-            continue;
-        }
-        bool remotePeerMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePeerMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv6Address::GetAny();
-
-        /* If remote does not match either with exact or wildcard,i
-           skip this one */
-        if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
+    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
+    auto port = m_ports.find(dport);
+    if (port == m_ports.end())
+    {
+        return EndPoints();
+    }
+    /* The end points with a peer can only match with the source address and
+       port of the packet, and with the destination address or the any
+       address. */
+    if (saddr != Ipv6Address::GetAny() && sport != 0)
+    {
+        auto range = m_connections.equal_range(Connection{daddr, dport, saddr, sport});
+        for (auto i = range.first; i != range.second; i++)
         {
-            continue;
+            add(i->second);
         }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+        if (daddr != Ipv6Address::GetAny())
         {
-            continue;
-        }
-
-        /* Now figure out which return list to add this one to */
-        if (localAddressMatchesWildCard && remotePeerMatchesWildCard &&
-            remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-            retval1.push_back(endP);
-        }
-        if ((localAddressMatchesExact || (localAddressMatchesAllRouters)) &&
-            remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All but local address */
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All 4 match */
-            retval4.push_back(endP);
+            range = m_connections.equal_range(
+                Connection{Ipv6Address::GetAny(), dport, saddr, sport});
+            for (auto i = range.first; i != range.second; i++)
+            {
+                add(i->second);
+            }
         }
     }
-
-    // Here we find the most exact match
-    EndPoints retval;
-    if (!retval4.empty())
-    {
-        retval = retval4;
-    }
-    else if (!retval3.empty())
-    {
-        retval = retval3;
-    }
-    else if (!retval2.empty())
+    for (const auto& [order, endP] : port->second.unconnected)
     {
-        retval = retval2;
+        add(endP);
     }
-    else
+
+    // Here we find the most exact match
+    EndPoints empty;
+    EndPoints* found = &empty;
+    for (auto& endPoints : retval)
     {
-        retval = retval1;
+        if (!endPoints.empty())
+        {
+            found = &endPoints;
+            break;
+        }
     }
 
-    NS_ABORT_MSG_IF(retval.size() > 1,
+    NS_ABORT_MSG_IF(found->size() > 1,
                     "Too many endpoints - perhaps you created too many sockets without binding "
                     "them to different NetDevices.");
-    return retval; // might be empty if no matches
+    return *found; // might be empty if no matches
 }
 
 Ipv6EndPoint*
 Ipv6EndPointDemux::SimpleLookup(Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+    auto port = m_ports.find(dport);
+    if (port == m_ports.end())
+    {
+        return nullptr;
+    }
     uint32_t genericity = 3;
     Ipv6EndPoint* generic = nullptr;
 
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    /* the end points of the port are scanned in allocation order */
+    for (const auto& [order, endPoint] : port->second.all)
     {
         uint32_t tmp = 0;
 
-        if ((*i)->GetLocalPort() != dport)
-        {
-            continue;
-        }
-
-        if ((*i)->GetLocalAddress() == dst && (*i)->GetPeerPort() == sport &&
-            (*i)->GetPeerAddress() == src)
+        if (endPoint->GetLocalAddress() == dst && endPoint->GetPeerPort() == sport &&
+            endPoint->GetPeerAddress() == src)
         {
             /* this is an exact match. */
-            return *i;
+            return endPoint;
         }
 
-        if ((*i)->GetLocalAddress() == Ipv6Address::GetAny())
+        if (endPoint->GetLocalAddress() == Ipv6Address::GetAny())
         {
             tmp++;
         }
 
-        if ((*i)->GetPeerAddress() == Ipv6Address::GetAny())
+        if (endPoint->GetPeerAddress() == Ipv6Address::GetAny())
         {
             tmp++;
         }
 
         if (tmp < genericity)
         {
-            generic = (*i);
+            generic = endPoint;
             genericity = tmp;
         }
     }
@@ -373,7 +487,20 @@ Ipv6EndPointDemux::AllocateEphemeralPort()
 Ipv6EndPointDemux::EndPoints
 Ipv6EndPointDemux::GetEndPoints() const
 {
-    return m_endPoints;
+    std::vector<std::pair<uint64_t, Ipv6EndPoint*>> endPoints;
+    endPoints.reserve(m_endPoints.size());
+    for (const auto& [endPoint, order] : m_endPoints)
+    {
+        endPoints.emplace_back(order, endPoint);
+    }
+    std::sort(endPoints.begin(), endPoints.end());
+
+    EndPoints ret;
+    for (const auto& [order, endPoint] : endPoints)
+    {
+        ret.push_back(endPoint);
+    }
+    return ret;
 }
 
 } /* namespace ns3 */
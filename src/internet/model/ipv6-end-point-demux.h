@@ -25,7 +25,9 @@
 #include "ns3/ipv6-address.h"
 
 #include <list>
+#include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -36,6 +38,11 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points are indexed in hash tables: the end points with a peer
+ * address and port by their four-tuple, and the other end points by their
+ * local port, so that a lookup only examines the end points which can match
+ * the packet, with the same precedence as a scan of all the end points.
  */
 class Ipv6EndPointDemux
 {
@@ -161,6 +168,84 @@ class Ipv6EndPointDemux
     EndPoints GetEndPoints() const;
 
   private:
+    friend class Ipv6EndPoint;
+
+    /**
+     * \brief The four-tuple of an end point with a peer address and port.
+     */
+    struct Connection
+    {
+        Ipv6Address localAddress; //!< The local address
+        uint16_t localPort;       //!< The local port
+        Ipv6Address peerAddress;  //!< The peer address
+        uint16_t peerPort;        //!< The peer port
+
+        /**
+         * \brief Equality operator.
+         * \param other the other four-tuple
+         * \return true if the four-tuples are equal
+         */
+        bool operator==(const Connection& other) const;
+    };
+
+    /**
+     * \brief Hash function of the four-tuples.
+     */
+    struct ConnectionHash
+    {
+        /**
+         * \brief Hash a four-tuple.
+         * \param connection the four-tuple
+         * \return the hash
+         */
+        size_t operator()(const Connection& connection) const;
+    };
+
+    /**
+     * \brief The end points of a local port, by allocation order.
+     */
+    struct Port
+    {
+        std::map<uint64_t, Ipv6EndPoint*> all;         //!< All the end points
+        std::map<uint64_t, Ipv6EndPoint*> unconnected; //!< The end points without a peer
+    };
+
+    /**
+     * \brief Add an end point to the indexes.
+     * \param endPoint the end point
+     */
+    void Index(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the indexes.
+     * \param endPoint the end point
+     */
+    void Unindex(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Add a new end point to the demux.
+     * \param endPoint the end point
+     * \return the end point
+     */
+    Ipv6EndPoint* Insert(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Check if an end point matches a packet.
+     *
+     * \param endP the end point, bound to the destination port
+     * \param daddr destination address to test
+     * \param saddr source address to test
+     * \param sport source port to test
+     * \param incomingInterface the incoming interface
+     * \return the cases of Lookup() matched by the end point, as a bit mask:
+     *         bit 0 for the full match, to bit 3 for the local port match
+     */
+    uint32_t Match(Ipv6EndPoint* endP,
+                   Ipv6Address daddr,
+                   Ipv6Address saddr,
+                   uint16_t sport,
+                   Ptr<Ipv6Interface> incomingInterface) const;
+
     /**
      * \brief Allocate a ephemeral port.
      * \return a port
@@ -183,9 +268,24 @@ class Ipv6EndPointDemux
     uint16_t m_portLast;
 
     /**
-     * \brief A list of IPv6 end points.
+     * \brief The allocation order of the IPv6 end points.
+     */
+    std::unordered_map<Ipv6EndPoint*, uint64_t> m_endPoints;
+
+    /**
+     * \brief The allocation order of the next end point.
+     */
+    uint64_t m_nextOrder;
+
+    /**
+     * \brief The end points, by local port.
+     */
+    std::unordered_map<uint16_t, Port> m_ports;
+
+    /**
+     * \brief The end points with a peer address and port, by four-tuple.
      */
-    EndPoints m_endPoints;
+    std::unordered_multimap<Connection, Ipv6EndPoint*, ConnectionHash> m_connections;
 };
 
 } /* namespace ns3 */
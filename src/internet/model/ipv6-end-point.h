@@ -33,6 +33,7 @@ namespace ns3
 {
 
 class Header;
+class Ipv6EndPointDemux;
 class Packet;
 
 /**
@@ -239,6 +240,13 @@ class Ipv6EndPoint
      * \brief true if the endpoint can receive packets.
      */
     bool m_rxEnabled;
+
+    /**
+     * \brief The demux which indexes the endpoint by its addresses, if any.
+     */
+    Ipv6EndPointDemux* m_demux;
+
+    friend class Ipv6EndPointDemux;
 };
 
 } /* namespace ns3 */
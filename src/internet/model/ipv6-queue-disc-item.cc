@@ -17,11 +17,10 @@
 
 #include "ipv6-queue-disc-item.h"
 
-#include "tcp-header.h"
-#include "udp-header.h"
-
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -124,23 +123,6 @@ Ipv6QueueDiscItem::Hash(uint32_t perturbation) const
     Ipv6Address dest = m_header.GetDestination();
     uint8_t prot = m_header.GetNextHeader();
 
-    TcpHeader tcpHdr;
-    UdpHeader udpHdr;
-    uint16_t srcPort = 0;
-    uint16_t destPort = 0;
-
-    if (prot == 6) // TCP
-    {
-        GetPacket()->PeekHeader(tcpHdr);
-        srcPort = tcpHdr.GetSourcePort();
-        destPort = tcpHdr.GetDestinationPort();
-    }
-    else if (prot == 17) // UDP
-    {
-        GetPacket()->PeekHeader(udpHdr);
-        srcPort = udpHdr.GetSourcePort();
-        destPort = udpHdr.GetDestinationPort();
-    }
     if (prot != 6 && prot != 17)
     {
         NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
@@ -151,10 +133,16 @@ Ipv6QueueDiscItem::Hash(uint32_t perturbation) const
     src.Serialize(buf);
     dest.Serialize(buf + 16);
     buf[32] = prot;
-    buf[33] = (srcPort >> 8) & 0xff;
-    buf[34] = srcPort & 0xff;
-    buf[35] = (destPort >> 8) & 0xff;
-    buf[36] = destPort & 0xff;
+    // the source and destination ports are the first four bytes of both the
+    // TCP and the UDP headers: copy them instead of deserializing the header
+    if ((prot == 6 || prot == 17) && GetPacket()->GetSize() >= 4)
+    {
+        GetPacket()->CopyData(buf + 33, 4);
+    }
+    else
+    {
+        std::fill(buf + 33, buf + 37, 0);
+    }
     buf[37] = (perturbation >> 24) & 0xff;
     buf[38] = (perturbation >> 16) & 0xff;
     buf[39] = (perturbation >> 8) & 0xff;
@@ -26,8 +26,11 @@
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/node.h"
+#include "ns3/simulator.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -101,9 +104,10 @@ NdiscCache::Lookup(Ipv6Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
 
-    if (m_ndCache.find(dst) != m_ndCache.end())
+    auto it = m_ndCache.find(dst);
+    if (it != m_ndCache.end())
     {
-        NdiscCache::Entry* entry = m_ndCache[dst];
+        NdiscCache::Entry* entry = it->second;
         NS_LOG_LOGIC("Found an entry: " << *entry);
 
         return entry;
@@ -127,6 +131,9 @@ NdiscCache::LookupInverse(Address dst)
             entryList.push_back(entry);
         }
     }
+    entryList.sort([](NdiscCache::Entry* a, NdiscCache::Entry* b) {
+        return a->GetIpv6Address() < b->GetIpv6Address();
+    });
     return entryList;
 }
 
@@ -147,15 +154,19 @@ NdiscCache::Remove(NdiscCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    auto i = m_ndCache.find(entry->GetIpv6Address());
+    if (i == m_ndCache.end() || i->second != entry)
     {
-        if ((*i).second == entry)
-        {
-            m_ndCache.erase(i);
-            entry->ClearWaitingPacket();
-            delete entry;
-            return;
-        }
+        // the address of the entry has been changed
+        i = std::find_if(m_ndCache.begin(), m_ndCache.end(), [entry](const auto& item) {
+            return item.second == entry;
+        });
+    }
+    if (i != m_ndCache.end())
+    {
+        m_ndCache.erase(i);
+        entry->ClearWaitingPacket();
+        delete entry;
     }
 }
 
@@ -170,6 +181,7 @@ NdiscCache::Flush()
     }
 
     m_ndCache.erase(m_ndCache.begin(), m_ndCache.end());
+    m_nudTimersEvent.Cancel();
 }
 
 void
@@ -192,7 +204,9 @@ NdiscCache::PrintNdiscCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    // print the entries in address order
+    std::map<Ipv6Address, NdiscCache::Entry*> entries(m_ndCache.begin(), m_ndCache.end());
+    for (auto i = entries.begin(); i != entries.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -247,13 +261,20 @@ NdiscCache::Entry::Entry(NdiscCache* nd)
     : m_ndCache(nd),
       m_waiting(),
       m_router(false),
-      m_nudTimer(Timer::CANCEL_ON_DESTROY),
+      m_nudFunction(nullptr),
+      m_nudTimer(nd->m_nudTimers.end()),
       m_lastReachabilityConfirmation(Seconds(0.0)),
       m_nsRetransmit(0)
 {
     NS_LOG_FUNCTION(this);
 }
 
+NdiscCache::Entry::~Entry()
+{
+    NS_LOG_FUNCTION(this);
+    CancelNudTimer();
+}
+
 void
 NdiscCache::Entry::SetRouter(bool router)
 {
@@ -469,15 +490,9 @@ void
 NdiscCache::Entry::StartReachableTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
     m_lastReachabilityConfirmation = Simulator::Now();
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionReachableTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetReachableTime());
-    m_nudTimer.Schedule();
+    StartNudTimer(&NdiscCache::Entry::FunctionReachableTimeout,
+                  m_ndCache->m_icmpv6->GetReachableTime());
 }
 
 void
@@ -488,11 +503,15 @@ NdiscCache::Entry::UpdateReachableTimer()
     if (m_state == REACHABLE)
     {
         m_lastReachabilityConfirmation = Simulator::Now();
-        if (m_nudTimer.IsRunning())
+        if (m_nudTimer != m_ndCache->m_nudTimers.end())
+        {
+            // the timer is moved when it reaches its former expiration time
+            m_nudExpiration = Simulator::Now() + m_nudDelay;
+        }
+        else
         {
-            m_nudTimer.Cancel();
+            StartNudTimer(m_nudFunction, m_nudDelay);
         }
-        m_nudTimer.Schedule();
     }
 }
 
@@ -500,52 +519,72 @@ void
 NdiscCache::Entry::StartProbeTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionProbeTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetRetransmissionTime());
-    m_nudTimer.Schedule();
+    StartNudTimer(&NdiscCache::Entry::FunctionProbeTimeout,
+                  m_ndCache->m_icmpv6->GetRetransmissionTime());
 }
 
 void
 NdiscCache::Entry::StartDelayTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionDelayTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetDelayFirstProbe());
-    m_nudTimer.Schedule();
+    StartNudTimer(&NdiscCache::Entry::FunctionDelayTimeout,
+                  m_ndCache->m_icmpv6->GetDelayFirstProbe());
 }
 
 void
 NdiscCache::Entry::StartRetransmitTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetRetransmissionTime());
-    m_nudTimer.Schedule();
+    StartNudTimer(&NdiscCache::Entry::FunctionRetransmitTimeout,
+                  m_ndCache->m_icmpv6->GetRetransmissionTime());
 }
 
 void
 NdiscCache::Entry::StopNudTimer()
 {
     NS_LOG_FUNCTION(this);
-    m_nudTimer.Cancel();
+    CancelNudTimer();
     m_nsRetransmit = 0;
 }
 
+void
+NdiscCache::Entry::StartNudTimer(void (Entry::*function)(), Time delay)
+{
+    NS_LOG_FUNCTION(this << delay);
+    NS_ASSERT_MSG(function, "No NUD timer function for " << m_ipv6Address);
+    CancelNudTimer();
+    m_nudFunction = function;
+    m_nudDelay = delay;
+    m_nudExpiration = Simulator::Now() + delay;
+    m_nudTimer = m_ndCache->m_nudTimers.emplace(m_nudExpiration, this);
+    m_ndCache->ScheduleNudTimers();
+}
+
+void
+NdiscCache::Entry::CancelNudTimer()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_nudTimer != m_ndCache->m_nudTimers.end())
+    {
+        m_ndCache->m_nudTimers.erase(m_nudTimer);
+        m_nudTimer = m_ndCache->m_nudTimers.end();
+    }
+}
+
+void
+NdiscCache::Entry::NudTimeout()
+{
+    NS_LOG_FUNCTION(this);
+    m_nudTimer = m_ndCache->m_nudTimers.end();
+    if (m_nudExpiration > Simulator::Now())
+    {
+        // the timer has been refreshed
+        m_nudTimer = m_ndCache->m_nudTimers.emplace(m_nudExpiration, this);
+        return;
+    }
+    (this->*m_nudFunction)();
+}
+
 void
 NdiscCache::Entry::MarkIncomplete(Ipv6PayloadHeaderPair p)
 {
@@ -713,6 +752,40 @@ NdiscCache::Entry::Print(std::ostream& os) const
     }
 }
 
+void
+NdiscCache::ScheduleNudTimers()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_nudTimers.empty())
+    {
+        return;
+    }
+    Time next = m_nudTimers.begin()->first;
+    if (m_nudTimersEvent.IsRunning() && m_nudTimersTime <= next)
+    {
+        // an early event finds no timer due and schedules the next one
+        return;
+    }
+    m_nudTimersEvent.Cancel();
+    m_nudTimersTime = next;
+    m_nudTimersEvent =
+        Simulator::Schedule(next - Simulator::Now(), &NdiscCache::HandleNudTimers, this);
+}
+
+void
+NdiscCache::HandleNudTimers()
+{
+    NS_LOG_FUNCTION(this);
+    // the timers expiring at the same time are handled in the order they were started
+    while (!m_nudTimers.empty() && m_nudTimers.begin()->first <= Simulator::Now())
+    {
+        NdiscCache::Entry* entry = m_nudTimers.begin()->second;
+        m_nudTimers.erase(m_nudTimers.begin());
+        entry->NudTimeout();
+    }
+    ScheduleNudTimers();
+}
+
 void
 NdiscCache::RemoveAutoGeneratedEntries()
 {
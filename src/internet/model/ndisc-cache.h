@@ -31,6 +31,7 @@
 #include <list>
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -44,6 +45,14 @@ class Icmpv6L4Protocol;
  * \ingroup ipv6
  *
  * \brief IPv6 Neighbor Discovery cache.
+ *
+ * The entries are stored in a hash table indexed by their IPv6 address.
+ * The NUD timers of the entries are not simulator events: the cache keeps
+ * them sorted by expiration time and schedules a single event, at the
+ * first expiration, which handles all the timers expired at that time.
+ * Refreshing the reachable timer of an entry, as done for each packet
+ * exchanged with a reachable neighbor, only records its new expiration
+ * time, and the timer is moved when it reaches its former expiration time.
  */
 class NdiscCache : public Object
 {
@@ -172,7 +181,10 @@ class NdiscCache : public Object
          */
         Entry(NdiscCache* nd);
 
-        virtual ~Entry() = default;
+        /**
+         * \brief Destructor.
+         */
+        virtual ~Entry();
 
         /**
          * \brief The Entry state enumeration.
@@ -412,6 +424,25 @@ class NdiscCache : public Object
         NdiscCache* m_ndCache;
 
       private:
+        friend class NdiscCache;
+
+        /**
+         * \brief Start the NUD timer.
+         * \param function The function called when the timer expires.
+         * \param delay The delay of the timer.
+         */
+        void StartNudTimer(void (Entry::*function)(), Time delay);
+
+        /**
+         * \brief Cancel the NUD timer, without resetting the NUD retransmission counter.
+         */
+        void CancelNudTimer();
+
+        /**
+         * \brief Function called when the NUD timer is due.
+         */
+        void NudTimeout();
+
         /**
          * \brief The IPv6 address.
          */
@@ -433,9 +464,27 @@ class NdiscCache : public Object
         bool m_router;
 
         /**
-         * \brief Timer (used for NUD).
+         * \brief Function called when the NUD timer expires, if any.
+         */
+        void (Entry::*m_nudFunction)();
+
+        /**
+         * \brief Delay of the NUD timer.
+         */
+        Time m_nudDelay;
+
+        /**
+         * \brief Expiration time of the NUD timer.
          */
-        Timer m_nudTimer;
+        Time m_nudExpiration;
+
+        /**
+         * \brief The NUD timer in the cache, if it is running.
+         *
+         * Its time is the expiration time of the timer, or an earlier time if
+         * the timer has been refreshed since it was started.
+         */
+        std::multimap<Time, Entry*>::iterator m_nudTimer;
 
         /**
          * \brief Last time we see a reachability confirmation.
@@ -457,11 +506,11 @@ class NdiscCache : public Object
     /**
      * \brief Neighbor Discovery Cache container
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv6Address, NdiscCache::Entry*, Ipv6AddressHash> Cache;
     /**
      * \brief Neighbor Discovery Cache container iterator
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*>::iterator CacheI;
+    typedef Cache::iterator CacheI;
 
     /**
      * \brief A list of Entry.
@@ -469,6 +518,17 @@ class NdiscCache : public Object
     Cache m_ndCache;
 
   private:
+    /**
+     * \brief Handle the NUD timers of the entries which are due.
+     */
+    void HandleNudTimers();
+
+    /**
+     * \brief Schedule HandleNudTimers() at the first NUD timer, if it is
+     * due before the event already scheduled.
+     */
+    void ScheduleNudTimers();
+
     /**
      * \brief The NetDevice.
      */
@@ -488,6 +548,21 @@ class NdiscCache : public Object
      * \brief Max number of packet stored in m_waiting.
      */
     uint32_t m_unresQlen;
+
+    /**
+     * \brief The running NUD timers of the entries, by time.
+     */
+    std::multimap<Time, NdiscCache::Entry*> m_nudTimers;
+
+    /**
+     * \brief The event handling the first NUD timers.
+     */
+    EventId m_nudTimersEvent;
+
+    /**
+     * \brief The time of m_nudTimersEvent.
+     */
+    Time m_nudTimersTime;
 };
 
 /**
@@ -61,7 +61,11 @@ TcpTxBuffer::TcpTxBuffer(uint32_t n)
     : m_maxBuffer(32768),
       m_size(0),
       m_sentSize(0),
-      m_firstByteSeq(n)
+      m_firstByteSeq(n),
+      m_lostMarkedUpTo(n),
+      m_lostEnd(n),
+      m_nextSegHint(n),
+      m_renoSacked(n, n)
 {
     m_rWndCallback = MakeNullCallback<uint32_t>();
 }
@@ -174,7 +178,11 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
 
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.empty());
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = std::make_pair(false, SequenceNumber32(0));
+    m_lostMarkedUpTo = seq;
+    m_lostEnd = seq;
+    m_nextSegHint = seq;
+    m_renoSacked = std::make_pair(seq, seq);
 }
 
 bool
@@ -298,6 +306,11 @@ TcpTxBuffer::GetNewSegment(uint32_t numBytes)
     m_sentList.insert(m_sentList.end(), item);
     m_sentSize += item->m_packet->GetSize();
 
+    if (item->m_lost)
+    {
+        m_lostEnd = std::max(m_lostEnd, item->m_startSeq + item->m_packet->GetSize());
+    }
+
     return item;
 }
 
@@ -309,37 +322,33 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
+    std::size_t index = FindSentItem(seq);
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    if (index < m_sentList.size() && m_sentList[index]->m_startSeq == seq)
     {
-        if ((*it)->m_startSeq == seq)
+        TcpTxItem* current = m_sentList[index];
+        if (index + 1 < m_sentList.size())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            TcpTxItem* next = m_sentList[index + 1];
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!next->m_sacked) && (current->m_lost == next->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, current->m_packet->GetSize() + next->m_packet->GetSize());
             }
             else
             {
-                s = std::min(s, (*it)->m_packet->GetSize());
+                // Next is sacked... better to retransmit only the first segment
+                s = std::min(s, current->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, current->m_packet->GetSize());
         }
     }
 
@@ -376,6 +385,26 @@ TcpTxBuffer::FindHighestSacked() const
     return ret;
 }
 
+std::size_t
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    if (m_sentList.empty() || seq < m_firstByteSeq.Get() ||
+        seq >= m_firstByteSeq.Get() + m_sentSize)
+    {
+        return m_sentList.size();
+    }
+
+    // The first item that starts after seq; the previous one contains seq
+    auto it = std::upper_bound(m_sentList.begin(),
+                               m_sentList.end(),
+                               seq,
+                               [](const SequenceNumber32& s, const TcpTxItem* item) {
+                                   return s < item->m_startSeq;
+                               });
+    NS_ASSERT(it != m_sentList.begin());
+    return std::distance(m_sentList.begin(), it) - 1;
+}
+
 void
 TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
 {
@@ -438,11 +467,22 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     auto it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+    if (&list == &m_sentList)
+    {
+        // The sent list is ordered: jump to the item that contains seq
+        std::size_t index = FindSentItem(seq);
+        if (index < list.size())
+        {
+            it += index;
+            beginOfCurrentPacket = (*it)->m_startSeq;
+        }
+    }
+
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(&list != &m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -599,6 +639,12 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
     // be updated in MarkTransmittedSegment.
     if (t1->m_retrans != t2->m_retrans)
     {
+        // The merged item may be returned by NextSeg again
+        if (t1->m_startSeq < m_nextSegHint)
+        {
+            m_nextSegHint = t1->m_startSeq;
+        }
+
         if (t1->m_retrans)
         {
             auto self = const_cast<TcpTxBuffer*>(this);
@@ -650,9 +696,11 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    // Only the item that ends at ack can match
+    std::size_t index = FindSentItem(ack - 1);
+    if (index < m_sentList.size())
     {
-        TcpTxItem* item = it;
+        TcpTxItem* item = m_sentList[index];
         Ptr<Packet> p = item->m_packet;
         if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
         {
@@ -744,6 +792,12 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
         m_firstByteSeq = seq;
     }
 
+    m_lostMarkedUpTo = std::max(m_lostMarkedUpTo, m_firstByteSeq.Get());
+    m_lostEnd = std::max(m_lostEnd, m_firstByteSeq.Get());
+    m_nextSegHint = std::max(m_nextSegHint, m_firstByteSeq.Get());
+    m_renoSacked.first = std::max(m_renoSacked.first, m_firstByteSeq.Get());
+    m_renoSacked.second = std::max(m_renoSacked.second, m_firstByteSeq.Get());
+
     if (!m_sentList.empty())
     {
         TcpTxItem* head = m_sentList.front();
@@ -767,7 +821,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
 
     if (m_highestSack.second <= m_firstByteSeq)
     {
-        m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_highestSack = std::make_pair(false, SequenceNumber32(0));
     }
 
     NS_LOG_DEBUG("Discarded up to " << seq << " lost: " << m_lostOut << " retrans: " << m_retrans
@@ -788,17 +842,21 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
-        while (item_it != m_sentList.end())
+        // The items before the one that contains the beginning of the block
+        // cannot be covered by the block
+        std::size_t index =
+            (*option_it).first <= m_firstByteSeq ? 0 : FindSentItem((*option_it).first);
+
+        for (; index < m_sentList.size(); ++index)
         {
+            auto item_it = m_sentList.begin() + index;
+            SequenceNumber32 beginOfCurrentPacket = (*item_it)->m_startSeq;
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
 
             // Check the boundary of this packet ... only mark as sacked if
@@ -828,10 +886,10 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                     m_sackedOut += (*item_it)->m_packet->GetSize();
                     bytesSacked += (*item_it)->m_packet->GetSize();
 
-                    if (m_highestSack.first == m_sentList.end() ||
+                    if (!m_highestSack.first ||
                         m_highestSack.second <= beginOfCurrentPacket + pktSize)
                     {
-                        m_highestSack = std::make_pair(item_it, beginOfCurrentPacket);
+                        m_highestSack = std::make_pair(true, beginOfCurrentPacket);
                     }
 
                     NS_LOG_INFO("Received block "
@@ -852,15 +910,12 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                                                << *(*item_it) << "], not found, breaking loop");
                 break;
             }
-
-            beginOfCurrentPacket += pktSize;
-            ++item_it;
         }
     }
 
     if (bytesSacked > 0)
     {
-        NS_ASSERT_MSG(m_highestSack.first != m_sentList.end(), "Buffer status: " << *this);
+        NS_ASSERT_MSG(m_highestSack.first, "Buffer status: " << *this);
         UpdateLostCount();
     }
 
@@ -876,47 +931,63 @@ void
 TcpTxBuffer::UpdateLostCount()
 {
     NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_highestSack.first && !m_sentList.empty());
+    std::size_t highest = std::min(FindSentItem(m_highestSack.second), m_sentList.size() - 1);
+    NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
+                                             << *m_sentList[highest]);
+
+    // Walk back from the highest sacked item, until m_dupAckThresh sacked
+    // items are found. The unsacked items before m_lostMarkedUpTo are already
+    // lost, so the walk can stop there (unless the head is sacked, as the
+    // head is then marked lost even if it is sacked).
+    std::size_t index = highest;
     uint32_t sacked = 0;
-    SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
-    if (m_highestSack.first == m_sentList.end())
-    {
-        NS_LOG_INFO("Status before the update: " << *this
-                                                 << ", will start from the latest sent item");
-    }
-    else
-    {
-        NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
-                                                 << *(*m_highestSack.first));
-    }
-
-    for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+    bool headSacked = m_sentList.front()->m_sacked;
+    if (m_dupAckThresh > 0)
     {
-        TcpTxItem* item = *it;
-        if (item->m_sacked)
-        {
-            sacked++;
-        }
-
-        if (sacked >= m_dupAckThresh)
+        for (; index > 0; --index)
         {
-            if (!item->m_sacked && !item->m_lost)
+            TcpTxItem* item = m_sentList[index];
+            if (!headSacked && item->m_startSeq < m_lostMarkedUpTo)
             {
-                item->m_lost = true;
-                m_lostOut += item->m_packet->GetSize();
+                break;
+            }
+            if (item->m_sacked && ++sacked >= m_dupAckThresh)
+            {
+                break;
             }
         }
-        beginOfCurrentPacket -= item->m_packet->GetSize();
     }
 
-    if (sacked >= m_dupAckThresh)
+    if (sacked < m_dupAckThresh)
+    {
+        NS_LOG_INFO("Not enough sacked items, status after the update: " << *this);
+        return;
+    }
+
+    // All the unsacked items up to the one found are lost, as well as the head
+    for (std::size_t i = index; i > 0 && m_sentList[i]->m_startSeq >= m_lostMarkedUpTo; --i)
     {
-        TcpTxItem* item = *m_sentList.begin();
-        if (!item->m_lost)
+        TcpTxItem* item = m_sentList[i];
+        if (!item->m_sacked && !item->m_lost)
         {
             item->m_lost = true;
             m_lostOut += item->m_packet->GetSize();
         }
     }
+
+    TcpTxItem* item = m_sentList.front();
+    if (!item->m_lost)
+    {
+        item->m_lost = true;
+        m_lostOut += item->m_packet->GetSize();
+    }
+
+    SequenceNumber32 endOfLost =
+        m_sentList[index]->m_startSeq + m_sentList[index]->m_packet->GetSize();
+    m_lostMarkedUpTo = std::max(m_lostMarkedUpTo, endOfLost);
+    m_lostEnd = std::max(m_lostEnd, endOfLost);
+
     NS_LOG_INFO("Status after the update: " << *this);
     ConsistencyCheck();
 }
@@ -926,34 +997,38 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
     NS_LOG_FUNCTION(this << seq);
 
-    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
     if (seq >= m_highestSack.second)
     {
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Start from the first item that begins at or after seq
+    std::size_t index = seq <= m_firstByteSeq ? 0 : FindSentItem(seq);
+    if (index < m_sentList.size() && m_sentList[index]->m_startSeq < seq)
+    {
+        ++index;
+    }
+
+    for (; index < m_sentList.size(); ++index)
     {
-        // Search for the right iterator before calling IsLost()
-        if (beginOfCurrentPacket >= seq)
+        TcpTxItem* item = m_sentList[index];
+        if (item->m_startSeq >= m_lostEnd)
         {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
+            NS_LOG_INFO("seq=" << seq << " is not lost because there are no lost items ahead");
+            return false;
+        }
 
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
+        if (item->m_lost)
+        {
+            NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+            return true;
         }
 
-        beginOfCurrentPacket += (*it)->m_packet->GetSize();
+        if (item->m_sacked)
+        {
+            NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
+            return false;
+        }
     }
 
     return false;
@@ -980,11 +1055,28 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
     TcpTxItem* item;
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Skip the items that are sacked or already retransmitted
+    std::size_t index = m_nextSegHint <= m_firstByteSeq ? 0 : FindSentItem(m_nextSegHint);
+    while (index < m_sentList.size() &&
+           (m_sentList[index]->m_retrans || m_sentList[index]->m_sacked))
     {
-        item = *it;
+        ++index;
+    }
+    m_nextSegHint = index < m_sentList.size() ? m_sentList[index]->m_startSeq
+                                              : m_firstByteSeq.Get() + m_sentSize;
+
+    for (; index < m_sentList.size(); ++index)
+    {
+        item = m_sentList[index];
+        SequenceNumber32 beginOfCurrentPkt = item->m_startSeq;
+
+        if (beginOfCurrentPkt >= m_lostEnd &&
+            (!isRecovery || (isSeqPerRule3Valid && seqPerRule3.GetValue() != 0)))
+        {
+            // There are no lost items ahead, and rule 3 has its candidate
+            break;
+        }
 
         // Condition 1.a , 1.b , and 1.c
         if (!item->m_retrans && !item->m_sacked)
@@ -1003,9 +1095,6 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
                 seqPerRule3 = beginOfCurrentPkt;
             }
         }
-
-        // Nothing found, iterate
-        beginOfCurrentPkt += item->m_packet->GetSize();
     }
 
     /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1201,7 +1290,7 @@ TcpTxBuffer::IsLostRFC(const SequenceNumber32& seq, const PacketList::const_iter
 
         beginOfCurrentPacket += current->GetSize();
     }
-    if (it == m_highestSack.first)
+    if (!m_highestSack.first)
     {
         NS_LOG_INFO("seq=" << seq << " is not lost because there are no sacked segment ahead "
                            << m_highestSack.second);
@@ -1220,7 +1309,10 @@ TcpTxBuffer::ResetRenoSack()
         (*it)->m_sacked = false;
     }
 
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = std::make_pair(false, SequenceNumber32(0));
+    m_lostMarkedUpTo = m_firstByteSeq;
+    m_nextSegHint = m_firstByteSeq;
+    m_renoSacked = std::make_pair(m_firstByteSeq.Get(), m_firstByteSeq.Get());
 }
 
 void
@@ -1249,7 +1341,11 @@ TcpTxBuffer::ResetSentList()
     m_lostOut = 0;
     m_retrans = 0;
     m_sackedOut = 0;
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = std::make_pair(false, SequenceNumber32(0));
+    m_lostMarkedUpTo = m_firstByteSeq;
+    m_lostEnd = m_firstByteSeq;
+    m_nextSegHint = m_firstByteSeq;
+    m_renoSacked = std::make_pair(m_firstByteSeq.Get(), m_firstByteSeq.Get());
 }
 
 void
@@ -1267,6 +1363,11 @@ TcpTxBuffer::ResetLastSegmentSent()
             m_retrans -= item->m_packet->GetSize();
         }
         m_appList.insert(m_appList.begin(), item);
+
+        // The item will be sent again as new data
+        m_lostMarkedUpTo = std::min(m_lostMarkedUpTo, item->m_startSeq);
+        m_nextSegHint = std::min(m_nextSegHint, item->m_startSeq);
+        m_renoSacked.second = std::min(m_renoSacked.second, item->m_startSeq);
     }
     ConsistencyCheck();
 }
@@ -1281,7 +1382,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
     {
         m_sackedOut = 0;
         m_lostOut = m_sentSize;
-        m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_highestSack = std::make_pair(false, SequenceNumber32(0));
     }
     else
     {
@@ -1313,6 +1414,14 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         (*it)->m_retrans = false;
     }
 
+    m_lostMarkedUpTo = m_firstByteSeq + m_sentSize;
+    m_lostEnd = m_firstByteSeq + m_sentSize;
+    m_nextSegHint = m_firstByteSeq;
+    if (resetSack)
+    {
+        m_renoSacked = std::make_pair(m_firstByteSeq.Get(), m_firstByteSeq.Get());
+    }
+
     NS_LOG_INFO("Set sent list lost, status: " << *this);
     NS_ASSERT_MSG(m_sentSize >= m_sackedOut + m_lostOut, *this);
     ConsistencyCheck();
@@ -1345,6 +1454,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
     {
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        m_nextSegHint = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1374,6 +1484,11 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+
+        SequenceNumber32 endOfHead =
+            m_firstByteSeq.Get() + m_sentList.front()->m_packet->GetSize();
+        m_lostEnd = std::max(m_lostEnd, endOfHead);
+        m_nextSegHint = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1396,6 +1511,14 @@ TcpTxBuffer::AddRenoSack()
 
     // We can _never_ SACK the head, so start from the second segment sent
     auto it = ++m_sentList.begin();
+    SequenceNumber32 startOfSacked =
+        it != m_sentList.end() ? (*it)->m_startSeq : m_firstByteSeq.Get() + m_sentSize;
+
+    // Skip the items sacked by the previous calls, if they follow the head
+    if (m_renoSacked.first <= startOfSacked && startOfSacked < m_renoSacked.second)
+    {
+        it = m_sentList.begin() + std::min(FindSentItem(m_renoSacked.second), m_sentList.size());
+    }
 
     // Find the "highest sacked" point, that is SND.UNA + m_sackedOut
     while (it != m_sentList.end() && (*it)->m_sacked)
@@ -1408,11 +1531,14 @@ TcpTxBuffer::AddRenoSack()
     {
         (*it)->m_sacked = true;
         m_sackedOut += (*it)->m_packet->GetSize();
-        m_highestSack = std::make_pair(it, (*it)->m_startSeq);
+        m_highestSack = std::make_pair(true, (*it)->m_startSeq);
+        m_renoSacked =
+            std::make_pair(startOfSacked, (*it)->m_startSeq + (*it)->m_packet->GetSize());
         NS_LOG_INFO("Added a Reno SACK, status: " << *this);
     }
     else
     {
+        m_renoSacked = std::make_pair(startOfSacked, m_firstByteSeq.Get() + m_sentSize);
         NS_LOG_INFO("Can't add a Reno SACK because we miss segments. This dupack"
                     " should be arrived from spurious retransmissions");
     }
@@ -28,6 +28,8 @@
 #include "ns3/sequence-number.h"
 #include "ns3/traced-value.h"
 
+#include <deque>
+
 namespace ns3
 {
 class Packet;
@@ -61,6 +63,12 @@ class Packet;
  * we also store the size (in bytes) of the packets inside the SentList in the
  * variable m_sentSize.
  *
+ * The lists are double-ended queues, and the items of the SentList are kept
+ * in order of their starting sequence number; the item that contains a given
+ * sequence number is therefore found with a binary search, instead of walking
+ * the list from the head. This keeps the cost of an ACK logarithmic in the
+ * number of segments in flight, which matters for high-BDP flows.
+ *
  * SACK management
  * ---------------
  *
@@ -71,8 +79,11 @@ class Packet;
  * associated with every segment sent. This is done through the use of the
  * class TcpTxItem: instead of storing a list of packets, we store a list of
  * TcpTxItem. Each item has different flags (check the corresponding
- * documentation) and maintaining the scoreboard is a matter of travelling the
- * list and set the SACK flag on the corresponding segment sent.
+ * documentation) and maintaining the scoreboard is a matter of finding the
+ * segments covered by each SACK block and set the SACK flag on them. The
+ * searches for lost segments (UpdateLostCount, IsLost, NextSeg) are bounded by
+ * a few sequence numbers that record the part of the list already examined,
+ * so that they do not walk the whole list at each ACK.
  *
  * Item properties
  * ---------------
@@ -411,7 +422,7 @@ class TcpTxBuffer : public Object
   private:
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
 
-    typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+    typedef std::deque<TcpTxItem*> PacketList; //!< container for data stored in the buffer
 
     /**
      * \brief Update the lost count
@@ -428,12 +439,25 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
-     *
+     * and updates the lost count. The walk starts from the highest sacked
+     * segment, and it stops as soon as it reaches the segments already
+     * marked by a previous call (see m_lostMarkedUpTo), so that each segment
+     * is visited a bounded number of times during a recovery.
      */
     void UpdateLostCount();
 
+    /**
+     * \brief Find the item of the sent list that contains a sequence number
+     *
+     * The items of the sent list are ordered by their starting sequence
+     * number, so the search is a binary search.
+     *
+     * \param seq Sequence number
+     * \return the index of the item in m_sentList, or the size of m_sentList
+     * if seq is not in the sent list
+     */
+    std::size_t FindSentItem(const SequenceNumber32& seq) const;
+
     /**
      * \brief Remove the size specified from the lostOut, retrans, sacked count
      *
@@ -611,7 +635,19 @@ class TcpTxBuffer : public Object
 
     TracedValue<SequenceNumber32>
         m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
-    std::pair<PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
+    /**
+     * Highest SACK byte: whether it is valid, and the starting sequence number
+     * of the highest sacked item (0 if not valid)
+     */
+    std::pair<bool, SequenceNumber32> m_highestSack;
+
+    // The following sequence numbers bound the walks of the sent list, and
+    // are never before the head of the sent list. They are conservative: a
+    // reset moves them back to the head, or to the end of the sent list.
+    SequenceNumber32 m_lostMarkedUpTo;      //!< The items before it are either sacked or lost
+    SequenceNumber32 m_lostEnd;             //!< No item at or after it is lost
+    mutable SequenceNumber32 m_nextSegHint; //!< The items before it are sacked or retransmitted
+    std::pair<SequenceNumber32, SequenceNumber32> m_renoSacked; //!< The items in it are sacked
 
     uint32_t m_lostOut{0};   //!< Number of lost bytes
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
@@ -0,0 +1,223 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4EndPointDemux lookup test.
+ *
+ * Checks the precedence of the connected and listening endpoints, with many
+ * connections on the same local port, and the update of the demux when the
+ * addresses of an endpoint change.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+  public:
+    Ipv4EndPointDemuxTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase()
+    : TestCase("Ipv4EndPointDemux lookup")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun()
+{
+    const uint32_t nConnections = 5000;
+    Ipv4Address local("10.0.0.1");
+    Ipv4Address peer("10.0.1.1");
+    Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface>();
+    interface->AddAddress(Ipv4InterfaceAddress(local, Ipv4Mask("255.255.255.0")));
+
+    Ipv4EndPointDemux demux;
+    Ipv4EndPoint* listener = demux.Allocate(nullptr, 80);
+    NS_TEST_ASSERT_MSG_NE(listener, nullptr, "Could not allocate the listening endpoint");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, 80), nullptr, "Duplicated endpoint allocated");
+
+    std::vector<Ipv4EndPoint*> connections;
+    for (uint32_t i = 0; i < nConnections; i++)
+    {
+        connections.push_back(demux.Allocate(nullptr, local, 80, peer, 1024 + i));
+    }
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, local, 80, peer, 1024),
+                          nullptr,
+                          "Duplicated connection allocated");
+    NS_TEST_EXPECT_MSG_EQ(demux.GetAllEndPoints().size(),
+                          nConnections + 1,
+                          "Wrong number of endpoints");
+    NS_TEST_EXPECT_MSG_EQ(demux.GetAllEndPoints().front(),
+                          listener,
+                          "The endpoints are not in allocation order");
+
+    for (uint32_t i = 0; i < nConnections; i++)
+    {
+        auto found = demux.Lookup(local, 80, peer, 1024 + i, interface);
+        NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+        NS_TEST_EXPECT_MSG_EQ(found.front(), connections[i], "Wrong connection found");
+    }
+    auto found = demux.Lookup(local, 80, peer, 1024 + nConnections, interface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), listener, "New connections must reach the listener");
+    NS_TEST_EXPECT_MSG_EQ(demux.Lookup(local, 81, peer, 1024, interface).size(),
+                          0,
+                          "Endpoint found on an unused port");
+    NS_TEST_EXPECT_MSG_EQ(demux.SimpleLookup(local, 80, peer, 1030),
+                          connections[6],
+                          "Wrong connection found by SimpleLookup");
+
+    // A connection bound to the subnet matches the subnet-directed broadcasts
+    Ipv4EndPoint* subnet =
+        demux.Allocate(nullptr, Ipv4Address("10.0.0.0"), 80, Ipv4Address("10.0.0.2"), 5000);
+    found = demux.Lookup(Ipv4Address("10.0.0.255"), 80, Ipv4Address("10.0.0.2"), 5000, interface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), subnet, "Subnet-directed connection not found");
+
+    // The demux follows the changes of the addresses of an endpoint
+    Ipv4EndPoint* client = demux.Allocate();
+    NS_TEST_ASSERT_MSG_NE(client, nullptr, "Could not allocate an ephemeral endpoint");
+    uint16_t port = client->GetLocalPort();
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(port), true, "Ephemeral port not in use");
+    client->SetLocalAddress(local);
+    client->SetPeer(peer, 8080);
+    found = demux.Lookup(local, port, peer, 8080, interface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), client, "Connected endpoint not found");
+    NS_TEST_EXPECT_MSG_EQ(demux.Lookup(local, port, peer, 8081, interface).size(),
+                          0,
+                          "Connected endpoint found for another peer");
+
+    demux.DeAllocate(client);
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(port), false, "Deallocated port still in use");
+    demux.DeAllocate(connections[0]);
+    found = demux.Lookup(local, 80, peer, 1024, interface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), listener, "Closed connections must reach the listener");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv6EndPointDemux lookup test.
+ *
+ * Checks the precedence of the connected and listening endpoints, with many
+ * connections on the same local port, and the update of the demux when the
+ * addresses of an endpoint change.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+  public:
+    Ipv6EndPointDemuxTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase()
+    : TestCase("Ipv6EndPointDemux lookup")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun()
+{
+    const uint32_t nConnections = 5000;
+    Ipv6Address local("2001:db8::1");
+    Ipv6Address peer("2001:db8:1::1");
+    Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface>();
+
+    Ipv6EndPointDemux demux;
+    Ipv6EndPoint* listener = demux.Allocate(nullptr, 80);
+    NS_TEST_ASSERT_MSG_NE(listener, nullptr, "Could not allocate the listening endpoint");
+    Ipv6EndPoint* boundListener = demux.Allocate(nullptr, local, 80);
+    NS_TEST_ASSERT_MSG_NE(boundListener, nullptr, "Could not allocate the bound endpoint");
+
+    std::vector<Ipv6EndPoint*> connections;
+    for (uint32_t i = 0; i < nConnections; i++)
+    {
+        connections.push_back(demux.Allocate(nullptr, local, 80, peer, 1024 + i));
+    }
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, local, 80, peer, 1024),
+                          nullptr,
+                          "Duplicated connection allocated");
+    NS_TEST_EXPECT_MSG_EQ(demux.GetEndPoints().size(),
+                          nConnections + 2,
+                          "Wrong number of endpoints");
+
+    for (uint32_t i = 0; i < nConnections; i++)
+    {
+        auto found = demux.Lookup(local, 80, peer, 1024 + i, interface);
+        NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+        NS_TEST_EXPECT_MSG_EQ(found.front(), connections[i], "Wrong connection found");
+    }
+    auto found = demux.Lookup(local, 80, peer, 1024 + nConnections, interface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), boundListener, "The bound listener must be preferred");
+    found = demux.Lookup(Ipv6Address("2001:db8::2"), 80, peer, 1024, interface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), listener, "Other addresses must reach the listener");
+
+    // The demux follows the changes of the addresses of an endpoint
+    Ipv6EndPoint* client = demux.Allocate();
+    NS_TEST_ASSERT_MSG_NE(client, nullptr, "Could not allocate an ephemeral endpoint");
+    uint16_t port = client->GetLocalPort();
+    client->SetLocalAddress(local);
+    client->SetPeer(peer, 8080);
+    found = demux.Lookup(local, port, peer, 8080, interface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), client, "Connected endpoint not found");
+    NS_TEST_EXPECT_MSG_EQ(demux.SimpleLookup(local, port, peer, 8080),
+                          client,
+                          "Connected endpoint not found by SimpleLookup");
+
+    demux.DeAllocate(client);
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(port), false, "Deallocated port still in use");
+    demux.DeAllocate(connections[0]);
+    found = demux.Lookup(local, 80, peer, 1024, interface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Wrong number of endpoints found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), boundListener, "Closed connections must reach the listener");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    EndPointDemuxTestSuite()
+        : TestSuite("end-point-demux", UNIT)
+    {
+        AddTestCase(new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+        AddTestCase(new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+    }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
@@ -16,6 +16,7 @@
 #include "ns3/boolean.h"
 #include "ns3/bridge-helper.h"
 #include "ns3/config.h"
+#include "ns3/global-route-manager.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -41,6 +42,7 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <sstream>
 #include <vector>
 
 using namespace ns3;
@@ -1311,6 +1313,283 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting route selection test
+ *
+ * Checks the order in which the routes are selected: the host routes,
+ * then the first added network route of any matching prefix, then the
+ * first added external route, on the requested interface if any.
+ */
+class Ipv4GlobalRoutingSelectionTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingSelectionTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Get the gateway of the route to a destination.
+     * \param routing The global routing.
+     * \param dest The destination.
+     * \param oif The output device, if any.
+     * \return The gateway, or 0.0.0.0 if there is no route.
+     */
+    static Ipv4Address GetGateway(Ptr<Ipv4GlobalRouting> routing,
+                                  Ipv4Address dest,
+                                  Ptr<NetDevice> oif = nullptr);
+};
+
+Ipv4GlobalRoutingSelectionTestCase::Ipv4GlobalRoutingSelectionTestCase()
+    : TestCase("Global routing route selection")
+{
+}
+
+Ipv4Address
+Ipv4GlobalRoutingSelectionTestCase::GetGateway(Ptr<Ipv4GlobalRouting> routing,
+                                               Ipv4Address dest,
+                                               Ptr<NetDevice> oif)
+{
+    Ipv4Header header;
+    header.SetDestination(dest);
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = routing->RouteOutput(nullptr, header, oif, sockerr);
+    return route ? route->GetGateway() : Ipv4Address::GetZero();
+}
+
+void
+Ipv4GlobalRoutingSelectionTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(node);
+
+    SimpleNetDeviceHelper simpleHelper;
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        int32_t ifIndex = ipv4->AddInterface(simpleHelper.Install(node).Get(0));
+        ipv4->AddAddress(ifIndex, Ipv4InterfaceAddress(Ipv4Address(0x0a000001 | i << 8), "/24"));
+        ipv4->SetUp(ifIndex);
+    }
+    Ptr<NetDevice> device2 = ipv4->GetNetDevice(2);
+    Ptr<Ipv4GlobalRouting> routing =
+        ipv4->GetRoutingProtocol()->GetObject<Ipv4GlobalRouting>();
+    NS_TEST_ASSERT_MSG_NE(routing, nullptr, "Error-- no Ipv4GlobalRouting object");
+
+    routing->AddNetworkRouteTo("10.1.0.0", "/16", "10.0.0.2", 1);
+    routing->AddNetworkRouteTo("10.1.1.0", "/24", "10.0.1.2", 2);
+    routing->AddNetworkRouteTo("10.1.0.0", "/16", "10.0.1.3", 2);
+    routing->AddASExternalRouteTo("192.168.0.0", "/16", "10.0.0.4", 1);
+    routing->AddASExternalRouteTo("192.168.1.0", "/24", "10.0.1.4", 2);
+
+    // The network routes are not selected by prefix length
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.1.1"), "10.0.0.2", "Wrong network route");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.1.1", device2),
+                          "10.0.1.2",
+                          "Wrong network route on interface");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.2.1", device2),
+                          "10.0.1.3",
+                          "Wrong network route on interface");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "192.168.1.1"), "10.0.0.4", "Wrong external route");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "192.168.1.1", device2),
+                          "10.0.1.4",
+                          "Wrong external route on interface");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "192.168.2.1", device2),
+                          Ipv4Address::GetZero(),
+                          "Unexpected external route on interface");
+
+    routing->AddHostRouteTo("10.1.1.1", "10.0.1.5", 2);
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.1.1"), "10.0.1.5", "Wrong host route");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.1.2"), "10.0.0.2", "Wrong network route");
+
+    // Removing the host route and the first network route
+    routing->RemoveRoute(0);
+    routing->RemoveRoute(0);
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.1.1"), "10.0.1.2", "Wrong network route");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.2.1"), "10.0.1.3", "Wrong network route");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting threaded and incremental update test
+ *
+ * Checks, on a grid of routers with a LAN and a stub router, that the routes
+ * do not depend on the number of threads of the SPF calculations, and that
+ * the incremental updates after a change of the topology give the same
+ * routes as a full recomputation while computing fewer trees.
+ */
+class Ipv4GlobalRoutingUpdateTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingUpdateTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Get the routes of all the nodes.
+     * \param nodes The nodes.
+     * \return The routes, one line per route.
+     */
+    static std::string GetRoutes(const NodeContainer& nodes);
+
+    /**
+     * \brief Check the incremental update of the routes after a change.
+     * \param nodes The nodes.
+     * \param maxCalculations The maximum number of SPF calculations.
+     */
+    void CheckUpdate(const NodeContainer& nodes, uint32_t maxCalculations);
+};
+
+Ipv4GlobalRoutingUpdateTestCase::Ipv4GlobalRoutingUpdateTestCase()
+    : TestCase("Global routing threaded and incremental updates")
+{
+}
+
+std::string
+Ipv4GlobalRoutingUpdateTestCase::GetRoutes(const NodeContainer& nodes)
+{
+    std::ostringstream oss;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<Ipv4GlobalRouting> routing =
+            nodes.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol()->GetObject<Ipv4GlobalRouting>();
+        for (uint32_t j = 0; j < routing->GetNRoutes(); j++)
+        {
+            Ipv4RoutingTableEntry* route = routing->GetRoute(j);
+            oss << i << " " << route->GetDest() << route->GetDestNetworkMask() << " "
+                << route->GetGateway() << " " << route->GetInterface() << std::endl;
+        }
+    }
+    return oss.str();
+}
+
+void
+Ipv4GlobalRoutingUpdateTestCase::CheckUpdate(const NodeContainer& nodes, uint32_t maxCalculations)
+{
+    uint32_t nCalculations = GlobalRouteManager::UpdateRoutes();
+    std::string incremental = GetRoutes(nodes);
+    NS_TEST_EXPECT_MSG_GT(nCalculations, 0, "The change was not detected");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(nCalculations,
+                                maxCalculations,
+                                "Too many routers were recomputed");
+
+    GlobalRouteManager::SetIncremental(false);
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(incremental,
+                          GetRoutes(nodes),
+                          "The incremental update differs from the full computation");
+
+    GlobalRouteManager::SetIncremental(true);
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(GlobalRouteManager::UpdateRoutes(), 0, "Unexpected SPF calculation");
+}
+
+void
+Ipv4GlobalRoutingUpdateTestCase::DoRun()
+{
+    const uint32_t size = 4;
+    NodeContainer nodes;
+    nodes.Create(size * size + 1);
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.0.0", "255.255.255.252");
+    auto link = [&](uint32_t a, uint32_t b) {
+        NetDeviceContainer devices =
+            simpleHelper.Install(NodeContainer(nodes.Get(a), nodes.Get(b)));
+        ipv4.Assign(devices);
+        ipv4.NewNetwork();
+        return devices;
+    };
+    // the grid, with a slow link between n5 and n6
+    NetDeviceContainer slowLink;
+    NetDeviceContainer fastLink;
+    for (uint32_t i = 0; i < size * size; i++)
+    {
+        if (i % size != size - 1)
+        {
+            NetDeviceContainer devices = link(i, i + 1);
+            if (i == 5)
+            {
+                slowLink = devices;
+            }
+            else if (i == 0)
+            {
+                fastLink = devices;
+            }
+        }
+        if (i + size < size * size)
+        {
+            link(i, i + size);
+        }
+    }
+    // a stub router attached to n15
+    link(size * size - 1, size * size);
+    // a LAN between n10, n11 and n14
+    SimpleNetDeviceHelper lanHelper;
+    ipv4.SetBase("10.2.0.0", "255.255.255.0");
+    ipv4.Assign(lanHelper.Install(NodeContainer(nodes.Get(10), nodes.Get(11), nodes.Get(14))));
+
+    for (uint32_t i = 0; i < slowLink.GetN(); i++)
+    {
+        Ptr<Ipv4> ip = slowLink.Get(i)->GetNode()->GetObject<Ipv4>();
+        ip->SetMetric(ip->GetInterfaceForDevice(slowLink.Get(i)), 10);
+    }
+
+    // The routes do not depend on the number of threads
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::string routes = GetRoutes(nodes);
+    Ipv4GlobalRoutingHelper::SetNThreads(4);
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(GetRoutes(nodes), routes, "The routes depend on the number of threads");
+
+    Ipv4GlobalRoutingHelper::SetIncremental(true);
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(GetRoutes(nodes), routes, "The routes depend on the incremental mode");
+    NS_TEST_EXPECT_MSG_EQ(GlobalRouteManager::UpdateRoutes(), 0, "Unexpected SPF calculation");
+
+    // The slow link is on no shortest path: only its routers and the stub
+    // router are recomputed when it goes down or up
+    Ptr<Ipv4> ip5 = nodes.Get(5)->GetObject<Ipv4>();
+    uint32_t slowInterface = ip5->GetInterfaceForDevice(slowLink.Get(0));
+    ip5->SetDown(slowInterface);
+    CheckUpdate(nodes, 3);
+    ip5->SetUp(slowInterface);
+    CheckUpdate(nodes, 3);
+
+    // A link on the shortest paths
+    Ptr<Ipv4> ip0 = nodes.Get(0)->GetObject<Ipv4>();
+    uint32_t fastInterface = ip0->GetInterfaceForDevice(fastLink.Get(0));
+    ip0->SetDown(fastInterface);
+    CheckUpdate(nodes, nodes.GetN());
+    ip0->SetUp(fastInterface);
+    CheckUpdate(nodes, nodes.GetN());
+
+    // A LAN router going down
+    Ptr<Ipv4> ip14 = nodes.Get(14)->GetObject<Ipv4>();
+    uint32_t lanInterface = ip14->GetNInterfaces() - 1;
+    ip14->SetDown(lanInterface);
+    CheckUpdate(nodes, nodes.GetN());
+    ip14->SetUp(lanInterface);
+    CheckUpdate(nodes, nodes.GetN());
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1333,6 +1612,8 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingSelectionTestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingUpdateTestCase, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
@@ -20,11 +20,13 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simple-net-device.h"
@@ -207,6 +209,171 @@ Ipv4StaticRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 StaticRouting longest prefix match Test
+ *
+ * Checks that the routes selected through the prefix index are the ones
+ * selected by a linear scan of the routing table, with overlapping
+ * prefixes, non-contiguous masks, metrics and output interfaces.
+ */
+class Ipv4StaticRoutingLookupTestCase : public TestCase
+{
+  public:
+    Ipv4StaticRoutingLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /// A route and its metric
+    typedef std::pair<Ipv4RoutingTableEntry, uint32_t> Route;
+
+    /**
+     * \brief Select a route by a scan of the routes, in order.
+     * \param routes The routes.
+     * \param ipv4 The IPv4 instance.
+     * \param dest The destination.
+     * \param oif The output device, if any.
+     * \return The selected route, or nullptr.
+     */
+    static const Ipv4RoutingTableEntry* LinearLookup(const std::vector<Route>& routes,
+                                                     Ptr<Ipv4> ipv4,
+                                                     Ipv4Address dest,
+                                                     Ptr<NetDevice> oif);
+};
+
+Ipv4StaticRoutingLookupTestCase::Ipv4StaticRoutingLookupTestCase()
+    : TestCase("Static routing longest prefix match")
+{
+}
+
+const Ipv4RoutingTableEntry*
+Ipv4StaticRoutingLookupTestCase::LinearLookup(const std::vector<Route>& routes,
+                                              Ptr<Ipv4> ipv4,
+                                              Ipv4Address dest,
+                                              Ptr<NetDevice> oif)
+{
+    const Ipv4RoutingTableEntry* selected = nullptr;
+    uint16_t longestMask = 0;
+    uint32_t shortestMetric = 0xffffffff;
+    for (const auto& [route, metric] : routes)
+    {
+        Ipv4Mask mask = route.GetDestNetworkMask();
+        uint16_t masklen = mask.GetPrefixLength();
+        if (!mask.IsMatch(dest, route.GetDestNetwork()) ||
+            (oif && oif != ipv4->GetNetDevice(route.GetInterface())) || masklen < longestMask)
+        {
+            continue;
+        }
+        if (masklen > longestMask)
+        {
+            shortestMetric = 0xffffffff;
+        }
+        longestMask = masklen;
+        if (metric > shortestMetric)
+        {
+            continue;
+        }
+        shortestMetric = metric;
+        selected = &route;
+        if (masklen == 32)
+        {
+            break;
+        }
+    }
+    return selected;
+}
+
+void
+Ipv4StaticRoutingLookupTestCase::DoRun()
+{
+    const uint32_t nDevices = 4;
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    for (uint32_t i = 1; i <= nDevices; i++)
+    {
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(device);
+        int32_t ifIndex = ipv4->AddInterface(device);
+        ipv4->AddAddress(ifIndex, Ipv4InterfaceAddress(Ipv4Address(0x0a000001 | i << 8), "/24"));
+        ipv4->SetUp(ifIndex);
+    }
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    Ptr<Ipv4StaticRouting> staticRouting = ipv4RoutingHelper.GetStaticRouting(ipv4);
+
+    // Overlapping prefixes of a few networks, with duplicate prefixes of
+    // different metrics and interfaces
+    Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+    rand->SetStream(1);
+    const uint32_t networks[] = {0x0a010000, 0x0a0100f0, 0x0a01ff00, 0xc0a80000, 0xc0a80480};
+    const uint32_t lengths[] = {0, 8, 16, 20, 24, 25, 28, 30, 32};
+    // Non-contiguous masks, which are not indexed by prefix, and whose
+    // lengths are those of the contiguous masks /24, /16 and /32
+    const uint32_t nonContiguousMasks[] = {0xffff00ff, 0xff00ff00, 0xfffffff3};
+    auto randomAddress = [&]() {
+        uint32_t network = networks[rand->GetInteger(0, std::size(networks) - 1)];
+        return Ipv4Address(network | rand->GetInteger(0, 255));
+    };
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        Ipv4Mask mask(("/" + std::to_string(lengths[rand->GetInteger(0, 8)])).c_str());
+        if (i % 10 == 9)
+        {
+            mask = Ipv4Mask(nonContiguousMasks[rand->GetInteger(0, 2)]);
+        }
+        uint32_t interface = rand->GetInteger(1, nDevices);
+        Ipv4Address gateway(0x0a000002 | interface << 8 | rand->GetInteger(0, 3) << 4);
+        staticRouting->AddNetworkRouteTo(randomAddress().CombineMask(mask),
+                                         mask,
+                                         gateway,
+                                         interface,
+                                         rand->GetInteger(0, 2));
+        if (i % 5 == 4)
+        {
+            staticRouting->RemoveRoute(rand->GetInteger(0, staticRouting->GetNRoutes() - 1));
+        }
+    }
+
+    std::vector<Route> routes;
+    for (uint32_t i = 0; i < staticRouting->GetNRoutes(); i++)
+    {
+        routes.emplace_back(staticRouting->GetRoute(i), staticRouting->GetMetric(i));
+    }
+
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        Ipv4Header header;
+        header.SetDestination(randomAddress());
+        uint32_t oifIndex = rand->GetInteger(0, nDevices);
+        Ptr<NetDevice> oif = oifIndex ? ipv4->GetNetDevice(oifIndex) : nullptr;
+        Socket::SocketErrno sockerr;
+        Ptr<Ipv4Route> route = staticRouting->RouteOutput(nullptr, header, oif, sockerr);
+        const Ipv4RoutingTableEntry* expected =
+            LinearLookup(routes, ipv4, header.GetDestination(), oif);
+        NS_TEST_ASSERT_MSG_EQ((route != nullptr),
+                              (expected != nullptr),
+                              "Route found for " << header.GetDestination() << " does not match");
+        if (expected)
+        {
+            NS_TEST_EXPECT_MSG_EQ(route->GetDestination(),
+                                  expected->GetDest(),
+                                  "Wrong route to " << header.GetDestination());
+            NS_TEST_EXPECT_MSG_EQ(route->GetGateway(),
+                                  expected->GetGateway(),
+                                  "Wrong gateway to " << header.GetDestination());
+            NS_TEST_EXPECT_MSG_EQ(route->GetOutputDevice(),
+                                  ipv4->GetNetDevice(expected->GetInterface()),
+                                  "Wrong output device to " << header.GetDestination());
+        }
+    }
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -222,6 +389,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite()
     : TestSuite("ipv4-static-routing", UNIT)
 {
     AddTestCase(new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4StaticRoutingLookupTestCase, TestCase::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite
@@ -17,15 +17,20 @@
  * Author: Zhiheng Dong <dzh2077@gmail.com>
  */
 
+#include "ns3/arp-cache.h"
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/boolean.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/ipv6-routing-helper.h"
+#include "ns3/ndisc-cache.h"
 #include "ns3/neighbor-cache-helper.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
@@ -1221,6 +1226,293 @@ DynamicPartialTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief ArpCache retransmission and expiry test.
+ *
+ * Checks that the ArpRequests of the entries waiting for a reply are retried
+ * every WaitReplyTimeout until MaxRetries, and that the dead and alive
+ * entries are removed from the cache once they have expired, when
+ * RemoveExpiredEntries is set.
+ */
+class ArpCacheExpiryTest : public TestCase
+{
+    uint32_t m_requests; //!< Number of ArpRequests
+    uint32_t m_drops;    //!< Number of dropped packets
+
+    /**
+     * \brief Count the ArpRequests.
+     * \param cache The ARP cache.
+     * \param to The address to resolve.
+     */
+    void ArpRequest(Ptr<const ArpCache> cache, Ipv4Address to);
+
+    /**
+     * \brief Count the dropped packets.
+     * \param packet The dropped packet.
+     */
+    void Drop(Ptr<const Packet> packet);
+
+  public:
+    void DoRun() override;
+
+    ArpCacheExpiryTest();
+};
+
+ArpCacheExpiryTest::ArpCacheExpiryTest()
+    : TestCase("ArpCache retransmission and expiry"),
+      m_requests(0),
+      m_drops(0)
+{
+}
+
+void
+ArpCacheExpiryTest::ArpRequest(Ptr<const ArpCache> cache, Ipv4Address to)
+{
+    m_requests++;
+}
+
+void
+ArpCacheExpiryTest::Drop(Ptr<const Packet> packet)
+{
+    m_drops++;
+}
+
+void
+ArpCacheExpiryTest::DoRun()
+{
+    const uint32_t nEntries = 1000;
+    Ptr<ArpCache> cache = CreateObject<ArpCache>();
+    cache->SetAttribute("RemoveExpiredEntries", BooleanValue(true));
+    cache->SetAliveTimeout(Seconds(10));
+    cache->SetDeadTimeout(Seconds(5));
+    cache->SetWaitReplyTimeout(Seconds(1));
+    cache->SetArpRequestCallback(MakeCallback(&ArpCacheExpiryTest::ArpRequest, this));
+    cache->TraceConnectWithoutContext("Drop", MakeCallback(&ArpCacheExpiryTest::Drop, this));
+
+    // The entries in 10.0.0.0/16 are never resolved, the ones in 10.1.0.0/16 are at 0.5s
+    std::vector<Ipv4Address> unresolved;
+    std::vector<Ipv4Address> resolved;
+    for (uint32_t i = 0; i < nEntries; i++)
+    {
+        unresolved.emplace_back(0x0a000000 + i + 1);
+        resolved.emplace_back(0x0a010000 + i + 1);
+    }
+    for (const auto& address : unresolved)
+    {
+        cache->Add(address)->MarkWaitReply(
+            ArpCache::Ipv4PayloadHeaderPair(Create<Packet>(100), Ipv4Header()));
+    }
+    for (const auto& address : resolved)
+    {
+        cache->Add(address)->MarkWaitReply(
+            ArpCache::Ipv4PayloadHeaderPair(Create<Packet>(100), Ipv4Header()));
+    }
+    Simulator::Schedule(Seconds(0.5), [&]() {
+        for (const auto& address : resolved)
+        {
+            cache->Lookup(address)->MarkAlive(Mac48Address::Allocate());
+        }
+    });
+
+    // The requests are retried at 1s, 2s and 3s, and the entries are dead at 4s
+    Simulator::Schedule(Seconds(3.5), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(m_requests, 3 * nEntries, "Wrong number of ArpRequests");
+        NS_TEST_EXPECT_MSG_EQ(m_drops, 0, "Packets dropped too early");
+        NS_TEST_EXPECT_MSG_EQ(cache->Lookup(unresolved[0])->IsWaitReply(),
+                              true,
+                              "Entry not waiting for a reply");
+    });
+    Simulator::Schedule(Seconds(4.5), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(m_requests, 3 * nEntries, "Wrong number of ArpRequests");
+        NS_TEST_EXPECT_MSG_EQ(m_drops, nEntries, "Wrong number of dropped packets");
+        NS_TEST_EXPECT_MSG_EQ(cache->Lookup(unresolved[0])->IsDead(), true, "Entry not dead");
+    });
+
+    // The dead entries expire after 9s
+    Simulator::Schedule(Seconds(9), [&]() {
+        NS_TEST_EXPECT_MSG_NE(cache->Lookup(unresolved[0]), nullptr, "Dead entry removed early");
+        NS_TEST_EXPECT_MSG_EQ(cache->Lookup(unresolved[0])->IsExpired(),
+                              false,
+                              "Dead entry expired early");
+    });
+    Simulator::Schedule(Seconds(9.1), [&]() {
+        for (const auto& address : unresolved)
+        {
+            NS_TEST_EXPECT_MSG_EQ(cache->Lookup(address), nullptr, "Expired dead entry kept");
+        }
+        NS_TEST_EXPECT_MSG_NE(cache->Lookup(resolved[0]), nullptr, "Alive entry removed");
+    });
+
+    // The alive entries expire after 10.5s, unless they are seen again
+    Simulator::Schedule(Seconds(5), [&]() { cache->Lookup(resolved[0])->UpdateSeen(); });
+    Simulator::Schedule(Seconds(10.6), [&]() {
+        NS_TEST_EXPECT_MSG_NE(cache->Lookup(resolved[0]), nullptr, "Refreshed entry removed");
+        for (uint32_t i = 1; i < nEntries; i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(cache->Lookup(resolved[i]), nullptr, "Expired alive entry kept");
+        }
+    });
+    Simulator::Schedule(Seconds(15.1), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(cache->Lookup(resolved[0]), nullptr, "Expired alive entry kept");
+    });
+
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_requests, 3 * nEntries, "Wrong number of ArpRequests");
+    cache->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief ArpCache refresh test.
+ *
+ * Checks that, by default, an alive entry is kept in the cache after it has
+ * expired, and that a packet received from its address makes it usable
+ * again without a new ARP exchange.
+ */
+class ArpCacheRefreshTest : public TestCase
+{
+  public:
+    void DoRun() override;
+
+    ArpCacheRefreshTest();
+};
+
+ArpCacheRefreshTest::ArpCacheRefreshTest()
+    : TestCase("ArpCache refresh of an expired entry")
+{
+}
+
+void
+ArpCacheRefreshTest::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<ArpL3Protocol> arp = CreateObject<ArpL3Protocol>();
+    node->AggregateObject(arp);
+    Ptr<ArpCache> cache = CreateObject<ArpCache>();
+    cache->SetAliveTimeout(Seconds(10));
+
+    Ipv4Address address("10.0.0.2");
+    Mac48Address mac = Mac48Address::Allocate();
+    ArpCache::Entry* entry = cache->Add(address);
+    entry->MarkWaitReply(ArpCache::Ipv4PayloadHeaderPair(Create<Packet>(100), Ipv4Header()));
+    entry->MarkAlive(mac);
+    entry->ClearPendingPacket();
+
+    Simulator::Schedule(Seconds(20), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(cache->Lookup(address), entry, "Expired alive entry removed");
+        NS_TEST_EXPECT_MSG_EQ(entry->IsExpired(), true, "Alive entry not expired");
+
+        // Ipv4L3Protocol refreshes the entry of the source of a received packet
+        entry->UpdateSeen();
+        Address hardwareDestination;
+        bool resolved = arp->Lookup(Create<Packet>(100),
+                                    Ipv4Header(),
+                                    address,
+                                    nullptr,
+                                    cache,
+                                    &hardwareDestination);
+        NS_TEST_EXPECT_MSG_EQ(resolved, true, "Refreshed entry not resolved");
+        NS_TEST_EXPECT_MSG_EQ(hardwareDestination, Address(mac), "Wrong hardware address");
+        NS_TEST_EXPECT_MSG_EQ(entry->IsAlive(), true, "Refreshed entry not alive");
+    });
+
+    Simulator::Run();
+    cache->Dispose();
+    node->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief NdiscCache reachable timer test.
+ *
+ * Checks that the REACHABLE entries whose timers expire at the same time all
+ * become STALE together, and that an entry whose reachability is confirmed
+ * again is kept REACHABLE until its new expiration time, even if its timer
+ * was queued for the former one.
+ */
+class NdiscCacheReachableTimerTest : public TestCase
+{
+  public:
+    void DoRun() override;
+
+    NdiscCacheReachableTimerTest();
+};
+
+NdiscCacheReachableTimerTest::NdiscCacheReachableTimerTest()
+    : TestCase("NdiscCache refresh of the reachable timers")
+{
+}
+
+void
+NdiscCacheReachableTimerTest::DoRun()
+{
+    const uint32_t nEntries = 100;
+    Ptr<Icmpv6L4Protocol> icmpv6 = CreateObject<Icmpv6L4Protocol>();
+    icmpv6->SetAttribute("ReachableTime", TimeValue(Seconds(10)));
+    Ptr<NdiscCache> cache = CreateObject<NdiscCache>();
+    cache->SetDevice(nullptr, nullptr, icmpv6);
+
+    // All the reachable timers expire at 10s
+    std::vector<NdiscCache::Entry*> entries;
+    for (uint32_t i = 0; i < nEntries; i++)
+    {
+        uint8_t buffer[16] = {0x20, 0x01};
+        buffer[14] = (i + 1) >> 8;
+        buffer[15] = (i + 1) & 0xff;
+        NdiscCache::Entry* entry = cache->Add(Ipv6Address(buffer));
+        entry->MarkReachable(Mac48Address::Allocate());
+        entry->StartReachableTimer();
+        entries.push_back(entry);
+    }
+
+    // The first two entries are confirmed again at 5s, their timers now expire at 15s,
+    // and the second one again at 12s, its timer now expires at 22s
+    Simulator::Schedule(Seconds(5), [&]() {
+        entries[0]->UpdateReachableTimer();
+        entries[1]->UpdateReachableTimer();
+    });
+    Simulator::Schedule(Seconds(12), [&]() { entries[1]->UpdateReachableTimer(); });
+
+    Simulator::Schedule(Seconds(9.9), [&]() {
+        for (const auto& entry : entries)
+        {
+            NS_TEST_EXPECT_MSG_EQ(entry->IsReachable(), true, "Entry stale too early");
+        }
+    });
+    Simulator::Schedule(Seconds(10.1), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(entries[0]->IsReachable(), true, "Refreshed entry stale");
+        NS_TEST_EXPECT_MSG_EQ(entries[1]->IsReachable(), true, "Refreshed entry stale");
+        for (uint32_t i = 2; i < nEntries; i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(entries[i]->IsStale(), true, "Expired entry not stale");
+        }
+    });
+    Simulator::Schedule(Seconds(14.9), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(entries[0]->IsReachable(), true, "Refreshed entry stale early");
+    });
+    Simulator::Schedule(Seconds(15.1), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(entries[0]->IsStale(), true, "Refreshed entry not stale");
+        NS_TEST_EXPECT_MSG_EQ(entries[1]->IsReachable(), true, "Refreshed entry stale");
+    });
+    Simulator::Schedule(Seconds(21.9), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(entries[1]->IsReachable(), true, "Refreshed entry stale early");
+    });
+    Simulator::Schedule(Seconds(22.1), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(entries[1]->IsStale(), true, "Refreshed entry not stale");
+    });
+
+    Simulator::Run();
+    cache->Dispose();
+    icmpv6->Dispose();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1239,6 +1531,9 @@ class NeighborCacheTestSuite : public TestSuite
         AddTestCase(new FlushTest, TestCase::QUICK);
         AddTestCase(new DuplicateTest, TestCase::QUICK);
         AddTestCase(new DynamicPartialTest, TestCase::QUICK);
+        AddTestCase(new ArpCacheExpiryTest, TestCase::QUICK);
+        AddTestCase(new ArpCacheRefreshTest, TestCase::QUICK);
+        AddTestCase(new NdiscCacheReachableTimerTest, TestCase::QUICK);
     }
 };
 
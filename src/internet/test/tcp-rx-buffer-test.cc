@@ -42,6 +42,11 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * \brief Test the reassembly of many out-of-order and overlapping segments.
+     */
+    void TestManyOutOfOrder();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -53,6 +58,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestManyOutOfOrder();
 }
 
 void
@@ -288,6 +294,75 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestManyOutOfOrder()
+{
+    const uint32_t segmentSize = 100;
+    const uint32_t nSegments = 10000;
+    TcpRxBuffer rxBuf;
+    TcpHeader h;
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+    rxBuf.SetMaxBufferSize(nSegments * segmentSize);
+
+    // The odd segments arrive first, from the last one
+    for (uint32_t i = nSegments - 1; i < nSegments; i -= 2)
+    {
+        h.SetSequenceNumber(SequenceNumber32(1 + i * segmentSize));
+        NS_TEST_ASSERT_MSG_EQ(rxBuf.Add(Create<Packet>(segmentSize), h),
+                              true,
+                              "Out-of-order segment " << i << " not buffered");
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(1),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(),
+                          nSegments / 2 * segmentSize,
+                          "Wrong number of buffered bytes");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().size(), 4, "SACK list should be full");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().front().first,
+                          SequenceNumber32(1 + segmentSize),
+                          "SACK block different than expected");
+
+    // Then segments that overlap the second half of each hole and the
+    // following odd segment
+    for (uint32_t i = 0; i < nSegments; i += 2)
+    {
+        h.SetSequenceNumber(SequenceNumber32(1 + i * segmentSize + segmentSize / 2));
+        NS_TEST_ASSERT_MSG_EQ(rxBuf.Add(Create<Packet>(segmentSize), h),
+                              true,
+                              "Overlapping segment " << i << " not buffered");
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(),
+                          3 * nSegments / 4 * segmentSize,
+                          "Wrong number of buffered bytes after the overlapping segments");
+
+    // Finally the even segments, in order: each one fills a hole
+    for (uint32_t i = 0; i < nSegments; i += 2)
+    {
+        h.SetSequenceNumber(SequenceNumber32(1 + i * segmentSize));
+        NS_TEST_ASSERT_MSG_EQ(rxBuf.Add(Create<Packet>(segmentSize), h),
+                              true,
+                              "Even segment " << i << " not buffered");
+        NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                              SequenceNumber32(1 + (i + 2) * segmentSize),
+                              "Sequence number differs from expected");
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(),
+                          nSegments * segmentSize,
+                          "All the data should be available");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().size(), 0, "SACK list should be empty");
+
+    // A duplicate is not buffered again
+    h.SetSequenceNumber(SequenceNumber32(1 + segmentSize));
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Add(Create<Packet>(segmentSize), h),
+                          false,
+                          "Duplicate segment buffered");
+
+    Ptr<Packet> p = rxBuf.Extract(nSegments * segmentSize);
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), nSegments * segmentSize, "Wrong number of bytes extracted");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "The buffer should be empty");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
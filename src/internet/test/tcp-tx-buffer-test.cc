@@ -53,6 +53,8 @@ class TcpTxBufferTestCase : public TestCase
     /** \brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** \brief Test the scoreboard with a large window and many holes */
+    void TestLargeWindow();
     /**
      * \brief Callback to provide a value of receiver window
      * \returns the receiver window size
@@ -100,6 +102,14 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Case for a high-BDP flow:
+     *  -> tens of thousands of segments in flight, one in ten is lost
+     *  -> the holes are detected as SACK blocks arrive, and retransmitted in order
+     *  -> a cumulative ACK empties the scoreboard
+     */
+    Simulator::Schedule(Seconds(0.0), &TcpTxBufferTestCase::TestLargeWindow, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -420,6 +430,115 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLargeWindow()
+{
+    const uint32_t segmentSize = 1000;
+    const uint32_t nSegments = 20000;
+    const uint32_t holeEvery = 10;
+    const uint32_t nHoles = nSegments / holeEvery;
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    SequenceNumber32 head(1);
+    txBuf->SetHeadSequence(head);
+    txBuf->SetSegmentSize(segmentSize);
+    txBuf->SetDupAckThresh(3);
+    txBuf->SetMaxBufferSize(nSegments * segmentSize);
+    txBuf->Add(Create<Packet>(nSegments * segmentSize));
+
+    for (uint32_t i = 0; i < nSegments; ++i)
+    {
+        txBuf->CopyFromSequence(segmentSize, head + (segmentSize * i));
+    }
+
+    // The first segment of every group is lost; the receiver SACKs the others,
+    // one group per ACK
+    for (uint32_t i = 0; i < nHoles; ++i)
+    {
+        TcpOptionSack::SackList list;
+        list.emplace_back(head + (segmentSize * (i * holeEvery + 1)),
+                          head + (segmentSize * (i + 1) * holeEvery));
+        NS_TEST_ASSERT_MSG_EQ(txBuf->Update(list),
+                              (holeEvery - 1) * segmentSize,
+                              "Wrong number of bytes sacked by block " << i);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(),
+                          (nSegments - nHoles) * segmentSize,
+                          "Wrong number of sacked bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), nHoles * segmentSize, "Wrong number of lost bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->BytesInFlight(), 0, "Nothing should be in flight");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + (segmentSize * holeEvery * (nHoles / 2))),
+                          true,
+                          "A hole is not lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + (segmentSize * (holeEvery * (nHoles / 2) + 1))),
+                          false,
+                          "A sacked segment is lost");
+
+    // The holes are retransmitted in order
+    SequenceNumber32 ret;
+    SequenceNumber32 retHigh;
+    for (uint32_t i = 0; i < nHoles; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                              true,
+                              "No NextSeg for hole " << i);
+        NS_TEST_ASSERT_MSG_EQ(ret,
+                              head + (segmentSize * holeEvery * i),
+                              "Wrong NextSeg for hole " << i);
+        txBuf->CopyFromSequence(segmentSize, ret);
+    }
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          false,
+                          "NextSeg returned a segment with all the holes retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(),
+                          nHoles * segmentSize,
+                          "Wrong number of retransmitted bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->BytesInFlight(),
+                          nHoles * segmentSize,
+                          "Only the retransmissions should be in flight");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + segmentSize),
+                          true,
+                          "The ACK of the first hole is not for retransmitted data");
+
+    // Half of the data is cumulatively acknowledged, then the rest
+    txBuf->DiscardUpTo(head + (segmentSize * nSegments / 2));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(),
+                          (nSegments - nHoles) * segmentSize / 2,
+                          "Wrong number of sacked bytes after a partial ACK");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(),
+                          nHoles * segmentSize / 2,
+                          "Wrong number of lost bytes after a partial ACK");
+    txBuf->DiscardUpTo(head + (segmentSize * nSegments));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Size(), 0, "The buffer should be empty");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), 0, "Sacked bytes in an empty buffer");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 0, "Lost bytes in an empty buffer");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 0, "Retransmits in an empty buffer");
+
+    // Without SACK, each duplicate ACK sacks the next segment after the head
+    Ptr<TcpTxBuffer> renoBuf = CreateObject<TcpTxBuffer>();
+    renoBuf->SetHeadSequence(head);
+    renoBuf->SetSegmentSize(segmentSize);
+    renoBuf->SetDupAckThresh(3);
+    renoBuf->SetSackEnabled(false);
+    renoBuf->SetMaxBufferSize(nSegments * segmentSize);
+    renoBuf->Add(Create<Packet>(nSegments * segmentSize));
+    for (uint32_t i = 0; i < nSegments; ++i)
+    {
+        renoBuf->CopyFromSequence(segmentSize, head + (segmentSize * i));
+    }
+    for (uint32_t i = 0; i < nSegments / 2; ++i)
+    {
+        renoBuf->AddRenoSack();
+    }
+    NS_TEST_ASSERT_MSG_EQ(renoBuf->GetSacked(),
+                          nSegments / 2 * segmentSize,
+                          "Wrong number of Reno sacked bytes");
+    NS_TEST_ASSERT_MSG_EQ(renoBuf->IsLost(head), false, "The head is not lost without SACK");
+    renoBuf->ResetRenoSack();
+    NS_TEST_ASSERT_MSG_EQ(renoBuf->GetSacked(), 0, "Reno SACKs not reset");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
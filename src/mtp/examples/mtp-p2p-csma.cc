@@ -0,0 +1,170 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ *
+ * Campus networks executed in parallel by the MultithreadedSimulatorImpl.
+ *
+ * Each campus is a CSMA LAN of hosts behind a router, and the routers are
+ * connected in a ring of point-to-point links:
+ *
+ * \verbatim
+     hosts        hosts        hosts
+     | | |        | | |        | | |
+    ========     ========     ========  CSMA
+        |            |            |
+      router ---- router ---- router    point-to-point, 5 ms
+        |________________________|
+   \endverbatim
+ *
+ * Each host sends UDP traffic to a host of the next campus. The point-to-
+ * point links are cut, and each campus is executed as a logical process.
+ * Compare the run time with, e.g.:
+ *
+ * \code
+ *   ./ns3 run "mtp-p2p-csma --campuses=16 --threads=1"
+ *   ./ns3 run "mtp-p2p-csma --campuses=16 --threads=4"
+ * \endcode
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("MtpP2pCsma");
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nCampuses = 8;
+    uint32_t nHosts = 16;
+    uint32_t nThreads = 0;
+    Time stopTime = Seconds(10);
+    std::string dataRate = "1Mbps";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("campuses", "Number of campus networks", nCampuses);
+    cmd.AddValue("hosts", "Number of hosts per campus", nHosts);
+    cmd.AddValue("threads", "Maximum number of threads, 0 for the hardware threads", nThreads);
+    cmd.AddValue("stopTime", "Simulation stop time", stopTime);
+    cmd.AddValue("dataRate", "Data rate of the traffic of each host", dataRate);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(nCampuses < 2, "At least two campuses are needed");
+
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(nThreads));
+
+    SystemWallClockMs setupClock;
+    setupClock.Start();
+
+    NodeContainer routers;
+    routers.Create(nCampuses);
+    std::vector<NodeContainer> hosts(nCampuses);
+    for (auto& campus : hosts)
+    {
+        campus.Create(nHosts);
+    }
+
+    InternetStackHelper stack;
+    stack.Install(routers);
+    for (const auto& campus : hosts)
+    {
+        stack.Install(campus);
+    }
+
+    CsmaHelper csma;
+    csma.SetChannelAttribute("DataRate", StringValue("100Mbps"));
+    csma.SetChannelAttribute("Delay", TimeValue(MicroSeconds(5)));
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    p2p.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+
+    Ipv4AddressHelper address;
+    std::vector<Ipv4InterfaceContainer> hostInterfaces(nCampuses);
+    for (uint32_t i = 0; i < nCampuses; ++i)
+    {
+        address.SetBase(Ipv4Address(0x0a000000 + (i << 16)), "255.255.0.0");
+        NetDeviceContainer lan = csma.Install(NodeContainer(routers.Get(i), hosts[i]));
+        Ipv4InterfaceContainer interfaces = address.Assign(lan);
+        for (uint32_t j = 1; j < interfaces.GetN(); ++j)
+        {
+            hostInterfaces[i].Add(interfaces.Get(j));
+        }
+
+        address.SetBase(Ipv4Address(0xac100000 + (i << 8)), "255.255.255.0");
+        address.Assign(p2p.Install(routers.Get(i), routers.Get((i + 1) % nCampuses)));
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    uint16_t port = 9;
+    ApplicationContainer sinks;
+    ApplicationContainer sources;
+    PacketSinkHelper sink("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), port));
+    OnOffHelper onOff("ns3::UdpSocketFactory", Address());
+    onOff.SetConstantRate(DataRate(dataRate), 512);
+    for (uint32_t i = 0; i < nCampuses; ++i)
+    {
+        sinks.Add(sink.Install(hosts[i]));
+        for (uint32_t j = 0; j < nHosts; ++j)
+        {
+            Ipv4Address destination = hostInterfaces[(i + 1) % nCampuses].GetAddress(j);
+            onOff.SetAttribute("Remote", AddressValue(InetSocketAddress(destination, port)));
+            sources.Add(onOff.Install(hosts[i].Get(j)));
+        }
+    }
+    sinks.Start(Seconds(0));
+    sources.Start(Seconds(1));
+    sources.Stop(stopTime);
+
+    int64_t setupTime = setupClock.End();
+
+    SystemWallClockMs runClock;
+    runClock.Start();
+    Simulator::Stop(stopTime);
+    Simulator::Run();
+    int64_t runTime = runClock.End();
+
+    uint64_t totalRx = 0;
+    for (auto app = sinks.Begin(); app != sinks.End(); ++app)
+    {
+        totalRx += DynamicCast<PacketSink>(*app)->GetTotalRx();
+    }
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+
+    std::cout << "Nodes:               " << NodeList::GetNNodes() << std::endl;
+    std::cout << "Logical processes:   " << impl->GetNPartitions() << std::endl;
+    std::cout << "Threads:             " << impl->GetNThreads() << std::endl;
+    std::cout << "Lookahead:           " << impl->GetLookahead().As(Time::MS) << std::endl;
+    std::cout << "Events:              " << Simulator::GetEventCount() << std::endl;
+    std::cout << "Received bytes:      " << totalRx << std::endl;
+    std::cout << "Setup time:          " << setupTime << " ms" << std::endl;
+    std::cout << "Run time:            " << runTime << " ms" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,828 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/object-base.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+namespace
+{
+/** Timestamp larger than the timestamp of any event. */
+constexpr uint64_t MAX_TS = std::numeric_limits<uint64_t>::max();
+} // namespace
+
+thread_local MultithreadedSimulatorImpl::LogicalProcess* MultithreadedSimulatorImpl::g_currentLp =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "The maximum number of threads executing the simulation, "
+                          "or 0 to use the number of hardware threads.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MinLookahead",
+                          "The minimum propagation delay of a point-to-point channel "
+                          "for its two ends to be placed in different logical processes.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&MultithreadedSimulatorImpl::m_minLookahead),
+                          MakeTimeChecker());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_maxThreads(0),
+      m_lookahead(MAX_TS),
+      m_partitioned(false),
+      m_round(0),
+      m_nextLp(0),
+      m_pending(0),
+      m_exit(false),
+      m_windowEnd(0),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this);
+    AddLp();
+    m_mainThreadId = std::this_thread::get_id();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+    StopWorkers();
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    StopWorkers();
+    for (auto& lp : m_lps)
+    {
+        for (const auto& msg : lp->m_inbox)
+        {
+            msg.m_event->Unref();
+        }
+        lp->m_inbox.clear();
+        while (!lp->m_events->IsEmpty())
+        {
+            Scheduler::Event next = lp->m_events->RemoveNext();
+            next.impl->Unref();
+        }
+        lp->m_events = nullptr;
+    }
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+    StopWorkers();
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+    for (auto& lp : m_lps)
+    {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        if (lp->m_events)
+        {
+            while (!lp->m_events->IsEmpty())
+            {
+                scheduler->Insert(lp->m_events->RemoveNext());
+            }
+        }
+        lp->m_events = scheduler;
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+MultithreadedSimulatorImpl::LogicalProcess*
+MultithreadedSimulatorImpl::AddLp()
+{
+    auto lp = std::make_unique<LogicalProcess>();
+    lp->m_index = m_lps.size();
+    lp->m_uid = EventId::UID::VALID;
+    lp->m_currentUid = EventId::UID::INVALID;
+    lp->m_currentTs = 0;
+    lp->m_currentContext = Simulator::NO_CONTEXT;
+    lp->m_eventCount = 0;
+    lp->m_unscheduledEvents = 0;
+    lp->m_cost = 0;
+    lp->m_seq = 0;
+    if (!m_lps.empty())
+    {
+        // The events moved from the global logical process keep their
+        // keys: continue from its clock and uid.
+        const LogicalProcess* global = m_lps[0].get();
+        lp->m_uid = global->m_uid;
+        lp->m_currentUid = global->m_currentUid;
+        lp->m_currentTs = global->m_currentTs;
+    }
+    if (m_schedulerFactory.IsTypeIdSet())
+    {
+        lp->m_events = m_schedulerFactory.Create<Scheduler>();
+    }
+    m_lps.push_back(std::move(lp));
+    return m_lps.back().get();
+}
+
+MultithreadedSimulatorImpl::LogicalProcess*
+MultithreadedSimulatorImpl::GetLp(uint32_t context) const
+{
+    if (context < m_contextLp.size())
+    {
+        return m_lps[m_contextLp[context]].get();
+    }
+    return m_lps[0].get();
+}
+
+MultithreadedSimulatorImpl::LogicalProcess*
+MultithreadedSimulatorImpl::GetCurrentLp() const
+{
+    if (g_currentLp != nullptr)
+    {
+        return g_currentLp;
+    }
+    return m_lps[0].get();
+}
+
+void
+MultithreadedSimulatorImpl::Partition()
+{
+    NS_LOG_FUNCTION(this);
+    m_partitioned = true;
+    uint32_t nThreads = m_maxThreads;
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    uint32_t nNodes = NodeList::GetNNodes();
+    if (nThreads < 2 || nNodes < 2)
+    {
+        NS_LOG_INFO("not partitioned: " << nThreads << " threads, " << nNodes << " nodes");
+        return;
+    }
+
+    // Union-find of the nodes sharing a channel, each set represented by
+    // its smallest node id.
+    std::vector<uint32_t> parent(nNodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t i) {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    std::vector<Ptr<PointToPointChannel>> cuts;
+    for (auto node = NodeList::Begin(); node != NodeList::End(); ++node)
+    {
+        uint32_t id = (*node)->GetId();
+        for (uint32_t i = 0; i < (*node)->GetNDevices(); ++i)
+        {
+            Ptr<Channel> channel = (*node)->GetDevice(i)->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+            Ptr<PointToPointChannel> p2p = DynamicCast<PointToPointChannel>(channel);
+            if (p2p && p2p->GetNDevices() == 2)
+            {
+                TimeValue delay;
+                p2p->GetAttribute("Delay", delay);
+                if (delay.Get().IsStrictlyPositive() && delay.Get() >= m_minLookahead)
+                {
+                    cuts.push_back(p2p);
+                    continue;
+                }
+            }
+            for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+            {
+                uint32_t a = find(id);
+                uint32_t b = find(channel->GetDevice(j)->GetNode()->GetId());
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+
+    // The roots come first, so that logical processes are numbered in
+    // the order of their smallest node id.
+    m_contextLp.assign(nNodes, 0);
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        uint32_t root = find(i);
+        m_contextLp[i] = root == i ? AddLp()->m_index : m_contextLp[root];
+    }
+
+    m_lookahead = MAX_TS;
+    for (const auto& channel : cuts)
+    {
+        uint32_t a = channel->GetPointToPointDevice(0)->GetNode()->GetId();
+        uint32_t b = channel->GetPointToPointDevice(1)->GetNode()->GetId();
+        if (m_contextLp[a] != m_contextLp[b] && !channel->IsPartitioned())
+        {
+            TimeValue delay;
+            channel->GetAttribute("Delay", delay);
+            channel->SetPartitioned(true);
+            m_lookahead = std::min<uint64_t>(m_lookahead, delay.Get().GetTimeStep());
+        }
+    }
+
+    // Move the events of the nodes to their logical process.
+    LogicalProcess* global = m_lps[0].get();
+    Ptr<Scheduler> events = global->m_events;
+    global->m_events = m_schedulerFactory.Create<Scheduler>();
+    while (!events->IsEmpty())
+    {
+        Scheduler::Event ev = events->RemoveNext();
+        LogicalProcess* lp = GetLp(ev.key.m_context);
+        lp->m_events->Insert(ev);
+        if (lp != global)
+        {
+            global->m_unscheduledEvents--;
+            lp->m_unscheduledEvents++;
+        }
+    }
+
+    std::size_t nWorkers = std::min<std::size_t>(nThreads, m_lps.size() - 1) - 1;
+    if (nWorkers > 0)
+    {
+        ObjectBase::SetConcurrentAttributeAccess(true);
+    }
+    for (std::size_t i = 0; i < nWorkers; ++i)
+    {
+        m_workers.emplace_back(&MultithreadedSimulatorImpl::WorkerLoop, this);
+    }
+    NS_LOG_INFO(m_lps.size() - 1 << " logical processes, " << nWorkers + 1 << " threads, "
+                                  << cuts.size() / 2 << " candidate links, lookahead "
+                                  << TimeStep(m_lookahead));
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert(LogicalProcess* lp,
+                                   uint64_t ts,
+                                   uint32_t context,
+                                   EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = lp->m_uid;
+    lp->m_uid++;
+    lp->m_unscheduledEvents++;
+    lp->m_events->Insert(ev);
+    return ev.key.m_uid;
+}
+
+void
+MultithreadedSimulatorImpl::DeliverMessages(LogicalProcess* lp)
+{
+    // Only called between windows: no other thread accesses the inbox.
+    if (lp->m_inbox.empty())
+    {
+        return;
+    }
+    std::sort(lp->m_inbox.begin(), lp->m_inbox.end(), [](const Message& a, const Message& b) {
+        return a.m_ts < b.m_ts ||
+               (a.m_ts == b.m_ts &&
+                (a.m_srcLp < b.m_srcLp || (a.m_srcLp == b.m_srcLp && a.m_seq < b.m_seq)));
+    });
+    for (const auto& msg : lp->m_inbox)
+    {
+        Insert(lp, msg.m_ts, msg.m_context, msg.m_event);
+    }
+    lp->m_inbox.clear();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent(LogicalProcess* lp)
+{
+    Scheduler::Event next = lp->m_events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= lp->m_currentTs);
+    lp->m_unscheduledEvents--;
+    lp->m_eventCount++;
+
+    NS_LOG_LOGIC("handle " << next.key.m_ts);
+    lp->m_currentTs = next.key.m_ts;
+    lp->m_currentContext = next.key.m_context;
+    lp->m_currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow()
+{
+    uint32_t i;
+    while ((i = m_nextLp.fetch_add(1, std::memory_order_relaxed)) < m_active.size())
+    {
+        LogicalProcess* lp = m_active[i];
+        uint64_t count = lp->m_eventCount;
+        g_currentLp = lp;
+        // Stop() is applied at the end of the window, so that the events
+        // executed do not depend on the interleaving of the threads.
+        while (!lp->m_events->IsEmpty() && lp->m_events->PeekNext().key.m_ts < m_windowEnd)
+        {
+            ProcessOneEvent(lp);
+        }
+        g_currentLp = nullptr;
+        lp->m_cost = lp->m_eventCount - count;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunWindow(uint64_t windowEnd)
+{
+    m_active.clear();
+    for (std::size_t i = 1; i < m_lps.size(); ++i)
+    {
+        LogicalProcess* lp = m_lps[i].get();
+        if (!lp->m_events->IsEmpty() && lp->m_events->PeekNext().key.m_ts < windowEnd)
+        {
+            m_active.push_back(lp);
+        }
+    }
+    // Start with the logical processes which were the busiest in their
+    // last window.
+    std::stable_sort(m_active.begin(),
+                     m_active.end(),
+                     [](const LogicalProcess* a, const LogicalProcess* b) {
+                         return a->m_cost > b->m_cost;
+                     });
+    m_windowEnd = windowEnd;
+    m_nextLp.store(0, std::memory_order_relaxed);
+
+    if (m_active.size() < 2 || m_workers.empty())
+    {
+        ProcessWindow();
+        return;
+    }
+    m_pending.store(m_workers.size(), std::memory_order_relaxed);
+    {
+        std::unique_lock lock{m_roundMutex};
+        m_round.fetch_add(1, std::memory_order_release);
+    }
+    m_roundCv.notify_all();
+    ProcessWindow();
+    std::unique_lock lock{m_roundMutex};
+    m_doneCv.wait(lock, [this]() { return m_pending.load(std::memory_order_acquire) == 0; });
+}
+
+void
+MultithreadedSimulatorImpl::WorkerLoop()
+{
+    uint64_t round = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock{m_roundMutex};
+            m_roundCv.wait(lock, [this, round]() {
+                return m_exit || m_round.load(std::memory_order_acquire) != round;
+            });
+            if (m_exit)
+            {
+                return;
+            }
+            round = m_round.load(std::memory_order_relaxed);
+        }
+        ProcessWindow();
+        if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // Take the mutex, so that the main thread cannot miss the
+            // notification between its check and its wait.
+            {
+                std::unique_lock lock{m_roundMutex};
+            }
+            m_doneCv.notify_one();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::StopWorkers()
+{
+    if (m_workers.empty())
+    {
+        return;
+    }
+    {
+        std::unique_lock lock{m_roundMutex};
+        m_exit = true;
+    }
+    m_roundCv.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+    ObjectBase::SetConcurrentAttributeAccess(false);
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    for (const auto& lp : m_lps)
+    {
+        if (!lp->m_events->IsEmpty() || !lp->m_inbox.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    // Set the current threadId as the main threadId
+    m_mainThreadId = std::this_thread::get_id();
+    if (!m_partitioned)
+    {
+        Partition();
+    }
+    m_stop = false;
+
+    LogicalProcess* global = m_lps[0].get();
+    while (!m_stop)
+    {
+        uint64_t nextLocal = MAX_TS;
+        for (std::size_t i = 1; i < m_lps.size(); ++i)
+        {
+            LogicalProcess* lp = m_lps[i].get();
+            DeliverMessages(lp);
+            if (!lp->m_events->IsEmpty())
+            {
+                nextLocal = std::min(nextLocal, lp->m_events->PeekNext().key.m_ts);
+            }
+        }
+        DeliverMessages(global);
+        uint64_t nextGlobal =
+            global->m_events->IsEmpty() ? MAX_TS : global->m_events->PeekNext().key.m_ts;
+
+        if (nextGlobal == MAX_TS && nextLocal == MAX_TS)
+        {
+            break;
+        }
+        if (nextGlobal <= nextLocal)
+        {
+            // No node event can precede the global event, and no other
+            // thread is running: the global event may access any node.
+            ProcessOneEvent(global);
+        }
+        else
+        {
+            uint64_t windowEnd = nextGlobal;
+            if (MAX_TS - nextLocal > m_lookahead)
+            {
+                windowEnd = std::min(windowEnd, nextLocal + m_lookahead);
+            }
+            RunWindow(windowEnd);
+        }
+    }
+
+    // The main thread continues from the most advanced logical process.
+    int unscheduledEvents = 0;
+    for (const auto& lp : m_lps)
+    {
+        global->m_currentTs = std::max(global->m_currentTs, lp->m_currentTs);
+        unscheduledEvents += lp->m_unscheduledEvents;
+    }
+
+    // If the simulator stopped naturally by lack of events, make a
+    // consistency test to check that we didn't lose any events along the way.
+    NS_ASSERT(!IsFinished() || m_stop || unscheduledEvents == 0);
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    LogicalProcess* src = g_currentLp;
+    if (src == nullptr)
+    {
+        Simulator::ScheduleWithContext(Simulator::NO_CONTEXT, delay, &Simulator::Stop);
+        return;
+    }
+    // A node event cannot schedule a global event within the current
+    // window: the simulation stops at the end of the window at the earliest.
+    uint64_t ts = (delay + TimeStep(src->m_currentTs)).GetTimeStep();
+    Send(src,
+         m_lps[0].get(),
+         std::max(ts, m_windowEnd),
+         Simulator::NO_CONTEXT,
+         MakeEvent(&Simulator::Stop));
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(g_currentLp != nullptr || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::Schedule Thread-unsafe invocation!");
+
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+    LogicalProcess* lp = GetCurrentLp();
+    Time tAbsolute = delay + TimeStep(lp->m_currentTs);
+    uint64_t ts = tAbsolute.GetTimeStep();
+    uint32_t uid = Insert(lp, ts, lp->m_currentContext, event);
+    return EventId(event, ts, lp->m_currentContext, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(g_currentLp != nullptr || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::ScheduleWithContext Thread-unsafe invocation!");
+
+    LogicalProcess* src = GetCurrentLp();
+    LogicalProcess* dst = GetLp(context);
+    Time tAbsolute = delay + TimeStep(src->m_currentTs);
+    uint64_t ts = tAbsolute.GetTimeStep();
+    if (dst == src || g_currentLp == nullptr)
+    {
+        // Same logical process, or main thread between two windows.
+        Insert(dst, ts, context, event);
+        return;
+    }
+
+    // Only the cut links are guaranteed to respect the lookahead: an
+    // earlier event could precede the events already executed by dst.
+    NS_ABORT_MSG_IF(ts < m_windowEnd,
+                    "Event for context " << context << " at " << TimeStep(ts)
+                                         << " scheduled by context " << src->m_currentContext
+                                         << " before the end of the window at "
+                                         << TimeStep(m_windowEnd));
+    Send(src, dst, ts, context, event);
+}
+
+void
+MultithreadedSimulatorImpl::Send(LogicalProcess* src,
+                                 LogicalProcess* dst,
+                                 uint64_t ts,
+                                 uint32_t context,
+                                 EventImpl* event)
+{
+    Message msg;
+    msg.m_ts = ts;
+    msg.m_context = context;
+    msg.m_srcLp = src->m_index;
+    msg.m_seq = src->m_seq;
+    msg.m_event = event;
+    src->m_seq++;
+    std::unique_lock lock{dst->m_inboxMutex};
+    dst->m_inbox.push_back(msg);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    EventId id(Ptr<EventImpl>(event, false),
+               GetCurrentLp()->m_currentTs,
+               0xffffffff,
+               EventId::UID::DESTROY);
+    std::unique_lock lock{m_destroyEventsMutex};
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(GetCurrentLp()->m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - GetCurrentLp()->m_currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::unique_lock lock{m_destroyEventsMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    LogicalProcess* lp = GetLp(id.GetContext());
+    NS_ASSERT_MSG(g_currentLp == nullptr || g_currentLp == lp,
+                  "Simulator::Remove of an event of another logical process");
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    lp->m_events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    lp->m_unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        std::unique_lock lock{m_destroyEventsMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+    {
+        return true;
+    }
+    const LogicalProcess* lp = GetLp(id.GetContext());
+    // The clock of another logical process is updated concurrently, except
+    // for the global one, which only runs while the worker threads wait.
+    NS_ABORT_MSG_IF(g_currentLp != nullptr && g_currentLp != lp && lp != m_lps[0].get(),
+                    "Simulator::IsExpired of an event of another logical process");
+    return id.GetTs() < lp->m_currentTs ||
+           (id.GetTs() == lp->m_currentTs && id.GetUid() <= lp->m_currentUid);
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrentLp()->m_currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = 0;
+    for (const auto& lp : m_lps)
+    {
+        count += lp->m_eventCount;
+    }
+    return count;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions() const
+{
+    return m_lps.size() - 1;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNThreads() const
+{
+    return m_workers.size() + 1;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return m_lookahead == MAX_TS ? GetMaximumSimulationTime() : TimeStep(m_lookahead);
+}
+
+} // namespace ns3
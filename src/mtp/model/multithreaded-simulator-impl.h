@@ -0,0 +1,320 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-impl.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+/**
+ * \defgroup mtp Multithreaded Simulation
+ *
+ * Parallel execution of a simulation by the threads of a single process.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Simulator implementation executing the nodes in parallel threads
+ *
+ * At the first call to Run(), the nodes are partitioned into logical
+ * processes: the nodes sharing a channel are placed in the same logical
+ * process, except across the PointToPointChannel instances whose
+ * propagation delay is positive and not less than the MinLookahead
+ * attribute. Each logical process has its own event queue, and the
+ * logical processes are executed in parallel by MaxThreads threads.
+ *
+ * The synchronization is conservative: the logical processes execute
+ * concurrently all the events of a time window no longer than the
+ * smallest delay of the cut links (the lookahead), so that the packets
+ * sent over a cut link during a window are received after it. The
+ * windows also end at the next global event, i.e. an event without a
+ * node context, such as the events scheduled by the main program;
+ * global events are executed alone by the main thread, before the node
+ * events with the same timestamp.
+ *
+ * Each logical process is claimed by a single thread for a whole window.
+ * The threads claim the logical processes in decreasing order of the
+ * number of events they executed in the previous window, so that the
+ * busiest logical processes are started first.
+ *
+ * With a single thread the nodes are not partitioned, and the events are
+ * executed in the same order as with the DefaultSimulatorImpl. With two
+ * threads or more, the partition, and thus the order of the events, does
+ * not depend on the number of threads nor on their interleaving: the
+ * events received over cut links are inserted in the order of their
+ * timestamp, sending logical process and sending order.
+ *
+ * The model code executed in parallel must not share state between
+ * the nodes of different logical processes. In particular:
+ *
+ * - the topology must not change after the first call to Run();
+ * - trace sinks connected to the nodes of several logical processes
+ *   must be thread-safe;
+ * - the TxRxPointToPoint trace source of the cut channels is not fired;
+ * - packet uids are unique, but their assignment depends on the
+ *   interleaving of the threads;
+ * - Stop() called by a node event stops the simulation at the end of the
+ *   current window, and so does Stop(const Time&) called by a node event
+ *   with a delay ending within the current window; otherwise
+ *   Stop(const Time&) is exact;
+ * - events can only be scheduled from the main thread and by the
+ *   events themselves;
+ * - an event scheduled for a node of another logical process must not
+ *   precede the end of the current window, which holds for the packets
+ *   sent over the cut links: an earlier event is a fatal error;
+ * - a pending event of a node can only be checked, cancelled or removed
+ *   by the main thread or by the events of its own logical process.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    void Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Get the number of logical processes executing the nodes.
+     *
+     * \returns The number of logical processes, 0 until the first call
+     *          to Run() or if the nodes are not partitioned.
+     */
+    uint32_t GetNPartitions() const;
+
+    /**
+     * Get the number of threads executing the logical processes.
+     *
+     * \returns The number of threads, including the main thread.
+     */
+    uint32_t GetNThreads() const;
+
+    /**
+     * Get the lookahead of the partition.
+     *
+     * \returns The smallest delay of the cut links, or the maximum
+     *          simulation time if no link is cut.
+     */
+    Time GetLookahead() const;
+
+  private:
+    void DoDispose() override;
+
+    /** An event sent to another logical process. */
+    struct Message
+    {
+        uint64_t m_ts;      //!< Absolute timestamp of the event
+        uint32_t m_context; //!< Context of the event
+        uint32_t m_srcLp;   //!< Index of the sending logical process
+        uint64_t m_seq;     //!< Sequence number within the sending logical process
+        EventImpl* m_event; //!< The event implementation
+    };
+
+    /** A logical process: the event queue of a set of nodes. */
+    struct LogicalProcess
+    {
+        Ptr<Scheduler> m_events;      //!< The event priority queue
+        uint32_t m_index;             //!< Index of the logical process
+        uint32_t m_uid;               //!< Next event unique id
+        uint32_t m_currentUid;        //!< Unique id of the current event
+        uint64_t m_currentTs;         //!< Timestamp of the current event
+        uint32_t m_currentContext;    //!< Execution context of the current event
+        uint64_t m_eventCount;        //!< The event count
+        int m_unscheduledEvents;      //!< Events inserted but not yet executed
+        uint64_t m_cost;              //!< Events executed in the last window
+        uint64_t m_seq;               //!< Next sequence number of sent messages
+        std::vector<Message> m_inbox; //!< Events received from other logical processes
+        std::mutex m_inboxMutex;      //!< Mutex protecting m_inbox
+    };
+
+    /**
+     * Create a logical process.
+     * \returns The new logical process.
+     */
+    LogicalProcess* AddLp();
+
+    /**
+     * Partition the nodes into logical processes and start the threads.
+     */
+    void Partition();
+
+    /**
+     * Get the logical process executing the events of a context.
+     * \param [in] context The context.
+     * \returns The logical process.
+     */
+    LogicalProcess* GetLp(uint32_t context) const;
+
+    /**
+     * Get the logical process of the calling thread.
+     * \returns The logical process whose events are being executed by the
+     *          calling thread, or the global logical process.
+     */
+    LogicalProcess* GetCurrentLp() const;
+
+    /**
+     * Insert an event in a logical process.
+     * \param [in] lp The logical process.
+     * \param [in] ts The absolute timestamp of the event.
+     * \param [in] context The context of the event.
+     * \param [in] event The event implementation.
+     * \returns The unique id of the event.
+     */
+    uint32_t Insert(LogicalProcess* lp, uint64_t ts, uint32_t context, EventImpl* event);
+
+    /**
+     * Send an event to another logical process, during a window.
+     * \param [in] src The sending logical process.
+     * \param [in] dst The receiving logical process.
+     * \param [in] ts The absolute timestamp of the event.
+     * \param [in] context The context of the event.
+     * \param [in] event The event implementation.
+     */
+    void Send(LogicalProcess* src,
+              LogicalProcess* dst,
+              uint64_t ts,
+              uint32_t context,
+              EventImpl* event);
+
+    /**
+     * Move the events received by a logical process into its event queue.
+     * \param [in] lp The logical process.
+     */
+    void DeliverMessages(LogicalProcess* lp);
+
+    /**
+     * Execute the next event of a logical process.
+     * \param [in] lp The logical process.
+     */
+    void ProcessOneEvent(LogicalProcess* lp);
+
+    /**
+     * Execute in parallel the events before the end of a window.
+     * \param [in] windowEnd The end of the window, excluded.
+     */
+    void RunWindow(uint64_t windowEnd);
+
+    /** Claim and execute logical processes until none is left in the window. */
+    void ProcessWindow();
+
+    /** Main loop of the worker threads. */
+    void WorkerLoop();
+
+    /** Stop and join the worker threads. */
+    void StopWorkers();
+
+    /** The logical process executed by the calling thread, if any. */
+    static thread_local LogicalProcess* g_currentLp;
+
+    /** The logical processes; the first one holds the global events. */
+    std::vector<std::unique_ptr<LogicalProcess>> m_lps;
+    /** Index of the logical process of each node. */
+    std::vector<uint32_t> m_contextLp;
+    /** The logical processes to execute in the current window. */
+    std::vector<LogicalProcess*> m_active;
+    /** The scheduler factory. */
+    ObjectFactory m_schedulerFactory;
+    /** Maximum number of threads, 0 for the hardware concurrency. */
+    uint32_t m_maxThreads;
+    /** Minimum delay of the cut links. */
+    Time m_minLookahead;
+    /** Smallest delay of the cut links. */
+    uint64_t m_lookahead;
+    /** Whether the nodes have been partitioned. */
+    bool m_partitioned;
+
+    /** The worker threads. */
+    std::vector<std::thread> m_workers;
+    /** Mutex protecting the start of the windows. */
+    std::mutex m_roundMutex;
+    /** Signals the start of a window to the worker threads. */
+    std::condition_variable m_roundCv;
+    /** Number of windows started. */
+    std::atomic<uint64_t> m_round;
+    /** Index of the next logical process to claim in m_active. */
+    std::atomic<uint32_t> m_nextLp;
+    /** Number of worker threads still executing the current window. */
+    std::atomic<uint32_t> m_pending;
+    /** Signals the end of the current window to the main thread. */
+    std::condition_variable m_doneCv;
+    /** Whether the worker threads must exit. */
+    bool m_exit;
+    /** End of the current window. */
+    uint64_t m_windowEnd;
+
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Mutex protecting m_destroyEvents. */
+    mutable std::mutex m_destroyEventsMutex;
+    /** Main execution thread. */
+    std::thread::id m_mainThreadId;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,395 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite.
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests mtp module tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Relay packets over clusters of nodes sharing a SimpleChannel, the
+ * clusters being connected by a ring of point-to-point links, and check
+ * that the MultithreadedSimulatorImpl executes the same events as the
+ * DefaultSimulatorImpl.
+ *
+ * The size of each packet encodes its remaining number of hops, and the
+ * next hop only depends on the relaying node and on that number, so
+ * the packets received by each node do not depend on the order of the
+ * events.
+ */
+class MtpRelayTestCase : public TestCase
+{
+  public:
+    MtpRelayTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /** The (timestamp, size) of the packets received by each node. */
+    typedef std::vector<std::vector<std::pair<int64_t, uint32_t>>> Log;
+
+    /**
+     * Build the topology and run the simulation.
+     * \param [in] simulatorType The simulator implementation.
+     * \param [in] maxThreads The maximum number of threads.
+     * \returns The packets received by each node.
+     */
+    Log RunScenario(std::string simulatorType, uint32_t maxThreads);
+
+    /**
+     * Send a packet to a neighbor.
+     * \param [in] node The sending node.
+     * \param [in] hops The remaining number of hops of the packet.
+     */
+    void Send(uint32_t node, uint32_t hops);
+
+    /**
+     * Log a received packet and relay it.
+     * \param [in] device The receiving device.
+     * \param [in] packet The packet.
+     * \param [in] protocol The protocol number.
+     * \param [in] from The source address.
+     * \param [in] to The destination address.
+     * \param [in] packetType The packet type.
+     */
+    void Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from,
+                 const Address& to,
+                 NetDevice::PacketType packetType);
+
+    static constexpr uint32_t N_CLUSTERS = 4;    //!< Number of clusters
+    static constexpr uint32_t N_NODES = 3;       //!< Number of nodes per cluster
+    static constexpr uint32_t HOPS = 50;         //!< Number of hops of each packet
+    static constexpr uint32_t PACKET_SIZE = 100; //!< Size of a packet with no hop left
+    static constexpr uint16_t PROTOCOL = 0x0800; //!< Protocol number, supported by PPP
+
+    /** The devices and destination addresses of the neighbors of each node. */
+    std::vector<std::vector<std::pair<Ptr<NetDevice>, Address>>> m_neighbors;
+    Log m_log;             //!< The packets received by each node
+    uint32_t m_partitions; //!< Number of logical processes of the last run
+    Time m_lookahead;      //!< Lookahead of the last run
+    uint64_t m_eventCount; //!< Number of events of the last run
+};
+
+MtpRelayTestCase::MtpRelayTestCase()
+    : TestCase("Check the events of a partitioned simulation")
+{
+}
+
+void
+MtpRelayTestCase::Send(uint32_t node, uint32_t hops)
+{
+    const auto& neighbors = m_neighbors[node];
+    const auto& [device, address] = neighbors[(node + hops) % neighbors.size()];
+    device->Send(Create<Packet>(PACKET_SIZE + hops), address, PROTOCOL);
+}
+
+void
+MtpRelayTestCase::Receive(Ptr<NetDevice> device,
+                          Ptr<const Packet> packet,
+                          uint16_t protocol,
+                          const Address& from,
+                          const Address& to,
+                          NetDevice::PacketType packetType)
+{
+    uint32_t node = device->GetNode()->GetId();
+    NS_TEST_ASSERT_MSG_EQ(Simulator::GetContext(), node, "Event executed in the wrong context");
+    m_log[node].emplace_back(Simulator::Now().GetTimeStep(), packet->GetSize());
+    uint32_t hops = packet->GetSize() - PACKET_SIZE;
+    if (hops > 0)
+    {
+        Send(node, hops - 1);
+    }
+}
+
+MtpRelayTestCase::Log
+MtpRelayTestCase::RunScenario(std::string simulatorType, uint32_t maxThreads)
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(simulatorType));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(maxThreads));
+
+    NodeContainer nodes;
+    nodes.Create(N_CLUSTERS * N_NODES);
+    m_neighbors.assign(nodes.GetN(), {});
+    m_log.assign(nodes.GetN(), {});
+
+    SimpleNetDeviceHelper simple;
+    simple.SetChannelAttribute("Delay", TimeValue(MicroSeconds(100)));
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("2ms"));
+    for (uint32_t c = 0; c < N_CLUSTERS; ++c)
+    {
+        NodeContainer cluster;
+        for (uint32_t i = 0; i < N_NODES; ++i)
+        {
+            cluster.Add(nodes.Get(c * N_NODES + i));
+        }
+        NetDeviceContainer devices = simple.Install(cluster);
+        for (uint32_t i = 0; i < N_NODES; ++i)
+        {
+            for (uint32_t j = 0; j < N_NODES; ++j)
+            {
+                if (i != j)
+                {
+                    m_neighbors[c * N_NODES + i].emplace_back(devices.Get(i),
+                                                              devices.Get(j)->GetAddress());
+                }
+            }
+        }
+        // Connect the first node of each cluster to the next cluster
+        uint32_t a = c * N_NODES;
+        uint32_t b = (c + 1) % N_CLUSTERS * N_NODES;
+        NetDeviceContainer link = p2p.Install(nodes.Get(a), nodes.Get(b));
+        m_neighbors[a].emplace_back(link.Get(0), link.Get(1)->GetAddress());
+        m_neighbors[b].emplace_back(link.Get(1), link.Get(0)->GetAddress());
+    }
+
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        nodes.Get(i)->RegisterProtocolHandler(MakeCallback(&MtpRelayTestCase::Receive, this),
+                                              PROTOCOL,
+                                              nullptr);
+        Simulator::ScheduleWithContext(i,
+                                       MicroSeconds(10 * i),
+                                       &MtpRelayTestCase::Send,
+                                       this,
+                                       i,
+                                       HOPS);
+    }
+
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), Seconds(1), "Simulation not stopped at 1 s");
+
+    m_partitions = 0;
+    m_lookahead = Time(0);
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    if (impl)
+    {
+        m_partitions = impl->GetNPartitions();
+        m_lookahead = impl->GetLookahead();
+    }
+    m_eventCount = Simulator::GetEventCount();
+    m_neighbors.clear();
+    Simulator::Destroy();
+    return m_log;
+}
+
+void
+MtpRelayTestCase::DoRun()
+{
+    Log expected = RunScenario("ns3::DefaultSimulatorImpl", 1);
+    uint64_t eventCount = m_eventCount;
+    uint32_t received = 0;
+    for (const auto& log : expected)
+    {
+        received += log.size();
+    }
+    NS_TEST_ASSERT_MSG_EQ(received, N_CLUSTERS * N_NODES * (HOPS + 1), "Packets lost");
+
+    // A single thread executes the same events in the same order.
+    Log log = RunScenario("ns3::MultithreadedSimulatorImpl", 1);
+    NS_TEST_EXPECT_MSG_EQ(m_partitions, 0U, "Partitioned with a single thread");
+    NS_TEST_EXPECT_MSG_EQ(m_eventCount, eventCount, "Different number of events");
+    NS_TEST_EXPECT_MSG_EQ((log == expected), true, "Different events with a single thread");
+
+    // The clusters are executed in parallel: the nodes receive the same
+    // packets, possibly at different times when packets are received at
+    // the same time and queued in a different order.
+    Log parallel = RunScenario("ns3::MultithreadedSimulatorImpl", 2);
+    NS_TEST_EXPECT_MSG_EQ(m_partitions, N_CLUSTERS, "Unexpected number of logical processes");
+    NS_TEST_EXPECT_MSG_EQ(m_lookahead, MilliSeconds(2), "Unexpected lookahead");
+    for (uint32_t i = 0; i < expected.size(); ++i)
+    {
+        std::vector<uint32_t> sizes;
+        std::vector<uint32_t> expectedSizes;
+        for (const auto& [ts, size] : parallel[i])
+        {
+            sizes.push_back(size);
+        }
+        for (const auto& [ts, size] : expected[i])
+        {
+            expectedSizes.push_back(size);
+        }
+        std::sort(sizes.begin(), sizes.end());
+        std::sort(expectedSizes.begin(), expectedSizes.end());
+        NS_TEST_EXPECT_MSG_EQ((sizes == expectedSizes), true, "Different packets at node " << i);
+    }
+
+    // The order of the events does not depend on the threads.
+    log = RunScenario("ns3::MultithreadedSimulatorImpl", 3);
+    NS_TEST_EXPECT_MSG_EQ(m_partitions, N_CLUSTERS, "Unexpected number of logical processes");
+    NS_TEST_EXPECT_MSG_EQ((log == parallel), true, "Events depend on the number of threads");
+}
+
+void
+MtpRelayTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(0));
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Check the time at which Simulator::Stop(const Time&), called by a node
+ * event of a partitioned simulation, stops the simulation.
+ */
+class MtpStopTestCase : public TestCase
+{
+  public:
+    MtpStopTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Run two nodes connected by a point-to-point link, in two logical
+     * processes, the first node calling Simulator::Stop(delay) at 1 ms.
+     * \param [in] delay The delay of the stop.
+     * \returns The time at which the simulation stopped.
+     */
+    Time RunScenario(Time delay);
+
+    /**
+     * Execute an event of a node every 100 us, so that the simulation
+     * only ends when it is stopped.
+     */
+    void Tick();
+
+    /**
+     * Call Simulator::Stop(const Time&).
+     * \param [in] delay The delay of the stop.
+     */
+    void CallStop(Time delay);
+};
+
+MtpStopTestCase::MtpStopTestCase()
+    : TestCase("Check Simulator::Stop(delay) called by a node event")
+{
+}
+
+void
+MtpStopTestCase::Tick()
+{
+    Simulator::Schedule(MicroSeconds(100), &MtpStopTestCase::Tick, this);
+}
+
+void
+MtpStopTestCase::CallStop(Time delay)
+{
+    Simulator::Stop(delay);
+}
+
+Time
+MtpStopTestCase::RunScenario(Time delay)
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(2));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    PointToPointHelper p2p;
+    p2p.SetChannelAttribute("Delay", StringValue("2ms"));
+    p2p.Install(nodes);
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Simulator::ScheduleWithContext(i, Time(0), &MtpStopTestCase::Tick, this);
+    }
+    Simulator::ScheduleWithContext(0, MilliSeconds(1), &MtpStopTestCase::CallStop, this, delay);
+
+    Simulator::Run();
+    Time stop = Simulator::Now();
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    NS_TEST_EXPECT_MSG_EQ(impl->GetNPartitions(), 2U, "Unexpected number of logical processes");
+    Simulator::Destroy();
+    return stop;
+}
+
+void
+MtpStopTestCase::DoRun()
+{
+    // A stop beyond the current window is exact.
+    NS_TEST_EXPECT_MSG_EQ(RunScenario(MilliSeconds(5)),
+                          MilliSeconds(6),
+                          "Simulation not stopped at the time of Stop(delay)");
+    // A stop within the current window, which starts at 0 and lasts for the
+    // lookahead of 2 ms, is delayed to its end.
+    NS_TEST_EXPECT_MSG_EQ(RunScenario(MicroSeconds(100)),
+                          MilliSeconds(2),
+                          "Simulation not stopped at the end of the window");
+}
+
+void
+MtpStopTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(0));
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * MultithreadedSimulatorImpl test suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite();
+};
+
+MtpTestSuite::MtpTestSuite()
+    : TestSuite("mtp", UNIT)
+{
+    AddTestCase(new MtpRelayTestCase(), TestCase::QUICK);
+    AddTestCase(new MtpStopTestCase(), TestCase::QUICK);
+}
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
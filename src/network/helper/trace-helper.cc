@@ -190,11 +190,14 @@ AsciiTraceHelper::~AsciiTraceHelper()
 }
 
 Ptr<OutputStreamWrapper>
-AsciiTraceHelper::CreateFileStream(std::string filename, std::ios::openmode filemode)
+AsciiTraceHelper::CreateFileStream(std::string filename,
+                                   std::ios::openmode filemode,
+                                   bool asynchronous)
 {
-    NS_LOG_FUNCTION(filename << filemode);
+    NS_LOG_FUNCTION(filename << filemode << asynchronous);
 
-    Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper>(filename, filemode);
+    Ptr<OutputStreamWrapper> StreamWrapper =
+        Create<OutputStreamWrapper>(filename, filemode, asynchronous);
 
     //
     // Note that the ascii trace helper promptly forgets all about the trace file.
@@ -231,12 +231,17 @@ class AsciiTraceHelper
      * that can solve the problem so we use one of those to carry the stream
      * around and deal with the lifetime issues.
      *
+     * The file can be written by a background thread, so that the simulation
+     * does not wait for the file system, see AsyncFileStream.
+     *
      * @param filename file name
      * @param filemode file mode
+     * @param asynchronous write the file with a background thread
      * @returns a smart pointer to the output stream
      */
     Ptr<OutputStreamWrapper> CreateFileStream(std::string filename,
-                                              std::ios::openmode filemode = std::ios::out);
+                                              std::ios::openmode filemode = std::ios::out,
+                                              bool asynchronous = false);
 
     /**
      * @brief Hook a trace source to the default enqueue operation trace sink that
@@ -25,8 +25,6 @@
 #include <stdint.h>
 #include <vector>
 
-#define BUFFER_FREE_LIST 1
-
 namespace ns3
 {
 
@@ -740,7 +738,11 @@ class Buffer
      */
     static Buffer::Data* Create(uint32_t size);
     /**
-     * \brief Allocate a buffer data storage
+     * \brief Allocate a buffer data storage from the PacketAllocator
+     *
+     * The storage spans the whole block of the PacketAllocator, so its
+     * size may exceed the requested size.
+     *
      * \param reqSize the storage size to create
      * \returns a pointer to the allocated buffer storage
      */
@@ -769,7 +771,7 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
-    static uint32_t g_recommendedStart;
+    static thread_local uint32_t g_recommendedStart;
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -791,21 +793,6 @@ class Buffer
      * instance from the start of m_data->m_data
      */
     uint32_t m_end;
-
-#ifdef BUFFER_FREE_LIST
-    /// Container for buffer data
-    typedef std::vector<Buffer::Data*> FreeList;
-
-    /// Local static destructor structure
-    struct LocalStaticDestructor
-    {
-        ~LocalStaticDestructor();
-    };
-
-    static uint32_t g_maxSize;                            //!< Max observed data size
-    static FreeList* g_freeList;                          //!< Buffer data container
-    static LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
-#endif
 };
 
 } // namespace ns3
@@ -138,6 +138,9 @@ NodeListPriv::DoGet()
     {
         ptr = CreateObject<NodeListPriv>();
         Config::RegisterRootNamespaceObject(ptr);
+        Config::RegisterCachedContainer(NodeListPriv::GetTypeId(), "NodeList");
+        Config::RegisterCachedContainer(Node::GetTypeId(), "DeviceList");
+        Config::RegisterCachedContainer(Node::GetTypeId(), "ApplicationList");
         Simulator::ScheduleDestroy(&NodeListPriv::Delete);
     }
     return &ptr;
@@ -172,6 +175,7 @@ NodeListPriv::DoDispose()
         *i = nullptr;
     }
     m_nodes.erase(m_nodes.begin(), m_nodes.end());
+    Config::InvalidateCache();
     Object::DoDispose();
 }
 
@@ -181,6 +185,7 @@ NodeListPriv::Add(Ptr<Node> node)
     NS_LOG_FUNCTION(this << node);
     uint32_t index = m_nodes.size();
     m_nodes.push_back(node);
+    Config::InvalidateCache();
     Simulator::ScheduleWithContext(index, TimeStep(0), &Node::Initialize, node);
     return index;
 }
@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-allocator.h"
+
+#include "ns3/assert.h"
+
+#include <new>
+
+namespace
+{
+
+/** Number of size classes: 16 up to 256 bytes, then 4 per power of two up to 16 KiB. */
+constexpr uint32_t N_CLASSES = 40;
+
+static_assert(ns3::PacketAllocator::MAX_BLOCK_SIZE == 16384,
+              "N_CLASSES must match PacketAllocator::MAX_BLOCK_SIZE");
+
+/**
+ * \ingroup packet
+ * Get the size class of a block.
+ * \param [in] size The requested size, not larger than MAX_BLOCK_SIZE.
+ * \return The size class.
+ */
+uint32_t
+GetClass(std::size_t size)
+{
+    if (size <= 256)
+    {
+        return size == 0 ? 0 : (size + 15) / 16 - 1;
+    }
+    uint32_t log = 8;
+    while (((size - 1) >> (log + 1)) != 0)
+    {
+        ++log;
+    }
+    return 16 + (log - 8) * 4 + static_cast<uint32_t>((size - 1) >> (log - 2)) - 4;
+}
+
+/**
+ * \ingroup packet
+ * Get the size of the blocks of a class.
+ * \param [in] c The size class.
+ * \return The size of the blocks, in bytes.
+ */
+std::size_t
+GetClassSize(uint32_t c)
+{
+    if (c < 16)
+    {
+        return (c + 1) * 16;
+    }
+    uint32_t log = 8 + (c - 16) / 4;
+    return static_cast<std::size_t>(4 + (c - 16) % 4 + 1) << (log - 2);
+}
+
+/** \ingroup packet A free block, linked in the free list of its class. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< The next free block
+};
+
+/** \ingroup packet The free lists and the counters of a thread. */
+struct ThreadCache
+{
+    FreeBlock* free[N_CLASSES]{};           //!< The free lists
+    uint32_t count[N_CLASSES]{};            //!< The lengths of the free lists
+    ns3::PacketAllocator::Statistics stats; //!< The allocation counters
+    bool registered{false};                 //!< Whether the destructor is registered
+    bool destroyed{false};                  //!< Whether the thread is exiting
+};
+
+/**
+ * \ingroup packet
+ * Returns the free lists to the heap at the exit of a thread.
+ */
+struct ThreadCacheDestructor
+{
+    ~ThreadCacheDestructor();
+};
+
+// The cache is trivially destructible, so that the blocks released after
+// the exit of the thread, e.g., by static destructors, can still check
+// whether it has been destroyed.
+thread_local ThreadCache g_cache;                     //!< The cache of this thread
+thread_local ThreadCacheDestructor g_cacheDestructor; //!< The destructor of g_cache
+
+ThreadCacheDestructor::~ThreadCacheDestructor()
+{
+    for (uint32_t c = 0; c < N_CLASSES; ++c)
+    {
+        while (g_cache.free[c] != nullptr)
+        {
+            FreeBlock* block = g_cache.free[c];
+            g_cache.free[c] = block->next;
+            ::operator delete(block);
+        }
+        g_cache.count[c] = 0;
+    }
+    g_cache.stats.cachedBlocks = 0;
+    g_cache.destroyed = true;
+}
+
+} // namespace
+
+namespace ns3
+{
+
+std::size_t
+PacketAllocator::GetBlockSize(std::size_t size)
+{
+    return size > MAX_BLOCK_SIZE ? size : GetClassSize(GetClass(size));
+}
+
+void*
+PacketAllocator::Allocate(std::size_t size)
+{
+    ++g_cache.stats.allocations;
+    if (size > MAX_BLOCK_SIZE)
+    {
+        ++g_cache.stats.heapAllocations;
+        return ::operator new(size);
+    }
+    uint32_t c = GetClass(size);
+    FreeBlock* block = g_cache.free[c];
+    if (block != nullptr)
+    {
+        g_cache.free[c] = block->next;
+        --g_cache.count[c];
+        --g_cache.stats.cachedBlocks;
+        return block;
+    }
+    ++g_cache.stats.heapAllocations;
+    return ::operator new(GetClassSize(c));
+}
+
+void
+PacketAllocator::Deallocate(void* block, std::size_t size)
+{
+    NS_ASSERT(block != nullptr);
+    ++g_cache.stats.deallocations;
+    if (size > MAX_BLOCK_SIZE || g_cache.destroyed)
+    {
+        ::operator delete(block);
+        return;
+    }
+    uint32_t c = GetClass(size);
+    if (g_cache.count[c] * GetClassSize(c) >= MAX_CACHED_BYTES)
+    {
+        ::operator delete(block);
+        return;
+    }
+    if (!g_cache.registered)
+    {
+        // make sure the free lists of this thread are released at its exit
+        (void)&g_cacheDestructor;
+        g_cache.registered = true;
+    }
+    auto freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = g_cache.free[c];
+    g_cache.free[c] = freeBlock;
+    ++g_cache.count[c];
+    ++g_cache.stats.cachedBlocks;
+}
+
+PacketAllocator::Statistics
+PacketAllocator::GetStatistics()
+{
+    return g_cache.stats;
+}
+
+void
+PacketAllocator::ResetStatistics()
+{
+    uint64_t cachedBlocks = g_cache.stats.cachedBlocks;
+    g_cache.stats = Statistics();
+    g_cache.stats.cachedBlocks = cachedBlocks;
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_ALLOCATOR_H
+#define PACKET_ALLOCATOR_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup packet
+ *
+ * \brief Size-classed memory pool of the packets and of their buffers.
+ *
+ * The Packet objects, the Buffer, PacketMetadata and ByteTagList data
+ * and the PacketTagList tag nodes are allocated and released at the rate
+ * of the packets, so they are not taken from the general heap each time.
+ * The blocks are rounded up to a size class: multiples of 16 bytes up to
+ * 256 bytes, then four classes per power of two up to MAX_BLOCK_SIZE.
+ * The free blocks of each class are kept in a list of the calling thread,
+ * without any lock, up to MAX_CACHED_BYTES per class, and are returned to
+ * the heap when the thread exits. The larger blocks are always taken from
+ * the heap.
+ *
+ * A block may be released by another thread than the one which allocated
+ * it, e.g., when a packet crosses the logical processes of a parallel
+ * simulation: it then joins the free list of the releasing thread.
+ *
+ * Since the variable sized data know their own capacity, their allocators
+ * round the requested size with GetBlockSize() and use the whole block.
+ */
+class PacketAllocator
+{
+  public:
+    /** Allocation counters of a thread. */
+    struct Statistics
+    {
+        uint64_t allocations{0};     //!< Number of blocks allocated
+        uint64_t deallocations{0};   //!< Number of blocks released
+        uint64_t heapAllocations{0}; //!< Number of allocations not served by a free list
+        uint64_t cachedBlocks{0};    //!< Number of blocks currently in the free lists
+    };
+
+    /** The largest block kept in the free lists. */
+    static constexpr std::size_t MAX_BLOCK_SIZE = 16384;
+    /** The maximum number of bytes of the free list of each size class. */
+    static constexpr std::size_t MAX_CACHED_BYTES = 4 << 20;
+
+    /**
+     * Get the size of the block allocated for a given size.
+     *
+     * \param [in] size The requested size, in bytes.
+     * \return The size of the block, not less than \pname{size}.
+     */
+    static std::size_t GetBlockSize(std::size_t size);
+
+    /**
+     * Allocate a block.
+     *
+     * \param [in] size The requested size, in bytes.
+     * \return The block, of at least GetBlockSize (\pname{size}) bytes.
+     */
+    static void* Allocate(std::size_t size);
+
+    /**
+     * Release a block.
+     *
+     * \param [in] block The block.
+     * \param [in] size The size given to Allocate(), or any size of the
+     *             same class, e.g., the one returned by GetBlockSize().
+     */
+    static void Deallocate(void* block, std::size_t size);
+
+    /**
+     * Get the allocation counters of the calling thread.
+     * \return The counters.
+     */
+    static Statistics GetStatistics();
+
+    /** Reset the allocation counters of the calling thread. */
+    static void ResetStatistics();
+};
+
+} // namespace ns3
+
+#endif /* PACKET_ALLOCATOR_H */
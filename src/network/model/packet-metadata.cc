@@ -20,6 +20,7 @@
 
 #include "buffer.h"
 #include "header.h"
+#include "packet-allocator.h"
 #include "trailer.h"
 
 #include "ns3/assert.h"
@@ -36,20 +37,12 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
-bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
-
-PacketMetadata::DataFreeList::~DataFreeList()
-{
-    NS_LOG_FUNCTION(this);
-    for (auto i = begin(); i != end(); i++)
-    {
-        PacketMetadata::Deallocate(*i);
-    }
-    PacketMetadata::m_enable = false;
-}
+std::atomic<bool> PacketMetadata::m_metadataSkipped(false);
+// The size heuristic is per thread, as the free lists of the PacketAllocator,
+// so that packets can be created and destroyed concurrently by the threads of
+// a parallel simulator.
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+std::atomic<uint16_t> PacketMetadata::m_chunkUid(0);
 
 void
 PacketMetadata::Enable()
@@ -572,19 +565,6 @@ PacketMetadata::Create(uint32_t size)
     {
         m_maxSize = size;
     }
-    while (!m_freeList.empty())
-    {
-        PacketMetadata::Data* data = m_freeList.back();
-        m_freeList.pop_back();
-        if (data->m_size >= size)
-        {
-            NS_LOG_LOGIC("create found size=" << data->m_size);
-            data->m_count = 1;
-            return data;
-        }
-        NS_LOG_LOGIC("create dealloc size=" << data->m_size);
-        PacketMetadata::Deallocate(data);
-    }
     NS_LOG_LOGIC("create alloc size=" << m_maxSize);
     return PacketMetadata::Allocate(m_maxSize);
 }
@@ -593,36 +573,22 @@ void
 PacketMetadata::Recycle(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
-    if (!m_enable)
-    {
-        PacketMetadata::Deallocate(data);
-        return;
-    }
-    NS_LOG_LOGIC("recycle size=" << data->m_size << ", list=" << m_freeList.size());
     NS_ASSERT(data->m_count == 0);
-    if (m_freeList.size() > 1000 || data->m_size < m_maxSize)
-    {
-        PacketMetadata::Deallocate(data);
-    }
-    else
-    {
-        m_freeList.push_back(data);
-    }
+    PacketMetadata::Deallocate(data);
 }
 
 PacketMetadata::Data*
 PacketMetadata::Allocate(uint32_t n)
 {
     NS_LOG_FUNCTION(n);
-    uint32_t size = sizeof(Data);
     if (n <= PACKET_METADATA_DATA_M_DATA_SIZE)
     {
         n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
-    size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
-    auto buf = new uint8_t[size];
-    auto data = (PacketMetadata::Data*)buf;
-    data->m_size = n;
+    std::size_t size =
+        PacketAllocator::GetBlockSize(sizeof(Data) + n - PACKET_METADATA_DATA_M_DATA_SIZE);
+    auto data = static_cast<PacketMetadata::Data*>(PacketAllocator::Allocate(size));
+    data->m_size = static_cast<uint16_t>(size - sizeof(Data) + PACKET_METADATA_DATA_M_DATA_SIZE);
     data->m_count = 1;
     data->m_dirtyEnd = 0;
     return data;
@@ -632,8 +598,8 @@ void
 PacketMetadata::Deallocate(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
-    auto buf = (uint8_t*)data;
-    delete[] buf;
+    PacketAllocator::Deallocate(data,
+                                sizeof(Data) + data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE);
 }
 
 PacketMetadata
@@ -661,7 +627,7 @@ PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
     NS_LOG_FUNCTION(this << uid << size);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
         return;
     }
 
@@ -670,8 +636,7 @@ PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
     item.prev = 0xffff;
     item.typeUid = uid;
     item.size = size;
-    item.chunkUid = m_chunkUid;
-    m_chunkUid++;
+    item.chunkUid = m_chunkUid.fetch_add(1, std::memory_order_relaxed);
     uint16_t written = AddSmall(&item);
     UpdateHead(written);
 }
@@ -683,7 +648,7 @@ PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
     NS_LOG_FUNCTION(this << &header << size);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
         return;
     }
     PacketMetadata::SmallItem item;
@@ -728,7 +693,7 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
     NS_LOG_FUNCTION(this << &trailer << size);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
         return;
     }
     PacketMetadata::SmallItem item;
@@ -736,8 +701,7 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
     item.prev = m_tail;
     item.typeUid = uid;
     item.size = size;
-    item.chunkUid = m_chunkUid;
-    m_chunkUid++;
+    item.chunkUid = m_chunkUid.fetch_add(1, std::memory_order_relaxed);
     uint16_t written = AddSmall(&item);
     UpdateTail(written);
     NS_ASSERT(IsStateOk());
@@ -750,7 +714,7 @@ PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
     NS_LOG_FUNCTION(this << &trailer << size);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
         return;
     }
     PacketMetadata::SmallItem item;
@@ -794,7 +758,7 @@ PacketMetadata::AddAtEnd(const PacketMetadata& o)
     NS_LOG_FUNCTION(this << &o);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
         return;
     }
     if (m_tail == 0xffff)
@@ -870,7 +834,7 @@ PacketMetadata::AddPaddingAtEnd(uint32_t end)
     NS_LOG_FUNCTION(this << end);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
         return;
     }
 }
@@ -881,7 +845,7 @@ PacketMetadata::RemoveAtStart(uint32_t start)
     NS_LOG_FUNCTION(this << start);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
         return;
     }
     NS_ASSERT(m_data != nullptr);
@@ -942,7 +906,7 @@ PacketMetadata::RemoveAtEnd(uint32_t end)
     NS_LOG_FUNCTION(this << end);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
         return;
     }
     NS_ASSERT(m_data != nullptr);
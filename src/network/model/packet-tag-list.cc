@@ -24,6 +24,7 @@
 
 #include "packet-tag-list.h"
 
+#include "packet-allocator.h"
 #include "tag-buffer.h"
 #include "tag.h"
 
@@ -44,14 +45,22 @@ PacketTagList::CreateTagData(size_t dataSize)
                   "Requested TagData size " << dataSize << " exceeds maximum "
                                             << std::numeric_limits<decltype(TagData::size)>::max());
 
-    void* p = std::malloc(sizeof(TagData) + dataSize - 1);
-    // The matching frees are in RemoveAll and RemoveWriter
+    void* p = PacketAllocator::Allocate(sizeof(TagData) + dataSize - 1);
+    // The matching deletes are in RemoveAll and RemoveWriter
 
     auto tag = new (p) TagData;
     tag->size = dataSize;
     return tag;
 }
 
+void
+PacketTagList::DeleteTagData(TagData* tag)
+{
+    std::size_t size = sizeof(TagData) + tag->size - 1;
+    tag->~TagData();
+    PacketAllocator::Deallocate(tag, size);
+}
+
 bool
 PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 {
@@ -195,8 +204,7 @@ PacketTagList::RemoveWriter(Tag& tag,
     if (preMerge)
     {
         // found tid before first merge, so delete cur
-        cur->~TagData();
-        std::free(cur);
+        DeleteTagData(cur);
     }
     else
     {
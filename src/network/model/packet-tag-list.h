@@ -136,8 +136,8 @@ class PacketTagList
      * possible.
      *
      * We use placement new so we can allocate enough room for the Tag
-     * type which will be serialized into data.  See Object::Aggregates
-     * for a similar construction.
+     * type which will be serialized into data, in a block of the
+     * PacketAllocator.  See Object::Aggregates for a similar construction.
      */
     struct TagData
     {
@@ -253,6 +253,13 @@ class PacketTagList
      */
     static TagData* CreateTagData(size_t dataSize);
 
+    /**
+     * Destroy a TagData struct and release its memory.
+     *
+     * \param [in] tag The TagData object.
+     */
+    static void DeleteTagData(TagData* tag);
+
     /**
      * Typedef of method function pointer for copy-on-write operations
      *
@@ -365,15 +372,13 @@ PacketTagList::RemoveAll()
         }
         if (prev != nullptr)
         {
-            prev->~TagData();
-            std::free(prev);
+            DeleteTagData(prev);
         }
         prev = cur;
     }
     if (prev != nullptr)
     {
-        prev->~TagData();
-        std::free(prev);
+        DeleteTagData(prev);
     }
     m_next = nullptr;
 }
@@ -18,6 +18,8 @@
  */
 #include "packet.h"
 
+#include "packet-allocator.h"
+
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -30,7 +32,7 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+std::atomic<uint32_t> Packet::m_globalUid(0);
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -146,10 +148,11 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 |
+                     m_globalUid.fetch_add(1, std::memory_order_relaxed),
+                 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
@@ -176,6 +179,18 @@ Packet::operator=(const Packet& o)
     return *this;
 }
 
+void*
+Packet::operator new(std::size_t size)
+{
+    return PacketAllocator::Allocate(size);
+}
+
+void
+Packet::operator delete(void* p, std::size_t size)
+{
+    PacketAllocator::Deallocate(p, size);
+}
+
 Packet::Packet(uint32_t size)
     : m_buffer(size),
       m_byteTagList(),
@@ -186,10 +201,11 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 |
+                     m_globalUid.fetch_add(1, std::memory_order_relaxed),
+                 size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -213,10 +229,11 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 |
+                     m_globalUid.fetch_add(1, std::memory_order_relaxed),
+                 size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
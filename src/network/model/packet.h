@@ -33,6 +33,7 @@
 #include "ns3/mac48-address.h"
 #include "ns3/ptr.h"
 
+#include <atomic>
 #include <stdint.h>
 
 namespace ns3
@@ -254,6 +255,18 @@ class Packet : public SimpleRefCount<Packet>
      * \return the copied object
      */
     Packet& operator=(const Packet& o);
+    /**
+     * \brief Allocate the memory of a packet from the PacketAllocator
+     * \param size the size of the packet
+     * \return the memory of the packet
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * \brief Release the memory of a packet to the PacketAllocator
+     * \param p the memory of the packet
+     * \param size the size of the packet
+     */
+    static void operator delete(void* p, std::size_t size);
     /**
      * \brief Create a packet with a zero-filled payload.
      *
@@ -795,7 +808,7 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-    static uint32_t m_globalUid; //!< Global counter of packets Uid
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
 };
 
 /**
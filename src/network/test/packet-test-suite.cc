@@ -16,6 +16,7 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/packet-allocator.h"
 #include "ns3/packet-tag-list.h"
 #include "ns3/packet.h"
 #include "ns3/test.h"
@@ -1264,6 +1265,84 @@ PacketTagListTest::DoRun()
 } // Timing
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * PacketAllocator unit tests.
+ */
+class PacketAllocatorTest : public TestCase
+{
+  public:
+    PacketAllocatorTest();
+
+  private:
+    void DoRun() override;
+};
+
+PacketAllocatorTest::PacketAllocatorTest()
+    : TestCase("PacketAllocator")
+{
+}
+
+void
+PacketAllocatorTest::DoRun()
+{
+    std::size_t previous = 0;
+    for (std::size_t size = 1; size <= PacketAllocator::MAX_BLOCK_SIZE; ++size)
+    {
+        std::size_t block = PacketAllocator::GetBlockSize(size);
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(block, size, "Block smaller than the size " << size);
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(block, previous, "Block sizes not monotonic at " << size);
+        NS_TEST_ASSERT_MSG_EQ(PacketAllocator::GetBlockSize(block),
+                              block,
+                              "Block size " << block << " is not a size class");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(block - size, std::max<std::size_t>(15, size / 4),
+                                    "Too much slack for the size " << size);
+        previous = block;
+    }
+    NS_TEST_ASSERT_MSG_EQ(PacketAllocator::GetBlockSize(PacketAllocator::MAX_BLOCK_SIZE + 1),
+                          PacketAllocator::MAX_BLOCK_SIZE + 1,
+                          "Large blocks are not rounded");
+
+    // A released block is reused for the next allocation of its class.
+    PacketAllocator::ResetStatistics();
+    void* block = PacketAllocator::Allocate(1500);
+    PacketAllocator::Deallocate(block, 1500);
+    NS_TEST_ASSERT_MSG_EQ(PacketAllocator::Allocate(1490), block, "Free block not reused");
+    PacketAllocator::Deallocate(block, PacketAllocator::GetBlockSize(1490));
+    PacketAllocator::Statistics stats = PacketAllocator::GetStatistics();
+    NS_TEST_ASSERT_MSG_EQ(stats.allocations, 2U, "Wrong number of allocations");
+    NS_TEST_ASSERT_MSG_EQ(stats.deallocations, 2U, "Wrong number of deallocations");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(stats.heapAllocations, 1U, "Free block not reused");
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(stats.cachedBlocks, 1U, "Free block not cached");
+
+    // Once warmed up, packets are created, copied and destroyed without
+    // allocating from the heap.
+    for (uint32_t round = 0; round < 2; ++round)
+    {
+        PacketAllocator::ResetStatistics();
+        {
+            Ptr<Packet> packet = Create<Packet>(1000);
+            packet->AddHeader(ATestHeader<10>());
+            packet->AddByteTag(ATestTag<2>());
+            packet->AddPacketTag(ATestTag<3>());
+            Ptr<Packet> copy = packet->Copy();
+            copy->AddHeader(ATestHeader<20>());
+            Ptr<Packet> fragment = copy->CreateFragment(10, 100);
+        }
+        stats = PacketAllocator::GetStatistics();
+        NS_TEST_ASSERT_MSG_GT(stats.allocations, 0U, "Packets not allocated from the pool");
+        NS_TEST_ASSERT_MSG_EQ(stats.allocations,
+                              stats.deallocations,
+                              "Packet memory not released to the pool");
+        if (round > 0)
+        {
+            NS_TEST_ASSERT_MSG_EQ(stats.heapAllocations, 0U, "Free blocks not reused");
+        }
+    }
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1281,6 +1360,7 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::QUICK);
+    AddTestCase(new PacketAllocatorTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -16,7 +16,9 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/output-stream-wrapper.h"
 #include "ns3/pcap-file.h"
+#include "ns3/simulator.h"
 #include "ns3/test.h"
 
 #include <cstdio>
@@ -1375,6 +1377,148 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that a pcap file written by a background
+ * thread is identical to the same file written synchronously.
+ */
+class AsynchronousWriteTestCase : public TestCase
+{
+  public:
+    AsynchronousWriteTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write a pcap file.
+     * \param filename The file name.
+     * \param asynchronous Whether the file is written by a background thread.
+     * \return The counters of the writer thread.
+     */
+    AsyncFileStream::Statistics WriteFile(std::string filename, bool asynchronous);
+};
+
+/** Number of packets of the asynchronous test files, larger than the writer blocks. */
+static const uint32_t N_ASYNC_PACKETS = 5000;
+
+AsynchronousWriteTestCase::AsynchronousWriteTestCase()
+    : TestCase("Check that PcapFile::Open with an asynchronous writer works")
+{
+}
+
+AsyncFileStream::Statistics
+AsynchronousWriteTestCase::WriteFile(std::string filename, bool asynchronous)
+{
+    PcapFile f;
+    f.Open(filename, std::ios::out, asynchronous);
+    NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Open (" << filename << ") returns error");
+    f.Init(1, 1400);
+
+    uint8_t data[1500];
+    for (uint32_t i = 0; i < N_ASYNC_PACKETS; ++i)
+    {
+        std::memset(data, i & 0xff, sizeof(data));
+        // Alternate full and truncated packets
+        f.Write(i / 1000, i % 1000, data, i % 2 ? sizeof(data) : 64 + i % 100);
+    }
+    NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Write (" << filename << ") returns error");
+    AsyncFileStream::Statistics stats = f.GetWriterStatistics();
+    f.Close();
+    return stats;
+}
+
+void
+AsynchronousWriteTestCase::DoRun()
+{
+    std::string syncFilename = CreateTempDirFilename("sync.pcap");
+    std::string asyncFilename = CreateTempDirFilename("async.pcap");
+
+    AsyncFileStream::Statistics syncStats = WriteFile(syncFilename, false);
+    NS_TEST_EXPECT_MSG_EQ(syncStats.records, 0, "Synchronous file has writer statistics");
+
+    AsyncFileStream::Statistics asyncStats = WriteFile(asyncFilename, true);
+    NS_TEST_EXPECT_MSG_EQ(asyncStats.records, N_ASYNC_PACKETS, "Records not counted");
+    NS_TEST_EXPECT_MSG_EQ(asyncStats.drops, 0, "Records dropped while blocking");
+
+    uint32_t sec(0);
+    uint32_t usec(0);
+    uint32_t packets(0);
+    bool diff = PcapFile::Diff(syncFilename, asyncFilename, sec, usec, packets);
+    NS_TEST_EXPECT_MSG_EQ(diff, false, "Asynchronous file differs from synchronous file");
+    NS_TEST_EXPECT_MSG_EQ(packets, N_ASYNC_PACKETS, "Asynchronous file is truncated");
+    FILE* p = std::fopen(syncFilename.c_str(), "rb");
+    NS_TEST_ASSERT_MSG_NE(p, nullptr, "Unable to fopen(" << syncFilename << ")");
+    std::fseek(p, 0, SEEK_END);
+    long length = std::ftell(p);
+    std::fclose(p);
+    long ringSize = AsyncFileStream::N_BLOCKS * AsyncFileStream::BLOCK_SIZE;
+    NS_TEST_EXPECT_MSG_GT(length, ringSize, "The file does not reuse the blocks of the writer");
+    NS_TEST_EXPECT_MSG_EQ(CheckFileLength(asyncFilename, length),
+                          true,
+                          "Asynchronous file length differs from synchronous file");
+
+    //
+    // An ascii trace file is written the same way
+    //
+    std::string asciiFilename = CreateTempDirFilename("async.tr");
+    auto stream = Create<OutputStreamWrapper>(asciiFilename, std::ios::out, true);
+    length = 0;
+    for (uint32_t i = 0; i < N_ASYNC_PACKETS * 20; ++i)
+    {
+        std::ostringstream line;
+        line << "+ " << i << " /NodeList/0/DeviceList/0/TxQueue/Enqueue";
+        // as in the trace sinks, std::endl must not force a write
+        *stream->GetStream() << line.str() << std::endl;
+        length += line.str().size() + 1;
+    }
+    stream = nullptr;
+    NS_TEST_EXPECT_MSG_EQ(CheckFileLength(asciiFilename, length),
+                          true,
+                          "Asynchronous ascii file is truncated");
+
+    //
+    // The open streams are flushed when the simulator is destroyed, and
+    // opening a stream flushes them again at the end of the next simulation
+    //
+    stream = Create<OutputStreamWrapper>(asciiFilename, std::ios::out, true);
+    *stream->GetStream() << "first simulation" << std::endl;
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(CheckFileLength(asciiFilename, 17),
+                          true,
+                          "Open stream not flushed at the first Simulator::Destroy");
+    *stream->GetStream() << "second simulation" << std::endl;
+    auto secondStream = Create<OutputStreamWrapper>(syncFilename, std::ios::out, true);
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(CheckFileLength(asciiFilename, 35),
+                          true,
+                          "Open stream not flushed at the second Simulator::Destroy");
+    stream = nullptr;
+    secondStream = nullptr;
+
+    //
+    // Reopening an asynchronous pcap file closes the previous one
+    //
+    PcapFile f;
+    f.Open(syncFilename, std::ios::out, true);
+    f.Init(1, 1400);
+    f.Open(asyncFilename, std::ios::out, true);
+    NS_TEST_EXPECT_MSG_EQ(CheckFileLength(syncFilename, 24),
+                          true,
+                          "Previous file not closed by PcapFile::Open");
+    f.Init(1, 1400);
+    f.Close();
+    NS_TEST_EXPECT_MSG_EQ(CheckFileLength(asyncFilename, 24),
+                          true,
+                          "Reopened file not written");
+
+    remove(syncFilename.c_str());
+    remove(asyncFilename.c_str());
+    remove(asciiFilename.c_str());
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1398,6 +1542,7 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new AsynchronousWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,563 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-stream.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AsyncFileStream");
+
+/**
+ * \ingroup network
+ *
+ * The stream buffer of an AsyncFileStream.
+ *
+ * The put area is the current block. When it is full, or flushed, the
+ * block is queued for the writer thread, which returns it to the free
+ * blocks once written. The blocks are allocated when they are first
+ * needed, up to N_BLOCKS. The counter of the records is only updated by
+ * the writing thread of the stream, but read by GetStatistics(): it is
+ * atomic. The blocks, the other counters and the queue of the writer are
+ * protected by the mutex of the Writer. The file is only accessed by the
+ * writing thread of the stream while none of its blocks is queued.
+ */
+class AsyncFileStream::WriterBuffer : public std::streambuf
+{
+  public:
+    /** Destructor, closes the file. */
+    ~WriterBuffer() override;
+
+    /**
+     * Open a file.
+     * \param [in] filename The name of the file.
+     * \param [in] mode The std::ios::openmode flags of the file.
+     * \return true if the file is open.
+     */
+    bool Open(const std::string& filename, std::ios::openmode mode);
+
+    /**
+     * Write the buffered bytes and close the file.
+     * \return false if a write failed.
+     */
+    bool Close();
+
+    /**
+     * Queue the current block and wait until the queued blocks are written.
+     * \return false if a write failed.
+     */
+    bool Drain();
+
+    /**
+     * Queue the current block and wait until the queued blocks are written.
+     * \param [in] lock The lock of the mutex of the Writer, held.
+     * \return false if a write failed.
+     */
+    bool Drain(std::unique_lock<std::mutex>& lock);
+
+    /** \copydoc AsyncFileStream::IsOpen */
+    bool IsOpen() const;
+
+    /** \copydoc AsyncFileStream::Reserve */
+    bool Reserve(std::size_t size);
+
+    /** \copydoc AsyncFileStream::GetStatistics */
+    Statistics GetStatistics() const;
+
+    /**
+     * Write a block to the file, called by the writer thread without the
+     * mutex of the Writer.
+     * \param [in] block The block.
+     * \param [in] size The number of bytes of the block.
+     * \return false if the write failed.
+     */
+    bool Write(const char* block, std::size_t size);
+
+    /**
+     * Return a written block to the free blocks, called by the writer
+     * thread with the mutex of the Writer.
+     * \param [in] block The block.
+     * \param [in] size The number of bytes of the block.
+     * \param [in] ok Whether the write succeeded.
+     */
+    void Release(char* block, std::size_t size, bool ok);
+
+    FullPolicy m_policy{BLOCK_WHEN_FULL}; //!< Behavior of Reserve() when the blocks are full
+
+  protected:
+    /**
+     * Queue the current block and take a free one.
+     * \param [in] c The character to write, or EOF.
+     * \return EOF on failure.
+     */
+    int_type overflow(int_type c) override;
+
+    /**
+     * Report the state of the file, without waiting for the writer thread,
+     * so that std::endl does not defeat the batching of the writes.
+     * \return -1 if a write failed.
+     */
+    int sync() override;
+
+  private:
+    /**
+     * Queue the current block, if any, and clear the put area.
+     * The caller holds the mutex of the Writer.
+     */
+    void Queue();
+
+    /**
+     * \return true if all the blocks are allocated and queued.
+     * The caller holds the mutex of the Writer.
+     */
+    bool IsFull() const;
+
+    std::ofstream m_file;                          //!< The file
+    bool m_open{false};                            //!< Whether the file is open
+    std::vector<std::unique_ptr<char[]>> m_blocks; //!< The allocated blocks
+    std::vector<char*> m_free;                     //!< The free blocks
+    std::size_t m_queued{0};                       //!< Number of blocks queued or being written
+    std::atomic<bool> m_error{false};              //!< Whether a write failed
+    Statistics m_stats;                            //!< The counters, except the records
+    std::atomic<uint64_t> m_records{0};            //!< The records accepted by Reserve()
+};
+
+/**
+ * \ingroup network
+ *
+ * The writer thread shared by the open streams.
+ *
+ * The thread writes the queued blocks of all the streams in order, and
+ * runs while a stream is open. The writer also keeps the set of the open
+ * streams, which are flushed when the simulator is destroyed.
+ */
+class AsyncFileStream::Writer
+{
+  public:
+    /**
+     * Get the writer. It is never destroyed, so that the static streams
+     * can still be closed at the exit of the program.
+     * \return The writer.
+     */
+    static Writer& Get();
+
+    /**
+     * Add an open stream, start the thread if it is the first one, and
+     * schedule the flush of the open streams when the simulator is
+     * destroyed.
+     * \param [in] buffer The buffer of the stream.
+     */
+    void Add(WriterBuffer* buffer);
+
+    /**
+     * Remove a drained stream, and stop the thread if it was the last one.
+     * \param [in] buffer The buffer of the stream.
+     */
+    void Remove(WriterBuffer* buffer);
+
+    /**
+     * Queue a block, with the mutex.
+     * \param [in] buffer The buffer of the stream.
+     * \param [in] block The block.
+     * \param [in] size The number of bytes of the block.
+     */
+    void Queue(WriterBuffer* buffer, char* block, std::size_t size);
+
+    std::mutex m_mutex;                   //!< Protects the queue, the streams and their blocks
+    std::condition_variable m_producerCv; //!< Signals written blocks
+    std::set<WriterBuffer*> m_buffers;    //!< The buffers of the open streams
+    bool m_flushScheduled{false};         //!< Whether FlushAll() is scheduled
+
+  private:
+    /** A queued block. */
+    struct Job
+    {
+        WriterBuffer* buffer; //!< The buffer of the stream
+        char* block;          //!< The block
+        std::size_t size;     //!< The number of bytes of the block
+    };
+
+    /** The loop of the writer thread. */
+    void Run();
+
+    std::mutex m_threadMutex;           //!< Serializes the start and the stop of the thread
+    std::condition_variable m_writerCv; //!< Wakes up the writer thread
+    std::deque<Job> m_queue;            //!< The blocks to write
+    bool m_stop{false};                 //!< Whether the writer thread must exit
+    std::thread m_thread;               //!< The writer thread
+};
+
+AsyncFileStream::Writer&
+AsyncFileStream::Writer::Get()
+{
+    static Writer* writer = new Writer;
+    return *writer;
+}
+
+void
+AsyncFileStream::Writer::Add(WriterBuffer* buffer)
+{
+    std::unique_lock threadLock{m_threadMutex};
+    bool schedule = false;
+    {
+        std::unique_lock lock{m_mutex};
+        m_buffers.insert(buffer);
+        if (!m_thread.joinable())
+        {
+            m_thread = std::thread(&Writer::Run, this);
+        }
+        schedule = !m_flushScheduled;
+        m_flushScheduled = true;
+    }
+    // The flush is scheduled when the streams are opened, while the
+    // simulation is set up, rather than when they are written.
+    if (schedule)
+    {
+        Simulator::ScheduleDestroy(&AsyncFileStream::FlushAll);
+    }
+}
+
+void
+AsyncFileStream::Writer::Remove(WriterBuffer* buffer)
+{
+    std::unique_lock threadLock{m_threadMutex};
+    {
+        std::unique_lock lock{m_mutex};
+        m_buffers.erase(buffer);
+        if (!m_buffers.empty())
+        {
+            return;
+        }
+        m_stop = true;
+    }
+    m_writerCv.notify_one();
+    m_thread.join();
+    std::unique_lock lock{m_mutex};
+    m_stop = false;
+}
+
+void
+AsyncFileStream::Writer::Queue(WriterBuffer* buffer, char* block, std::size_t size)
+{
+    m_queue.push_back({buffer, block, size});
+    m_writerCv.notify_one();
+}
+
+void
+AsyncFileStream::Writer::Run()
+{
+    std::unique_lock lock{m_mutex};
+    while (true)
+    {
+        m_writerCv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty())
+        {
+            break;
+        }
+        Job job = m_queue.front();
+        m_queue.pop_front();
+        lock.unlock();
+        bool ok = job.buffer->Write(job.block, job.size);
+        lock.lock();
+        job.buffer->Release(job.block, job.size, ok);
+        m_producerCv.notify_all();
+    }
+}
+
+AsyncFileStream::WriterBuffer::~WriterBuffer()
+{
+    Close();
+}
+
+bool
+AsyncFileStream::WriterBuffer::Open(const std::string& filename, std::ios::openmode mode)
+{
+    NS_LOG_FUNCTION(this << filename << mode);
+    Close();
+    m_file.open(filename, mode);
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+    m_open = true;
+    m_error = false;
+    Writer::Get().Add(this);
+    return true;
+}
+
+bool
+AsyncFileStream::WriterBuffer::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_open)
+    {
+        return true;
+    }
+    Drain();
+    Writer::Get().Remove(this);
+    m_file.close();
+    m_open = false;
+    m_free.clear();
+    m_blocks.clear();
+    return !m_error;
+}
+
+bool
+AsyncFileStream::WriterBuffer::IsOpen() const
+{
+    return m_open;
+}
+
+bool
+AsyncFileStream::WriterBuffer::IsFull() const
+{
+    return m_free.empty() && m_blocks.size() == N_BLOCKS;
+}
+
+bool
+AsyncFileStream::WriterBuffer::Reserve(std::size_t size)
+{
+    if (static_cast<std::size_t>(epptr() - pptr()) < size && m_policy == DROP_WHEN_FULL)
+    {
+        std::unique_lock lock{Writer::Get().m_mutex};
+        if (IsFull())
+        {
+            ++m_stats.drops;
+            return false;
+        }
+    }
+    // Only the writing thread of the stream updates the counter.
+    m_records.store(m_records.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return true;
+}
+
+AsyncFileStream::Statistics
+AsyncFileStream::WriterBuffer::GetStatistics() const
+{
+    std::unique_lock lock{Writer::Get().m_mutex};
+    Statistics stats = m_stats;
+    stats.records = m_records.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool
+AsyncFileStream::WriterBuffer::Write(const char* block, std::size_t size)
+{
+    m_file.write(block, size);
+    return m_file.good();
+}
+
+void
+AsyncFileStream::WriterBuffer::Release(char* block, std::size_t size, bool ok)
+{
+    m_error = m_error || !ok;
+    ++m_stats.writes;
+    m_stats.bytes += size;
+    m_free.push_back(block);
+    --m_queued;
+}
+
+void
+AsyncFileStream::WriterBuffer::Queue()
+{
+    if (pbase() != nullptr)
+    {
+        if (pptr() > pbase())
+        {
+            Writer::Get().Queue(this, pbase(), pptr() - pbase());
+            ++m_queued;
+        }
+        else
+        {
+            m_free.push_back(pbase());
+        }
+        setp(nullptr, nullptr);
+    }
+}
+
+AsyncFileStream::WriterBuffer::int_type
+AsyncFileStream::WriterBuffer::overflow(int_type c)
+{
+    if (!m_open)
+    {
+        return traits_type::eof();
+    }
+    Writer& writer = Writer::Get();
+    std::unique_lock lock{writer.m_mutex};
+    Queue();
+    if (m_free.empty() && m_blocks.size() < N_BLOCKS)
+    {
+        m_blocks.emplace_back(new char[BLOCK_SIZE]);
+        m_free.push_back(m_blocks.back().get());
+    }
+    if (m_free.empty())
+    {
+        ++m_stats.stalls;
+        writer.m_producerCv.wait(lock, [this]() { return !m_free.empty(); });
+    }
+    char* block = m_free.back();
+    m_free.pop_back();
+    setp(block, block + BLOCK_SIZE);
+    if (m_error)
+    {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+int
+AsyncFileStream::WriterBuffer::sync()
+{
+    return m_error ? -1 : 0;
+}
+
+bool
+AsyncFileStream::WriterBuffer::Drain()
+{
+    if (!m_open)
+    {
+        return true;
+    }
+    std::unique_lock lock{Writer::Get().m_mutex};
+    return Drain(lock);
+}
+
+bool
+AsyncFileStream::WriterBuffer::Drain(std::unique_lock<std::mutex>& lock)
+{
+    Queue();
+    Writer::Get().m_producerCv.wait(lock, [this]() { return m_queued == 0; });
+    // The writer thread does not access the file until the next block is queued.
+    m_file.flush();
+    m_error = m_error || !m_file.good();
+    return !m_error;
+}
+
+AsyncFileStream::AsyncFileStream()
+    : std::ostream(nullptr),
+      m_buffer(std::make_unique<WriterBuffer>())
+{
+    NS_LOG_FUNCTION(this);
+    rdbuf(m_buffer.get());
+}
+
+AsyncFileStream::AsyncFileStream(const std::string& filename, std::ios::openmode mode)
+    : AsyncFileStream()
+{
+    Open(filename, mode);
+}
+
+AsyncFileStream::~AsyncFileStream()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+AsyncFileStream::Open(const std::string& filename, std::ios::openmode mode)
+{
+    NS_LOG_FUNCTION(this << filename << mode);
+    if (m_buffer->Open(filename, mode))
+    {
+        clear();
+    }
+    else
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+bool
+AsyncFileStream::IsOpen() const
+{
+    return m_buffer->IsOpen();
+}
+
+void
+AsyncFileStream::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_buffer->Close())
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+void
+AsyncFileStream::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_buffer->Drain())
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+void
+AsyncFileStream::SetFullPolicy(FullPolicy policy)
+{
+    NS_LOG_FUNCTION(this << policy);
+    m_buffer->m_policy = policy;
+}
+
+bool
+AsyncFileStream::Reserve(std::size_t size)
+{
+    return m_buffer->Reserve(size);
+}
+
+AsyncFileStream::Statistics
+AsyncFileStream::GetStatistics() const
+{
+    return m_buffer->GetStatistics();
+}
+
+void
+AsyncFileStream::FlushAll()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    Writer& writer = Writer::Get();
+    std::unique_lock lock{writer.m_mutex};
+    // The streams opened after this flush schedule the next one.
+    writer.m_flushScheduled = false;
+    std::vector<WriterBuffer*> buffers(writer.m_buffers.begin(), writer.m_buffers.end());
+    for (auto buffer : buffers)
+    {
+        // The lock is released while a stream is drained.
+        if (writer.m_buffers.count(buffer) != 0)
+        {
+            buffer->Drain(lock);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,158 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_STREAM_H
+#define ASYNC_FILE_STREAM_H
+
+#include <memory>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief An output file stream written by a background thread.
+ *
+ * The bytes written to the stream are copied into blocks of BLOCK_SIZE
+ * bytes, up to N_BLOCKS per stream, allocated when they are first needed.
+ * Each full block is handed to a background thread shared by all the open
+ * streams, which writes it with a single call, so that the simulation
+ * thread never waits for the file system as long as a block is free.
+ * The content of the file is the same as with an std::ofstream.
+ *
+ * When all the blocks are waiting to be written, the writer of a record
+ * either waits for a free block (BLOCK_WHEN_FULL, the default), or, if
+ * the record was announced with Reserve(), drops it (DROP_WHEN_FULL).
+ * Both cases are counted in the Statistics.
+ *
+ * std::flush and std::endl do not wait for the writer thread, so that the
+ * trace sinks which end each line with std::endl still write large blocks;
+ * Flush() waits until the buffered bytes are written. The open streams are
+ * flushed when the simulator is destroyed: the flush is scheduled when a
+ * stream is opened, never when it is written, so that a write after
+ * Simulator::Destroy() does not create a new simulator. A stream which is
+ * still open after Simulator::Destroy() is flushed again at the end of a
+ * later simulation only if a stream is opened during it. The stream is
+ * flushed and closed by Close() or by its destructor. The bytes still buffered when the
+ * program aborts, e.g., on NS_FATAL_ERROR, are lost. A stream must be
+ * written by a single thread at a time.
+ */
+class AsyncFileStream : public std::ostream
+{
+  public:
+    /** Behavior of Reserve() when all the blocks are waiting to be written. */
+    enum FullPolicy
+    {
+        BLOCK_WHEN_FULL, //!< Wait for the writer thread
+        DROP_WHEN_FULL   //!< Drop the record
+    };
+
+    /** Counters of a stream. */
+    struct Statistics
+    {
+        uint64_t records{0}; //!< Number of records accepted by Reserve()
+        uint64_t drops{0};   //!< Number of records dropped by Reserve()
+        uint64_t stalls{0};  //!< Number of waits for a free block
+        uint64_t writes{0};  //!< Number of writes to the file
+        uint64_t bytes{0};   //!< Number of bytes written to the file
+    };
+
+    /** Size of a block, in bytes. */
+    static constexpr std::size_t BLOCK_SIZE = 256 * 1024;
+    /** Maximum number of blocks of a stream. */
+    static constexpr std::size_t N_BLOCKS = 8;
+
+    /** Create a stream without a file. */
+    AsyncFileStream();
+
+    /**
+     * Create a stream and open a file.
+     *
+     * \param [in] filename The name of the file.
+     * \param [in] mode The std::ios::openmode flags of the file.
+     */
+    AsyncFileStream(const std::string& filename, std::ios::openmode mode = std::ios::out);
+
+    /** Destructor, flushes and closes the file. */
+    ~AsyncFileStream() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    AsyncFileStream(const AsyncFileStream&) = delete;
+    AsyncFileStream& operator=(const AsyncFileStream&) = delete;
+
+    /**
+     * Open a file. Sets the failbit if the file cannot be opened.
+     *
+     * \param [in] filename The name of the file.
+     * \param [in] mode The std::ios::openmode flags of the file.
+     */
+    void Open(const std::string& filename, std::ios::openmode mode = std::ios::out);
+
+    /**
+     * \return true if a file is open.
+     */
+    bool IsOpen() const;
+
+    /**
+     * Write the buffered bytes and close the file.
+     * Sets the failbit if a write failed.
+     */
+    void Close();
+
+    /**
+     * Wait until the buffered bytes are written to the file.
+     * Sets the failbit if a write failed.
+     */
+    void Flush();
+
+    /**
+     * Set the behavior of Reserve() when all the blocks are full.
+     * \param [in] policy The policy.
+     */
+    void SetFullPolicy(FullPolicy policy);
+
+    /**
+     * Announce a record, before writing it.
+     *
+     * \param [in] size The size of the record, in bytes.
+     * \return false if the record must be dropped, because all the blocks
+     *         are full and the policy is DROP_WHEN_FULL.
+     */
+    bool Reserve(std::size_t size);
+
+    /**
+     * \return The counters of the stream.
+     */
+    Statistics GetStatistics() const;
+
+    /** Flush all the open streams. */
+    static void FlushAll();
+
+  private:
+    /** The stream buffer, which owns the blocks. */
+    class WriterBuffer;
+    /** The writer thread shared by the open streams. */
+    class Writer;
+
+    std::unique_ptr<WriterBuffer> m_buffer; //!< The stream buffer
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_STREAM_H */
@@ -17,6 +17,8 @@
 
 #include "output-stream-wrapper.h"
 
+#include "async-file-stream.h"
+
 #include "ns3/abort.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/log.h"
@@ -28,15 +30,28 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("OutputStreamWrapper");
 
-OutputStreamWrapper::OutputStreamWrapper(std::string filename, std::ios::openmode filemode)
+OutputStreamWrapper::OutputStreamWrapper(std::string filename,
+                                         std::ios::openmode filemode,
+                                         bool asynchronous)
     : m_destroyable(true)
 {
-    NS_LOG_FUNCTION(this << filename << filemode);
-    auto os = new std::ofstream();
-    os->open(filename, filemode);
-    m_ostream = os;
+    NS_LOG_FUNCTION(this << filename << filemode << asynchronous);
+    bool isOpen;
+    if (asynchronous)
+    {
+        auto os = new AsyncFileStream(filename, filemode);
+        isOpen = os->IsOpen();
+        m_ostream = os;
+    }
+    else
+    {
+        auto os = new std::ofstream();
+        os->open(filename, filemode);
+        isOpen = os->is_open();
+        m_ostream = os;
+    }
     FatalImpl::RegisterStream(m_ostream);
-    NS_ABORT_MSG_UNLESS(os->is_open(),
+    NS_ABORT_MSG_UNLESS(isOpen,
                         "AsciiTraceHelper::CreateFileStream():  "
                             << "Unable to Open " << filename << " for mode " << filemode);
 }
@@ -75,8 +75,11 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
      * Constructor
      * \param filename file name
      * \param filemode std::ios::openmode flags
+     * \param asynchronous write the file with a background thread, see AsyncFileStream
      */
-    OutputStreamWrapper(std::string filename, std::ios::openmode filemode);
+    OutputStreamWrapper(std::string filename,
+                        std::ios::openmode filemode,
+                        bool asynchronous = false);
     /**
      * Constructor
      * \param os output stream
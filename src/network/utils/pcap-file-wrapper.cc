@@ -48,6 +48,18 @@ PcapFileWrapper::GetTypeId()
                           "microseconds(default).",
                           BooleanValue(false),
                           MakeBooleanAccessor(&PcapFileWrapper::m_nanosecMode),
+                          MakeBooleanChecker())
+            .AddAttribute("Asynchronous",
+                          "Whether the files opened for writing are written by a background "
+                          "thread, see AsyncFileStream.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PcapFileWrapper::m_asynchronous),
+                          MakeBooleanChecker())
+            .AddAttribute("DropWhenFull",
+                          "Whether the packets are dropped, rather than waiting for the "
+                          "background thread, when its buffers are full.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PcapFileWrapper::m_dropWhenFull),
                           MakeBooleanChecker());
     return tid;
 }
@@ -95,7 +107,8 @@ void
 PcapFileWrapper::Open(const std::string& filename, std::ios::openmode mode)
 {
     NS_LOG_FUNCTION(this << filename << mode);
-    m_file.Open(filename, mode);
+    m_file.SetDropWhenFull(m_dropWhenFull);
+    m_file.Open(filename, mode, m_asynchronous && (mode & std::ios::in) == 0);
 }
 
 void
@@ -256,4 +269,11 @@ PcapFileWrapper::GetDataLinkType()
     return m_file.GetDataLinkType();
 }
 
+AsyncFileStream::Statistics
+PcapFileWrapper::GetWriterStatistics() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_file.GetWriterStatistics();
+}
+
 } // namespace ns3
@@ -75,6 +75,8 @@ class PcapFileWrapper : public Object
      *
      * \param mode String containing the access mode for the file.
      *
+     * A file opened for writing is written by a background thread if the
+     * "Asynchronous" attribute is true.
      */
     void Open(const std::string& filename, std::ios::openmode mode);
 
@@ -221,10 +223,20 @@ class PcapFileWrapper : public Object
      */
     uint32_t GetDataLinkType();
 
+    /**
+     * \brief Returns the counters of the background writer thread of the file,
+     * which are zero if the file is not written asynchronously.
+     *
+     * \returns the counters of the writer
+     */
+    AsyncFileStream::Statistics GetWriterStatistics() const;
+
   private:
-    PcapFile m_file;    //!< Pcap file
-    uint32_t m_snapLen; //!< max length of saved packets
-    bool m_nanosecMode; //!< Timestamps in nanosecond mode
+    PcapFile m_file;     //!< Pcap file
+    uint32_t m_snapLen;  //!< max length of saved packets
+    bool m_nanosecMode;  //!< Timestamps in nanosecond mode
+    bool m_asynchronous; //!< Write the file with a background thread
+    bool m_dropWhenFull; //!< Drop the packets when the writer buffers are full
 };
 
 } // namespace ns3
@@ -54,7 +54,8 @@ const uint16_t VERSION_MINOR = 4; /**< Minor version of supported pcap file form
 PcapFile::PcapFile()
     : m_file(),
       m_swapMode(false),
-      m_nanosecMode(false)
+      m_nanosecMode(false),
+      m_dropWhenFull(false)
 {
     NS_LOG_FUNCTION(this);
     FatalImpl::RegisterStream(&m_file);
@@ -71,7 +72,7 @@ bool
 PcapFile::Fail() const
 {
     NS_LOG_FUNCTION(this);
-    return m_file.fail();
+    return m_asyncFile ? m_asyncFile->fail() : m_file.fail();
 }
 
 bool
@@ -86,15 +87,65 @@ PcapFile::Clear()
 {
     NS_LOG_FUNCTION(this);
     m_file.clear();
+    if (m_asyncFile)
+    {
+        m_asyncFile->clear();
+    }
 }
 
 void
 PcapFile::Close()
 {
     NS_LOG_FUNCTION(this);
+    if (m_asyncFile)
+    {
+        FatalImpl::UnregisterStream(m_asyncFile.get());
+        m_asyncFile->Close();
+        m_asyncFile.reset();
+    }
     m_file.close();
 }
 
+void
+PcapFile::SetDropWhenFull(bool drop)
+{
+    NS_LOG_FUNCTION(this << drop);
+    m_dropWhenFull = drop;
+    if (m_asyncFile)
+    {
+        m_asyncFile->SetFullPolicy(drop ? AsyncFileStream::DROP_WHEN_FULL
+                                        : AsyncFileStream::BLOCK_WHEN_FULL);
+    }
+}
+
+AsyncFileStream::Statistics
+PcapFile::GetWriterStatistics() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_asyncFile ? m_asyncFile->GetStatistics() : AsyncFileStream::Statistics();
+}
+
+std::ostream&
+PcapFile::GetOutput()
+{
+    if (m_asyncFile)
+    {
+        return *m_asyncFile;
+    }
+    return m_file;
+}
+
+bool
+PcapFile::Reserve(uint32_t totalLen)
+{
+    if (!m_asyncFile)
+    {
+        return true;
+    }
+    uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+    return m_asyncFile->Reserve(sizeof(PcapRecordHeader) + inclLen);
+}
+
 uint32_t
 PcapFile::GetMagic()
 {
@@ -209,9 +260,13 @@ PcapFile::WriteFileHeader()
     NS_LOG_FUNCTION(this);
     //
     // If we're initializing the file, we need to write the pcap file header
-    // at the start of the file.
+    // at the start of the file. An asynchronous file cannot seek, but
+    // nothing has been written to it yet.
     //
-    m_file.seekp(0, std::ios::beg);
+    if (!m_asyncFile)
+    {
+        m_file.seekp(0, std::ios::beg);
+    }
 
     //
     // We have the ability to write out the pcap file header in a foreign endian
@@ -239,13 +294,13 @@ PcapFile::WriteFileHeader()
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-    m_file.write((const char*)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-    m_file.write((const char*)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-    m_file.write((const char*)&headerOut->m_zone, sizeof(headerOut->m_zone));
-    m_file.write((const char*)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-    m_file.write((const char*)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-    m_file.write((const char*)&headerOut->m_type, sizeof(headerOut->m_type));
+    GetOutput().write((const char*)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+    GetOutput().write((const char*)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+    GetOutput().write((const char*)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+    GetOutput().write((const char*)&headerOut->m_zone, sizeof(headerOut->m_zone));
+    GetOutput().write((const char*)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+    GetOutput().write((const char*)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+    GetOutput().write((const char*)&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -328,9 +383,9 @@ PcapFile::ReadAndVerifyFileHeader()
 }
 
 void
-PcapFile::Open(const std::string& filename, std::ios::openmode mode)
+PcapFile::Open(const std::string& filename, std::ios::openmode mode, bool asynchronous)
 {
-    NS_LOG_FUNCTION(this << filename << mode);
+    NS_LOG_FUNCTION(this << filename << mode << asynchronous);
     NS_ASSERT((mode & std::ios::app) == 0);
     NS_ASSERT(!m_file.fail());
     //
@@ -338,7 +393,21 @@ PcapFile::Open(const std::string& filename, std::ios::openmode mode)
     //
     mode |= std::ios::binary;
 
+    if (m_asyncFile)
+    {
+        FatalImpl::UnregisterStream(m_asyncFile.get());
+        m_asyncFile->Close();
+        m_asyncFile.reset();
+    }
     m_filename = filename;
+    if (asynchronous)
+    {
+        NS_ASSERT_MSG((mode & std::ios::in) == 0, "Asynchronous pcap files are write-only");
+        m_asyncFile = std::make_unique<AsyncFileStream>(filename, mode);
+        FatalImpl::RegisterStream(m_asyncFile.get());
+        SetDropWhenFull(m_dropWhenFull);
+        return;
+    }
     m_file.open(filename, mode);
     if (mode & std::ios::in)
     {
@@ -413,7 +482,7 @@ uint32_t
 PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen);
-    NS_ASSERT(m_file.good());
+    NS_ASSERT(GetOutput().good());
 
     uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -432,10 +501,10 @@ PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&header.m_tsSec, sizeof(header.m_tsSec));
-    m_file.write((const char*)&header.m_tsUsec, sizeof(header.m_tsUsec));
-    m_file.write((const char*)&header.m_inclLen, sizeof(header.m_inclLen));
-    m_file.write((const char*)&header.m_origLen, sizeof(header.m_origLen));
+    GetOutput().write((const char*)&header.m_tsSec, sizeof(header.m_tsSec));
+    GetOutput().write((const char*)&header.m_tsUsec, sizeof(header.m_tsUsec));
+    GetOutput().write((const char*)&header.m_inclLen, sizeof(header.m_inclLen));
+    GetOutput().write((const char*)&header.m_origLen, sizeof(header.m_origLen));
     NS_BUILD_DEBUG(m_file.flush());
     return inclLen;
 }
@@ -444,8 +513,12 @@ void
 PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const uint8_t* const data, uint32_t totalLen)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &data << totalLen);
+    if (!Reserve(totalLen))
+    {
+        return;
+    }
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalLen);
-    m_file.write((const char*)data, inclLen);
+    GetOutput().write((const char*)data, inclLen);
     NS_BUILD_DEBUG(m_file.flush());
 }
 
@@ -453,8 +526,12 @@ void
 PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << p);
+    if (!Reserve(p->GetSize()))
+    {
+        return;
+    }
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize());
-    p->CopyData(&m_file, inclLen);
+    p->CopyData(&GetOutput(), inclLen);
     NS_BUILD_DEBUG(m_file.flush());
 }
 
@@ -464,15 +541,19 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const Header& header, Ptr<const
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &header << p);
     uint32_t headerSize = header.GetSerializedSize();
     uint32_t totalSize = headerSize + p->GetSize();
+    if (!Reserve(totalSize))
+    {
+        return;
+    }
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalSize);
 
     Buffer headerBuffer;
     headerBuffer.AddAtStart(headerSize);
     header.Serialize(headerBuffer.Begin());
     uint32_t toCopy = std::min(headerSize, inclLen);
-    headerBuffer.CopyData(&m_file, toCopy);
+    headerBuffer.CopyData(&GetOutput(), toCopy);
     inclLen -= toCopy;
-    p->CopyData(&m_file, inclLen);
+    p->CopyData(&GetOutput(), inclLen);
 }
 
 void
@@ -20,9 +20,12 @@
 #ifndef PCAP_FILE_H
 #define PCAP_FILE_H
 
+#include "async-file-stream.h"
+
 #include "ns3/ptr.h"
 
 #include <fstream>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -75,17 +78,40 @@ class PcapFile
      * selected as a binary file (fstream::binary is automatically ored with the mode
      * field).
      *
+     * A file opened for writing only may be written asynchronously, by an
+     * AsyncFileStream: the records are then copied into its buffer, and
+     * written to the file by a background thread. The content of the file
+     * is the same, but it is complete only after Close() or after the
+     * simulator is destroyed.
+     *
      * \param filename String containing the name of the file.
      *
      * \param mode the access mode for the file.
+     *
+     * \param asynchronous whether the file is written by a background thread.
      */
-    void Open(const std::string& filename, std::ios::openmode mode);
+    void Open(const std::string& filename, std::ios::openmode mode, bool asynchronous = false);
 
     /**
      * Close the underlying file.
      */
     void Close();
 
+    /**
+     * Set whether the records are dropped, rather than waiting for the
+     * background thread, when the buffer of an asynchronous file is full.
+     *
+     * \param drop true to drop the records.
+     */
+    void SetDropWhenFull(bool drop);
+
+    /**
+     * Get the counters of the background writer of an asynchronous file.
+     *
+     * \returns the counters, all zero if the file is not asynchronous.
+     */
+    AsyncFileStream::Statistics GetWriterStatistics() const;
+
     /**
      * Initialize the pcap file associated with this object.  This file must have
      * been previously opened with write permissions.
@@ -373,11 +399,26 @@ class PcapFile
      */
     void ReadAndVerifyFileHeader();
 
-    std::string m_filename;      //!< file name
-    std::fstream m_file;         //!< file stream
-    PcapFileHeader m_fileHeader; //!< file header
-    bool m_swapMode;             //!< swap mode
-    bool m_nanosecMode;          //!< nanosecond timestamp mode
+    /**
+     * \brief Get the stream the records are written to
+     * \returns the asynchronous stream if any, else the file stream
+     */
+    std::ostream& GetOutput();
+
+    /**
+     * \brief Announce a record to an asynchronous file
+     * \param totalLen total packet length
+     * \returns false if the record must be dropped
+     */
+    bool Reserve(uint32_t totalLen);
+
+    std::string m_filename;                       //!< file name
+    std::fstream m_file;                          //!< file stream
+    std::unique_ptr<AsyncFileStream> m_asyncFile; //!< asynchronous file stream, if any
+    PcapFileHeader m_fileHeader;                  //!< file header
+    bool m_swapMode;                              //!< swap mode
+    bool m_nanosecMode;                           //!< nanosecond timestamp mode
+    bool m_dropWhenFull;                          //!< drop records when the buffer is full
 };
 
 } // namespace ns3
@@ -24,6 +24,8 @@
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -59,7 +61,8 @@ PointToPointChannel::GetTypeId()
 PointToPointChannel::PointToPointChannel()
     : Channel(),
       m_delay(Seconds(0.)),
-      m_nDevices(0)
+      m_nDevices(0),
+      m_partitioned(false)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -96,6 +99,21 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+    if (m_partitioned)
+    {
+        // The destination is executed by another thread: neither the
+        // packet data nor the reference count of the device are shared.
+        uint32_t size = p->GetSerializedSize();
+        std::vector<uint8_t> buffer(size);
+        p->Serialize(buffer.data(), size);
+        Simulator::ScheduleWithContext(m_link[wire].m_dstNodeId,
+                                       txTime + m_delay,
+                                       &PointToPointNetDevice::Receive,
+                                       PeekPointer(m_link[wire].m_dst),
+                                       Create<Packet>(buffer.data(), size, true));
+        return true;
+    }
+
     Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
                                    txTime + m_delay,
                                    &PointToPointNetDevice::Receive,
@@ -107,6 +125,31 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
     return true;
 }
 
+Address
+PointToPointChannel::GetRemoteAddress(const PointToPointNetDevice* device) const
+{
+    NS_LOG_FUNCTION(this << device);
+    NS_ASSERT(m_nDevices == N_DEVICES);
+    const Link& link = PeekPointer(m_link[0].m_src) == device ? m_link[0] : m_link[1];
+    return link.m_dst->GetAddress();
+}
+
+void
+PointToPointChannel::SetPartitioned(bool partitioned)
+{
+    NS_LOG_FUNCTION(this << partitioned);
+    NS_ASSERT(IsInitialized());
+    m_partitioned = partitioned;
+    m_link[0].m_dstNodeId = m_link[0].m_dst->GetNode()->GetId();
+    m_link[1].m_dstNodeId = m_link[1].m_dst->GetNode()->GetId();
+}
+
+bool
+PointToPointChannel::IsPartitioned() const
+{
+    return m_partitioned;
+}
+
 std::size_t
 PointToPointChannel::GetNDevices() const
 {
@@ -18,6 +18,7 @@
 #ifndef POINT_TO_POINT_CHANNEL_H
 #define POINT_TO_POINT_CHANNEL_H
 
+#include "ns3/address.h"
 #include "ns3/channel.h"
 #include "ns3/data-rate.h"
 #include "ns3/nstime.h"
@@ -101,6 +102,36 @@ class PointToPointChannel : public Channel
      */
     Ptr<NetDevice> GetDevice(std::size_t i) const override;
 
+    /**
+     * \brief Get the address of the device at the other end of the channel
+     *
+     * Unlike GetDevice(), this does not take a reference to the remote
+     * device, which may be executed by another thread when the channel is
+     * partitioned.
+     *
+     * \param device the local device
+     * \returns the address of the remote device
+     */
+    Address GetRemoteAddress(const PointToPointNetDevice* device) const;
+
+    /**
+     * \brief Declare whether the two devices are executed by different threads
+     *
+     * Used by parallel simulator implementations which place the two ends
+     * of the channel in different logical processes. Transmitted packets
+     * are then deep copied, so that the two ends never share reference
+     * counted data, and the TxRxPointToPoint trace source is not fired.
+     *
+     * \param partitioned true if the two devices are executed by different threads
+     */
+    void SetPartitioned(bool partitioned);
+
+    /**
+     * \brief Check whether the two devices are executed by different threads
+     * \returns true if the channel is partitioned
+     */
+    bool IsPartitioned() const;
+
   protected:
     /**
      * \brief Get the delay associated with this channel
@@ -153,6 +184,7 @@ class PointToPointChannel : public Channel
 
     Time m_delay;           //!< Propagation delay
     std::size_t m_nDevices; //!< Devices of this channel
+    bool m_partitioned;     //!< Whether the two devices are executed by different threads
 
     /**
      * The trace source for the packet transmission animation events that the
@@ -200,13 +232,15 @@ class PointToPointChannel : public Channel
         Link()
             : m_state(INITIALIZING),
               m_src(nullptr),
-              m_dst(nullptr)
+              m_dst(nullptr),
+              m_dstNodeId(0)
         {
         }
 
         WireState m_state;                //!< State of the link
         Ptr<PointToPointNetDevice> m_src; //!< First NetDevice
         Ptr<PointToPointNetDevice> m_dst; //!< Second NetDevice
+        uint32_t m_dstNodeId;             //!< Node ID of the second NetDevice, if partitioned
     };
 
     Link m_link[N_DEVICES]; //!< Link model
@@ -0,0 +1,299 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "path-loss-spectrum-transmit-filter.h"
+
+#include "spectrum-phy.h"
+#include "spectrum-signal-parameters.h"
+#include "spectrum-value.h"
+
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+#include <ns3/pointer.h>
+#include <ns3/propagation-loss-model.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PathLossSpectrumTransmitFilter");
+
+NS_OBJECT_ENSURE_REGISTERED(PathLossSpectrumTransmitFilter);
+
+/// Minimum size of the coarse path loss cache triggering a sweep
+static constexpr std::size_t MIN_SWEEP_SIZE = 1024;
+
+TypeId
+PathLossSpectrumTransmitFilter::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::PathLossSpectrumTransmitFilter")
+            .SetParent<SpectrumTransmitFilter>()
+            .SetGroupName("Spectrum")
+            .AddConstructor<PathLossSpectrumTransmitFilter>()
+            .AddAttribute("PropagationLossModel",
+                          "The single-frequency propagation loss model used to estimate "
+                          "the coarse path loss of each link. If not set, only the "
+                          "MaxDistance criterion is applied.",
+                          PointerValue(nullptr),
+                          MakePointerAccessor(
+                              &PathLossSpectrumTransmitFilter::SetPropagationLossModel,
+                              &PathLossSpectrumTransmitFilter::GetPropagationLossModel),
+                          MakePointerChecker<PropagationLossModel>())
+            .AddAttribute("ThresholdDbm",
+                          "Signals whose estimated received power (in dBm), increased by "
+                          "the margin, is below this value are discarded.",
+                          DoubleValue(-120.0),
+                          MakeDoubleAccessor(&PathLossSpectrumTransmitFilter::m_thresholdDbm),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("MarginDb",
+                          "Safety margin (in dB) added to the estimated received power "
+                          "before comparing it with the threshold. It should cover antenna "
+                          "gains, fading and the position error due to the grid.",
+                          DoubleValue(10.0),
+                          MakeDoubleAccessor(&PathLossSpectrumTransmitFilter::m_marginDb),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("CellSize",
+                          "Edge (in meters) of the cubic cells used to quantize positions. "
+                          "The coarse path loss of a link is recomputed only when one of "
+                          "its ends moves to a different cell.",
+                          DoubleValue(10.0),
+                          MakeDoubleAccessor(&PathLossSpectrumTransmitFilter::m_cellSize),
+                          MakeDoubleChecker<double>(std::numeric_limits<double>::min()))
+            .AddAttribute("MaxDistance",
+                          "Signals are discarded without evaluating the propagation loss "
+                          "model if the minimum distance between the cells of the "
+                          "transmitter and of the receiver exceeds this value (in meters). "
+                          "A value of zero disables this criterion.",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&PathLossSpectrumTransmitFilter::m_maxDistance),
+                          MakeDoubleChecker<double>(0.0))
+            .AddTraceSource("Culled",
+                            "This trace is fired whenever a signal is discarded. The "
+                            "parameters are the TX and RX SpectrumPhy instances and the "
+                            "estimated received power in dBm (-infinity if the signal "
+                            "was discarded because of the MaxDistance criterion).",
+                            MakeTraceSourceAccessor(&PathLossSpectrumTransmitFilter::m_culledTrace),
+                            "ns3::PathLossSpectrumTransmitFilter::CulledTracedCallback");
+    return tid;
+}
+
+PathLossSpectrumTransmitFilter::PathLossSpectrumTransmitFilter()
+    : m_numUses(0),
+      m_lastSweepUse(0),
+      m_sweepSize(MIN_SWEEP_SIZE),
+      m_lastTxPowerDbm(0),
+      m_numEvaluated(0),
+      m_numCulled(0),
+      m_numCacheHits(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PathLossSpectrumTransmitFilter::~PathLossSpectrumTransmitFilter()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PathLossSpectrumTransmitFilter::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_propagationLoss = nullptr;
+    m_lastParams = nullptr;
+    m_linkLossCache.clear();
+    SpectrumTransmitFilter::DoDispose();
+}
+
+void
+PathLossSpectrumTransmitFilter::SetPropagationLossModel(Ptr<PropagationLossModel> loss)
+{
+    NS_LOG_FUNCTION(this << loss);
+    m_propagationLoss = loss;
+    m_linkLossCache.clear();
+}
+
+Ptr<PropagationLossModel>
+PathLossSpectrumTransmitFilter::GetPropagationLossModel() const
+{
+    return m_propagationLoss;
+}
+
+uint64_t
+PathLossSpectrumTransmitFilter::GetNumEvaluated() const
+{
+    return m_numEvaluated;
+}
+
+uint64_t
+PathLossSpectrumTransmitFilter::GetNumCulled() const
+{
+    return m_numCulled;
+}
+
+uint64_t
+PathLossSpectrumTransmitFilter::GetNumCacheHits() const
+{
+    return m_numCacheHits;
+}
+
+void
+PathLossSpectrumTransmitFilter::ResetStats()
+{
+    NS_LOG_FUNCTION(this);
+    m_numEvaluated = 0;
+    m_numCulled = 0;
+    m_numCacheHits = 0;
+}
+
+std::size_t
+PathLossSpectrumTransmitFilter::LinkKeyHash::operator()(const LinkKey& key) const
+{
+    std::size_t h = std::hash<const MobilityModel*>()(key.first);
+    return h ^ (std::hash<const MobilityModel*>()(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+PathLossSpectrumTransmitFilter::GridCell
+PathLossSpectrumTransmitFilter::GetCell(const Vector& position) const
+{
+    return {static_cast<int64_t>(std::floor(position.x / m_cellSize)),
+            static_cast<int64_t>(std::floor(position.y / m_cellSize)),
+            static_cast<int64_t>(std::floor(position.z / m_cellSize))};
+}
+
+double
+PathLossSpectrumTransmitFilter::GetMinCellDistance(const GridCell& a, const GridCell& b) const
+{
+    // two cells whose indices differ by n along an axis are (n - 1) cells apart along that axis
+    auto gap = [this](int64_t i, int64_t j) {
+        int64_t d = std::abs(i - j);
+        return d > 0 ? (d - 1) * m_cellSize : 0.0;
+    };
+    double dx = gap(a.x, b.x);
+    double dy = gap(a.y, b.y);
+    double dz = gap(a.z, b.z);
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+double
+PathLossSpectrumTransmitFilter::GetTxPowerDbm(Ptr<const SpectrumSignalParameters> params)
+{
+    // the channel evaluates the same signal for all the receivers in a row
+    if (params != m_lastParams)
+    {
+        m_lastParams = params;
+        m_lastTxPowerDbm = 10 * std::log10(Integral(*params->psd)) + 30;
+    }
+    return m_lastTxPowerDbm;
+}
+
+void
+PathLossSpectrumTransmitFilter::SweepCache()
+{
+    NS_LOG_FUNCTION(this << m_linkLossCache.size());
+    for (auto it = m_linkLossCache.begin(); it != m_linkLossCache.end();)
+    {
+        if (it->second.lastUse <= m_lastSweepUse)
+        {
+            it = m_linkLossCache.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    m_lastSweepUse = m_numUses;
+    m_sweepSize = std::max(MIN_SWEEP_SIZE, 2 * m_linkLossCache.size());
+}
+
+bool
+PathLossSpectrumTransmitFilter::DoFilter(Ptr<const SpectrumSignalParameters> params,
+                                         Ptr<const SpectrumPhy> receiverPhy)
+{
+    NS_LOG_FUNCTION(this << params << receiverPhy);
+
+    Ptr<const MobilityModel> txMobility = params->txPhy->GetMobility();
+    Ptr<const MobilityModel> rxMobility = receiverPhy->GetMobility();
+    if (!txMobility || !rxMobility)
+    {
+        NS_LOG_DEBUG("Mobility model not available: do not filter");
+        return false;
+    }
+
+    ++m_numEvaluated;
+
+    GridCell txCell = GetCell(txMobility->GetPosition());
+    GridCell rxCell = GetCell(rxMobility->GetPosition());
+
+    if (m_maxDistance > 0 && GetMinCellDistance(txCell, rxCell) > m_maxDistance)
+    {
+        NS_LOG_DEBUG("Receiver beyond " << m_maxDistance << " m: filter");
+        ++m_numCulled;
+        m_culledTrace(params->txPhy, receiverPhy, -std::numeric_limits<double>::infinity());
+        return true;
+    }
+
+    if (!m_propagationLoss)
+    {
+        return false;
+    }
+
+    auto sameCell = [](const GridCell& a, const GridCell& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    };
+
+    ++m_numUses;
+    LinkKey key{PeekPointer(txMobility), PeekPointer(rxMobility)};
+    auto it = m_linkLossCache.find(key);
+    if (it != m_linkLossCache.end() && sameCell(it->second.txCell, txCell) &&
+        sameCell(it->second.rxCell, rxCell))
+    {
+        ++m_numCacheHits;
+        it->second.lastUse = m_numUses;
+    }
+    else
+    {
+        double lossDb = -m_propagationLoss->CalcRxPower(0,
+                                                         ConstCast<MobilityModel>(txMobility),
+                                                         ConstCast<MobilityModel>(rxMobility));
+        NS_LOG_LOGIC("coarse path loss " << lossDb << " dB");
+        if (it == m_linkLossCache.end() && m_linkLossCache.size() >= m_sweepSize)
+        {
+            SweepCache();
+        }
+        it = m_linkLossCache
+                 .insert_or_assign(
+                     key,
+                     LinkLoss{txMobility, rxMobility, txCell, rxCell, lossDb, m_numUses})
+                 .first;
+    }
+
+    double rxPowerDbm = GetTxPowerDbm(params) - it->second.lossDb;
+    if (rxPowerDbm + m_marginDb < m_thresholdDbm)
+    {
+        NS_LOG_DEBUG("Estimated received power " << rxPowerDbm << " dBm: filter");
+        ++m_numCulled;
+        m_culledTrace(params->txPhy, receiverPhy, rxPowerDbm);
+        return true;
+    }
+    return false;
+}
+
+} // namespace ns3
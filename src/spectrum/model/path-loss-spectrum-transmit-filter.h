@@ -0,0 +1,217 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PATH_LOSS_SPECTRUM_TRANSMIT_FILTER_H
+#define PATH_LOSS_SPECTRUM_TRANSMIT_FILTER_H
+
+#include "spectrum-transmit-filter.h"
+
+#include <ns3/traced-callback.h>
+#include <ns3/vector.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+namespace ns3
+{
+
+class MobilityModel;
+class PropagationLossModel;
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Transmit filter discarding signals that are received far below a power threshold
+ *
+ * For every (transmitter, receiver) pair, this filter estimates the received
+ * power as the total transmitted power (the integral of the TX PSD) minus a
+ * coarse path loss, computed with a single-frequency PropagationLossModel.
+ * Signals whose estimated received power, increased by a safety margin, is
+ * below a threshold are discarded by the channel before any per-receiver
+ * processing (copy of the signal parameters, spectrum propagation loss
+ * computation, scheduling of the reception event) takes place.
+ *
+ * To keep the cost of the estimate low, the positions of the mobility
+ * models are quantized on a grid of cubic cells; the coarse path loss of a
+ * link is cached and only recomputed when either end of the link moves to
+ * a different cell. The margin must therefore account for the position
+ * error introduced by the grid, for the antenna gains and for the fading
+ * not modeled by the coarse loss model. In addition, links whose ends are
+ * in cells farther apart than the MaxDistance attribute are discarded
+ * without evaluating the loss model at all.
+ *
+ * The cache holds a reference to the mobility models of its links, so that
+ * their addresses can not be reused by the models of new devices while they
+ * are cached. The links not evaluated since the previous sweep of the cache
+ * are removed whenever the cache doubles in size, so that it does not grow
+ * with the devices removed from the channel.
+ *
+ * The coarse loss model should be deterministic and should not overestimate
+ * the loss computed by the models installed in the channel; otherwise,
+ * signals that would have been received could be discarded.
+ */
+class PathLossSpectrumTransmitFilter : public SpectrumTransmitFilter
+{
+  public:
+    PathLossSpectrumTransmitFilter();
+    ~PathLossSpectrumTransmitFilter() override;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * Set the propagation loss model used to estimate the coarse path loss
+     * of each link.
+     *
+     * \param loss the propagation loss model
+     */
+    void SetPropagationLossModel(Ptr<PropagationLossModel> loss);
+
+    /**
+     * \return the propagation loss model used to estimate the coarse path loss
+     */
+    Ptr<PropagationLossModel> GetPropagationLossModel() const;
+
+    /**
+     * \return the number of (signal, receiver) pairs evaluated by this filter
+     */
+    uint64_t GetNumEvaluated() const;
+
+    /**
+     * \return the number of (signal, receiver) pairs discarded by this filter
+     */
+    uint64_t GetNumCulled() const;
+
+    /**
+     * \return the number of coarse path loss values served from the cache
+     */
+    uint64_t GetNumCacheHits() const;
+
+    /**
+     * Reset the counters of evaluated and discarded signals.
+     */
+    void ResetStats();
+
+    /**
+     * TracedCallback signature for discarded signals.
+     *
+     * \param [in] txPhy The TX SpectrumPhy instance.
+     * \param [in] rxPhy The RX SpectrumPhy instance.
+     * \param [in] rxPowerDbm The estimated received power, in dBm.
+     */
+    typedef void (*CulledTracedCallback)(Ptr<const SpectrumPhy> txPhy,
+                                         Ptr<const SpectrumPhy> rxPhy,
+                                         double rxPowerDbm);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    bool DoFilter(Ptr<const SpectrumSignalParameters> params,
+                  Ptr<const SpectrumPhy> receiverPhy) override;
+
+    /// Index of a cell of the grid used to quantize positions
+    struct GridCell
+    {
+        int64_t x; //!< index along the x axis
+        int64_t y; //!< index along the y axis
+        int64_t z; //!< index along the z axis
+    };
+
+    /// Cached coarse path loss of a link
+    struct LinkLoss
+    {
+        Ptr<const MobilityModel> txMobility; //!< mobility model of the transmitter
+        Ptr<const MobilityModel> rxMobility; //!< mobility model of the receiver
+        GridCell txCell;                     //!< cell of the transmitter when the loss was computed
+        GridCell rxCell;                     //!< cell of the receiver when the loss was computed
+        double lossDb;                       //!< coarse path loss, in dB
+        uint64_t lastUse;                    //!< evaluation in which the loss was last used
+    };
+
+    /// Key identifying a link by the mobility models of its ends
+    using LinkKey = std::pair<const MobilityModel*, const MobilityModel*>;
+
+    /// Hash function for LinkKey
+    struct LinkKeyHash
+    {
+        /**
+         * \param key the link key
+         * \return the hash of the key
+         */
+        std::size_t operator()(const LinkKey& key) const;
+    };
+
+    /**
+     * Quantize a position on the grid.
+     *
+     * \param position the position
+     * \return the cell containing the position
+     */
+    GridCell GetCell(const Vector& position) const;
+
+    /**
+     * Compute the minimum distance between any two points of two cells.
+     *
+     * \param a the first cell
+     * \param b the second cell
+     * \return the minimum distance, in meters
+     */
+    double GetMinCellDistance(const GridCell& a, const GridCell& b) const;
+
+    /**
+     * Get the total power of the signal being evaluated, computing it only
+     * once per transmitted signal.
+     *
+     * \param params the spectrum signal parameters
+     * \return the total transmitted power, in dBm
+     */
+    double GetTxPowerDbm(Ptr<const SpectrumSignalParameters> params);
+
+    /**
+     * Remove from the cache the links that were not evaluated since the
+     * previous sweep.
+     */
+    void SweepCache();
+
+    Ptr<PropagationLossModel> m_propagationLoss; //!< coarse propagation loss model
+    double m_thresholdDbm;                        //!< received power threshold, in dBm
+    double m_marginDb;                            //!< safety margin, in dB
+    double m_cellSize;                            //!< edge of the grid cells, in meters
+    double m_maxDistance; //!< distance beyond which signals are discarded (0 to disable)
+
+    std::unordered_map<LinkKey, LinkLoss, LinkKeyHash> m_linkLossCache; //!< coarse loss cache
+    uint64_t m_numUses;      //!< number of evaluations using the cache, never reset
+    uint64_t m_lastSweepUse; //!< value of m_numUses at the previous sweep
+    std::size_t m_sweepSize; //!< size of the cache triggering the next sweep
+
+    Ptr<const SpectrumSignalParameters> m_lastParams; //!< last evaluated signal
+    double m_lastTxPowerDbm;                          //!< total power of the last signal, in dBm
+
+    uint64_t m_numEvaluated; //!< number of evaluated (signal, receiver) pairs
+    uint64_t m_numCulled;    //!< number of discarded (signal, receiver) pairs
+    uint64_t m_numCacheHits; //!< number of coarse path loss cache hits
+
+    /// Trace fired when a signal is discarded
+    TracedCallback<Ptr<const SpectrumPhy>, Ptr<const SpectrumPhy>, double> m_culledTrace;
+};
+
+} // namespace ns3
+
+#endif /* PATH_LOSS_SPECTRUM_TRANSMIT_FILTER_H */
@@ -23,6 +23,8 @@
 #include <ns3/log.h>
 #include <ns3/math.h>
 
+#include <utility>
+
 namespace ns3
 {
 
@@ -101,46 +103,41 @@ SpectrumValue::ConstBandsEnd() const
 void
 SpectrumValue::Add(const SpectrumValue& x)
 {
-    auto it1 = m_values.begin();
-    auto it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
 
-    while (it1 != m_values.end())
+    double* v = m_values.data();
+    const double* xv = x.m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        *it1 += *it2;
-        ++it1;
-        ++it2;
+        v[i] += xv[i];
     }
 }
 
 void
 SpectrumValue::Add(double s)
 {
-    auto it1 = m_values.begin();
-
-    while (it1 != m_values.end())
+    double* v = m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        *it1 += s;
-        ++it1;
+        v[i] += s;
     }
 }
 
 void
 SpectrumValue::Subtract(const SpectrumValue& x)
 {
-    auto it1 = m_values.begin();
-    auto it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
 
-    while (it1 != m_values.end())
+    double* v = m_values.data();
+    const double* xv = x.m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        *it1 -= *it2;
-        ++it1;
-        ++it2;
+        v[i] -= xv[i];
     }
 }
 
@@ -151,48 +148,58 @@ SpectrumValue::Subtract(double s)
 }
 
 void
-SpectrumValue::Multiply(const SpectrumValue& x)
+SpectrumValue::SubtractFrom(const SpectrumValue& x)
 {
-    auto it1 = m_values.begin();
-    auto it2 = x.m_values.begin();
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size());
+
+    double* v = m_values.data();
+    const double* xv = x.m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i] = xv[i] - v[i];
+    }
+}
 
+void
+SpectrumValue::Multiply(const SpectrumValue& x)
+{
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
 
-    while (it1 != m_values.end())
+    double* v = m_values.data();
+    const double* xv = x.m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        *it1 *= *it2;
-        ++it1;
-        ++it2;
+        v[i] *= xv[i];
     }
 }
 
 void
 SpectrumValue::Multiply(double s)
 {
-    auto it1 = m_values.begin();
-
-    while (it1 != m_values.end())
+    double* v = m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        *it1 *= s;
-        ++it1;
+        v[i] *= s;
     }
 }
 
 void
 SpectrumValue::Divide(const SpectrumValue& x)
 {
-    auto it1 = m_values.begin();
-    auto it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
 
-    while (it1 != m_values.end())
+    double* v = m_values.data();
+    const double* xv = x.m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        *it1 /= *it2;
-        ++it1;
-        ++it2;
+        v[i] /= xv[i];
     }
 }
 
@@ -200,24 +207,37 @@ void
 SpectrumValue::Divide(double s)
 {
     NS_LOG_FUNCTION(this << s);
-    auto it1 = m_values.begin();
+    double* v = m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i] /= s;
+    }
+}
 
-    while (it1 != m_values.end())
+void
+SpectrumValue::DivideInto(const SpectrumValue& x)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size());
+
+    double* v = m_values.data();
+    const double* xv = x.m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        *it1 /= s;
-        ++it1;
+        v[i] = xv[i] / v[i];
     }
 }
 
 void
 SpectrumValue::ChangeSign()
 {
-    auto it1 = m_values.begin();
-
-    while (it1 != m_values.end())
+    double* v = m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        *it1 = -(*it1);
-        ++it1;
+        v[i] = -v[i];
     }
 }
 
@@ -322,11 +342,11 @@ double
 Norm(const SpectrumValue& x)
 {
     double s = 0;
-    auto it1 = x.ConstValuesBegin();
-    while (it1 != x.ConstValuesEnd())
+    const double* v = x.m_values.data();
+    const size_t n = x.m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        s += (*it1) * (*it1);
-        ++it1;
+        s += v[i] * v[i];
     }
     return std::sqrt(s);
 }
@@ -335,11 +355,11 @@ double
 Sum(const SpectrumValue& x)
 {
     double s = 0;
-    auto it1 = x.ConstValuesBegin();
-    while (it1 != x.ConstValuesEnd())
+    const double* v = x.m_values.data();
+    const size_t n = x.m_values.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        s += (*it1);
-        ++it1;
+        s += v[i];
     }
     return s;
 }
@@ -430,9 +450,8 @@ operator+(double lhs, const SpectrumValue& rhs)
 SpectrumValue
 operator-(const SpectrumValue& lhs, const SpectrumValue& rhs)
 {
-    SpectrumValue res = rhs;
-    res.ChangeSign();
-    res.Add(lhs);
+    SpectrumValue res = lhs;
+    res.Subtract(rhs);
     return res;
 }
 
@@ -554,6 +573,188 @@ Log(const SpectrumValue& arg)
     return res;
 }
 
+SpectrumValue
+operator+(SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+    lhs.Add(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator+(const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+    rhs.Add(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator+(SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+    lhs.Add(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator+(SpectrumValue&& lhs, double rhs)
+{
+    lhs.Add(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator+(double lhs, SpectrumValue&& rhs)
+{
+    rhs.Add(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator-(SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+    lhs.Subtract(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator-(const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+    rhs.SubtractFrom(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator-(SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+    lhs.Subtract(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator-(SpectrumValue&& lhs, double rhs)
+{
+    lhs.Subtract(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator-(double lhs, SpectrumValue&& rhs)
+{
+    rhs.Subtract(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator*(SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+    lhs.Multiply(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator*(const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+    rhs.Multiply(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator*(SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+    lhs.Multiply(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator*(SpectrumValue&& lhs, double rhs)
+{
+    lhs.Multiply(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator*(double lhs, SpectrumValue&& rhs)
+{
+    rhs.Multiply(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator/(SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+    lhs.Divide(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator/(const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+    rhs.DivideInto(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator/(SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+    lhs.Divide(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator/(SpectrumValue&& lhs, double rhs)
+{
+    lhs.Divide(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+operator/(double lhs, SpectrumValue&& rhs)
+{
+    rhs.Divide(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+operator-(SpectrumValue&& rhs)
+{
+    rhs.ChangeSign();
+    return std::move(rhs);
+}
+
+SpectrumValue
+Pow(SpectrumValue&& lhs, double rhs)
+{
+    lhs.Pow(rhs);
+    return std::move(lhs);
+}
+
+SpectrumValue
+Pow(double lhs, SpectrumValue&& rhs)
+{
+    rhs.Exp(lhs);
+    return std::move(rhs);
+}
+
+SpectrumValue
+Log10(SpectrumValue&& arg)
+{
+    arg.Log10();
+    return std::move(arg);
+}
+
+SpectrumValue
+Log2(SpectrumValue&& arg)
+{
+    arg.Log2();
+    return std::move(arg);
+}
+
+SpectrumValue
+Log(SpectrumValue&& arg)
+{
+    arg.Log();
+    return std::move(arg);
+}
+
 SpectrumValue&
 SpectrumValue::operator+=(const SpectrumValue& rhs)
 {
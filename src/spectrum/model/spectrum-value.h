@@ -302,6 +302,44 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     friend SpectrumValue operator-(const SpectrumValue& rhs);
 
+    /**
+     * \name Operators reusing the storage of temporaries
+     *
+     * These overloads are selected when at least one of the operands is an
+     * rvalue (e.g., the result of another operator). The result is computed
+     * in place in the storage of the temporary, so that compound expressions
+     * such as <tt>signal / (interference + noise)</tt> allocate a single
+     * vector of values instead of one per operator. They have the same
+     * semantics as the corresponding overloads taking const references.
+     *
+     * \param lhs Left Hand Side of the operator
+     * \param rhs Right Hand Side of the operator
+     * \return the result of the operation
+     * @{
+     */
+    friend SpectrumValue operator+(SpectrumValue&& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator+(const SpectrumValue& lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator+(SpectrumValue&& lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator+(SpectrumValue&& lhs, double rhs);
+    friend SpectrumValue operator+(double lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator-(SpectrumValue&& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator-(const SpectrumValue& lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator-(SpectrumValue&& lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator-(SpectrumValue&& lhs, double rhs);
+    friend SpectrumValue operator-(double lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator*(SpectrumValue&& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator*(const SpectrumValue& lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator*(SpectrumValue&& lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator*(SpectrumValue&& lhs, double rhs);
+    friend SpectrumValue operator*(double lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator/(SpectrumValue&& lhs, const SpectrumValue& rhs);
+    friend SpectrumValue operator/(const SpectrumValue& lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator/(SpectrumValue&& lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator/(SpectrumValue&& lhs, double rhs);
+    friend SpectrumValue operator/(double lhs, SpectrumValue&& rhs);
+    friend SpectrumValue operator-(SpectrumValue&& rhs);
+    /** @} */
+
     /**
      * left shift operator
      *
@@ -482,6 +520,25 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     friend SpectrumValue Log(const SpectrumValue& arg);
 
+    /**
+     * \name Math functions reusing the storage of temporaries
+     *
+     * Same as the overloads taking const references, but the result is
+     * computed in place in the storage of the rvalue argument.
+     *
+     * \param arg the argument
+     * \param lhs the base
+     * \param rhs the exponent
+     * \return the result of the function
+     * @{
+     */
+    friend SpectrumValue Pow(SpectrumValue&& lhs, double rhs);
+    friend SpectrumValue Pow(double lhs, SpectrumValue&& rhs);
+    friend SpectrumValue Log10(SpectrumValue&& arg);
+    friend SpectrumValue Log2(SpectrumValue&& arg);
+    friend SpectrumValue Log(SpectrumValue&& arg);
+    /** @} */
+
     /**
      *
      *
@@ -528,6 +585,12 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * \param s flat value
      */
     void Subtract(double s);
+    /**
+     * Replaces each element with the difference between the corresponding
+     * element of a SpectrumValue and itself, i.e., *this = x - *this
+     * \param x SpectrumValue
+     */
+    void SubtractFrom(const SpectrumValue& x);
     /**
      * Multiplies for a SpectrumValue (element to element multiplication)
      * \param x SpectrumValue
@@ -548,6 +611,12 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * \param s flat value
      */
     void Divide(double s);
+    /**
+     * Replaces each element with the ratio between the corresponding
+     * element of a SpectrumValue and itself, i.e., *this = x / *this
+     * \param x SpectrumValue
+     */
+    void DivideInto(const SpectrumValue& x);
     /**
      * Change the values sign
      */
@@ -610,6 +679,11 @@ SpectrumValue Pow(double lhs, const SpectrumValue& rhs);
 SpectrumValue Log10(const SpectrumValue& arg);
 SpectrumValue Log2(const SpectrumValue& arg);
 SpectrumValue Log(const SpectrumValue& arg);
+SpectrumValue Pow(SpectrumValue&& lhs, double rhs);
+SpectrumValue Pow(double lhs, SpectrumValue&& rhs);
+SpectrumValue Log10(SpectrumValue&& arg);
+SpectrumValue Log2(SpectrumValue&& arg);
+SpectrumValue Log(SpectrumValue&& arg);
 double Integral(const SpectrumValue& arg);
 
 } // namespace ns3
@@ -29,10 +29,12 @@
 #include "ns3/phased-array-model.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 #include <ns3/simulator.h>
 
 #include <algorithm>
 #include <random>
+#include <thread>
 
 namespace ns3
 {
@@ -48,6 +50,10 @@ static const double offSetAlpha[20] = {
     0.6797, -0.6797, 0.8844, -0.8844, 1.1481, -1.1481, 1.5195, -1.5195, 2.1551, -2.1551,
 };
 
+/// Minimum number of pairs of antenna elements for which the channel
+/// coefficients are computed by multiple threads
+static const size_t MIN_PARALLEL_ELEMENT_PAIRS = 256;
+
 /**
  * The square root matrix for <em>RMa LOS</em>, which is generated using the
  * Cholesky decomposition according to table 7.5-6 Part 2 and follows the order
@@ -306,6 +312,15 @@ ThreeGppChannelModel::GetTypeId()
                           TimeValue(MilliSeconds(0)),
                           MakeTimeAccessor(&ThreeGppChannelModel::m_updatePeriod),
                           MakeTimeChecker())
+            .AddAttribute("ComputationThreads",
+                          "Number of threads computing the coefficients of a channel matrix "
+                          "when it is generated. The channel matrices are still generated "
+                          "when they are requested, and the random draws are performed on the "
+                          "calling thread, so the realizations do not depend on the number of "
+                          "threads, nor differ from those obtained with 0 or 1 thread.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::m_computationThreads),
+                          MakeUintegerChecker<uint32_t>())
             // attributes for the blockage model
             .AddAttribute("Blockage",
                           "Enable blockage model A (sec 7.6.4.1)",
@@ -1842,75 +1857,100 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::Double2DVector rayAodRadian;
-    MatrixBasedChannelModel::Double2DVector rayAoaRadian;
-    MatrixBasedChannelModel::Double2DVector rayZodRadian;
-    MatrixBasedChannelModel::Double2DVector rayZoaRadian;
+    Complex3DVector hUsn = GenerateChannelCoefficients(*channelParams,
+                                                       *table3gpp,
+                                                       isSameDirection,
+                                                       sMob->GetPosition(),
+                                                       uMob->GetPosition(),
+                                                       *sAntenna,
+                                                       *uAntenna);
 
-    // if channel params is generated in the same direction in which we
-    // generate the channel matrix, angles and zenith od departure and arrival are ok,
-    // just set them to corresponding variable that will be used for the generation
-    // of channel matrix, otherwise we need to flip angles and zeniths of departure and arrival
-    if (isSameDirection)
-    {
-        rayAodRadian = channelParams->m_rayAodRadian;
-        rayAoaRadian = channelParams->m_rayAoaRadian;
-        rayZodRadian = channelParams->m_rayZodRadian;
-        rayZoaRadian = channelParams->m_rayZoaRadian;
-    }
-    else
+    NS_LOG_DEBUG("Husn (sAntenna, uAntenna):" << sAntenna->GetId() << ", " << uAntenna->GetId());
+    for (size_t cIndex = 0; cIndex < hUsn.GetNumPages(); cIndex++)
     {
-        rayAodRadian = channelParams->m_rayAoaRadian;
-        rayAoaRadian = channelParams->m_rayAodRadian;
-        rayZodRadian = channelParams->m_rayZoaRadian;
-        rayZoaRadian = channelParams->m_rayZodRadian;
+        for (size_t rowIdx = 0; rowIdx < hUsn.GetNumRows(); rowIdx++)
+        {
+            for (size_t colIdx = 0; colIdx < hUsn.GetNumCols(); colIdx++)
+            {
+                NS_LOG_DEBUG(" " << hUsn(rowIdx, colIdx, cIndex) << ",");
+            }
+        }
     }
 
+    NS_LOG_INFO("size of coefficient matrix (rows, columns, clusters) = ("
+                << hUsn.GetNumRows() << ", " << hUsn.GetNumCols() << ", " << hUsn.GetNumPages()
+                << ")");
+    channelMatrix->m_channel = hUsn;
+    return channelMatrix;
+}
+
+MatrixBasedChannelModel::Complex3DVector
+ThreeGppChannelModel::GenerateChannelCoefficients(const ThreeGppChannelParams& channelParams,
+                                                  const ParamsTable& table3gpp,
+                                                  bool isSameDirection,
+                                                  const Vector& sPos,
+                                                  const Vector& uPos,
+                                                  const PhasedArrayModel& sAntenna,
+                                                  const PhasedArrayModel& uAntenna) const
+{
+    // if channel params is generated in the same direction in which we
+    // generate the channel matrix, angles and zenith od departure and arrival are ok,
+    // just use them for the generation of channel matrix, otherwise we need to flip
+    // angles and zeniths of departure and arrival
+    const Double2DVector& rayAodRadian =
+        isSameDirection ? channelParams.m_rayAodRadian : channelParams.m_rayAoaRadian;
+    const Double2DVector& rayAoaRadian =
+        isSameDirection ? channelParams.m_rayAoaRadian : channelParams.m_rayAodRadian;
+    const Double2DVector& rayZodRadian =
+        isSameDirection ? channelParams.m_rayZodRadian : channelParams.m_rayZoaRadian;
+    const Double2DVector& rayZoaRadian =
+        isSameDirection ? channelParams.m_rayZoaRadian : channelParams.m_rayZodRadian;
+
     // Step 11: Generate channel coefficients for each cluster n and each receiver
     //  and transmitter element pair u,s.
     // where n is cluster index, u and s are receive and transmit antenna element.
-    size_t uSize = uAntenna->GetNumberOfElements();
-    size_t sSize = sAntenna->GetNumberOfElements();
+    size_t uSize = uAntenna.GetNumberOfElements();
+    size_t sSize = sAntenna.GetNumberOfElements();
 
     // NOTE: Since each of the strongest 2 clusters are divided into 3 sub-clusters,
     // the total cluster will generally be numReducedCLuster + 4.
     // However, it might be that m_cluster1st = m_cluster2nd. In this case the
     // total number of clusters will be numReducedCLuster + 2.
-    uint16_t numOverallCluster = (channelParams->m_cluster1st != channelParams->m_cluster2nd)
-                                     ? channelParams->m_reducedClusterNumber + 4
-                                     : channelParams->m_reducedClusterNumber + 2;
+    uint16_t numOverallCluster = (channelParams.m_cluster1st != channelParams.m_cluster2nd)
+                                     ? channelParams.m_reducedClusterNumber + 4
+                                     : channelParams.m_reducedClusterNumber + 2;
     Complex3DVector hUsn(uSize, sSize, numOverallCluster); // channel coefficient hUsn (u, s, n);
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= channelParams->m_clusterPhase.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= channelParams->m_clusterPower.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <=
-              channelParams->m_crossPolarizationPowerRatios.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= rayZoaRadian.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= rayZodRadian.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= rayAoaRadian.size());
-    NS_ASSERT(channelParams->m_reducedClusterNumber <= rayAodRadian.size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <=
-              channelParams->m_crossPolarizationPowerRatios[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= rayZoaRadian[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= rayZodRadian[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= rayAoaRadian[0].size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= rayAodRadian[0].size());
-
-    double x = sMob->GetPosition().x - uMob->GetPosition().x;
-    double y = sMob->GetPosition().y - uMob->GetPosition().y;
+    NS_ASSERT(channelParams.m_reducedClusterNumber <= channelParams.m_clusterPhase.size());
+    NS_ASSERT(channelParams.m_reducedClusterNumber <= channelParams.m_clusterPower.size());
+    NS_ASSERT(channelParams.m_reducedClusterNumber <=
+              channelParams.m_crossPolarizationPowerRatios.size());
+    NS_ASSERT(channelParams.m_reducedClusterNumber <= rayZoaRadian.size());
+    NS_ASSERT(channelParams.m_reducedClusterNumber <= rayZodRadian.size());
+    NS_ASSERT(channelParams.m_reducedClusterNumber <= rayAoaRadian.size());
+    NS_ASSERT(channelParams.m_reducedClusterNumber <= rayAodRadian.size());
+    NS_ASSERT(table3gpp.m_raysPerCluster <= channelParams.m_clusterPhase[0].size());
+    NS_ASSERT(table3gpp.m_raysPerCluster <=
+              channelParams.m_crossPolarizationPowerRatios[0].size());
+    NS_ASSERT(table3gpp.m_raysPerCluster <= rayZoaRadian[0].size());
+    NS_ASSERT(table3gpp.m_raysPerCluster <= rayZodRadian[0].size());
+    NS_ASSERT(table3gpp.m_raysPerCluster <= rayAoaRadian[0].size());
+    NS_ASSERT(table3gpp.m_raysPerCluster <= rayAodRadian[0].size());
+
+    double x = sPos.x - uPos.x;
+    double y = sPos.y - uPos.y;
     double distance2D = sqrt(x * x + y * y);
     // NOTE we assume hUT = min (height(a), height(b)) and
     // hBS = max (height (a), height (b))
-    double hUt = std::min(sMob->GetPosition().z, uMob->GetPosition().z);
-    double hBs = std::max(sMob->GetPosition().z, uMob->GetPosition().z);
+    double hUt = std::min(sPos.z, uPos.z);
+    double hBs = std::max(sPos.z, uPos.z);
     // compute the 3D distance using eq. 7.4-1
     double distance3D = std::sqrt(distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
 
-    Angles sAngle(uMob->GetPosition(), sMob->GetPosition());
-    Angles uAngle(sMob->GetPosition(), uMob->GetPosition());
+    Angles sAngle(uPos, sPos);
+    Angles uAngle(sPos, uPos);
 
-    Complex2DVector raysPreComp(channelParams->m_reducedClusterNumber,
-                                table3gpp->m_raysPerCluster); // stores part of the ray expression,
+    Complex2DVector raysPreComp(channelParams.m_reducedClusterNumber,
+                                table3gpp.m_raysPerCluster); // stores part of the ray expression,
     // cached as independent from the u- and s-indexes
     Double2DVector sinCosA; // cached multiplications of sin and cos of the ZoA and AoA angles
     Double2DVector sinSinA; // cached multiplications of sines of the ZoA and AoA angles
@@ -1920,38 +1960,38 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     Double2DVector cosZoD;  // cached cos of the ZoD angle
 
     // resize to appropriate dimensions
-    sinCosA.resize(channelParams->m_reducedClusterNumber);
-    sinSinA.resize(channelParams->m_reducedClusterNumber);
-    cosZoA.resize(channelParams->m_reducedClusterNumber);
-    sinCosD.resize(channelParams->m_reducedClusterNumber);
-    sinSinD.resize(channelParams->m_reducedClusterNumber);
-    cosZoD.resize(channelParams->m_reducedClusterNumber);
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+    sinCosA.resize(channelParams.m_reducedClusterNumber);
+    sinSinA.resize(channelParams.m_reducedClusterNumber);
+    cosZoA.resize(channelParams.m_reducedClusterNumber);
+    sinCosD.resize(channelParams.m_reducedClusterNumber);
+    sinSinD.resize(channelParams.m_reducedClusterNumber);
+    cosZoD.resize(channelParams.m_reducedClusterNumber);
+    for (uint8_t nIndex = 0; nIndex < channelParams.m_reducedClusterNumber; nIndex++)
     {
-        sinCosA[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinSinA[nIndex].resize(table3gpp->m_raysPerCluster);
-        cosZoA[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinCosD[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinSinD[nIndex].resize(table3gpp->m_raysPerCluster);
-        cosZoD[nIndex].resize(table3gpp->m_raysPerCluster);
+        sinCosA[nIndex].resize(table3gpp.m_raysPerCluster);
+        sinSinA[nIndex].resize(table3gpp.m_raysPerCluster);
+        cosZoA[nIndex].resize(table3gpp.m_raysPerCluster);
+        sinCosD[nIndex].resize(table3gpp.m_raysPerCluster);
+        sinSinD[nIndex].resize(table3gpp.m_raysPerCluster);
+        cosZoD[nIndex].resize(table3gpp.m_raysPerCluster);
     }
     // pre-compute the terms which are independent from uIndex and sIndex
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+    for (uint8_t nIndex = 0; nIndex < channelParams.m_reducedClusterNumber; nIndex++)
     {
-        for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+        for (uint8_t mIndex = 0; mIndex < table3gpp.m_raysPerCluster; mIndex++)
         {
-            DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
+            const DoubleVector& initialPhase = channelParams.m_clusterPhase[nIndex][mIndex];
             NS_ASSERT(4 <= initialPhase.size());
-            double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
+            double k = channelParams.m_crossPolarizationPowerRatios[nIndex][mIndex];
 
             // cache the component of the "rays" terms which depend on the random angle of arrivals
             // and departures and initial phases only
-            auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
-                Angles(channelParams->m_rayAoaRadian[nIndex][mIndex],
-                       channelParams->m_rayZoaRadian[nIndex][mIndex]));
-            auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
-                Angles(channelParams->m_rayAodRadian[nIndex][mIndex],
-                       channelParams->m_rayZodRadian[nIndex][mIndex]));
+            auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna.GetElementFieldPattern(
+                Angles(channelParams.m_rayAoaRadian[nIndex][mIndex],
+                       channelParams.m_rayZoaRadian[nIndex][mIndex]));
+            auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna.GetElementFieldPattern(
+                Angles(channelParams.m_rayAodRadian[nIndex][mIndex],
+                       channelParams.m_rayZodRadian[nIndex][mIndex]));
             raysPreComp(nIndex, mIndex) =
                 std::complex<double>(cos(initialPhase[0]), sin(initialPhase[0])) *
                     rxFieldPatternTheta * txFieldPatternTheta +
@@ -1982,116 +2022,169 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
         }
     }
 
-    // The following for loops computes the channel coefficients
-    // Keeps track of how many sub-clusters have been added up to now
-    uint8_t numSubClustersAdded = 0;
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+    // The phase terms of each ray depend either on the u or on the s antenna
+    // element, but not on both: compute them once per element and ray, storing
+    // them contiguously per element, instead of once per (u, s) pair
+    uint8_t numRays = table3gpp.m_raysPerCluster;
+    std::vector<Vector> uLocs(uSize);
+    for (size_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-        for (size_t uIndex = 0; uIndex < uSize; uIndex++)
-        {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
+        uLocs[uIndex] = uAntenna.GetElementLocation(uIndex);
+    }
+    std::vector<Vector> sLocs(sSize);
+    for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+        sLocs[sIndex] = sAntenna.GetElementLocation(sIndex);
+    }
 
-            for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+    // The following loops compute the channel coefficients of the s antenna
+    // elements in [sBegin, sEnd). They only read the cached terms and write
+    // distinct coefficients, so that disjoint ranges can be computed by
+    // different threads, with the same results as a single thread.
+    auto computeCoefficients = [&](size_t sBegin, size_t sEnd) {
+        std::vector<std::complex<double>> rxPhases(uSize * numRays); // rx phase terms (u, m)
+        std::vector<std::complex<double>> txPhases(sSize * numRays); // tx phase terms (s, m)
+        // Keeps track of how many sub-clusters have been added up to now
+        uint8_t numSubClustersAdded = 0;
+        for (uint8_t nIndex = 0; nIndex < channelParams.m_reducedClusterNumber; nIndex++)
+        {
+            for (size_t uIndex = 0; uIndex < uSize; uIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                // Compute the N-2 weakest cluster, assuming 0 slant angle and a
-                // polarization slant angle configured in the array (7.5-22)
-                if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+                const Vector& uLoc = uLocs[uIndex];
+                for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
                 {
-                    std::complex<double> rays(0, 0);
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
-                    {
-                        // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
-                        // NOTE Doppler is computed in the CalcBeamformingGain function and is
-                        // simplified to only account for the center angle of each cluster.
-                        rays += raysPreComp(nIndex, mIndex) *
-                                std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                                std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-                    }
-                    rays *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn(uIndex, sIndex, nIndex) = rays;
+                    // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+                    double rxPhaseDiff =
+                        2 * M_PI *
+                        (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
+                         cosZoA[nIndex][mIndex] * uLoc.z);
+                    rxPhases[uIndex * numRays + mIndex] =
+                        std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff));
                 }
-                else //(7.5-28)
+            }
+            for (size_t sIndex = sBegin; sIndex < sEnd; sIndex++)
+            {
+                const Vector& sLoc = sLocs[sIndex];
+                for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
                 {
-                    std::complex<double> raysSub1(0, 0);
-                    std::complex<double> raysSub2(0, 0);
-                    std::complex<double> raysSub3(0, 0);
+                    double txPhaseDiff =
+                        2 * M_PI *
+                        (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
+                         cosZoD[nIndex][mIndex] * sLoc.z);
+                    txPhases[sIndex * numRays + mIndex] =
+                        std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+                }
+            }
+            std::vector<std::complex<double>> preComp(numRays);
+            for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
+            {
+                preComp[mIndex] = raysPreComp(nIndex, mIndex);
+            }
+            double clusterAmplitude =
+                sqrt(channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
 
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+            // the u index runs in the inner loop, so that the coefficients are
+            // written contiguously (the u index is the fastest in Complex3DVector)
+            for (size_t sIndex = sBegin; sIndex < sEnd; sIndex++)
+            {
+                const std::complex<double>* txPhase = &txPhases[sIndex * numRays];
+                for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+                {
+                    const std::complex<double>* rxPhase = &rxPhases[uIndex * numRays];
+                    // Compute the N-2 weakest cluster, assuming 0 slant angle and a
+                    // polarization slant angle configured in the array (7.5-22)
+                    if (nIndex != channelParams.m_cluster1st &&
+                        nIndex != channelParams.m_cluster2nd)
+                    {
+                        std::complex<double> rays(0, 0);
+                        for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
+                        {
+                            // NOTE Doppler is computed in the CalcBeamformingGain function and
+                            // is simplified to only account for the center angle of each
+                            // cluster.
+                            rays += preComp[mIndex] * rxPhase[mIndex] * txPhase[mIndex];
+                        }
+                        rays *= clusterAmplitude;
+                        hUsn(uIndex, sIndex, nIndex) = rays;
+                    }
+                    else //(7.5-28)
                     {
-                        // ZML:Just remind me that the angle offsets for the 3 subclusters were not
-                        // generated correctly.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
-                        std::complex<double> raySub =
-                            raysPreComp(nIndex, mIndex) *
-                            std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                            std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                        switch (mIndex)
+                        std::complex<double> raysSub1(0, 0);
+                        std::complex<double> raysSub2(0, 0);
+                        std::complex<double> raysSub3(0, 0);
+
+                        for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
                         {
-                        case 9:
-                        case 10:
-                        case 11:
-                        case 12:
-                        case 17:
-                        case 18:
-                            raysSub2 += raySub;
-                            break;
-                        case 13:
-                        case 14:
-                        case 15:
-                        case 16:
-                            raysSub3 += raySub;
-                            break;
-                        default: // case 1,2,3,4,5,6,7,8,19,20
-                            raysSub1 += raySub;
-                            break;
+                            // ZML:Just remind me that the angle offsets for the 3 subclusters
+                            // were not generated correctly.
+                            std::complex<double> raySub =
+                                preComp[mIndex] * rxPhase[mIndex] * txPhase[mIndex];
+
+                            switch (mIndex)
+                            {
+                            case 9:
+                            case 10:
+                            case 11:
+                            case 12:
+                            case 17:
+                            case 18:
+                                raysSub2 += raySub;
+                                break;
+                            case 13:
+                            case 14:
+                            case 15:
+                            case 16:
+                                raysSub3 += raySub;
+                                break;
+                            default: // case 1,2,3,4,5,6,7,8,19,20
+                                raysSub1 += raySub;
+                                break;
+                            }
                         }
+                        raysSub1 *= clusterAmplitude;
+                        raysSub2 *= clusterAmplitude;
+                        raysSub3 *= clusterAmplitude;
+                        hUsn(uIndex, sIndex, nIndex) = raysSub1;
+                        hUsn(uIndex,
+                             sIndex,
+                             channelParams.m_reducedClusterNumber + numSubClustersAdded) = raysSub2;
+                        hUsn(uIndex,
+                             sIndex,
+                             channelParams.m_reducedClusterNumber + numSubClustersAdded + 1) =
+                            raysSub3;
                     }
-                    raysSub1 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub2 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub3 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn(uIndex, sIndex, nIndex) = raysSub1;
-                    hUsn(uIndex,
-                         sIndex,
-                         channelParams->m_reducedClusterNumber + numSubClustersAdded) = raysSub2;
-                    hUsn(uIndex,
-                         sIndex,
-                         channelParams->m_reducedClusterNumber + numSubClustersAdded + 1) =
-                        raysSub3;
                 }
             }
+            if (nIndex == channelParams.m_cluster1st || nIndex == channelParams.m_cluster2nd)
+            {
+                numSubClustersAdded += 2;
+            }
+        }
+    };
+
+    uint32_t nThreads = std::min<size_t>(m_computationThreads, sSize);
+    if (nThreads > 1 && uSize * sSize >= MIN_PARALLEL_ELEMENT_PAIRS)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(nThreads - 1);
+        for (uint32_t t = 1; t < nThreads; t++)
+        {
+            workers.emplace_back(computeCoefficients,
+                                 sSize * t / nThreads,
+                                 sSize * (t + 1) / nThreads);
         }
-        if (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd)
+        computeCoefficients(0, sSize / nThreads);
+        for (auto& worker : workers)
         {
-            numSubClustersAdded += 2;
+            worker.join();
         }
     }
+    else
+    {
+        computeCoefficients(0, sSize);
+    }
 
-    if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+    if (channelParams.m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
     {
         double lambda = 3.0e8 / m_frequency; // the wavelength of the carrier frequency
         std::complex<double> phaseDiffDueToDistance(cos(-2 * M_PI * distance3D / lambda),
@@ -2106,66 +2199,56 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
         const double sinSAngleAz = sin(sAngle.GetAzimuth());
         const double cosSAngleAz = cos(sAngle.GetAzimuth());
 
+        // the field patterns only depend on the LOS angles, and the scaling
+        // factors on the K-factor and on the attenuation
+        auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna.GetElementFieldPattern(
+            Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
+        auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna.GetElementFieldPattern(
+            Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
+        double kLinear = pow(10, channelParams.m_K_factor / 10.0);
+        double nlosScaling = sqrt(1.0 / (kLinear + 1));
+        double losScaling = sqrt(kLinear / (1 + kLinear));
+        double losAttenuation = pow(10, channelParams.m_attenuation_dB[0] / 10.0);
+
+        std::vector<std::complex<double>> txLosPhases(sSize);
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            const Vector& sLoc = sLocs[sIndex];
+            double txPhaseDiff =
+                2 * M_PI *
+                (sinSAngleIncl * cosSAngleAz * sLoc.x + sinSAngleIncl * sinSAngleAz * sLoc.y +
+                 cosSAngleIncl * sLoc.z);
+            txLosPhases[sIndex] = std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+        }
+
         for (size_t uIndex = 0; uIndex < uSize; uIndex++)
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
+            const Vector& uLoc = uLocs[uIndex];
             double rxPhaseDiff = 2 * M_PI *
                                  (sinUAngleIncl * cosUAngleAz * uLoc.x +
                                   sinUAngleIncl * sinUAngleAz * uLoc.y + cosUAngleIncl * uLoc.z);
+            std::complex<double> rxRay = (rxFieldPatternTheta * txFieldPatternTheta -
+                                          rxFieldPatternPhi * txFieldPatternPhi) *
+                                         phaseDiffDueToDistance *
+                                         std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff));
 
             for (size_t sIndex = 0; sIndex < sSize; sIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                std::complex<double> ray(0, 0);
-                double txPhaseDiff =
-                    2 * M_PI *
-                    (sinSAngleIncl * cosSAngleAz * sLoc.x + sinSAngleIncl * sinSAngleAz * sLoc.y +
-                     cosSAngleIncl * sLoc.z);
-
-                auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
-                    Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
-                auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
-                    Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
-
-                ray = (rxFieldPatternTheta * txFieldPatternTheta -
-                       rxFieldPatternPhi * txFieldPatternPhi) *
-                      phaseDiffDueToDistance *
-                      std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                      std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                double kLinear = pow(10, channelParams->m_K_factor / 10.0);
+                std::complex<double> ray = rxRay * txLosPhases[sIndex];
+
                 // the LOS path should be attenuated if blockage is enabled.
+                //(7.5-30) for tau = tau1
                 hUsn(uIndex, sIndex, 0) =
-                    sqrt(1.0 / (kLinear + 1)) * hUsn(uIndex, sIndex, 0) +
-                    sqrt(kLinear / (1 + kLinear)) * ray /
-                        pow(10,
-                            channelParams->m_attenuation_dB[0] / 10.0); //(7.5-30) for tau = tau1
+                    nlosScaling * hUsn(uIndex, sIndex, 0) + losScaling * ray / losAttenuation;
                 for (size_t nIndex = 1; nIndex < hUsn.GetNumPages(); nIndex++)
                 {
-                    hUsn(uIndex, sIndex, nIndex) *=
-                        sqrt(1.0 / (kLinear + 1)); //(7.5-30) for tau = tau2...tauN
+                    hUsn(uIndex, sIndex, nIndex) *= nlosScaling; //(7.5-30) for tau = tau2...tauN
                 }
             }
         }
     }
 
-    NS_LOG_DEBUG("Husn (sAntenna, uAntenna):" << sAntenna->GetId() << ", " << uAntenna->GetId());
-    for (size_t cIndex = 0; cIndex < hUsn.GetNumPages(); cIndex++)
-    {
-        for (size_t rowIdx = 0; rowIdx < hUsn.GetNumRows(); rowIdx++)
-        {
-            for (size_t colIdx = 0; colIdx < hUsn.GetNumCols(); colIdx++)
-            {
-                NS_LOG_DEBUG(" " << hUsn(rowIdx, colIdx, cIndex) << ",");
-            }
-        }
-    }
-
-    NS_LOG_INFO("size of coefficient matrix (rows, columns, clusters) = ("
-                << hUsn.GetNumRows() << ", " << hUsn.GetNumCols() << ", " << hUsn.GetNumPages()
-                << ")");
-    channelMatrix->m_channel = hUsn;
-    return channelMatrix;
+    return hUsn;
 }
 
 std::pair<double, double>
@@ -304,6 +304,33 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                                              const Ptr<const MobilityModel> uMob,
                                              Ptr<const PhasedArrayModel> sAntenna,
                                              Ptr<const PhasedArrayModel> uAntenna) const;
+
+    /**
+     * Compute the channel coefficients between the antenna arrays of two
+     * nodes s and u (step 11 of the procedure described in 3GPP TR 38.901).
+     * This method does not draw random numbers, nor does it modify or copy
+     * any reference-counted object, so that the coefficients of large antenna
+     * arrays are computed by m_computationThreads threads, each one for a range
+     * of elements of s.
+     * \param channelParams the channel parameters previously generated for the pair of
+     * nodes s and u
+     * \param table3gpp the 3gpp parameters table
+     * \param isSameDirection true if the channel parameters were generated in the
+     * direction s-to-u, false otherwise
+     * \param sPos the position of node s
+     * \param uPos the position of node u
+     * \param sAntenna the antenna array of node s
+     * \param uAntenna the antenna array of node u
+     * \return the channel coefficients hUsn (u, s, n)
+     */
+    Complex3DVector GenerateChannelCoefficients(const ThreeGppChannelParams& channelParams,
+                                                const ParamsTable& table3gpp,
+                                                bool isSameDirection,
+                                                const Vector& sPos,
+                                                const Vector& uPos,
+                                                const PhasedArrayModel& sAntenna,
+                                                const PhasedArrayModel& uAntenna) const;
+
     /**
      * Applies the blockage model A described in 3GPP TR 38.901
      * \param channelParams the channel parameters structure
@@ -371,6 +398,8 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
         2;                            //!< index of the THETA value in the m_nonSelfBlocking array
     static const uint8_t Y_INDEX = 3; //!< index of the Y value in the m_nonSelfBlocking array
     static const uint8_t R_INDEX = 4; //!< index of the R value in the m_nonSelfBlocking array
+
+    uint32_t m_computationThreads; //!< number of threads computing the channel coefficients
 };
 } // namespace ns3
 
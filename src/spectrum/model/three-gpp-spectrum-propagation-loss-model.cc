@@ -31,8 +31,10 @@
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
 #include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -42,6 +44,10 @@ NS_LOG_COMPONENT_DEFINE("ThreeGppSpectrumPropagationLossModel");
 NS_OBJECT_ENSURE_REGISTERED(ThreeGppSpectrumPropagationLossModel);
 
 ThreeGppSpectrumPropagationLossModel::ThreeGppSpectrumPropagationLossModel()
+    : m_longTermCacheSize(0),
+      m_longTermCacheHits(0),
+      m_longTermCacheMisses(0),
+      m_longTermCacheEvictions(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -54,7 +60,10 @@ ThreeGppSpectrumPropagationLossModel::~ThreeGppSpectrumPropagationLossModel()
 void
 ThreeGppSpectrumPropagationLossModel::DoDispose()
 {
-    m_longTermMap.clear();
+    m_longTermCache.clear();
+    m_longTermLru.clear();
+    m_channelGenerations.clear();
+    m_longTermCacheSize = 0;
     m_channelModel->Dispose();
     m_channelModel = nullptr;
 }
@@ -73,7 +82,18 @@ ThreeGppSpectrumPropagationLossModel::GetTypeId()
                 StringValue("ns3::ThreeGppChannelModel"),
                 MakePointerAccessor(&ThreeGppSpectrumPropagationLossModel::SetChannelModel,
                                     &ThreeGppSpectrumPropagationLossModel::GetChannelModel),
-                MakePointerChecker<MatrixBasedChannelModel>());
+                MakePointerChecker<MatrixBasedChannelModel>())
+            .AddAttribute("LongTermCacheBudget",
+                          "Memory budget (in bytes) of the cache of the long term components. "
+                          "The long term components are cached per pair of antenna arrays and "
+                          "pair of beamforming vectors, so that switching back to previously "
+                          "used beams does not require to compute them again. When the budget "
+                          "is exceeded, the least recently used components are evicted. A "
+                          "value of zero disables the limit.",
+                          UintegerValue(64 * 1024 * 1024),
+                          MakeUintegerAccessor(
+                              &ThreeGppSpectrumPropagationLossModel::m_longTermCacheBudget),
+                          MakeUintegerChecker<uint64_t>());
     return tid;
 }
 
@@ -173,29 +193,20 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::DoubleVector zoa;
-    MatrixBasedChannelModel::DoubleVector zod;
-    MatrixBasedChannelModel::DoubleVector aoa;
-    MatrixBasedChannelModel::DoubleVector aod;
-
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenith od departure and arrival are ok,
     // just set them to corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zeniths of departure and arrival
-    if (isSameDirection)
-    {
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-    else
-    {
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
+    using DoubleVector = MatrixBasedChannelModel::DoubleVector;
+    const auto& angle = channelParams->m_angle;
+    const DoubleVector& zoa = angle[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX
+                                                    : MatrixBasedChannelModel::ZOD_INDEX];
+    const DoubleVector& zod = angle[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX
+                                                    : MatrixBasedChannelModel::ZOA_INDEX];
+    const DoubleVector& aoa = angle[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX
+                                                    : MatrixBasedChannelModel::AOD_INDEX];
+    const DoubleVector& aod = angle[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX
+                                                    : MatrixBasedChannelModel::AOA_INDEX];
 
     for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
@@ -226,6 +237,17 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     }
 
     NS_ASSERT(numCluster <= doppler.GetSize());
+    NS_ASSERT(numCluster <= channelParams->m_delay.size());
+
+    // the product of the long term component and of the doppler term does
+    // not depend on the sub-band, so it is computed once per cluster and
+    // stored contiguously, together with the cluster delays
+    std::vector<std::complex<double>> longTermDoppler(numCluster);
+    for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        longTermDoppler[cIndex] = longTerm[cIndex] * doppler[cIndex];
+    }
+    const double* clusterDelay = channelParams->m_delay.data();
 
     // apply the doppler term and the propagation delay to the long term component
     // to obtain the beamforming gain
@@ -235,15 +257,21 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     {
         if ((*vit) != 0.00)
         {
-            std::complex<double> subsbandGain(0.0, 0.0);
+            // the complex products are expanded to let the compiler inline them
+            double gainRe = 0.0;
+            double gainIm = 0.0;
             double fsb = (*sbit).fc; // center frequency of the sub-band
+            double bandPhase = -2 * M_PI * fsb;
             for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
-                double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
-                subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] *
-                                                  std::complex<double>(cos(delay), sin(delay));
+                double delay = bandPhase * clusterDelay[cIndex];
+                double cosDelay = cos(delay);
+                double sinDelay = sin(delay);
+                const std::complex<double>& ltd = longTermDoppler[cIndex];
+                gainRe += ltd.real() * cosDelay - ltd.imag() * sinDelay;
+                gainIm += ltd.real() * sinDelay + ltd.imag() * cosDelay;
             }
-            *vit = (*vit) * (norm(subsbandGain));
+            *vit = (*vit) * (gainRe * gainRe + gainIm * gainIm);
         }
         vit++;
         sbit++;
@@ -251,72 +279,148 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     return tempPsd;
 }
 
-PhasedArrayModel::ComplexVector
-ThreeGppSpectrumPropagationLossModel::GetLongTerm(
-    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-    Ptr<const PhasedArrayModel> aPhasedArrayModel,
-    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+bool
+ThreeGppSpectrumPropagationLossModel::LongTermKey::operator==(const LongTermKey& other) const
 {
-    PhasedArrayModel::ComplexVector
-        longTerm; // vector containing the long term component for each cluster
+    // the identifiers are hashes of the vectors: compare the vectors only if
+    // the identifiers are equal
+    return m_linkKey == other.m_linkKey && m_sBfId == other.m_sBfId && m_uBfId == other.m_uBfId &&
+           m_sW == other.m_sW && m_uW == other.m_uW;
+}
 
-    // check if the channel matrix was generated considering a as the s-node and
-    // b as the u-node or vice-versa
-    PhasedArrayModel::ComplexVector sW;
-    PhasedArrayModel::ComplexVector uW;
-    if (!channelMatrix->IsReverse(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId()))
+std::size_t
+ThreeGppSpectrumPropagationLossModel::LongTermKeyHash::operator()(const LongTermKey& key) const
+{
+    std::size_t h = std::hash<uint64_t>()(key.m_linkKey);
+    h ^= std::hash<uint64_t>()(key.m_sBfId) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<uint64_t>()(key.m_uBfId) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheHits() const
+{
+    return m_longTermCacheHits;
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheMisses() const
+{
+    return m_longTermCacheMisses;
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheEvictions() const
+{
+    return m_longTermCacheEvictions;
+}
+
+std::size_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCost(
+    const LongTermKey& key,
+    const PhasedArrayModel::ComplexVector& longTerm)
+{
+    std::size_t elements = longTerm.GetSize() + key.m_sW.GetSize() + key.m_uW.GetSize();
+    std::size_t values = elements * sizeof(std::complex<double>);
+    // hash table node: key, entry, pointer to the next node and cached hash
+    std::size_t cacheNode = sizeof(LongTermKey) + sizeof(LongTerm) + 2 * sizeof(void*);
+    // LRU list node: pointers to the key and to the previous and next nodes
+    std::size_t lruNode = 3 * sizeof(void*);
+    return values + cacheNode + lruNode;
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::CacheLongTerm(const LongTermKey& key,
+                                                    const PhasedArrayModel::ComplexVector& longTerm,
+                                                    uint64_t channelGeneration) const
+{
+    auto it = m_longTermCache.find(key);
+    if (it != m_longTermCache.end())
     {
-        sW = aPhasedArrayModel->GetBeamformingVector();
-        uW = bPhasedArrayModel->GetBeamformingVector();
+        // replace an outdated component
+        m_longTermCacheSize -= GetLongTermCost(key, it->second.m_longTerm);
+        it->second.m_longTerm = longTerm;
+        it->second.m_channelGeneration = channelGeneration;
+        m_longTermLru.splice(m_longTermLru.begin(), m_longTermLru, it->second.m_lruIt);
     }
     else
     {
-        sW = bPhasedArrayModel->GetBeamformingVector();
-        uW = aPhasedArrayModel->GetBeamformingVector();
+        // the keys are not moved by a rehash of the cache
+        it = m_longTermCache.emplace(key, LongTerm{longTerm, channelGeneration, {}}).first;
+        m_longTermLru.push_front(&it->first);
+        it->second.m_lruIt = m_longTermLru.begin();
+        ++m_channelGenerations[key.m_linkKey].m_longTerms;
     }
+    m_longTermCacheSize += GetLongTermCost(key, longTerm);
 
-    bool update = false;   // indicates whether the long term has to be updated
-    bool notFound = false; // indicates if the long term has not been computed yet
-
-    // compute the long term key, the key is unique for each tx-rx pair
-    uint64_t longTermId =
-        MatrixBasedChannelModel::GetKey(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId());
+    // evict the least recently used components, but never the one just inserted
+    while (m_longTermCacheBudget > 0 && m_longTermCacheSize > m_longTermCacheBudget &&
+           m_longTermLru.size() > 1)
+    {
+        auto evicted = m_longTermCache.find(*m_longTermLru.back());
+        NS_ASSERT(evicted != m_longTermCache.end());
+        m_longTermCacheSize -= GetLongTermCost(evicted->first, evicted->second.m_longTerm);
+        auto generation = m_channelGenerations.find(evicted->first.m_linkKey);
+        NS_ASSERT(generation != m_channelGenerations.end());
+        if (--generation->second.m_longTerms == 0)
+        {
+            // release the channel matrix with the last component computed with it
+            m_channelGenerations.erase(generation);
+        }
+        m_longTermLru.pop_back();
+        m_longTermCache.erase(evicted);
+        ++m_longTermCacheEvictions;
+    }
+}
 
-    // look for the long term in the map and check if it is valid
-    if (m_longTermMap.find(longTermId) != m_longTermMap.end())
+PhasedArrayModel::ComplexVector
+ThreeGppSpectrumPropagationLossModel::GetLongTerm(
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+    // check if the channel matrix was generated considering a as the s-node and
+    // b as the u-node or vice-versa
+    Ptr<const PhasedArrayModel> sPhasedArrayModel = aPhasedArrayModel;
+    Ptr<const PhasedArrayModel> uPhasedArrayModel = bPhasedArrayModel;
+    if (channelMatrix->IsReverse(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId()))
     {
-        NS_LOG_DEBUG("found the long term component in the map");
-        longTerm = m_longTermMap[longTermId]->m_longTerm;
-
-        // check if the channel matrix has been updated
-        // or the s beam has been changed
-        // or the u beam has been changed
-        update = (m_longTermMap[longTermId]->m_channel->m_generatedTime !=
-                      channelMatrix->m_generatedTime ||
-                  m_longTermMap[longTermId]->m_sW != sW || m_longTermMap[longTermId]->m_uW != uW);
+        std::swap(sPhasedArrayModel, uPhasedArrayModel);
     }
-    else
+
+    // compute the long term key, the link key is unique for each tx-rx pair
+    LongTermKey key{
+        MatrixBasedChannelModel::GetKey(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId()),
+        sPhasedArrayModel->GetBeamformingVectorId(),
+        uPhasedArrayModel->GetBeamformingVectorId(),
+        sPhasedArrayModel->GetBeamformingVector(),
+        uPhasedArrayModel->GetBeamformingVector()};
+
+    // the generation of the channel of a link is increased whenever the
+    // channel matrix is updated, invalidating the long term components
+    // computed with the previous one
+    ChannelGeneration& generation = m_channelGenerations[key.m_linkKey];
+    if (generation.m_channel != channelMatrix)
     {
-        NS_LOG_DEBUG("long term component NOT found");
-        notFound = true;
+        generation.m_channel = channelMatrix;
+        ++generation.m_generation;
     }
+    uint64_t channelGeneration = generation.m_generation;
 
-    if (update || notFound)
+    // look for the long term in the cache and check if it is valid
+    auto it = m_longTermCache.find(key);
+    if (it != m_longTermCache.end() && it->second.m_channelGeneration == channelGeneration)
     {
-        NS_LOG_DEBUG("compute the long term");
-        // compute the long term component
-        longTerm = CalcLongTerm(channelMatrix, sW, uW);
-
-        // store the long term
-        Ptr<LongTerm> longTermItem = Create<LongTerm>();
-        longTermItem->m_longTerm = longTerm;
-        longTermItem->m_channel = channelMatrix;
-        longTermItem->m_sW = sW;
-        longTermItem->m_uW = uW;
-
-        m_longTermMap[longTermId] = longTermItem;
+        NS_LOG_DEBUG("found the long term component in the cache");
+        ++m_longTermCacheHits;
+        m_longTermLru.splice(m_longTermLru.begin(), m_longTermLru, it->second.m_lruIt);
+        return it->second.m_longTerm;
     }
 
+    NS_LOG_DEBUG("compute the long term");
+    ++m_longTermCacheMisses;
+    PhasedArrayModel::ComplexVector longTerm = CalcLongTerm(channelMatrix, key.m_sW, key.m_uW);
+    CacheLongTerm(key, longTerm, channelGeneration);
     return longTerm;
 }
 
@@ -27,6 +27,7 @@
 #include "ns3/random-variable-stream.h"
 
 #include <complex.h>
+#include <list>
 #include <map>
 #include <unordered_map>
 
@@ -109,8 +110,10 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
      * vectors (w_rx^T H^n_ab w_tx), and accounts for the Doppler component and
      * the propagation delay.
      * To reduce the computational load, the long term component associated with
-     * a certain channel is cached and recomputed only when the channel realization
-     * is updated, or when the beamforming vectors change.
+     * a certain channel and pair of beamforming vectors is cached, and recomputed
+     * only when the channel realization is updated or when new beamforming
+     * vectors are used. The size of the cache is bounded by the
+     * LongTermCacheBudget attribute.
      *
      * \param params tx parameters
      * \param a first node mobility model
@@ -126,20 +129,77 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         Ptr<const PhasedArrayModel> aPhasedArrayModel,
         Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
 
+    /**
+     * \return the number of long term components retrieved from the cache
+     */
+    uint64_t GetLongTermCacheHits() const;
+
+    /**
+     * \return the number of long term components computed because they were
+     * not found in the cache or were outdated
+     */
+    uint64_t GetLongTermCacheMisses() const;
+
+    /**
+     * \return the number of long term components evicted from the cache to
+     * respect the memory budget
+     */
+    uint64_t GetLongTermCacheEvictions() const;
+
   private:
     /**
-     * Data structure that stores the long term component for a tx-rx pair
+     * Key of a long term component: the pair of antenna arrays and their
+     * beamforming vectors. The identifiers of the beamforming vectors are
+     * hashes of their content, used to hash the key and to compare the keys
+     * before comparing the vectors themselves.
+     */
+    struct LongTermKey
+    {
+        uint64_t m_linkKey;                   //!< reciprocal key of the pair of antenna arrays
+        uint64_t m_sBfId;                     //!< identifier of the beamforming vector of s
+        uint64_t m_uBfId;                     //!< identifier of the beamforming vector of u
+        PhasedArrayModel::ComplexVector m_sW; //!< the beamforming vector of the s device
+        PhasedArrayModel::ComplexVector m_uW; //!< the beamforming vector of the u device
+
+        /**
+         * \param other the key to compare with
+         * \return true if the keys are equal
+         */
+        bool operator==(const LongTermKey& other) const;
+    };
+
+    /// Hash function for LongTermKey
+    struct LongTermKeyHash
+    {
+        /**
+         * \param key the key
+         * \return the hash of the key
+         */
+        std::size_t operator()(const LongTermKey& key) const;
+    };
+
+    /**
+     * Data structure that stores the long term component for a tx-rx pair and
+     * a pair of beamforming vectors
      */
-    struct LongTerm : public SimpleRefCount<LongTerm>
+    struct LongTerm
     {
         PhasedArrayModel::ComplexVector
             m_longTerm; //!< vector containing the long term component for each cluster
-        Ptr<const MatrixBasedChannelModel::ChannelMatrix>
-            m_channel; //!< pointer to the channel matrix used to compute the long term
-        PhasedArrayModel::ComplexVector
-            m_sW; //!< the beamforming vector for the node s used to compute the long term
-        PhasedArrayModel::ComplexVector
-            m_uW; //!< the beamforming vector for the node u used to compute the long term
+        uint64_t m_channelGeneration;                    //!< generation of the channel used
+        std::list<const LongTermKey*>::iterator m_lruIt; //!< position in the LRU list
+    };
+
+    /**
+     * The channel matrix of a pair of antenna arrays used by the cached long
+     * term components, and the number of these components
+     */
+    struct ChannelGeneration
+    {
+        /// the channel matrix
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channel;
+        uint64_t m_generation{0};   //!< generation of the channel matrix
+        std::size_t m_longTerms{0}; //!< number of cached components of the pair
     };
 
     /**
@@ -149,9 +209,10 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
     double GetFrequency() const;
 
     /**
-     * Looks for the long term component in m_longTermMap. If found, checks
-     * whether it has to be updated. If not found or if it has to be updated,
-     * calls the method CalcLongTerm to compute it.
+     * Looks for the long term component in m_longTermCache, using the
+     * current beamforming vectors. If not found, or if it
+     * was computed with a previous generation of the channel matrix, calls
+     * the method CalcLongTerm to compute it and stores it in the cache.
      * \param channelMatrix the channel matrix
      * \param aPhasedArrayModel the antenna array of the tx device
      * \param bPhasedArrayModel the antenna array of the rx device
@@ -191,8 +252,37 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         const Vector& sSpeed,
         const Vector& uSpeed) const;
 
-    mutable std::unordered_map<uint64_t, Ptr<const LongTerm>>
-        m_longTermMap;                           //!< map containing the long term components
+    /**
+     * Inserts a long term component in the cache, evicting the least recently
+     * used ones if the memory budget is exceeded. The channel generation of a
+     * pair of antenna arrays is erased with its last cached component.
+     * \param key the key of the long term component
+     * \param longTerm the long term component
+     * \param channelGeneration the generation of the channel matrix
+     */
+    void CacheLongTerm(const LongTermKey& key,
+                       const PhasedArrayModel::ComplexVector& longTerm,
+                       uint64_t channelGeneration) const;
+
+    /**
+     * \param key the key of a long term component
+     * \param longTerm a long term component
+     * \return the memory taken by a cached long term component, in bytes
+     */
+    static std::size_t GetLongTermCost(const LongTermKey& key,
+                                       const PhasedArrayModel::ComplexVector& longTerm);
+
+    mutable std::unordered_map<LongTermKey, LongTerm, LongTermKeyHash>
+        m_longTermCache;                          //!< cache of the long term components
+    /// keys of the cache, most recently used first
+    mutable std::list<const LongTermKey*> m_longTermLru;
+    /// channel matrix of the cached components, per pair of antenna arrays
+    mutable std::unordered_map<uint64_t, ChannelGeneration> m_channelGenerations;
+    uint64_t m_longTermCacheBudget;              //!< memory budget of the cache, in bytes
+    mutable std::size_t m_longTermCacheSize;     //!< memory taken by the cache, in bytes
+    mutable uint64_t m_longTermCacheHits;        //!< number of cache hits
+    mutable uint64_t m_longTermCacheMisses;      //!< number of cache misses
+    mutable uint64_t m_longTermCacheEvictions;   //!< number of cache evictions
     Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
 };
 } // namespace ns3
@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/half-duplex-ideal-phy.h>
+#include <ns3/log.h>
+#include <ns3/path-loss-spectrum-transmit-filter.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/test.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("PathLossSpectrumTransmitFilterTest");
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test the PathLossSpectrumTransmitFilter
+ *
+ * A transmitter sends a 0 dBm signal at 5.15 GHz; with Friis propagation, a
+ * threshold of -120 dBm and a margin of 10 dB, receivers farther than about
+ * 14.6 km are expected to be discarded. The test also checks that the cached
+ * path loss is refreshed when the receiver moves to a different grid cell,
+ * that the links no longer evaluated are removed from the cache, and the
+ * MaxDistance criterion.
+ */
+class PathLossSpectrumTransmitFilterTestCase : public TestCase
+{
+  public:
+    PathLossSpectrumTransmitFilterTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Create a PHY at the given position
+     *
+     * \param position the position of the PHY
+     * \return the PHY
+     */
+    Ptr<HalfDuplexIdealPhy> CreatePhy(const Vector& position);
+};
+
+PathLossSpectrumTransmitFilterTestCase::PathLossSpectrumTransmitFilterTestCase()
+    : TestCase("Check the filtering of signals received below the threshold")
+{
+}
+
+Ptr<HalfDuplexIdealPhy>
+PathLossSpectrumTransmitFilterTestCase::CreatePhy(const Vector& position)
+{
+    Ptr<HalfDuplexIdealPhy> phy = CreateObject<HalfDuplexIdealPhy>();
+    Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetPosition(position);
+    phy->SetMobility(mobility);
+    return phy;
+}
+
+void
+PathLossSpectrumTransmitFilterTestCase::DoRun()
+{
+    Bands bands;
+    BandInfo bi;
+    bi.fl = 5.1495e9;
+    bi.fc = 5.15e9;
+    bi.fh = 5.1505e9;
+    bands.push_back(bi);
+    Ptr<SpectrumModel> sm = Create<SpectrumModel>(bands);
+
+    Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+    params->psd = Create<SpectrumValue>(sm);
+    (*params->psd)[0] = 1e-3 / 1e6; // 0 dBm over 1 MHz
+    params->txPhy = CreatePhy(Vector(0, 0, 0));
+
+    Ptr<HalfDuplexIdealPhy> nearPhy = CreatePhy(Vector(100, 0, 0));
+    Ptr<HalfDuplexIdealPhy> farPhy = CreatePhy(Vector(100e3, 0, 0));
+
+    Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel>();
+    friis->SetFrequency(5.15e9);
+
+    Ptr<PathLossSpectrumTransmitFilter> filter = CreateObject<PathLossSpectrumTransmitFilter>();
+    filter->SetAttribute("ThresholdDbm", DoubleValue(-120));
+    filter->SetAttribute("MarginDb", DoubleValue(10));
+    filter->SetPropagationLossModel(friis);
+
+    NS_TEST_ASSERT_MSG_EQ(filter->Filter(params, nearPhy), false, "Near receiver filtered");
+    NS_TEST_ASSERT_MSG_EQ(filter->Filter(params, farPhy), true, "Far receiver not filtered");
+    NS_TEST_ASSERT_MSG_EQ(filter->Filter(params, farPhy), true, "Far receiver not filtered");
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNumEvaluated(), 3, "Unexpected number of evaluations");
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNumCulled(), 2, "Unexpected number of culled signals");
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNumCacheHits(), 1, "Unexpected number of cache hits");
+
+    // moving within the same cell reuses the cached loss
+    farPhy->GetMobility()->SetPosition(Vector(100e3 + 1, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(filter->Filter(params, farPhy), true, "Far receiver not filtered");
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNumCacheHits(), 2, "Unexpected number of cache hits");
+
+    // moving to a different cell refreshes the cached loss
+    farPhy->GetMobility()->SetPosition(Vector(50, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(filter->Filter(params, farPhy), false, "Moved receiver filtered");
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNumCacheHits(), 2, "Unexpected number of cache hits");
+
+    filter->ResetStats();
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNumEvaluated(), 0, "Statistics not reset");
+
+    // the links of many short-lived receivers sweep the links not evaluated
+    // since the previous sweep, whereas the links still in use are kept
+    for (uint32_t i = 0; i < 3000; i++)
+    {
+        filter->Filter(params, CreatePhy(Vector(100, 0, 0)));
+        if (i % 100 == 0)
+        {
+            filter->Filter(params, nearPhy);
+        }
+    }
+    uint64_t hits = filter->GetNumCacheHits();
+    filter->Filter(params, nearPhy);
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNumCacheHits(), hits + 1, "Link in use removed");
+    filter->Filter(params, farPhy);
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNumCacheHits(), hits + 1, "Unused link not removed");
+
+    // a receiver beyond MaxDistance is filtered even without loss model
+    Ptr<PathLossSpectrumTransmitFilter> distanceFilter =
+        CreateObject<PathLossSpectrumTransmitFilter>();
+    distanceFilter->SetAttribute("MaxDistance", DoubleValue(1000));
+    NS_TEST_ASSERT_MSG_EQ(distanceFilter->Filter(params, nearPhy),
+                          false,
+                          "Receiver within MaxDistance filtered");
+    nearPhy->GetMobility()->SetPosition(Vector(2000, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(distanceFilter->Filter(params, nearPhy),
+                          true,
+                          "Receiver beyond MaxDistance not filtered");
+
+    filter->Dispose();
+    distanceFilter->Dispose();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief PathLossSpectrumTransmitFilter TestSuite
+ */
+class PathLossSpectrumTransmitFilterTestSuite : public TestSuite
+{
+  public:
+    PathLossSpectrumTransmitFilterTestSuite();
+};
+
+PathLossSpectrumTransmitFilterTestSuite::PathLossSpectrumTransmitFilterTestSuite()
+    : TestSuite("path-loss-spectrum-transmit-filter", UNIT)
+{
+    AddTestCase(new PathLossSpectrumTransmitFilterTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static PathLossSpectrumTransmitFilterTestSuite g_pathLossSpectrumTransmitFilterTestSuite;
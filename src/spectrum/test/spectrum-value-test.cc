@@ -226,6 +226,26 @@ SpectrumValueTestSuite::SpectrumValueTestSuite()
     AddTestCase(new SpectrumValueTestCase(tv5, v5, "tv5 *= v2"), TestCase::QUICK);
     AddTestCase(new SpectrumValueTestCase(tv6, v6, "tv6 div= v2"), TestCase::QUICK);
 
+    // operators taking temporaries compute the result in place
+    tv3 = SpectrumValue(v1) + v2;
+    tv4 = v1 - SpectrumValue(v2);
+    tv5 = SpectrumValue(v1) * SpectrumValue(v2);
+    tv6 = v1 / SpectrumValue(v2);
+
+    AddTestCase(new SpectrumValueTestCase(tv3, v3, "tv3 = rvalue v1 + v2"), TestCase::QUICK);
+    AddTestCase(new SpectrumValueTestCase(tv4, v4, "tv4 = v1 - rvalue v2"), TestCase::QUICK);
+    AddTestCase(new SpectrumValueTestCase(tv5, v5, "tv5 = rvalue v1 * rvalue v2"),
+                TestCase::QUICK);
+    AddTestCase(new SpectrumValueTestCase(tv6, v6, "tv6 = v1 div rvalue v2"), TestCase::QUICK);
+
+    tv3 = (v1 - v2) + v2 + v2;
+    tv6 = (v1 * v2) / (v2 * v2);
+
+    AddTestCase(new SpectrumValueTestCase(tv3, v3, "tv3 = (v1 - v2) + v2 + v2"),
+                TestCase::QUICK);
+    AddTestCase(new SpectrumValueTestCase(tv6, v6, "tv6 = (v1 * v2) div (v2 * v2)"),
+                TestCase::QUICK);
+
     SpectrumValue tv7a(f);
     SpectrumValue tv8a(f);
     SpectrumValue tv9a(f);
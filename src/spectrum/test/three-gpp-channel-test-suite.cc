@@ -26,6 +26,7 @@
 #include "ns3/log.h"
 #include "ns3/node-container.h"
 #include "ns3/pointer.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/spectrum-signal-parameters.h"
@@ -36,6 +37,9 @@
 #include "ns3/uinteger.h"
 #include "ns3/uniform-planar-array.h"
 
+#include <algorithm>
+#include <tuple>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("ThreeGppChannelTestSuite");
@@ -682,6 +686,324 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the cache of the long term components of the
+ * ThreeGppSpectrumPropagationLossModel class. It checks that:
+ * 1) switching back to a previously used beam reuses the cached long term
+ * 2) the least recently used components are evicted to respect the budget
+ * 3) the cached components are invalidated when the channel is updated
+ */
+class ThreeGppLongTermCacheTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppLongTermCacheTest();
+
+    /**
+     * Destructor
+     */
+    ~ThreeGppLongTermCacheTest() override;
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * Compute the rx PSD and check the cache counters
+     * \param hits the expected number of cache hits
+     * \param misses the expected number of cache misses
+     * \param evictions the expected number of cache evictions
+     * \return the rx PSD
+     */
+    Ptr<SpectrumValue> CheckRxPsd(uint64_t hits, uint64_t misses, uint64_t evictions);
+
+    Ptr<ThreeGppSpectrumPropagationLossModel> m_lossModel; //!< the spectrum loss model
+    Ptr<SpectrumSignalParameters> m_txParams;              //!< the params of the tx signal
+    Ptr<MobilityModel> m_txMob;                            //!< the mobility model of the tx
+    Ptr<MobilityModel> m_rxMob;                            //!< the mobility model of the rx
+    Ptr<PhasedArrayModel> m_txAntenna;                     //!< the antenna array of the tx
+    Ptr<PhasedArrayModel> m_rxAntenna;                     //!< the antenna array of the rx
+};
+
+ThreeGppLongTermCacheTest::ThreeGppLongTermCacheTest()
+    : TestCase("Check the cache of the long term components")
+{
+}
+
+ThreeGppLongTermCacheTest::~ThreeGppLongTermCacheTest()
+{
+}
+
+Ptr<SpectrumValue>
+ThreeGppLongTermCacheTest::CheckRxPsd(uint64_t hits, uint64_t misses, uint64_t evictions)
+{
+    Ptr<SpectrumValue> rxPsd = m_lossModel->DoCalcRxPowerSpectralDensity(m_txParams,
+                                                                         m_txMob,
+                                                                         m_rxMob,
+                                                                         m_txAntenna,
+                                                                         m_rxAntenna);
+    NS_TEST_EXPECT_MSG_EQ(m_lossModel->GetLongTermCacheHits(), hits, "Unexpected cache hits");
+    NS_TEST_EXPECT_MSG_EQ(m_lossModel->GetLongTermCacheMisses(), misses, "Unexpected misses");
+    NS_TEST_EXPECT_MSG_EQ(m_lossModel->GetLongTermCacheEvictions(),
+                          evictions,
+                          "Unexpected cache evictions");
+    return rxPsd;
+}
+
+void
+ThreeGppLongTermCacheTest::DoRun()
+{
+    m_lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    m_lossModel->SetChannelModelAttribute("Frequency", DoubleValue(2.4e9));
+    m_lossModel->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+    m_lossModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+    m_lossModel->SetChannelModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(100)));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    m_txMob = CreateObject<ConstantPositionMobilityModel>();
+    m_txMob->SetPosition(Vector(0.0, 0.0, 10.0));
+    m_rxMob = CreateObject<ConstantPositionMobilityModel>();
+    m_rxMob->SetPosition(Vector(15.0, 0.0, 10.0));
+    nodes.Get(0)->AggregateObject(m_txMob);
+    nodes.Get(1)->AggregateObject(m_rxMob);
+
+    m_txAntenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumColumns",
+        UintegerValue(4),
+        "NumRows",
+        UintegerValue(4),
+        "AntennaElement",
+        PointerValue(CreateObject<IsotropicAntennaModel>()));
+    m_rxAntenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumColumns",
+        UintegerValue(2),
+        "NumRows",
+        UintegerValue(2),
+        "AntennaElement",
+        PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    // a small codebook of tx beams
+    PhasedArrayModel::ComplexVector txBeams[3] = {
+        m_txAntenna->GetBeamformingVector(Angles(0.0, M_PI / 2)),
+        m_txAntenna->GetBeamformingVector(Angles(M_PI / 4, M_PI / 2)),
+        m_txAntenna->GetBeamformingVector(Angles(-M_PI / 4, M_PI / 2))};
+    m_rxAntenna->SetBeamformingVector(m_rxAntenna->GetBeamformingVector(Angles(M_PI, M_PI / 2)));
+
+    SpectrumValue5MhzFactory sf;
+    m_txParams = Create<SpectrumSignalParameters>();
+    m_txParams->psd = sf.CreateTxPowerSpectralDensity(0.1, 1);
+
+    // 1) switching back to a previously used beam reuses the cached long term
+    m_txAntenna->SetBeamformingVector(txBeams[0]);
+    Ptr<SpectrumValue> firstPsd = CheckRxPsd(0, 1, 0);
+    CheckRxPsd(1, 1, 0);
+    m_txAntenna->SetBeamformingVector(txBeams[1]);
+    CheckRxPsd(1, 2, 0);
+    m_txAntenna->SetBeamformingVector(txBeams[0]);
+    Ptr<SpectrumValue> secondPsd = CheckRxPsd(2, 2, 0);
+    NS_TEST_ASSERT_MSG_EQ(std::equal(firstPsd->ConstValuesBegin(),
+                                     firstPsd->ConstValuesEnd(),
+                                     secondPsd->ConstValuesBegin()),
+                          true,
+                          "The cached long term differs");
+
+    // the reverse link shares the cached components
+    m_lossModel->DoCalcRxPowerSpectralDensity(m_txParams,
+                                              m_rxMob,
+                                              m_txMob,
+                                              m_rxAntenna,
+                                              m_txAntenna);
+    NS_TEST_ASSERT_MSG_EQ(m_lossModel->GetLongTermCacheHits(), 3, "Reverse link not cached");
+
+    // 2) with a tiny budget, only the last component is kept
+    m_lossModel->SetAttribute("LongTermCacheBudget", UintegerValue(1));
+    m_txAntenna->SetBeamformingVector(txBeams[2]);
+    CheckRxPsd(3, 3, 2);
+    m_txAntenna->SetBeamformingVector(txBeams[0]);
+    CheckRxPsd(3, 4, 3);
+    m_lossModel->SetAttribute("LongTermCacheBudget", UintegerValue(0));
+
+    // 3) the cached component is invalidated when the channel is updated
+    Simulator::Schedule(MilliSeconds(101), [this]() { CheckRxPsd(3, 5, 3); });
+    Simulator::Run();
+    Simulator::Destroy();
+
+    m_lossModel = nullptr;
+    m_txParams = nullptr;
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the parallel computation of the channel coefficients in the
+ * ThreeGppChannelModel class. Two channel models, using the same random
+ * streams, the first one with ComputationThreads set to 0 and the second one to
+ * a larger value, are queried for the same links several times per update
+ * period, in an order different from the one of the channel keys. It checks
+ * that:
+ * 1) the channel matrices are regenerated when they are requested after the
+ *    end of the update period, as without threads
+ * 2) the channel realizations do not depend on the number of threads
+ */
+class ThreeGppChannelComputationThreadsTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppChannelComputationThreadsTest();
+
+    /**
+     * Destructor
+     */
+    ~ThreeGppChannelComputationThreadsTest() override;
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * Get the channel matrices of all the links from both channel models and
+     * check that they are equal
+     */
+    void DoGetChannels();
+
+    Ptr<ThreeGppChannelModel> m_sequentialModel; //!< the model without threads
+    Ptr<ThreeGppChannelModel> m_parallelModel;   //!< the model using multiple threads
+    /// the links, as (tx mobility, rx mobility, tx antenna, rx antenna)
+    std::vector<std::tuple<Ptr<MobilityModel>,
+                           Ptr<MobilityModel>,
+                           Ptr<PhasedArrayModel>,
+                           Ptr<PhasedArrayModel>>>
+        m_links;
+    std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>>
+        m_lastChannels; //!< the channel matrices returned by the last call to DoGetChannels
+};
+
+ThreeGppChannelComputationThreadsTest::ThreeGppChannelComputationThreadsTest()
+    : TestCase("Check that the channel matrices do not depend on the number of threads")
+{
+}
+
+ThreeGppChannelComputationThreadsTest::~ThreeGppChannelComputationThreadsTest()
+{
+}
+
+void
+ThreeGppChannelComputationThreadsTest::DoGetChannels()
+{
+    std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> channels;
+    for (std::size_t i = 0; i < m_links.size(); i++)
+    {
+        auto [txMob, rxMob, txAntenna, rxAntenna] = m_links[i];
+        Ptr<const ThreeGppChannelModel::ChannelMatrix> sequential =
+            m_sequentialModel->GetChannel(txMob, rxMob, txAntenna, rxAntenna);
+        Ptr<const ThreeGppChannelModel::ChannelMatrix> parallel =
+            m_parallelModel->GetChannel(txMob, rxMob, txAntenna, rxAntenna);
+
+        NS_TEST_ASSERT_MSG_EQ(sequential->m_generatedTime,
+                              parallel->m_generatedTime,
+                              "The generation times differ");
+        NS_TEST_ASSERT_MSG_EQ((sequential->m_channel == parallel->m_channel),
+                              true,
+                              "The channel realizations depend on the number of threads");
+
+        // the channel is regenerated when requested more than an update
+        // period after its generation
+        if (!m_lastChannels.empty())
+        {
+            Time lastGenerated = m_lastChannels[i]->m_generatedTime;
+            bool expired = (Simulator::Now() - lastGenerated > MilliSeconds(100));
+            NS_TEST_ASSERT_MSG_EQ(sequential->m_generatedTime,
+                                  (expired ? Simulator::Now() : lastGenerated),
+                                  "The channel matrix has not been regenerated at the right time");
+            NS_TEST_ASSERT_MSG_EQ((sequential->m_channel == m_lastChannels[i]->m_channel),
+                                  !expired,
+                                  "The channel matrix has been updated unexpectedly");
+        }
+        channels.push_back(sequential);
+    }
+    m_lastChannels = channels;
+}
+
+void
+ThreeGppChannelComputationThreadsTest::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    // create the nodes: node 0 is the transmitter, the others are the receivers
+    NodeContainer nodes;
+    nodes.Create(4);
+    std::vector<Ptr<MobilityModel>> mobs;
+    std::vector<Ptr<PhasedArrayModel>> antennas;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+        mob->SetPosition(i == 0 ? Vector(0.0, 0.0, 10.0) : Vector(50.0 * i, 10.0 * i, 1.6));
+        nodes.Get(i)->AggregateObject(mob);
+        mobs.push_back(mob);
+
+        // use antenna arrays of different sizes, large enough for their
+        // coefficients to be computed by multiple threads
+        antennas.push_back(CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(i == 0 ? 8 : 2 * i),
+            "NumRows",
+            UintegerValue(i == 0 ? 8 : 2),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>())));
+    }
+    // query the links in the reverse order of their keys
+    for (uint32_t i = nodes.GetN() - 1; i > 0; i--)
+    {
+        m_links.emplace_back(mobs[0], mobs[i], antennas[0], antennas[i]);
+    }
+
+    uint32_t nThreads[]{0, 4};
+    Ptr<ThreeGppChannelModel> models[2];
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        models[i] = CreateObject<ThreeGppChannelModel>();
+        models[i]->SetAttribute("Frequency", DoubleValue(28.0e9));
+        models[i]->SetAttribute("Scenario", StringValue("UMi-StreetCanyon"));
+        models[i]->SetAttribute("ChannelConditionModel",
+                                PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+        models[i]->SetAttribute("UpdatePeriod", TimeValue(MilliSeconds(100)));
+        models[i]->SetAttribute("ComputationThreads", UintegerValue(nThreads[i]));
+        models[i]->AssignStreams(1);
+    }
+    m_sequentialModel = models[0];
+    m_parallelModel = models[1];
+
+    // the channels are regenerated at 130 and 270 ms
+    for (uint32_t t : {0, 30, 60, 90, 130, 170, 230, 270, 330})
+    {
+        Simulator::Schedule(MilliSeconds(t),
+                            &ThreeGppChannelComputationThreadsTest::DoGetChannels,
+                            this);
+    }
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    m_sequentialModel = nullptr;
+    m_parallelModel = nullptr;
+    m_links.clear();
+    m_lastChannels.clear();
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -701,7 +1023,9 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite()
 {
     AddTestCase(new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
     AddTestCase(new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
+    AddTestCase(new ThreeGppChannelComputationThreadsTest, TestCase::QUICK);
     AddTestCase(new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+    AddTestCase(new ThreeGppLongTermCacheTest, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
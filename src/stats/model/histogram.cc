@@ -19,6 +19,7 @@
 
 #include "histogram.h"
 
+#include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 
@@ -48,19 +49,33 @@ Histogram::GetNBins() const
 double
 Histogram::GetBinStart(uint32_t index) const
 {
-    return index * m_binWidth;
+    uint32_t linearBins = 2U << m_precision;
+    if (m_precision == 0 || index < linearBins)
+    {
+        return index * m_binWidth;
+    }
+    // bin 'index' groups the values whose 'precision + 1' most significant bits,
+    // in units of m_binWidth, are 'sub', and whose other 'shift' bits are ignored
+    uint32_t shift = (index >> m_precision) - 1;
+    uint32_t sub = index - (shift << m_precision);
+    return std::ldexp(sub * m_binWidth, shift);
 }
 
 double
 Histogram::GetBinEnd(uint32_t index) const
 {
-    return (index + 1) * m_binWidth;
+    return GetBinStart(index) + GetBinWidth(index);
 }
 
 double
 Histogram::GetBinWidth(uint32_t index) const
 {
-    return m_binWidth;
+    uint32_t linearBins = 2U << m_precision;
+    if (m_precision == 0 || index < linearBins)
+    {
+        return m_binWidth;
+    }
+    return std::ldexp(m_binWidth, (index >> m_precision) - 1);
 }
 
 void
@@ -68,6 +83,36 @@ Histogram::SetDefaultBinWidth(double binWidth)
 {
     NS_ASSERT(m_histogram.empty()); // we can only change the bin width if no values were added
     m_binWidth = binWidth;
+    m_precision = 0;
+}
+
+void
+Histogram::SetLogBins(double resolution, uint8_t precision)
+{
+    NS_ASSERT(m_histogram.empty()); // we can only change the bins if no values were added
+    NS_ASSERT_MSG(precision >= 1 && precision <= 16, "Invalid precision " << +precision);
+    m_binWidth = resolution;
+    m_precision = precision;
+}
+
+uint32_t
+Histogram::GetIndex(double value) const
+{
+    if (m_precision == 0)
+    {
+        return (uint32_t)std::floor(value / m_binWidth);
+    }
+    double units = std::floor(value / m_binWidth);
+    if (units < (2U << m_precision))
+    {
+        return (uint32_t)units;
+    }
+    // keep the 'precision + 1' most significant bits of the value
+    int exponent;
+    std::frexp(units, &exponent); // units is in [2^(exponent-1), 2^exponent)
+    uint32_t shift = exponent - 1 - m_precision;
+    auto sub = (uint32_t)std::ldexp(units, -(int)shift);
+    return (shift << m_precision) + sub;
 }
 
 uint32_t
@@ -77,10 +122,39 @@ Histogram::GetBinCount(uint32_t index) const
     return m_histogram[index];
 }
 
+uint64_t
+Histogram::GetCount() const
+{
+    uint64_t count = 0;
+    for (auto binCount : m_histogram)
+    {
+        count += binCount;
+    }
+    return count;
+}
+
+double
+Histogram::GetPercentile(double percentile) const
+{
+    NS_ASSERT_MSG(percentile >= 0 && percentile <= 100, "Invalid percentile " << percentile);
+    double rank = percentile / 100 * GetCount();
+    uint64_t below = 0;
+    for (uint32_t index = 0; index < m_histogram.size(); index++)
+    {
+        if (m_histogram[index] > 0 && below + m_histogram[index] >= rank)
+        {
+            double fraction = (rank - below) / m_histogram[index];
+            return GetBinStart(index) + fraction * GetBinWidth(index);
+        }
+        below += m_histogram[index];
+    }
+    return 0;
+}
+
 void
 Histogram::AddValue(double value)
 {
-    auto index = (uint32_t)std::floor(value / m_binWidth);
+    uint32_t index = GetIndex(value);
 
     // check if we need to resize the vector
     NS_LOG_DEBUG("AddValue: index=" << index << ", m_histogram.size()=" << m_histogram.size());
@@ -92,6 +166,21 @@ Histogram::AddValue(double value)
     m_histogram[index]++;
 }
 
+void
+Histogram::Merge(const Histogram& other)
+{
+    NS_ABORT_MSG_IF(m_binWidth != other.m_binWidth || m_precision != other.m_precision,
+                    "Histograms with different bins can not be merged");
+    if (other.m_histogram.size() > m_histogram.size())
+    {
+        m_histogram.resize(other.m_histogram.size(), 0);
+    }
+    for (uint32_t index = 0; index < other.m_histogram.size(); index++)
+    {
+        m_histogram[index] += other.m_histogram[index];
+    }
+}
+
 void
 Histogram::Clear()
 {
@@ -101,11 +190,13 @@ Histogram::Clear()
 Histogram::Histogram(double binWidth)
 {
     m_binWidth = binWidth;
+    m_precision = 0;
 }
 
 Histogram::Histogram()
 {
     m_binWidth = DEFAULT_BIN_WIDTH;
+    m_precision = 0;
 }
 
 void
@@ -124,8 +215,8 @@ Histogram::SerializeToXmlStream(std::ostream& os, uint16_t indent, std::string e
             os << std::string(indent, ' ');
             os << "<bin"
                << " index=\"" << (index) << "\""
-               << " start=\"" << (index * m_binWidth) << "\""
-               << " width=\"" << m_binWidth << "\""
+               << " start=\"" << GetBinStart(index) << "\""
+               << " width=\"" << GetBinWidth(index) << "\""
                << " count=\"" << m_histogram[index] << "\""
                << " />\n";
         }
@@ -36,6 +36,12 @@ namespace ns3
  *
  * This class only handles \a positive bins, i.e., it does \a not handles negative data.
  *
+ * Alternatively, the bins can be logarithmic (see SetLogBins()), as in an
+ * HDR histogram: each power of two is split in the same number of bins, so
+ * that the relative width of the bins is bounded, and a wide range of values
+ * is covered with few bins. Histograms with the same bins can be merged, and
+ * the percentiles of the data can be estimated from any histogram.
+ *
  * \todo Add support for negative data.
  *
  * \todo Add method(s) to estimate parameters from the histogram,
@@ -74,7 +80,7 @@ class Histogram
     /**
      * \brief Returns the bin width.
      *
-     * Note that all the bins have the same width.
+     * Note that all the bins have the same width, unless the bins are logarithmic.
      *
      * \param index the bin index
      * \return the bin width
@@ -84,16 +90,46 @@ class Histogram
      * \brief Set the bin width.
      *
      * Note that you can change the bin width only if the histogram is empty.
+     * The bins are linear afterwards.
      *
      * \param binWidth the bin width
      */
     void SetDefaultBinWidth(double binWidth);
+    /**
+     * \brief Use logarithmic bins.
+     *
+     * The values lower than 2^(precision+1) * resolution are grouped in bins
+     * of width \a resolution. Each following power of two is split in
+     * 2^precision bins of the same width, so that the width of a bin is at
+     * most 2^-precision times its start.
+     *
+     * Note that you can change the bins only if the histogram is empty.
+     *
+     * \param resolution the width of the narrowest bins
+     * \param precision the log2 of the number of bins per power of two, from 1 to 16
+     */
+    void SetLogBins(double resolution, uint8_t precision);
     /**
      * \brief Get the number of data added to the bin.
      * \param index the bin index
      * \return the number of data added to the bin
      */
     uint32_t GetBinCount(uint32_t index) const;
+    /**
+     * \brief Get the number of data added to the histogram.
+     * \return the number of data added to the histogram
+     */
+    uint64_t GetCount() const;
+    /**
+     * \brief Estimate a percentile of the data.
+     *
+     * The value is interpolated linearly in the bin holding the percentile,
+     * so its error is at most the width of that bin.
+     *
+     * \param percentile the percentile, from 0 to 100
+     * \return the estimated value, or 0 if the histogram is empty
+     */
+    double GetPercentile(double percentile) const;
 
     // Method for adding values
     /**
@@ -102,6 +138,15 @@ class Histogram
      */
     void AddValue(double value);
 
+    /**
+     * \brief Add the data of another histogram.
+     *
+     * Both histograms must have the same bins.
+     *
+     * \param other the histogram to add
+     */
+    void Merge(const Histogram& other);
+
     /**
      * Clear the histogram content.
      */
@@ -116,8 +161,16 @@ class Histogram
     void SerializeToXmlStream(std::ostream& os, uint16_t indent, std::string elementName) const;
 
   private:
+    /**
+     * \brief Get the bin of a value.
+     * \param value the value
+     * \return the bin index
+     */
+    uint32_t GetIndex(double value) const;
+
     std::vector<uint32_t> m_histogram; //!< Histogram data
-    double m_binWidth;                 //!< Bin width
+    double m_binWidth;                 //!< Bin width, or width of the narrowest logarithmic bins
+    uint8_t m_precision;               //!< log2 of the bins per power of two, 0 for linear bins
 };
 
 } // namespace ns3
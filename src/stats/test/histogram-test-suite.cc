@@ -71,6 +71,88 @@ HistogramTestCase::DoRun()
     }
 }
 
+/**
+ * \ingroup stats-tests
+ *
+ * \brief Histogram with logarithmic bins Test
+ */
+class HistogramLogBinsTestCase : public ns3::TestCase
+{
+  public:
+    HistogramLogBinsTestCase();
+    void DoRun() override;
+};
+
+HistogramLogBinsTestCase::HistogramLogBinsTestCase()
+    : ns3::TestCase("Histogram with logarithmic bins")
+{
+}
+
+void
+HistogramLogBinsTestCase::DoRun()
+{
+    Histogram h0;
+    h0.SetLogBins(0.5, 2);
+    {
+        // Testing the linear bins below 2^3 * 0.5
+        h0.AddValue(0.7);
+        h0.AddValue(3.9);
+        NS_TEST_EXPECT_MSG_EQ(h0.GetNBins(), 8, "");
+        NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(1), 1, "");
+        NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(7), 1, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h0.GetBinWidth(7), 0.5, 1e-6, "");
+    }
+
+    {
+        // Testing the logarithmic bins: 4 bins per power of two
+        h0.AddValue(4);
+        h0.AddValue(8.9);
+        h0.AddValue(1000);
+        NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(8), 1, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h0.GetBinStart(8), 4, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h0.GetBinWidth(8), 1, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(12), 1, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h0.GetBinStart(12), 8, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h0.GetBinEnd(12), 10, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ(h0.GetNBins(), 40, "");
+        NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(39), 1, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h0.GetBinStart(39), 896, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h0.GetBinEnd(39), 1024, 1e-6, "");
+    }
+
+    {
+        // Testing the relative width of the bins
+        for (uint32_t index = 8; index < h0.GetNBins(); index++)
+        {
+            NS_TEST_EXPECT_MSG_EQ_TOL(h0.GetBinStart(index + 1),
+                                      h0.GetBinEnd(index),
+                                      1e-6,
+                                      "Bins are not contiguous");
+            NS_TEST_EXPECT_MSG_LT_OR_EQ(h0.GetBinWidth(index),
+                                        h0.GetBinStart(index) / 4,
+                                        "Bin too wide");
+        }
+    }
+
+    {
+        // Testing the merge and the percentiles
+        Histogram h1;
+        h1.SetLogBins(0.5, 2);
+        for (int i = 0; i < 95; i++)
+        {
+            h1.AddValue(0.2);
+        }
+        h1.Merge(h0);
+        NS_TEST_EXPECT_MSG_EQ(h1.GetCount(), 100, "");
+        NS_TEST_EXPECT_MSG_EQ(h1.GetBinCount(0), 95, "");
+        NS_TEST_EXPECT_MSG_EQ(h1.GetBinCount(39), 1, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h1.GetPercentile(50), 50.0 / 95 * 0.5, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h1.GetPercentile(100), 1024, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(h1.GetPercentile(99.5), 960, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ(Histogram().GetPercentile(50), 0, "");
+    }
+}
+
 /**
  * \ingroup stats-tests
  *
@@ -86,6 +168,7 @@ HistogramTestSuite::HistogramTestSuite()
     : TestSuite("histogram", UNIT)
 {
     AddTestCase(new HistogramTestCase, TestCase::QUICK);
+    AddTestCase(new HistogramLogBinsTestCase, TestCase::QUICK);
 }
 
 static HistogramTestSuite g_HistogramTestSuite; //!< Static variable for test initialization
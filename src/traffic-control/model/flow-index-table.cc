@@ -0,0 +1,150 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-index-table.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowIndexTable");
+
+/** Initial number of slots. */
+static constexpr uint32_t INITIAL_SLOTS_LOG2 = 4;
+
+FlowIndexTable::FlowIndexTable()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+}
+
+inline uint32_t
+FlowIndexTable::GetHome(uint32_t flowQueue) const
+{
+    // Fibonacci hashing: the flow queues of a set are consecutive numbers
+    return (flowQueue * 2654435769U) >> m_shift;
+}
+
+const FlowIndexTable::Slot*
+FlowIndexTable::Find(uint32_t flowQueue) const
+{
+    uint32_t mask = m_slots.size() - 1;
+    for (uint32_t i = GetHome(flowQueue);; i = (i + 1) & mask)
+    {
+        const Slot& slot = m_slots[i];
+        if (slot.flowQueue == flowQueue)
+        {
+            return &slot;
+        }
+        if (slot.flowQueue == EMPTY)
+        {
+            return nullptr;
+        }
+    }
+}
+
+FlowIndexTable::Slot&
+FlowIndexTable::Insert(uint32_t flowQueue)
+{
+    NS_ASSERT_MSG(flowQueue != EMPTY, "Invalid flow queue " << flowQueue);
+    if (2 * (m_size + 1) > m_slots.size())
+    {
+        Grow();
+    }
+    uint32_t mask = m_slots.size() - 1;
+    uint32_t i = GetHome(flowQueue);
+    while (m_slots[i].flowQueue != flowQueue && m_slots[i].flowQueue != EMPTY)
+    {
+        i = (i + 1) & mask;
+    }
+    Slot& slot = m_slots[i];
+    if (slot.flowQueue == EMPTY)
+    {
+        slot.flowQueue = flowQueue;
+        m_size++;
+    }
+    return slot;
+}
+
+void
+FlowIndexTable::Grow()
+{
+    NS_LOG_FUNCTION(this << m_slots.size());
+    std::vector<Slot> slots(2 * m_slots.size(), Slot{EMPTY, NO_CLASS, 0, false});
+    slots.swap(m_slots);
+    m_shift--;
+    uint32_t mask = m_slots.size() - 1;
+    for (const auto& slot : slots)
+    {
+        if (slot.flowQueue != EMPTY)
+        {
+            uint32_t i = GetHome(slot.flowQueue);
+            while (m_slots[i].flowQueue != EMPTY)
+            {
+                i = (i + 1) & mask;
+            }
+            m_slots[i] = slot;
+        }
+    }
+}
+
+uint32_t
+FlowIndexTable::GetClassIndex(uint32_t flowQueue) const
+{
+    const Slot* slot = Find(flowQueue);
+    return slot ? slot->classIndex : NO_CLASS;
+}
+
+void
+FlowIndexTable::SetClassIndex(uint32_t flowQueue, uint32_t classIndex)
+{
+    NS_LOG_FUNCTION(this << flowQueue << classIndex);
+    Insert(flowQueue).classIndex = classIndex;
+}
+
+bool
+FlowIndexTable::HasTag(uint32_t flowQueue, uint32_t tag) const
+{
+    const Slot* slot = Find(flowQueue);
+    return slot && slot->tagged && slot->tag == tag;
+}
+
+void
+FlowIndexTable::SetTag(uint32_t flowQueue, uint32_t tag)
+{
+    NS_LOG_FUNCTION(this << flowQueue << tag);
+    Slot& slot = Insert(flowQueue);
+    slot.tag = tag;
+    slot.tagged = true;
+}
+
+uint32_t
+FlowIndexTable::GetSize() const
+{
+    return m_size;
+}
+
+void
+FlowIndexTable::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    m_slots.assign(1U << INITIAL_SLOTS_LOG2, Slot{EMPTY, NO_CLASS, 0, false});
+    m_shift = 32 - INITIAL_SLOTS_LOG2;
+    m_size = 0;
+}
+
+} // namespace ns3
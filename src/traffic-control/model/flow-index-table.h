@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_INDEX_TABLE_H
+#define FLOW_INDEX_TABLE_H
+
+#include <limits>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Index of the flow queues of a flow queueing queue disc.
+ *
+ * The flow queueing queue discs (FqCoDel, FqPie, FqCobalt) classify the
+ * packets into flow queues, identified by the hash of the flow 5-tuple
+ * modulo the number of flow queues, and create the queue disc class of a
+ * flow queue when its first packet arrives. This table maps the flow queues
+ * to the index of their queue disc class and, when the set associative hash
+ * is enabled, to the tag of the flow they are associated with.
+ *
+ * The table uses open addressing with linear probing in an array whose size
+ * is a power of two, kept at most half full, so that a lookup usually reads
+ * a single slot whatever the number of flow queues. The flow queues are
+ * never removed, as the queue disc classes are not.
+ */
+class FlowIndexTable
+{
+  public:
+    /** Class index of the flow queues without a queue disc class. */
+    static constexpr uint32_t NO_CLASS = std::numeric_limits<uint32_t>::max();
+
+    FlowIndexTable();
+
+    /**
+     * Get the queue disc class of a flow queue.
+     *
+     * \param [in] flowQueue The flow queue.
+     * \return The index of the queue disc class, or NO_CLASS.
+     */
+    uint32_t GetClassIndex(uint32_t flowQueue) const;
+
+    /**
+     * Set the queue disc class of a flow queue.
+     *
+     * \param [in] flowQueue The flow queue.
+     * \param [in] classIndex The index of the queue disc class.
+     */
+    void SetClassIndex(uint32_t flowQueue, uint32_t classIndex);
+
+    /**
+     * Check the tag of a flow queue.
+     *
+     * \param [in] flowQueue The flow queue.
+     * \param [in] tag The tag.
+     * \return true if the flow queue has the given tag.
+     */
+    bool HasTag(uint32_t flowQueue, uint32_t tag) const;
+
+    /**
+     * Set the tag of a flow queue.
+     *
+     * \param [in] flowQueue The flow queue.
+     * \param [in] tag The tag.
+     */
+    void SetTag(uint32_t flowQueue, uint32_t tag);
+
+    /**
+     * \return The number of flow queues with a queue disc class or a tag.
+     */
+    uint32_t GetSize() const;
+
+    /** Remove all the flow queues. */
+    void Clear();
+
+  private:
+    /** A slot of the table. */
+    struct Slot
+    {
+        uint32_t flowQueue;  //!< The flow queue, or EMPTY if the slot is free
+        uint32_t classIndex; //!< The index of the queue disc class, or NO_CLASS
+        uint32_t tag;        //!< The tag of the flow queue, if tagged
+        bool tagged;         //!< Whether the flow queue has a tag
+    };
+
+    /** Flow queue of the free slots: the flow queues are lower than the number of queues. */
+    static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Find the slot of a flow queue.
+     * \param [in] flowQueue The flow queue.
+     * \return The slot, or nullptr if the flow queue is not in the table.
+     */
+    const Slot* Find(uint32_t flowQueue) const;
+
+    /**
+     * Find the slot of a flow queue, adding it if needed.
+     * \param [in] flowQueue The flow queue.
+     * \return The slot.
+     */
+    Slot& Insert(uint32_t flowQueue);
+
+    /**
+     * Get the first slot to probe for a flow queue.
+     * \param [in] flowQueue The flow queue.
+     * \return The index of the slot.
+     */
+    uint32_t GetHome(uint32_t flowQueue) const;
+
+    /** Double the number of slots. */
+    void Grow();
+
+    std::vector<Slot> m_slots; //!< The slots, a power of two
+    uint32_t m_shift;          //!< 32 minus the log2 of the number of slots
+    uint32_t m_size;           //!< The number of used slots
+};
+
+} // namespace ns3
+
+#endif /* FLOW_INDEX_TABLE_H */
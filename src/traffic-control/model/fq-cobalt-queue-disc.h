@@ -27,6 +27,7 @@
 #ifndef FQ_COBALT_QUEUE_DISC
 #define FQ_COBALT_QUEUE_DISC
 
+#include "flow-index-table.h"
 #include "queue-disc.h"
 
 #include "ns3/object-factory.h"
@@ -193,8 +194,7 @@ class FqCobaltQueueDisc : public QueueDisc
     std::list<Ptr<FqCobaltFlow>> m_newFlows; //!< The list of new flows
     std::list<Ptr<FqCobaltFlow>> m_oldFlows; //!< The list of old flows
 
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    FlowIndexTable m_flowsIndices; //!< Index of class and set associative hash tag of each flow
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
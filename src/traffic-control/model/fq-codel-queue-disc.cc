@@ -210,22 +210,21 @@ FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
 
     for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-        auto it = m_flowsIndices.find(i);
+        uint32_t classIndex = m_flowsIndices.GetClassIndex(i);
 
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqCoDelFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
+        if (classIndex == FlowIndexTable::NO_CLASS || m_flowsIndices.HasTag(i, flowHash) ||
+            StaticCast<FqCoDelFlow>(GetQueueDiscClass(classIndex))->GetStatus() ==
                 FqCoDelFlow::INACTIVE)
         {
             // this queue has not been created yet or is associated with this flow
             // or is inactive, hence we can use it
-            m_tags[i] = flowHash;
+            m_flowsIndices.SetTag(i, flowHash);
             return i;
         }
     }
 
     // all the queues of the set are used. Use the first queue of the set
-    m_tags[outerHash] = flowHash;
+    m_flowsIndices.SetTag(outerHash, flowHash);
     return outerHash;
 }
 
@@ -267,7 +266,8 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     }
 
     Ptr<FqCoDelFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    uint32_t classIndex = m_flowsIndices.GetClassIndex(h);
+    if (classIndex == FlowIndexTable::NO_CLASS)
     {
         NS_LOG_DEBUG("Creating a new flow queue with index " << h);
         flow = m_flowFactory.Create<FqCoDelFlow>();
@@ -285,11 +285,12 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         flow->SetIndex(h);
         AddQueueDiscClass(flow);
 
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
+        classIndex = GetNQueueDiscClasses() - 1;
+        m_flowsIndices.SetClassIndex(h, classIndex);
     }
     else
     {
-        flow = StaticCast<FqCoDelFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        flow = StaticCast<FqCoDelFlow>(GetQueueDiscClass(classIndex));
     }
 
     if (flow->GetStatus() == FqCoDelFlow::INACTIVE)
@@ -301,7 +302,7 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 
     flow->GetQueueDisc()->Enqueue(item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << classIndex);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -26,6 +26,7 @@
 #ifndef FQ_PIE_QUEUE_DISC
 #define FQ_PIE_QUEUE_DISC
 
+#include "flow-index-table.h"
 #include "queue-disc.h"
 
 #include "ns3/object-factory.h"
@@ -203,8 +204,7 @@ class FqPieQueueDisc : public QueueDisc
     std::list<Ptr<FqPieFlow>> m_newFlows; //!< The list of new flows
     std::list<Ptr<FqPieFlow>> m_oldFlows; //!< The list of old flows
 
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    FlowIndexTable m_flowsIndices; //!< Index of class and set associative hash tag of each flow
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
@@ -0,0 +1,97 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/flow-index-table.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Flow Index Table Test Case
+ *
+ * Fills the table with many flow queues, some of them sharing their first
+ * slot, and checks their class indices and tags after the table grew.
+ */
+class FlowIndexTableTestCase : public TestCase
+{
+  public:
+    FlowIndexTableTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FlowIndexTableTestCase::FlowIndexTableTestCase()
+    : TestCase("Flow index table")
+{
+}
+
+void
+FlowIndexTableTestCase::DoRun()
+{
+    const uint32_t nFlowQueues = 5000;
+    FlowIndexTable table;
+    NS_TEST_EXPECT_MSG_EQ(table.GetClassIndex(0), FlowIndexTable::NO_CLASS, "Empty table");
+    NS_TEST_EXPECT_MSG_EQ(table.HasTag(0, 0), false, "Empty table");
+
+    // flow queues that are multiples of a power of two probe the same slots
+    for (uint32_t i = 0; i < nFlowQueues; i++)
+    {
+        table.SetClassIndex(i << 16, i);
+    }
+    for (uint32_t i = 0; i < nFlowQueues; i += 2)
+    {
+        table.SetTag(i << 16, i + 1);
+    }
+    NS_TEST_EXPECT_MSG_EQ(table.GetSize(), nFlowQueues, "Wrong number of flow queues");
+    for (uint32_t i = 0; i < nFlowQueues; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(table.GetClassIndex(i << 16), i, "Wrong class index");
+        NS_TEST_EXPECT_MSG_EQ(table.HasTag(i << 16, i + 1), (i % 2 == 0), "Wrong tag");
+        NS_TEST_EXPECT_MSG_EQ(table.GetClassIndex((i << 16) + 1),
+                              FlowIndexTable::NO_CLASS,
+                              "Flow queue found but not added");
+    }
+
+    // a flow queue can be tagged before its class is created
+    table.SetTag(7, 42);
+    NS_TEST_EXPECT_MSG_EQ(table.GetClassIndex(7), FlowIndexTable::NO_CLASS, "Class not created");
+    NS_TEST_EXPECT_MSG_EQ(table.HasTag(7, 42), true, "Tag not set");
+    table.SetClassIndex(7, nFlowQueues);
+    NS_TEST_EXPECT_MSG_EQ(table.GetClassIndex(7), nFlowQueues, "Wrong class index");
+    NS_TEST_EXPECT_MSG_EQ(table.HasTag(7, 42), true, "Tag lost");
+    NS_TEST_EXPECT_MSG_EQ(table.GetSize(), nFlowQueues + 1, "Wrong number of flow queues");
+
+    table.Clear();
+    NS_TEST_EXPECT_MSG_EQ(table.GetSize(), 0, "Table not cleared");
+    NS_TEST_EXPECT_MSG_EQ(table.GetClassIndex(7), FlowIndexTable::NO_CLASS, "Table not cleared");
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Flow Index Table Test Suite
+ */
+static class FlowIndexTableTestSuite : public TestSuite
+{
+  public:
+    FlowIndexTableTestSuite()
+        : TestSuite("flow-index-table", UNIT)
+    {
+        AddTestCase(new FlowIndexTableTestCase(), TestCase::QUICK);
+    }
+} g_flowIndexTableTestSuite; ///< the test suite
@@ -22,6 +22,7 @@
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
 
 #include "ns3/command-line.h"
+#include "ns3/packet-allocator.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
 #include "ns3/system-wall-clock-ms.h"
@@ -214,6 +215,51 @@ class BenchTag : public Tag
     }
 };
 
+static void
+benchCreate(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1500);
+    }
+}
+
+static void
+benchCopy(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+    BenchTag<16> tag;
+
+    Ptr<Packet> p = Create<Packet>(1500);
+    p->AddHeader(udp);
+    p->AddHeader(ipv4);
+    p->AddPacketTag(tag);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> o = p->Copy();
+    }
+}
+
+static void
+benchMtuFragment(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(9000);
+        p->AddHeader(udp);
+        for (uint32_t offset = 0; offset < p->GetSize(); offset += 1480)
+        {
+            Ptr<Packet> fragment =
+                p->CreateFragment(offset, std::min<uint32_t>(1480, p->GetSize() - offset));
+            fragment->AddHeader(ipv4);
+        }
+    }
+}
+
 static void
 benchD(uint32_t n)
 {
@@ -364,16 +410,21 @@ static void
 runBench(void (*bench)(uint32_t), uint32_t n, uint32_t minIterations, const char* name)
 {
     uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    PacketAllocator::ResetStatistics();
     for (uint32_t i = 0; i < minIterations; i++)
     {
         uint64_t delay = runBenchOneIteration(bench, n);
         minDelay = std::min(minDelay, delay);
     }
+    PacketAllocator::Statistics stats = PacketAllocator::GetStatistics();
     double ps = n;
     ps *= 1000;
     ps /= minDelay;
     std::cout << ps << " packets/s"
-              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+              << " (" << minDelay << " ms elapsed, "
+              << static_cast<double>(stats.allocations) / n / minIterations
+              << " allocations/packet, " << stats.heapAllocations << " from the heap)\t" << name
+              << std::endl;
 }
 
 int
@@ -401,11 +452,14 @@ main(int argc, char* argv[])
     std::cout << "Running bench-packets with n=" << n << std::endl;
     std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
 
+    runBench(&benchCreate, n, minIterations, "Create packet");
+    runBench(&benchCopy, n, minIterations, "Copy packet");
     runBench(&benchA, n, minIterations, "Copy packet, remove headers");
     runBench(&benchB, n, minIterations, "Just add headers");
     runBench(&benchC, n, minIterations, "Remove by func call");
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
+    runBench(&benchMtuFragment, n, minIterations, "Fragmentation to the MTU");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
 
     return 0;
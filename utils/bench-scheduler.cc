@@ -239,7 +239,11 @@ class BenchSuite
         void Log(T label) const;
     }; // struct Result
 
+    /** Log the average cost of scheduling and invoking an event. */
+    void LogEventCost() const;
+
     std::string m_scheduler;       /**< Descriptive string for the scheduler. */
+    bool m_eventPool;              /**< Whether the event pool was enabled. */
     std::vector<Result> m_results; /**< Store for the run results. */
 
 }; // BenchSuite
@@ -274,6 +278,7 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     Simulator::SetScheduler(factory);
 
     m_scheduler = factory.GetTypeId().GetName();
+    m_eventPool = EventImpl::IsPoolEnabled();
     if (m_scheduler == "ns3::CalendarScheduler")
     {
         m_scheduler += ": insertion order: " + std::string(calRev ? "reverse" : "normal");
@@ -282,6 +287,7 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     {
         m_scheduler += " (default)";
     }
+    m_scheduler += std::string(", event pool: ") + (m_eventPool ? "on" : "off");
 
     Bench bench(pop, total);
     bench.SetRandomStream(eventStream);
@@ -328,11 +334,29 @@ BenchSuite::Header() const
                           << std::right << std::setw(g_fwidth) << " " << std::setfill(' '));
 }
 
+void
+BenchSuite::LogEventCost() const
+{
+    if (m_results.empty())
+    {
+        return;
+    }
+    double period = 0;
+    for (const auto& run : m_results)
+    {
+        period += run.run.period;
+    }
+    period /= m_results.size();
+    LOG("Schedule+invoke: " << period * 1e9 << " ns/event (event pool "
+                            << (m_eventPool ? "on" : "off") << ")");
+}
+
 void
 BenchSuite::Log() const
 {
     if (m_results.size() < 2)
     {
+        LogEventCost();
         LOG("");
         return;
     }
@@ -382,11 +406,124 @@ BenchSuite::Log() const
 
     average.Log("average");
     stdev.Log("stdev");
+    LogEventCost();
 
     LOG("");
 
 } // BenchSuite::Log()
 
+/**
+ * Event delays mimicking the event distribution of TTI-driven models.
+ *
+ * Most events are PHY and MAC events scheduled a few slots ahead, on a slot
+ * boundary or on an OFDM symbol boundary within the slot, which results in
+ * large bursts of events sharing the same timestamp.  The remaining events
+ * model long-horizon application and mobility timers, with exponentially
+ * distributed delays.
+ *
+ * The delays depend on the current simulation time, to keep the events
+ * aligned to slot and symbol boundaries.
+ */
+class TtiDelayStream : public RandomVariableStream
+{
+  public:
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * Configure the workload.
+     *
+     * \param [in] slot The slot duration, in ns.
+     * \param [in] symbols The number of OFDM symbols per slot.
+     * \param [in] timerProbability The fraction of long-horizon timer events.
+     * \param [in] timerMean The mean delay of the timer events, in ns.
+     */
+    void SetWorkload(uint64_t slot, uint32_t symbols, double timerProbability, double timerMean);
+
+    // Inherited
+    double GetValue() override;
+    uint32_t GetInteger() override;
+
+  private:
+    uint64_t m_slot{1000000};               /**< Slot duration, in ns. */
+    uint32_t m_symbols{14};                 /**< Number of OFDM symbols per slot. */
+    double m_timerProbability{0.1};         /**< Fraction of long-horizon timer events. */
+    Ptr<UniformRandomVariable> m_uniform;   /**< Selection of the event type. */
+    Ptr<ExponentialRandomVariable> m_timer; /**< Delays of the timer events. */
+};
+
+TypeId
+TtiDelayStream::GetTypeId()
+{
+    static TypeId tid = TypeId("TtiDelayStream")
+                            .SetParent<RandomVariableStream>()
+                            .AddConstructor<TtiDelayStream>();
+    return tid;
+}
+
+void
+TtiDelayStream::SetWorkload(uint64_t slot,
+                            uint32_t symbols,
+                            double timerProbability,
+                            double timerMean)
+{
+    m_slot = slot;
+    m_symbols = symbols;
+    m_timerProbability = timerProbability;
+    m_uniform = CreateObject<UniformRandomVariable>();
+    m_timer = CreateObject<ExponentialRandomVariable>();
+    m_timer->SetAttribute("Mean", DoubleValue(timerMean));
+}
+
+double
+TtiDelayStream::GetValue()
+{
+    if (m_uniform->GetValue() < m_timerProbability)
+    {
+        return std::ceil(m_timer->GetValue());
+    }
+    // Next slot boundary, up to 3 slots ahead, and 1 in 4 events on a
+    // symbol boundary within the slot.
+    uint64_t now = Simulator::Now().GetNanoSeconds();
+    uint64_t next = (now / m_slot + 1 + m_uniform->GetInteger(0, 2)) * m_slot;
+    if (m_uniform->GetValue() < 0.25)
+    {
+        next += m_uniform->GetInteger(1, m_symbols - 1) * (m_slot / m_symbols);
+    }
+    return next - now;
+}
+
+uint32_t
+TtiDelayStream::GetInteger()
+{
+    return static_cast<uint32_t>(GetValue());
+}
+
+/**
+ *  Create a TtiDelayStream to generate next event delays.
+ *
+ *  The LTE workload uses 1 ms slots; the NR workload uses the 125 us
+ *  slots of numerology 3.  In both cases 10% of the events are timers
+ *  with a mean delay of 100 ms.
+ *
+ *  \param [in] workload The workload, either \c lte or \c nr.
+ *  \returns The RandomVariableStream.
+ */
+Ptr<RandomVariableStream>
+GetWorkloadStream(std::string workload)
+{
+    NS_ABORT_MSG_IF(workload != "lte" && workload != "nr", "Unknown workload " << workload);
+    uint64_t slot = (workload == "lte") ? 1000000 : 125000;
+    LOG("  Event time distribution:      " << workload << " TTI workload, " << slot
+                                           << " ns slots");
+    auto stream = CreateObject<TtiDelayStream>();
+    stream->SetWorkload(slot, 14, 0.1, 1e8);
+    return stream;
+}
+
 /**
  *  Create a RandomVariableStream to generate next event delays.
  *
@@ -457,6 +594,7 @@ main(int argc, char* argv[])
     bool allSched = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -465,7 +603,9 @@ main(int argc, char* argv[])
     uint64_t total = 1000000;
     uint64_t runs = 1;
     std::string filename = "";
+    std::string workload = "";
     bool calRev = false;
+    bool comparePool = false;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark the simulator scheduler.\n"
@@ -474,14 +614,21 @@ main(int argc, char* argv[])
               "  an exponential distribution, with mean 100 ns,\n"
               "  an ascii file, given by the --file=\"<filename>\" argument,\n"
               "  or standard input, by the argument --file=\"-\"\n"
+              "  or a TTI-driven workload, given by --workload=lte (1 ms slots)\n"
+              "  or --workload=nr (125 us slots)\n"
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
               "\n"
-              "If no scheduler is specified the MapScheduler will be run.");
+              "If no scheduler is specified the MapScheduler will be run.\n"
+              "\n"
+              "With --pool, each scheduler is run first with the EventImpl\n"
+              "pool disabled, then enabled, to compare the cost of\n"
+              "scheduling and invoking an event.");
     cmd.AddValue("all", "use all schedulers", allSched);
     cmd.AddValue("cal", "use CalendarSheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListSheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
@@ -490,7 +637,9 @@ main(int argc, char* argv[])
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("workload", "TTI-driven workload: lte or nr", workload);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
+    cmd.AddValue("pool", "compare runs without and with the event pool", comparePool);
     cmd.Parse(argc, argv);
 
     g_me = cmd.GetName() + ": ";
@@ -505,54 +654,69 @@ main(int argc, char* argv[])
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
+    auto eventStream = workload.empty() ? GetRandomStream(filename) : GetWorkloadStream(workload);
 
-    ObjectFactory factory("ns3::MapScheduler");
-    if (schedCal)
-    {
-        factory.SetTypeId("ns3::CalendarScheduler");
-        factory.Set("Reverse", BooleanValue(calRev));
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
-        if (allSched)
+    auto runSchedulers = [&]() {
+        ObjectFactory factory("ns3::MapScheduler");
+        if (schedCal)
         {
-            factory.Set("Reverse", BooleanValue(!calRev));
-            BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            factory.SetTypeId("ns3::CalendarScheduler");
+            factory.Set("Reverse", BooleanValue(calRev));
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+            if (allSched)
+            {
+                factory.Set("Reverse", BooleanValue(!calRev));
+                BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            }
         }
-    }
-    if (schedHeap)
-    {
-        factory.SetTypeId("ns3::HeapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
-    }
-    if (schedList)
-    {
-        factory.SetTypeId("ns3::ListScheduler");
-        auto listTotal = total;
-        if (allSched)
+        if (schedHeap)
         {
-            LOG("Running List scheduler with 1/10 total events");
-            listTotal /= 10;
+            factory.SetTypeId("ns3::HeapScheduler");
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
         }
-        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
-    }
-    if (schedMap)
-    {
-        factory.SetTypeId("ns3::MapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
-    }
-    if (schedPQ)
+        if (schedLadder)
+        {
+            factory.SetTypeId("ns3::LadderScheduler");
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        }
+        if (schedList)
+        {
+            factory.SetTypeId("ns3::ListScheduler");
+            auto listTotal = total;
+            if (allSched)
+            {
+                LOG("Running List scheduler with 1/10 total events");
+                listTotal /= 10;
+            }
+            BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
+        }
+        if (schedMap)
+        {
+            factory.SetTypeId("ns3::MapScheduler");
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        }
+        if (schedPQ)
+        {
+            factory.SetTypeId("ns3::PriorityQueueScheduler");
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        }
+    };
+
+    if (comparePool)
     {
-        factory.SetTypeId("ns3::PriorityQueueScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        Config::SetDefault("ns3::SimulatorImpl::EventPool", BooleanValue(false));
+        runSchedulers();
+        Config::SetDefault("ns3::SimulatorImpl::EventPool", BooleanValue(true));
     }
+    runSchedulers();
 
     return 0;
 }
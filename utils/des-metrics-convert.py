@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+"""
+Convert a binary DES Metrics trace file (.desm), written by ns3::DesMetrics,
+to one of the following formats:
+- json: the JSON format of the DES Metrics tools (default).
+- folded: "send;receive count" context stacks, the input of flamegraph.pl.
+- csv: one line per event, with the wall clock time of the scheduling.
+
+See the documentation of ns3::DesMetrics in src/core/model/des-metrics.h
+for the layout of the trace file.
+"""
+
+import argparse
+import collections
+import struct
+import sys
+
+MAGIC = b"ns3desm\0"
+VERSION = 1
+RECORD = struct.Struct("=iiqqq")
+
+
+def read_trace(path):
+    """
+    Read a trace file.
+
+    @param path Path of the trace file.
+    @return The header text and an iterator over the records.
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[: len(MAGIC)] != MAGIC:
+        sys.exit(f"{path}: not a DES Metrics trace file")
+    version, length = struct.unpack_from("=II", data, len(MAGIC))
+    if version != VERSION:
+        sys.exit(f"{path}: unsupported format version {version}")
+    start = len(MAGIC) + 8
+    header = data[start : start + length].decode()
+    events = data[start + length :]
+    if len(events) % RECORD.size != 0:
+        print(f"{path}: truncated last record ignored", file=sys.stderr)
+        events = events[: len(events) - len(events) % RECORD.size]
+    return header, RECORD.iter_unpack(events)
+
+
+def write_json(header, records, out):
+    """Write the header and the events in JSON."""
+    out.write(header)
+    separator = ""
+    for send, recv, send_time, recv_time, _ in records:
+        out.write(f'{separator}  ["{send}","{send_time}","{recv}","{recv_time}"]')
+        separator = ",\n"
+    out.write("\n ]\n}\n")
+
+
+def write_folded(records, out):
+    """Write the number of events of each pair of contexts."""
+    stacks = collections.Counter((send, recv) for send, recv, _, _, _ in records)
+    for (send, recv), count in sorted(stacks.items()):
+        out.write(f"{send};{recv} {count}\n")
+
+
+def write_csv(records, out):
+    """Write the events in CSV."""
+    out.write("send,send_time,recv,recv_time,wall_clock_ns\n")
+    for record in records:
+        out.write(",".join(str(field) for field in record) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a DES Metrics trace file.")
+    parser.add_argument("trace", help="the .desm trace file")
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument(
+        "--folded", action="store_true", help="write context stacks for flamegraph.pl"
+    )
+    group.add_argument("--csv", action="store_true", help="write the events as CSV")
+    args = parser.parse_args()
+
+    header, records = read_trace(args.trace)
+    if args.folded:
+        write_folded(records, sys.stdout)
+    elif args.csv:
+        write_csv(records, sys.stdout)
+    else:
+        write_json(header, records, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,179 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/channel-condition-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/core-module.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/node.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Create an antenna array and its node, placed at the given position.
+ *
+ * \param rows The number of rows of the array.
+ * \param cols The number of columns of the array.
+ * \param position The position of the node.
+ * \param [out] mob The mobility model of the node.
+ * \return The antenna array.
+ */
+Ptr<PhasedArrayModel>
+CreateArray(uint32_t rows, uint32_t cols, const Vector& position, Ptr<MobilityModel>& mob)
+{
+    Ptr<Node> node = CreateObject<Node>();
+    mob = CreateObject<ConstantPositionMobilityModel>();
+    mob->SetPosition(position);
+    node->AggregateObject(mob);
+    return CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumRows",
+        UintegerValue(rows),
+        "NumColumns",
+        UintegerValue(cols),
+        "AntennaElement",
+        PointerValue(CreateObject<IsotropicAntennaModel>()));
+}
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Compute a beamforming vector with a linear phase progression.
+ *
+ * \param antenna The antenna array.
+ * \param phase The phase difference between consecutive elements.
+ * \return The beamforming vector.
+ */
+PhasedArrayModel::ComplexVector
+MakeBeam(Ptr<PhasedArrayModel> antenna, double phase)
+{
+    size_t n = antenna->GetNumberOfElements();
+    PhasedArrayModel::ComplexVector w(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        w[i] = std::polar(1.0 / std::sqrt(n), phase * i);
+    }
+    return w;
+}
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Measure the time needed to compute the received PSD.
+ *
+ * \param lossModel The spectrum propagation loss model.
+ * \param params The parameters of the transmitted signal.
+ * \param aMob The mobility model of the transmitter.
+ * \param bMob The mobility model of the receiver.
+ * \param aAntenna The antenna array of the transmitter.
+ * \param bAntenna The antenna array of the receiver.
+ * \param n The number of computations.
+ * \param changeBeam Whether to change the transmit beam at each computation,
+ *        forcing the computation of the long term component.
+ * \return The average time per computation, in microseconds.
+ */
+double
+PerfRxPsd(Ptr<ThreeGppSpectrumPropagationLossModel> lossModel,
+          Ptr<SpectrumSignalParameters> params,
+          Ptr<MobilityModel> aMob,
+          Ptr<MobilityModel> bMob,
+          Ptr<PhasedArrayModel> aAntenna,
+          Ptr<PhasedArrayModel> bAntenna,
+          uint32_t n,
+          bool changeBeam)
+{
+    PhasedArrayModel::ComplexVector beams[2] = {MakeBeam(aAntenna, 0.3), MakeBeam(aAntenna, 0.7)};
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (changeBeam)
+        {
+            aAntenna->SetBeamformingVector(beams[i % 2]);
+        }
+        sum += Sum(*lossModel->CalcRxPowerSpectralDensity(params, aMob, bMob, aAntenna, bAntenna));
+    }
+    auto end = std::chrono::steady_clock::now();
+    NS_ABORT_MSG_IF(sum <= 0, "Unexpected received power");
+    return std::chrono::duration<double, std::micro>(end - start).count() / n;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t txRows = 8;
+    uint32_t txCols = 8;
+    uint32_t rxRows = 2;
+    uint32_t rxCols = 2;
+    uint32_t numRbs = 100;
+    uint32_t n = 2000;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("txRows", "Number of rows of the transmit array", txRows);
+    cmd.AddValue("txCols", "Number of columns of the transmit array", txCols);
+    cmd.AddValue("rxRows", "Number of rows of the receive array", rxRows);
+    cmd.AddValue("rxCols", "Number of columns of the receive array", rxCols);
+    cmd.AddValue("numRbs", "Number of 180 kHz sub-bands of the PSD", numRbs);
+    cmd.AddValue("n", "Number of received PSD computations", n);
+    cmd.Parse(argc, argv);
+
+    double frequency = 28e9;
+    Ptr<ThreeGppSpectrumPropagationLossModel> lossModel =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    lossModel->SetChannelModelAttribute("Frequency", DoubleValue(frequency));
+    lossModel->SetChannelModelAttribute("Scenario", StringValue("UMi-StreetCanyon"));
+    lossModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+
+    Ptr<MobilityModel> aMob;
+    Ptr<MobilityModel> bMob;
+    Ptr<PhasedArrayModel> aAntenna = CreateArray(txRows, txCols, Vector(0, 0, 10), aMob);
+    Ptr<PhasedArrayModel> bAntenna = CreateArray(rxRows, rxCols, Vector(100, 20, 1.5), bMob);
+    aAntenna->SetBeamformingVector(MakeBeam(aAntenna, 0.3));
+    bAntenna->SetBeamformingVector(MakeBeam(bAntenna, 0.5));
+
+    Bands bands;
+    for (uint32_t i = 0; i < numRbs; ++i)
+    {
+        BandInfo band;
+        band.fc = frequency + (i - numRbs / 2.0) * 180e3;
+        band.fl = band.fc - 90e3;
+        band.fh = band.fc + 90e3;
+        bands.push_back(band);
+    }
+    Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+    params->psd = Create<SpectrumValue>(Create<SpectrumModel>(bands));
+    *params->psd = 1e-9;
+
+    std::cout << txRows * txCols << "x" << rxRows * rxCols << " antenna elements, " << numRbs
+              << " sub-bands" << std::endl;
+    std::cout << "long term and beamforming gain: "
+              << PerfRxPsd(lossModel, params, aMob, bMob, aAntenna, bAntenna, n, true)
+              << " us per received PSD" << std::endl;
+    std::cout << "beamforming gain only:          "
+              << PerfRxPsd(lossModel, params, aMob, bMob, aAntenna, bAntenna, n, false)
+              << " us per received PSD" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Time a function called repeatedly.
+ *
+ * \param n The number of calls.
+ * \param f The function, called with the index of the call.
+ * \return The mean duration of a call, in nanoseconds.
+ */
+template <typename F>
+double
+PerfLoop(uint32_t n, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        f(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / n;
+}
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * A trace sink counting its calls.
+ */
+class Sink
+{
+  public:
+    /**
+     * Count a call.
+     * \param value The traced value.
+     */
+    void Receive(uint32_t value)
+    {
+        m_sum += value;
+    }
+
+    /**
+     * Count a call with a context.
+     * \param context The context.
+     * \param value The traced value.
+     */
+    void ReceiveWithContext(std::string context, uint32_t value)
+    {
+        m_sum += value + context.size();
+    }
+
+    uint64_t m_sum{0}; //!< Sum of the traced values
+};
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * A free trace sink with a bound argument.
+ *
+ * \param sink The bound sink.
+ * \param value The traced value.
+ */
+void
+BoundReceive(Sink* sink, uint32_t value)
+{
+    sink->m_sum += value;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 1000000;
+    uint32_t sinks = 4;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("n", "Number of calls of each operation", n);
+    cmd.AddValue("sinks", "Number of sinks connected to the trace source", sinks);
+    cmd.Parse(argc, argv);
+
+    Sink sink;
+    std::vector<Callback<void, uint32_t>> callbacks(n);
+
+    auto makeMember = [&](uint32_t i) { callbacks[i] = MakeCallback(&Sink::Receive, &sink); };
+    auto makeBound = [&](uint32_t i) { callbacks[i] = MakeBoundCallback(&BoundReceive, &sink); };
+    std::cout << "make a member callback:         " << PerfLoop(n, makeMember) << " ns per call"
+              << std::endl;
+    std::cout << "make a bound callback:          " << PerfLoop(n, makeBound) << " ns per call"
+              << std::endl;
+
+    Callback<void, uint32_t> member = MakeCallback(&Sink::Receive, &sink);
+    Callback<void, uint32_t> bound = MakeBoundCallback(&BoundReceive, &sink);
+    std::cout << "copy a callback:                "
+              << PerfLoop(n, [&](uint32_t i) { callbacks[i] = member; }) << " ns per call"
+              << std::endl;
+    callbacks.clear();
+
+    std::cout << "invoke a member callback:       " << PerfLoop(n, [&](uint32_t i) { member(i); })
+              << " ns per call" << std::endl;
+    std::cout << "invoke a bound callback:        " << PerfLoop(n, [&](uint32_t i) { bound(i); })
+              << " ns per call" << std::endl;
+
+    std::vector<TracedCallback<uint32_t>> sources(n / sinks);
+    auto connect = [&](uint32_t i) { sources[i / sinks].ConnectWithoutContext(member); };
+    std::cout << "connect a sink:                 " << PerfLoop(n / sinks * sinks, connect)
+              << " ns per call" << std::endl;
+    sources.clear();
+
+    TracedCallback<uint32_t> source;
+    TracedCallback<uint32_t> contextSource;
+    for (uint32_t i = 0; i < sinks; ++i)
+    {
+        source.ConnectWithoutContext(member);
+        contextSource.Connect(MakeCallback(&Sink::ReceiveWithContext, &sink),
+                              "/NodeList/0/DeviceList/0/Tx");
+    }
+    std::cout << "fire a trace source:            " << PerfLoop(n, [&](uint32_t i) { source(i); })
+              << " ns per call, " << sinks << " sinks" << std::endl;
+    std::cout << "fire a trace source (context):  "
+              << PerfLoop(n, [&](uint32_t i) { contextSource(i); }) << " ns per call, " << sinks
+              << " sinks" << std::endl;
+
+    std::cout << "checksum: " << sink.m_sum << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Time a function called repeatedly.
+ *
+ * \param n The number of calls.
+ * \param f The function, called with the index of the call.
+ * \return The mean duration of a call, in nanoseconds.
+ */
+template <typename F>
+double
+PerfLoop(uint32_t n, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        f(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / n;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 100000;
+    std::string typeName = "ns3::SimpleNetDevice";
+    std::string attribute = "DataRate";
+    std::string value = "10Mbps";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("n", "Number of objects to create and of lookups", n);
+    cmd.AddValue("type", "TypeId of the objects to create", typeName);
+    cmd.AddValue("attribute", "Attribute to set and look up", attribute);
+    cmd.AddValue("value", "Value of the attribute", value);
+    cmd.Parse(argc, argv);
+
+    TypeId tid = TypeId::LookupByName(typeName);
+    TypeId::AttributeInformation info;
+    NS_ABORT_MSG_UNLESS(tid.LookupAttributeByName(attribute, &info),
+                        "No attribute " << attribute << " in " << typeName);
+
+    ObjectFactory factory(typeName);
+    std::vector<Ptr<Object>> objects;
+    objects.reserve(n);
+
+    std::cout << n << " objects of type " << typeName << " with "
+              << tid.GetInheritedAttributes().size() << " attributes" << std::endl;
+    std::cout << "create with default attributes: "
+              << PerfLoop(n, [&](uint32_t) { objects.push_back(factory.Create()); })
+              << " ns per object" << std::endl;
+    objects.clear();
+
+    factory.Set(attribute, StringValue(value));
+    std::cout << "create with one attribute:      "
+              << PerfLoop(n, [&](uint32_t) { objects.push_back(factory.Create()); })
+              << " ns per object" << std::endl;
+
+    StringValue result;
+    std::cout << "get an attribute by name:       "
+              << PerfLoop(n, [&](uint32_t i) { objects[i]->GetAttribute(attribute, result); })
+              << " ns per call" << std::endl;
+
+    // Aggregate each object to a node, which moves to the head of the
+    // aggregates once looked up, and look the object up by its TypeId.
+    Object::ResetLookupStatistics();
+    for (auto& object : objects)
+    {
+        object->AggregateObject(CreateObject<Node>());
+        object->GetObject<Node>();
+    }
+    std::cout << "get an aggregated object:       "
+              << PerfLoop(n, [&](uint32_t i) { objects[i]->GetObject<Object>(tid); })
+              << " ns per call" << std::endl;
+    Object::LookupStatistics lookups = Object::GetLookupStatistics();
+    std::cout << "aggregate lookups:              " << lookups.hits << " hits, " << lookups.misses
+              << " misses" << std::endl;
+    objects.clear();
+
+    std::cout << "look up a TypeId by name:       "
+              << PerfLoop(n, [&](uint32_t) { TypeId::LookupByName(typeName); }) << " ns per call"
+              << std::endl;
+    std::cout << "look up an attribute by name:   "
+              << PerfLoop(n, [&](uint32_t) { tid.LookupAttributeByName(attribute, &info); })
+              << " ns per call" << std::endl;
+    std::cout << "set an attribute default:       "
+              << PerfLoop(n,
+                          [&](uint32_t) {
+                              Config::SetDefault(typeName + "::" + attribute, StringValue(value));
+                          })
+              << " ns per call" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Time a function called repeatedly.
+ *
+ * \param n The number of calls.
+ * \param f The function, called with the index of the call.
+ * \return The mean duration of a call, in nanoseconds.
+ */
+template <typename F>
+double
+PerfLoop(uint32_t n, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        f(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / n;
+}
+
+/**
+ * \ingroup system-tests-perf
+ *
+ * Create a flow queueing queue disc.
+ *
+ * \param setAssociativeHash Whether to enable the set associative hash.
+ * \return The queue disc.
+ */
+template <typename T>
+Ptr<QueueDisc>
+CreateFqQueueDisc(bool setAssociativeHash)
+{
+    Ptr<T> queueDisc = CreateObject<T>();
+    queueDisc->SetAttribute("EnableSetAssociativeHash", BooleanValue(setAssociativeHash));
+    queueDisc->SetQuantum(1500);
+    queueDisc->Initialize();
+    return queueDisc;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nPackets = 1000000;
+    uint32_t nFlows = 1000;
+    uint32_t burst = 64;
+    uint32_t packetSize = 1000;
+    bool setAssociativeHash = false;
+    bool tcp = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("n", "Number of packets enqueued and dequeued", nPackets);
+    cmd.AddValue("flows", "Number of flows", nFlows);
+    cmd.AddValue("burst", "Number of packets enqueued before dequeuing them", burst);
+    cmd.AddValue("size", "Payload size of the packets, in bytes", packetSize);
+    cmd.AddValue("setAssociativeHash", "Enable the set associative hash", setAssociativeHash);
+    cmd.AddValue("tcp", "Send TCP segments with timestamps instead of UDP datagrams", tcp);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(burst == 0, "The burst must contain at least one packet");
+    NS_ABORT_MSG_IF(nFlows == 0, "There must be at least one flow");
+    nPackets -= nPackets % burst;
+
+    // Stop recording the Time objects for a change of resolution, as a
+    // simulation does when it starts running
+    Simulator::Run();
+
+    // One packet and one IPv4 header per flow, the flows being interleaved below
+    std::vector<Ptr<Packet>> packets;
+    std::vector<Ipv4Header> headers;
+    for (uint32_t flow = 0; flow < nFlows; ++flow)
+    {
+        Ptr<Packet> packet = Create<Packet>(packetSize);
+        if (tcp)
+        {
+            TcpHeader header;
+            header.SetSourcePort(49152 + flow % 16384);
+            header.SetDestinationPort(5000 + flow / 16384);
+            header.AppendOption(CreateObject<TcpOptionTS>());
+            packet->AddHeader(header);
+        }
+        else
+        {
+            UdpHeader header;
+            header.SetSourcePort(49152 + flow % 16384);
+            header.SetDestinationPort(5000 + flow / 16384);
+            packet->AddHeader(header);
+        }
+        packets.push_back(packet);
+
+        Ipv4Header ipv4;
+        ipv4.SetSource(Ipv4Address("10.0.0.1"));
+        ipv4.SetDestination(Ipv4Address("10.1.0.1"));
+        ipv4.SetProtocol(tcp ? TcpL4Protocol::PROT_NUMBER : UdpL4Protocol::PROT_NUMBER);
+        ipv4.SetPayloadSize(packet->GetSize());
+        headers.push_back(ipv4);
+    }
+    Address destination;
+    auto createItem = [&](uint32_t i) {
+        uint32_t flow = (i * 7919ULL) % nFlows;
+        return Create<Ipv4QueueDiscItem>(packets[flow]->Copy(),
+                                         destination,
+                                         Ipv4L3Protocol::PROT_NUMBER,
+                                         headers[flow]);
+    };
+
+    std::cout << nPackets << " packets of " << nFlows << " flows, in bursts of " << burst
+              << std::endl;
+    std::cout << "create a queue disc item:       " << PerfLoop(nPackets, createItem)
+              << " ns per packet" << std::endl;
+    Ptr<QueueDiscItem> item = createItem(0);
+    std::cout << "hash the 5-tuple of a packet:   "
+              << PerfLoop(nPackets, [&](uint32_t i) { item->Hash(i); }) << " ns per packet"
+              << std::endl;
+
+    std::vector<std::pair<std::string, Ptr<QueueDisc>>> queueDiscs = {
+        {"FqCoDel", CreateFqQueueDisc<FqCoDelQueueDisc>(setAssociativeHash)},
+        {"FqPie", CreateFqQueueDisc<FqPieQueueDisc>(setAssociativeHash)},
+        {"FqCobalt", CreateFqQueueDisc<FqCobaltQueueDisc>(setAssociativeHash)},
+    };
+    for (auto& [name, queueDisc] : queueDiscs)
+    {
+        // The item creation is included, see above for its cost
+        double ns = PerfLoop(nPackets / burst, [&](uint32_t i) {
+            for (uint32_t j = 0; j < burst; ++j)
+            {
+                queueDisc->Enqueue(createItem(i * burst + j));
+            }
+            for (uint32_t j = 0; j < burst; ++j)
+            {
+                queueDisc->Dequeue();
+            }
+        });
+        ns /= burst;
+        NS_ABORT_MSG_UNLESS(queueDisc->GetStats().nTotalDroppedPackets == 0,
+                            name << " dropped packets: " << queueDisc->GetStats());
+        std::cout << name << " enqueue and dequeue: " << std::string(12 - name.size(), ' ') << ns
+                  << " ns per packet, " << 1e3 / ns << " Mpps, "
+                  << queueDisc->GetNQueueDiscClasses() << " flow queues" << std::endl;
+    }
+
+    Simulator::Destroy();
+    return 0;
+}